@@ -18,13 +18,45 @@ use pyo3::Python;
 use pyo3::prelude::*;
 use pyo3::wrap_pyfunction;
 
-use hashbrown::HashSet;
-use itertools::Itertools;
 use ndarray::prelude::*;
 use numpy::{IntoPyArray, PyReadonlyArray1, PyReadonlyArray2};
+use rayon::prelude::*;
 
 use qiskit_circuit::gate_matrix::ONE_QUBIT_IDENTITY;
 use qiskit_util::complex::C_ZERO;
+use qiskit_util::getenv_use_multiple_threads;
+
+/// The minimum number of matrix entries for which the gates are applied in parallel.
+const PARALLEL_THRESHOLD: usize = 1 << 14;
+
+type Gate2x2 = [[Complex64; 2]; 2];
+
+fn gate_from_array(gate: &PyReadonlyArray2<Complex64>) -> Gate2x2 {
+    let gate = gate.as_array();
+    [[gate[[0, 0]], gate[[0, 1]]], [gate[[1, 0]], gate[[1, 1]]]]
+}
+
+/// Apply a single-qubit gate to the pairs of entries `(top[i], bottom[i])`.
+///
+/// The entries are contiguous, so that the compiler can vectorize the loop.
+#[inline(always)]
+fn apply_2x2(gate: &Gate2x2, top: &mut [Complex64], bottom: &mut [Complex64]) {
+    for (x, y) in top.iter_mut().zip(bottom.iter_mut()) {
+        let (a, b) = (*x, *y);
+        *x = gate[0][0] * a + gate[0][1] * b;
+        *y = gate[1][0] * a + gate[1][1] * b;
+    }
+}
+
+/// The index of the entry of a diagonal gate acting on the qubits with the given labels, for
+/// the basis state `state` of `num_qubits` qubits. Qubit labels count from the most significant
+/// bit of the state.
+#[inline(always)]
+fn diag_index(state: usize, num_qubits: usize, action_qubit_labels: &[usize]) -> usize {
+    action_qubit_labels.iter().fold(0, |acc, label| {
+        (acc << 1) | ((state >> (num_qubits - 1 - label)) & 1)
+    })
+}
 
 /// Find special unitary matrix that maps [c0,c1] to [r,0] or [0,r] if basis_state=0 or
 /// basis_state=1 respectively
@@ -90,23 +122,24 @@ pub fn find_squs_for_disentangling(
     } else {
         a(k, s + 1) + 1
     };
-    let mut output: Vec<Array2<Complex64>> = (0..i_start).map(|_| Array2::eye(2)).collect();
-    let mut squs: Vec<Array2<Complex64>> = (i_start..2_usize.pow((n - s - 1) as u32))
+    let stride = 1 << s;
+    let (offset, basis_state) = (b(k, s), k_s(k, s));
+    (0..1 << (n - s - 1))
         .map(|i| {
-            reverse_qubit_state_inner(
-                &[
-                    v[[2 * i * 2_usize.pow(s as u32) + b(k, s), k_prime]],
-                    v[[(2 * i + 1) * 2_usize.pow(s as u32) + b(k, s), k_prime]],
-                ],
-                k_s(k, s),
-                epsilon,
-            )
+            let squ = if i < i_start {
+                Array2::eye(2)
+            } else {
+                reverse_qubit_state_inner(
+                    &[
+                        v[[2 * i * stride + offset, k_prime]],
+                        v[[(2 * i + 1) * stride + offset, k_prime]],
+                    ],
+                    basis_state,
+                    epsilon,
+                )
+            };
+            squ.into_pyarray(py).into_any().unbind()
         })
-        .collect();
-    output.append(&mut squs);
-    output
-        .into_iter()
-        .map(|x| x.into_pyarray(py).into_any().unbind())
         .collect()
 }
 
@@ -117,31 +150,31 @@ pub fn apply_ucg(
     k: usize,
     single_qubit_gates: Vec<PyReadonlyArray2<Complex64>>,
 ) -> Py<PyAny> {
-    let mut m = m.as_array().to_owned();
+    let mut m = m.as_array().as_standard_layout().into_owned();
     let shape = m.shape();
     let num_qubits = shape[0].ilog2();
     let num_col = shape[1];
-    let spacing: usize = 2_usize.pow(num_qubits - k as u32 - 1);
-    for j in 0..2_usize.pow(num_qubits - 1) {
-        let i = (j / spacing) * spacing + j;
-        let gate_index = i / (2_usize.pow(num_qubits - k as u32));
-        for col in 0..num_col {
-            let gate = single_qubit_gates[gate_index].as_array();
-            let a = m[[i, col]];
-            let b = m[[i + spacing, col]];
-            m[[i, col]] = gate[[0, 0]] * a + gate[[0, 1]] * b;
-            m[[i + spacing, col]] = gate[[1, 0]] * a + gate[[1, 1]] * b;
+    let gates: Vec<Gate2x2> = single_qubit_gates.iter().map(gate_from_array).collect();
+    // The rows are split into consecutive blocks, one for each single-qubit gate, whose first
+    // and second halves are the rows where the target qubit is 0 and 1 respectively.
+    let half_block = (1 << (num_qubits - k as u32 - 1)) * num_col;
+    let data = m.as_slice_mut().expect("the matrix is in standard layout");
+    if half_block > 0 {
+        let apply = |(gate_index, block): (usize, &mut [Complex64])| {
+            let (top, bottom) = block.split_at_mut(half_block);
+            apply_2x2(&gates[gate_index], top, bottom);
+        };
+        if getenv_use_multiple_threads() && data.len() >= PARALLEL_THRESHOLD {
+            data.par_chunks_mut(2 * half_block)
+                .enumerate()
+                .for_each(apply);
+        } else {
+            data.chunks_mut(2 * half_block).enumerate().for_each(apply);
         }
     }
     m.into_pyarray(py).into_any().unbind()
 }
 
-#[inline(always)]
-fn bin_to_int(bin: &[u8]) -> usize {
-    bin.iter()
-        .fold(0_usize, |acc, digit| (acc << 1) + *digit as usize)
-}
-
 #[pyfunction]
 pub fn apply_diagonal_gate(
     py: Python,
@@ -150,17 +183,20 @@ pub fn apply_diagonal_gate(
     diag: PyReadonlyArray1<Complex64>,
 ) -> PyResult<Py<PyAny>> {
     let diag = diag.as_slice()?;
-    let mut m = m.as_array().to_owned();
+    let mut m = m.as_array().as_standard_layout().into_owned();
     let shape = m.shape();
-    let num_qubits = shape[0].ilog2();
+    let num_qubits = shape[0].ilog2() as usize;
     let num_col = shape[1];
-    for state in std::iter::repeat_n([0_u8, 1_u8], num_qubits as usize).multi_cartesian_product() {
-        let diag_index = action_qubit_labels
-            .iter()
-            .fold(0_usize, |acc, i| (acc << 1) + state[*i] as usize);
-        let i = bin_to_int(&state);
-        for j in 0..num_col {
-            m[[i, j]] = diag[diag_index] * m[[i, j]]
+    let data = m.as_slice_mut().expect("the matrix is in standard layout");
+    if num_col > 0 {
+        let apply = |(state, row): (usize, &mut [Complex64])| {
+            let factor = diag[diag_index(state, num_qubits, &action_qubit_labels)];
+            row.iter_mut().for_each(|x| *x *= factor);
+        };
+        if getenv_use_multiple_threads() && data.len() >= PARALLEL_THRESHOLD {
+            data.par_chunks_mut(num_col).enumerate().for_each(apply);
+        } else {
+            data.chunks_mut(num_col).enumerate().for_each(apply);
         }
     }
     Ok(m.into_pyarray(py).into_any().unbind())
@@ -177,47 +213,14 @@ pub fn apply_diagonal_gate_to_diag(
     if m_diagonal.is_empty() {
         return Ok(m_diagonal);
     }
-    for state in std::iter::repeat_n([0_u8, 1_u8], num_qubits)
-        .multi_cartesian_product()
-        .take(m_diagonal.len())
-    {
-        let diag_index = action_qubit_labels
-            .iter()
-            .fold(0_usize, |acc, i| (acc << 1) + state[*i] as usize);
-        let i = bin_to_int(&state);
-        m_diagonal[i] *= diag[diag_index]
-    }
+    m_diagonal
+        .iter_mut()
+        .take(1 << num_qubits)
+        .enumerate()
+        .for_each(|(state, x)| *x *= diag[diag_index(state, num_qubits, &action_qubit_labels)]);
     Ok(m_diagonal)
 }
 
-/// Helper method for _apply_multi_controlled_gate. This constructs the basis states the MG gate
-/// is acting on for a specific state state_free of the qubits we neither control nor act on
-fn construct_basis_states(
-    state_free: &[u8],
-    control_set: &HashSet<usize>,
-    target_label: usize,
-) -> [usize; 2] {
-    let size = state_free.len() + control_set.len() + 1;
-    let mut e1: usize = 0;
-    let mut e2: usize = 0;
-    let mut j = 0;
-    for i in 0..size {
-        e1 <<= 1;
-        e2 <<= 1;
-        if control_set.contains(&i) {
-            e1 += 1;
-            e2 += 1;
-        } else if i == target_label {
-            e2 += 1;
-        } else {
-            e1 += state_free[j] as usize;
-            e2 += state_free[j] as usize;
-            j += 1
-        }
-    }
-    [e1, e2]
-}
-
 #[pyfunction]
 pub fn apply_multi_controlled_gate(
     py: Python,
@@ -226,37 +229,37 @@ pub fn apply_multi_controlled_gate(
     target_label: usize,
     gate: PyReadonlyArray2<Complex64>,
 ) -> Py<PyAny> {
-    let mut m = m.as_array().to_owned();
-    let gate = gate.as_array();
+    let mut m = m.as_array().as_standard_layout().into_owned();
+    let gate = gate_from_array(&gate);
     let shape = m.shape();
-    let num_qubits = shape[0].ilog2();
+    let num_qubits = shape[0].ilog2() as usize;
     let num_col = shape[1];
-    let free_qubits = num_qubits as usize - control_labels.len() - 1;
-    let control_set: HashSet<usize> = control_labels.into_iter().collect();
-    if free_qubits == 0 {
-        let [e1, e2] = construct_basis_states(&[], &control_set, target_label);
-        for i in 0..num_col {
-            let temp: Vec<_> = gate
-                .dot(&aview2(&[[m[[e1, i]]], [m[[e2, i]]]]))
-                .into_iter()
-                .take(2)
-                .collect();
-            m[[e1, i]] = temp[0];
-            m[[e2, i]] = temp[1];
-        }
-        return m.into_pyarray(py).into_any().unbind();
-    }
-    for state_free in std::iter::repeat_n([0_u8, 1_u8], free_qubits).multi_cartesian_product() {
-        let [e1, e2] = construct_basis_states(&state_free, &control_set, target_label);
-        for i in 0..num_col {
-            let temp: Vec<_> = gate
-                .dot(&aview2(&[[m[[e1, i]]], [m[[e2, i]]]]))
-                .into_iter()
-                .take(2)
-                .collect();
-            m[[e1, i]] = temp[0];
-            m[[e2, i]] = temp[1];
-        }
+    // Qubit labels count from the most significant bit of the row index.
+    let bit = |label: usize| 1_usize << (num_qubits - 1 - label);
+    let control_mask = control_labels
+        .iter()
+        .fold(0, |acc, label| acc | bit(*label));
+    let target_bit = bit(target_label);
+    let free_bits: Vec<usize> = (0..num_qubits)
+        .map(bit)
+        .filter(|b| b & (control_mask | target_bit) == 0)
+        .collect();
+    let data = m.as_slice_mut().expect("the matrix is in standard layout");
+    // The gate acts on the pairs of rows with all the controls set, and which only differ in the
+    // target bit, for each state of the free qubits.
+    for free_state in 0..1_usize << free_bits.len() {
+        let row_0 = free_bits
+            .iter()
+            .enumerate()
+            .filter(|(i, _)| free_state & (1 << i) != 0)
+            .fold(control_mask, |acc, (_, b)| acc | b);
+        let row_1 = row_0 | target_bit;
+        let (head, tail) = data.split_at_mut(row_1 * num_col);
+        apply_2x2(
+            &gate,
+            &mut head[row_0 * num_col..(row_0 + 1) * num_col],
+            &mut tail[..num_col],
+        );
     }
     m.into_pyarray(py).into_any().unbind()
 }
@@ -20,8 +20,12 @@ use nalgebra::{Matrix2, MatrixView2, Vector2};
 use numpy::{IntoPyArray, PyReadonlyArray2, ToPyArray};
 
 use qiskit_util::complex::{C_ZERO, IM, c64};
+use qiskit_util::getenv_use_multiple_threads;
+use rayon::prelude::*;
 
 const EPS: f64 = 1e-10;
+/// The minimum number of pairs of single-qubit gates of a UCGate to demultiplex in parallel.
+const PARALLEL_THRESHOLD: usize = 64;
 
 /// Compute the eigenvectors and eigenvalues for a 2x2 matrix
 ///
@@ -116,6 +120,27 @@ fn demultiplex_single_uc(
     [v, u, r]
 }
 
+/// Demultiplex the pair of single-qubit gates `(a, b)` of a UCGate in place, as `(v, u)`, and
+/// merge the resulting UC-Rz rotation and the Rz(pi/2) rotation on the control into the pair of
+/// gates `next` of the following UCGate, if there is one.
+///
+/// Returns the diagonal matrix `r` of the decomposition.
+#[inline]
+fn demultiplex_in_place(
+    a: &mut Matrix2<Complex64>,
+    b: &mut Matrix2<Complex64>,
+    next: Option<(&mut Matrix2<Complex64>, &mut Matrix2<Complex64>)>,
+) -> Matrix2<Complex64> {
+    let [v, u, r] = demultiplex_single_uc(a, b);
+    *a = v;
+    *b = u;
+    if let Some((next_a, next_b)) = next {
+        *next_a *= r.adjoint() * RZ_PI2_00;
+        *next_b *= r * RZ_PI2_11;
+    }
+    r
+}
+
 #[pyfunction]
 pub fn dec_ucg_help(
     py: Python,
@@ -130,63 +155,83 @@ pub fn dec_ucg_help(
         })
         .collect();
     let mut diag: Vec<Complex64> = vec![Complex64::ONE; 2_usize.pow(num_qubits)];
+    let run_in_parallel = getenv_use_multiple_threads();
     let num_controls = num_qubits - 1;
     for dec_step in 0..num_controls {
         let num_ucgs = 2_usize.pow(dec_step);
+        let len_ucg = 2_usize.pow(num_controls - dec_step);
+        let parallel = run_in_parallel && len_ucg / 2 >= PARALLEL_THRESHOLD;
         // The decomposition works recursively and the following loop goes over the different
-        // UCGates that arise in the decomposition
+        // UCGates that arise in the decomposition. Each UCGate modifies the next one, so they are
+        // processed in order, but the pairs of single-qubit gates of a UCGate are independent.
         for ucg_index in 0..num_ucgs {
-            let len_ucg = 2_usize.pow(num_controls - dec_step);
-            for i in 0..len_ucg / 2 {
-                let shift = ucg_index * len_ucg;
-                let a = single_qubit_gates[shift + i];
-                let b = single_qubit_gates[shift + len_ucg / 2 + i];
-                // Apply the decomposition for UCGates given in equation (3) in
-                // https://arxiv.org/pdf/quant-ph/0410066.pdf
-                // to demultiplex one control of all the num_ucgs uniformly-controlled gates
-                // with log2(len_ucg) uniform controls
-
-                let [v, u, r] = demultiplex_single_uc(&a, &b);
-
-                // replace the single-qubit gates with v,u (the already existing ones
-                // are not needed any more)
-                single_qubit_gates[shift + i] = v;
-                single_qubit_gates[shift + len_ucg / 2 + i] = u;
-                // Now we decompose the gates D as described in Figure 4 in
-                // https://arxiv.org/pdf/quant-ph/0410066.pdf and merge some of the gates
-                // into the UCGates and the diagonal at the end of the circuit
-
-                // Remark: The Rz(pi/2) rotation acting on the target qubit and the Hadamard
-                // gates arising in the decomposition of D are ignored for the moment (they will
-                // be added together with the C-NOT gates at the end of the decomposition
-                // (in the method dec_ucg()))
-                let r_conj_t = r.adjoint();
-                if ucg_index < num_ucgs - 1 {
-                    // Absorb the Rz(pi/2) rotation on the control into the UC-Rz gate and
-                    // merge the UC-Rz rotation with the following UCGate,
-                    // which hasn't been decomposed yet
-                    let k = shift + len_ucg + i;
-
-                    single_qubit_gates[k] *= r_conj_t;
-                    single_qubit_gates[k]
-                        .iter_mut()
-                        .for_each(|x| *x *= RZ_PI2_00);
-                    let k = k + len_ucg / 2;
-                    single_qubit_gates[k] *= r;
-                    single_qubit_gates[k]
+            let shift = ucg_index * len_ucg;
+            let (gates, next_gates) = single_qubit_gates[shift..].split_at_mut(len_ucg);
+            let (gates_a, gates_b) = gates.split_at_mut(len_ucg / 2);
+            // Apply the decomposition for UCGates given in equation (3) in
+            // https://arxiv.org/pdf/quant-ph/0410066.pdf
+            // to demultiplex one control of all the num_ucgs uniformly-controlled gates
+            // with log2(len_ucg) uniform controls, and replace the single-qubit gates with v,u
+            // (the already existing ones are not needed any more).
+            //
+            // Now we decompose the gates D as described in Figure 4 in
+            // https://arxiv.org/pdf/quant-ph/0410066.pdf and merge some of the gates
+            // into the UCGates and the diagonal at the end of the circuit
+            //
+            // Remark: The Rz(pi/2) rotation acting on the target qubit and the Hadamard
+            // gates arising in the decomposition of D are ignored for the moment (they will
+            // be added together with the C-NOT gates at the end of the decomposition
+            // (in the method dec_ucg()))
+            if ucg_index < num_ucgs - 1 {
+                // Absorb the Rz(pi/2) rotation on the control into the UC-Rz gate and
+                // merge the UC-Rz rotation with the following UCGate,
+                // which hasn't been decomposed yet
+                let (next_a, next_b) = next_gates[..len_ucg].split_at_mut(len_ucg / 2);
+                let demultiplex = |(((a, b), next_a), next_b)| {
+                    demultiplex_in_place(a, b, Some((next_a, next_b)));
+                };
+                if parallel {
+                    gates_a
+                        .par_iter_mut()
+                        .zip(gates_b.par_iter_mut())
+                        .zip(next_a.par_iter_mut())
+                        .zip(next_b.par_iter_mut())
+                        .for_each(demultiplex);
+                } else {
+                    gates_a
                         .iter_mut()
-                        .for_each(|x| *x *= RZ_PI2_11);
+                        .zip(gates_b.iter_mut())
+                        .zip(next_a.iter_mut())
+                        .zip(next_b.iter_mut())
+                        .for_each(demultiplex);
+                }
+            } else {
+                // Absorb the Rz(pi/2) rotation on the control into the UC-Rz gate and merge
+                // the trailing UC-Rz rotation into a diagonal gate at the end of the circuit
+                let demultiplex = |(a, b)| demultiplex_in_place(a, b, None);
+                let rs: Vec<Matrix2<Complex64>> = if parallel {
+                    gates_a
+                        .par_iter_mut()
+                        .zip(gates_b.par_iter_mut())
+                        .map(demultiplex)
+                        .collect()
                 } else {
-                    // Absorb the Rz(pi/2) rotation on the control into the UC-Rz gate and merge
-                    // the trailing UC-Rz rotation into a diagonal gate at the end of the circuit
+                    gates_a
+                        .iter_mut()
+                        .zip(gates_b.iter_mut())
+                        .map(demultiplex)
+                        .collect()
+                };
+                for (i, r) in rs.iter().enumerate() {
+                    let (r_00, r_11) = (r[(0, 0)], r[(1, 1)]);
                     for ucg_index_2 in 0..num_ucgs {
                         let shift_2 = ucg_index_2 * len_ucg;
                         let k = 2 * (i + shift_2);
-                        diag[k] *= r_conj_t[(0, 0)] * RZ_PI2_00;
-                        diag[k + 1] *= r_conj_t[(1, 1)] * RZ_PI2_00;
+                        diag[k] *= r_00.conj() * RZ_PI2_00;
+                        diag[k + 1] *= r_11.conj() * RZ_PI2_00;
                         let k = len_ucg + k;
-                        diag[k] *= r[(0, 0)] * RZ_PI2_11;
-                        diag[k + 1] *= r[(1, 1)] * RZ_PI2_11;
+                        diag[k] *= r_00 * RZ_PI2_11;
+                        diag[k + 1] *= r_11 * RZ_PI2_11;
                     }
                 }
             }
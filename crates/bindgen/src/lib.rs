@@ -81,19 +81,34 @@ pub static QISKIT_PUBLIC_API_CRATES: &[&str] =
     &["qiskit-quantum-info", "qiskit-circuit", "qiskit-transpiler"];
 
 pub static EXPORT_PREFIX: &str = "Qk";
+/// Types to export even though no function signature refers to them, such as enums whose values
+/// are stored in integer fields of C-filled structs.
+pub static EXPORT_INCLUDE: &[&str] = &["CDynamicalDecoupling", "CSchedulingMethod"];
 pub static EXPORT_RENAME: &[(&str, &str)] = &[
     ("CBlocksMode", "BlocksMode"),
+    ("CDagAdjacency", "DagAdjacency"),
+    ("CDagEdge", "DagEdge"),
     ("CDagNeighbors", "DagNeighbors"),
+    ("CDagNodeBlocks", "DagNodeBlocks"),
+    ("CDagNodeFilter", "DagNodeFilter"),
     ("CDagNodeType", "DagNodeType"),
+    ("CDagWireType", "DagWireType"),
     ("CDelayUnit", "DelayUnit"),
+    ("CDynamicalDecoupling", "DynamicalDecoupling"),
+    ("CEquivalence", "Equivalence"),
     ("CInstruction", "CircuitInstruction"),
     ("CInstructionProperties", "InstructionProperties"),
+    ("CNativePass", "NativePass"),
     ("CNeighbors", "Neighbors"),
     ("COperationKind", "OperationKind"),
+    ("CPassCallback", "PassCallback"),
+    ("CPassInsertionPoint", "PassInsertionPoint"),
     ("CPauliProductRotation", "PauliProductRotation"),
     ("CPauliProductMeasurement", "PauliProductMeasurement"),
+    ("CSchedulingMethod", "SchedulingMethod"),
     ("CSparseTerm", "ObsTerm"),
     ("CTargetOp", "TargetOp"),
+    ("CTermOrdering", "TermOrdering"),
     ("CVarsMode", "VarsMode"),
     ("CircuitData", "Circuit"),
     ("DAGCircuit", "Dag"),
@@ -204,6 +219,7 @@ fn get_config() -> anyhow::Result<cbindgen::Config> {
     );
     let export = cbindgen::ExportConfig {
         prefix: Some(EXPORT_PREFIX.into()),
+        include: to_vec_string(EXPORT_INCLUDE),
         rename,
         renaming_overrides_prefixing: true,
         ..Default::default()
@@ -27,7 +27,8 @@ pub static FUNCTIONS_CIRCUIT: ExportedFunctions =
         .add_child(105, &dag::FUNCTIONS)
         .add_child(205, &param::FUNCTIONS)
         .add_child(255, &circuit_library::FUNCTIONS)
-        .add_child(305, &classical_expr::FUNCTIONS);
+        .add_child(305, &classical_expr::FUNCTIONS)
+        .add_child(355, &shared_circuit::FUNCTIONS);
 pub static FUNCTIONS_QI: ExportedFunctions =
     ExportedFunctions::empty().add_child(0, &sparse_observable::FUNCTIONS);
 pub use transpiler::FUNCTIONS as FUNCTIONS_TRANSPILE;
@@ -140,6 +141,12 @@ mod circuit {
             export_fn!(qk_control_flow_switch_case_labels_bit_width),
             export_fn!(qk_control_flow_switch_case_labels_uint),
             export_fn!(qk_control_flow_switch_case_labels_clear),
+            export_fn!(qk_circuit_statevector),
+            export_fn!(qk_circuit_sample),
+            export_fn!(qk_circuit_equiv_check),
+            export_fn!(qk_circuit_serialize),
+            export_fn!(qk_circuit_serialized_free),
+            export_fn!(qk_circuit_deserialize),
         ]
     });
 }
@@ -157,6 +164,10 @@ mod circuit_library {
             export_fn!(suzuki_trotter::qk_circuit_library_suzuki_trotter),
             export_fn!(pbc::qk_pauli_product_rotation_clear),
             export_fn!(pbc::qk_pauli_product_measurement_clear),
+            export_fn!(suzuki_trotter::qk_circuit_library_suzuki_trotter_ordered),
+            export_fn!(qft::qk_circuit_library_qft),
+            export_fn!(qft::qk_circuit_library_qft_line),
+            export_fn!(sparse_state::qk_circuit_library_sparse_state_prep),
         ]
     });
 }
@@ -210,6 +221,18 @@ mod dag {
             export_fn!(qk_dag_substitute_node_with_unitary),
             export_fn!(qk_dag_global_phase),
             export_fn!(qk_dag_set_global_phase),
+            export_fn!(qk_dag_adjacency_snapshot),
+            export_fn!(qk_dag_adjacency_free),
+            export_fn!(qk_dag_collect_1q_runs),
+            export_fn!(qk_dag_collect_2q_blocks),
+            export_fn!(qk_dag_collect_blocks),
+            export_fn!(qk_dag_node_blocks_clear),
+            export_fn!(qk_dag_rewrite_begin),
+            export_fn!(qk_dag_rewrite_remove_node),
+            export_fn!(qk_dag_rewrite_substitute_node_with_dag),
+            export_fn!(qk_dag_rewrite_replace_block_with_unitary),
+            export_fn!(qk_dag_rewrite_commit),
+            export_fn!(qk_dag_rewrite_free),
         ]
     });
 }
@@ -297,7 +320,10 @@ mod sparse_observable {
 mod transpiler {
     use crate::impl_::prelude::*;
     #[cfg(feature = "addr")]
-    use qiskit_cext::transpiler::{neighbors::*, transpile_function::*, transpile_layout::*};
+    use qiskit_cext::transpiler::{
+        neighbors::*, pass_manager::*, passes::template_optimization::*, transpile_function::*,
+        transpile_layout::*,
+    };
 
     pub static TRANSPILE_FUNCTION: ExportedFunctions = ExportedFunctions::leaves(20, || {
         vec![
@@ -308,6 +334,8 @@ mod transpiler {
             export_fn!(qk_transpile_stage_optimization),
             export_fn!(qk_transpile_stage_translation),
             export_fn!(qk_transpile_stage_layout),
+            export_fn!(qk_transpiler_default_scheduling_options),
+            export_fn!(qk_transpile_stage_scheduling),
         ]
     });
     pub static NEIGHBORS: ExportedFunctions = ExportedFunctions::leaves(5, || {
@@ -327,6 +355,8 @@ mod transpiler {
             export_fn!(qk_transpile_layout_generate_from_mapping),
             export_fn!(qk_transpile_layout_free),
             export_fn!(qk_transpile_layout_to_python, feature = "python_binding"),
+            export_fn!(qk_equiv_check_options_default),
+            export_fn!(qk_transpile_layout_equiv_check),
         ]
     });
     pub static TRANSPILE_STATE: ExportedFunctions = ExportedFunctions::leaves(15, || {
@@ -337,6 +367,23 @@ mod transpiler {
             export_fn!(qk_transpile_state_layout_set),
         ]
     });
+    pub static PASS_MANAGER: ExportedFunctions = ExportedFunctions::leaves(15, || {
+        vec![
+            export_fn!(qk_pass_manager_new),
+            export_fn!(qk_pass_manager_add_pass),
+            export_fn!(qk_pass_manager_add_native_pass),
+            export_fn!(qk_pass_manager_run),
+            export_fn!(qk_pass_manager_free),
+        ]
+    });
+    pub static TEMPLATE_LIBRARY: ExportedFunctions = ExportedFunctions::leaves(10, || {
+        vec![
+            export_fn!(qk_template_library_new),
+            export_fn!(qk_template_library_add),
+            export_fn!(qk_template_library_num_templates),
+            export_fn!(qk_template_library_free),
+        ]
+    });
 
     mod target {
         use crate::impl_::prelude::*;
@@ -408,6 +455,8 @@ mod transpiler {
                 export_fn!(remove_identity_equiv::qk_transpiler_pass_remove_identity_equivalent),
                 export_fn!(split_2q_unitaries::qk_transpiler_pass_split_2q_unitaries),
                 export_fn!(two_qubit_peephole::qk_transpiler_pass_2q_peephole_optimization),
+                export_fn!(restore_final_layout::qk_transpiler_pass_restore_final_layout),
+                export_fn!(template_optimization::qk_transpiler_pass_template_optimization),
             ]
         });
         static FUNCTIONS_STANDALONE: ExportedFunctions = ExportedFunctions::leaves(50, || {
@@ -430,6 +479,8 @@ mod transpiler {
                 export_fn!(convert_to_pauli_rotations::qk_transpiler_pass_standalone_convert_to_pauli_rotations),
                 export_fn!(litinski_transformation::qk_transpiler_pass_standalone_litinski_transformation),
                 export_fn!(two_qubit_peephole::qk_transpiler_pass_standalone_2q_peephole_optimization),
+                export_fn!(restore_final_layout::qk_transpiler_pass_standalone_restore_final_layout),
+                export_fn!(template_optimization::qk_transpiler_pass_standalone_template_optimization),
             ]
         });
         static FUNCTIONS_SABRE: ExportedFunctions = ExportedFunctions::leaves(5, || {
@@ -464,7 +515,9 @@ mod transpiler {
         .add_child(35, &TRANSPILE_LAYOUT)
         .add_child(50, &TRANSPILE_STATE)
         .add_child(150, &target::FUNCTIONS)
-        .add_child(250, &passes::FUNCTIONS);
+        .add_child(250, &passes::FUNCTIONS)
+        .add_child(475, &PASS_MANAGER)
+        .add_child(490, &TEMPLATE_LIBRARY);
 }
 
 mod classical_expr {
@@ -493,3 +546,22 @@ mod classical_expr {
         ]
     });
 }
+
+mod shared_circuit {
+    use crate::impl_::prelude::*;
+    #[cfg(feature = "addr")]
+    use qiskit_cext::shared_circuit::*;
+
+    pub static FUNCTIONS: ExportedFunctions = ExportedFunctions::leaves(20, || {
+        vec![
+            export_fn!(qk_shared_circuit_new),
+            export_fn!(qk_shared_circuit_clone),
+            export_fn!(qk_shared_circuit_is_unique),
+            export_fn!(qk_shared_circuit_get),
+            export_fn!(qk_shared_circuit_get_mut),
+            export_fn!(qk_shared_circuit_free),
+            export_fn!(qk_shared_circuit_from_python, feature = "python_binding"),
+            export_fn!(qk_shared_circuit_to_python, feature = "python_binding"),
+        ]
+    });
+}
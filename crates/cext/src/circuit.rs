@@ -24,6 +24,7 @@ use nalgebra::{Matrix2, Matrix4};
 use ndarray::{Array2, ArrayView2};
 use num_complex::{Complex64, ComplexFloat};
 
+use qiskit_circuit::binary_format;
 use qiskit_circuit::bit::{ClassicalRegister, QuantumRegister};
 use qiskit_circuit::bit::{ShareableClbit, ShareableQubit};
 use qiskit_circuit::circuit_data::{CircuitData, CircuitDataError};
@@ -38,7 +39,12 @@ use qiskit_circuit::operations::{
 use qiskit_circuit::packed_instruction::{PackedInstruction, PackedOperation};
 use qiskit_circuit::parameter_table::ParameterTableError;
 use qiskit_circuit::{BlocksMode, Clbit, Qubit, VarsMode};
+use qiskit_synthesis::matrix::statevector::{
+    check_equivalence, sample_statevector, simulate_statevector,
+};
+use qiskit_transpiler::equivalence_check::layout_qubit_mapping;
 use qiskit_transpiler::target::{Target, estimate_fidelity};
+use qiskit_transpiler::transpile_layout::TranspileLayout;
 use smallvec::smallvec;
 
 /// @ingroup QkCircuit
@@ -876,6 +882,125 @@ pub unsafe extern "C" fn qk_circuit_free(circuit: *mut CircuitData) {
     }
 }
 
+/// @ingroup QkCircuit
+/// Serialize a circuit to a compact binary buffer.
+///
+/// The buffer holds the bits, registers, global phase and instructions of the circuit, including
+/// symbolic parameters and control-flow blocks, in a versioned layout of fixed-size records. It is
+/// intended for handing circuits to other processes using the same version of Qiskit, for example
+/// through shared memory or a memory-mapped file, and can be read in place by
+/// ``qk_circuit_deserialize``. It is not a replacement for QPY, which is the stable interchange
+/// format.
+///
+/// Circuits that contain classical variables or stretches, operations without a native
+/// representation (such as Python-defined gates), parameters that are Python objects, or control
+/// flow that depends on classical expressions or box annotations cannot be serialized.
+///
+/// @param circuit A pointer to the circuit to serialize.
+/// @param buffer A pointer to write the address of the serialized bytes to. The bytes must be
+///     freed with ``qk_circuit_serialized_free``.
+/// @param len A pointer to write the number of serialized bytes to.
+///
+/// @return ``QkExitCode_Success`` on success, or ``QkExitCode_SerializationError`` if the circuit
+///     cannot be serialized, in which case nothing is written to ``buffer`` and ``len``.
+///
+/// # Example
+///
+/// ```c
+///     QkCircuit *qc = qk_circuit_new(2, 0);
+///     qk_circuit_gate(qc, QkGate_H, (uint32_t[]){0}, NULL);
+///     uint8_t *buffer;
+///     size_t len;
+///     qk_circuit_serialize(qc, &buffer, &len);
+///     // ... copy the bytes to shared memory, or hand them over directly ...
+///     QkCircuit *copy = qk_circuit_deserialize(buffer, len);
+///     qk_circuit_serialized_free(buffer, len);
+///     qk_circuit_free(copy);
+///     qk_circuit_free(qc);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``circuit`` is not a valid, non-null pointer to a ``QkCircuit``, or if
+/// ``buffer`` and ``len`` are not aligned pointers that are writeable for a single value of their
+/// type.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_circuit_serialize(
+    circuit: *const CircuitData,
+    buffer: *mut *mut u8,
+    len: *mut usize,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointer is non-null and aligned.
+    let circuit = unsafe { const_ptr_as_ref(circuit) };
+    let Ok(bytes) = binary_format::serialize(circuit) else {
+        return ExitCode::SerializationError;
+    };
+    let bytes = bytes.into_boxed_slice();
+    let bytes_len = bytes.len();
+    // SAFETY: Per documentation, the pointers are aligned and writeable.
+    unsafe {
+        buffer.write(Box::into_raw(bytes).cast());
+        len.write(bytes_len);
+    }
+    ExitCode::Success
+}
+
+/// @ingroup QkCircuit
+/// Free the bytes of a circuit serialized by ``qk_circuit_serialize``.
+///
+/// @param buffer The address of the serialized bytes.
+/// @param len The number of serialized bytes, as returned by ``qk_circuit_serialize``.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``buffer`` is not either null or an address written by
+/// ``qk_circuit_serialize`` together with ``len``, that has not been freed yet.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_circuit_serialized_free(buffer: *mut u8, len: usize) {
+    if !buffer.is_null() {
+        // SAFETY: Per documentation, the buffer and length come from a boxed slice created by
+        // `qk_circuit_serialize`.
+        unsafe {
+            let _ = Box::from_raw(ptr::slice_from_raw_parts_mut(buffer, len));
+        }
+    }
+}
+
+/// @ingroup QkCircuit
+/// Build a circuit from bytes written by ``qk_circuit_serialize``.
+///
+/// The bytes are read in place and are not modified, so they can live in shared memory or a
+/// memory-mapped file. They are validated, so malformed or truncated input results in ``NULL``
+/// rather than undefined behavior. The bits of the circuit are new bits, with the same registers
+/// and names as the serialized circuit.
+///
+/// @param buffer A pointer to the serialized bytes.
+/// @param len The number of serialized bytes.
+///
+/// @return A pointer to the new circuit, or ``NULL`` if the bytes are not a valid serialized
+///     circuit, or were written by an incompatible version of Qiskit.
+///
+/// # Example
+///
+/// See ``qk_circuit_serialize``.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``buffer`` is not a pointer to at least ``len`` readable bytes, which
+/// must not be modified while this function runs. ``buffer`` can be null if ``len`` is 0.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_circuit_deserialize(buffer: *const u8, len: usize) -> *mut CircuitData {
+    if buffer.is_null() {
+        return ptr::null_mut();
+    }
+    // SAFETY: Per documentation, the buffer points to `len` readable bytes.
+    let bytes = unsafe { ::std::slice::from_raw_parts(buffer, len) };
+    match binary_format::deserialize(bytes) {
+        Ok(circuit) => Box::into_raw(Box::new(circuit)),
+        Err(_) => ptr::null_mut(),
+    }
+}
+
 /// @ingroup QkCircuit
 /// Append a ``QkGate`` to the circuit.
 ///
@@ -2649,6 +2774,190 @@ pub unsafe extern "C" fn qk_circuit_estimate_fidelity(
     estimate_fidelity(circuit, target).unwrap_or(f64::NAN)
 }
 
+/// The seed of the random input states of ``qk_circuit_equiv_check``, which is fixed so that the
+/// check is reproducible.
+const EQUIV_CHECK_SEED: u64 = 2026;
+
+/// The number of random input states tried by ``qk_circuit_equiv_check``.
+const EQUIV_CHECK_TRIALS: usize = 2;
+
+/// @ingroup QkCircuit
+/// Simulate the statevector produced by a circuit from the all-zeros state.
+///
+/// The circuit must only contain unitary operations (and barriers), with no classical bits and a
+/// numeric global phase, and can have at most 30 qubits.  The gates are fused and applied in place
+/// with multiple threads for large circuits.  The statevector of an ``n``-qubit circuit takes
+/// ``16 * 2**n`` bytes.
+///
+/// @param circuit A pointer to the circuit to simulate.
+/// @param out Allocated and aligned pointer to write the ``2**num_qubits`` amplitudes to.  The
+///     amplitude of each basis state is at the index whose bit ``k`` is the state of qubit ``k``.
+///
+/// @return An exit code, which is ``QkExitCode_SimulationError`` if the circuit cannot be
+///     simulated, in which case nothing is written to ``out``.
+///
+/// # Example
+/// ```c
+///     QkCircuit *qc = qk_circuit_new(2, 0);
+///     qk_circuit_gate(qc, QkGate_H, (uint32_t[]){0}, NULL);
+///     qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+///     QkComplex64 state[4];
+///     qk_circuit_statevector(qc, state);  // (|00> + |11>) / sqrt(2)
+///     qk_circuit_free(qc);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``circuit`` is not a valid, non-null pointer to a ``QkCircuit``, or
+/// if ``out`` is not valid for ``2**num_qubits`` writes of ``QkComplex64``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_circuit_statevector(
+    circuit: *const CircuitData,
+    out: *mut Complex64,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointer is to valid data.
+    let circuit = unsafe { const_ptr_as_ref(circuit) };
+    let Ok(state) = simulate_statevector(circuit) else {
+        return ExitCode::SimulationError;
+    };
+    // SAFETY: per documentation, `out` is aligned and valid for `2**num_qubits` writes.
+    unsafe { ptr::copy_nonoverlapping(state.as_ptr(), out, state.len()) };
+    ExitCode::Success
+}
+
+/// @ingroup QkCircuit
+/// Sample measurements of every qubit at the end of a circuit.
+///
+/// The statevector of the circuit is simulated as in ``qk_circuit_statevector``, and the shots
+/// are then sampled from it.
+///
+/// @param circuit A pointer to the circuit to sample.
+/// @param num_shots The number of shots to sample.
+/// @param seed An RNG seed for the sampling.  If the provided number is negative, the seed used
+///     will be sourced from system entropy.
+/// @param out Allocated and aligned pointer to write the measured basis state of each shot to,
+///     where bit ``k`` is the outcome of qubit ``k``.  It may be ``NULL`` if ``num_shots`` is zero,
+///     in which case the circuit is not simulated.
+///
+/// @return An exit code, which is ``QkExitCode_SimulationError`` if the circuit cannot be
+///     simulated, in which case nothing is written to ``out``.
+///
+/// # Example
+/// ```c
+///     QkCircuit *qc = qk_circuit_new(2, 0);
+///     qk_circuit_gate(qc, QkGate_H, (uint32_t[]){0}, NULL);
+///     qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+///     uint64_t shots[100];
+///     qk_circuit_sample(qc, 100, 42, shots);  // each shot is 0 or 3
+///     qk_circuit_free(qc);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``circuit`` is not a valid, non-null pointer to a ``QkCircuit``, or
+/// if ``out`` is not valid for ``num_shots`` writes of ``uint64_t``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_circuit_sample(
+    circuit: *const CircuitData,
+    num_shots: usize,
+    seed: i64,
+    out: *mut u64,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointer is to valid data.
+    let circuit = unsafe { const_ptr_as_ref(circuit) };
+    if num_shots == 0 {
+        return ExitCode::Success;
+    }
+    let Ok(state) = simulate_statevector(circuit) else {
+        return ExitCode::SimulationError;
+    };
+    let seed = if seed < 0 { None } else { Some(seed as u64) };
+    let shots = sample_statevector(&state, num_shots, seed);
+    // SAFETY: per documentation, `out` is aligned and valid for `num_shots` writes.
+    unsafe { ptr::copy_nonoverlapping(shots.as_ptr(), out, num_shots) };
+    ExitCode::Success
+}
+
+/// @ingroup QkCircuit
+/// Check whether two circuits implement the same unitary, up to a global phase.
+///
+/// The check simulates both circuits on random product input states and compares the outputs,
+/// so it has the same requirements on the circuits as ``qk_circuit_statevector``.  The product
+/// states span the whole space of inputs, so in practice the check only succeeds for equivalent
+/// circuits, while being much cheaper than comparing the full unitaries.  The random states are
+/// seeded deterministically, so the result is reproducible.
+///
+/// If ``layout`` is given, ``b`` is compared as the output of transpiling ``a``: the qubits of
+/// ``a`` start on the qubits of ``b`` given by the initial layout and must end on those given by
+/// the final layout, and the ancillas of ``b`` start in, and must be returned to, the zero state.
+///
+/// @param a A pointer to the first circuit, such as the input to the transpiler.
+/// @param b A pointer to the second circuit, such as the output of the transpiler.
+/// @param layout A pointer to the ``QkTranspileLayout`` relating the qubits of ``b`` to those of
+///     ``a``, or ``NULL`` if the circuits have the same qubits.
+/// @param equivalent A pointer to write whether the circuits are equivalent to.
+///
+/// @return An exit code, which is ``QkExitCode_MismatchedQubits`` if the numbers of qubits of
+///     the circuits and the layout don't match, and ``QkExitCode_SimulationError`` if either
+///     circuit cannot be simulated.  Nothing is written to ``equivalent`` on failure.
+///
+/// # Example
+/// ```c
+///     QkCircuit *circuit = ...;
+///     QkTarget *target = ...;
+///     QkTranspileResult result;
+///     char *error = NULL;
+///     qk_transpile(circuit, target, NULL, &result, &error);
+///     bool equivalent;
+///     qk_circuit_equiv_check(circuit, result.circuit, result.layout, &equivalent);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``a`` or ``b`` is not a valid, non-null pointer to a ``QkCircuit``,
+/// if ``layout`` is not either null or a valid pointer to a ``QkTranspileLayout``, or if
+/// ``equivalent`` is not a valid, non-null pointer to a ``bool``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_circuit_equiv_check(
+    a: *const CircuitData,
+    b: *const CircuitData,
+    layout: *const TranspileLayout,
+    equivalent: *mut bool,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointers are to valid data.
+    let a = unsafe { const_ptr_as_ref(a) };
+    let b = unsafe { const_ptr_as_ref(b) };
+    let equivalent = unsafe { mut_ptr_as_ref(equivalent) };
+    let mapping = if layout.is_null() {
+        if a.num_qubits() != b.num_qubits() {
+            return ExitCode::MismatchedQubits;
+        }
+        None
+    } else {
+        // SAFETY: Per documentation, the non-null pointer is to valid data.
+        let layout = unsafe { const_ptr_as_ref(layout) };
+        if layout.num_input_qubits() as usize != a.num_qubits()
+            || layout.num_output_qubits() as usize != b.num_qubits()
+        {
+            return ExitCode::MismatchedQubits;
+        }
+        Some(layout_qubit_mapping(layout))
+    };
+    match check_equivalence(
+        a,
+        b,
+        mapping.as_ref(),
+        EQUIV_CHECK_TRIALS,
+        Some(EQUIV_CHECK_SEED),
+    ) {
+        Ok(result) => {
+            *equivalent = result;
+            ExitCode::Success
+        }
+        Err(_) => ExitCode::SimulationError,
+    }
+}
+
 /// @ingroup QkCircuit
 /// Get a control flow instruction from a circuit at the specified index.
 ///
@@ -12,5 +12,7 @@
 
 pub mod iqp;
 pub mod pbc;
+pub mod qft;
 pub mod quantum_volume;
+pub mod sparse_state;
 pub mod suzuki_trotter;
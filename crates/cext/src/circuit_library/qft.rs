@@ -0,0 +1,116 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+use qiskit_circuit::circuit_data::CircuitData;
+use qiskit_synthesis::qft::{QftConnectivity, qft_circuit};
+
+/// @ingroup QkCircuitLibrary
+/// Generate a Quantum Fourier Transform (QFT) circuit using all-to-all connectivity.
+///
+/// The circuit consists of Hadamard and controlled-phase gates, followed by swap gates reversing
+/// the order of the qubits if ``do_swaps`` is ``true``. Without the swaps, the circuit
+/// implements the "QFT-with-reversal": applying the QFT and reversing the order of its output
+/// qubits.
+///
+/// The circuits are cached, so that generating a QFT with the same arguments again only copies
+/// the circuit. This makes repeatedly generating QFTs of the same width, as in phase estimation
+/// or QFT-based arithmetic, cheap.
+///
+/// @param num_qubits The number of qubits the QFT acts on.
+/// @param approximation_degree The degree of approximation, 0 for no approximation. The
+///   controlled-phase rotations with the ``approximation_degree`` smallest angles are dropped,
+///   see [1].
+/// @param do_swaps Whether to reverse the order of the qubits at the end of the circuit.
+/// @param inverse Whether to generate the inverse QFT.
+///
+/// @return A pointer to the generated circuit.
+///
+/// # Example
+/// ```c
+/// QkCircuit *qft = qk_circuit_library_qft(10, 2, true, false);
+/// qk_circuit_free(qft);
+/// ```
+///
+/// # References
+///
+/// [1]: A. Barenco, A. Ekert, K.-A. Suominen and P. Törmä,
+/// "Approximate Quantum Fourier Transform and Decoherence" (1996).
+/// [arXiv:quant-ph/9601018](https://arxiv.org/abs/quant-ph/9601018)
+#[unsafe(no_mangle)]
+pub extern "C" fn qk_circuit_library_qft(
+    num_qubits: u32,
+    approximation_degree: u32,
+    do_swaps: bool,
+    inverse: bool,
+) -> *mut CircuitData {
+    match qft_circuit(
+        num_qubits as usize,
+        approximation_degree as usize,
+        QftConnectivity::Full,
+        do_swaps,
+        inverse,
+        false,
+    ) {
+        Ok(circuit) => Box::into_raw(Box::new(CircuitData::clone(&circuit))),
+        Err(_) => std::ptr::null_mut(),
+    }
+}
+
+/// @ingroup QkCircuitLibrary
+/// Generate a Quantum Fourier Transform (QFT) circuit using linear nearest-neighbor
+/// connectivity.
+///
+/// The construction is based on Fig 2.b in Fowler et al. [1], and only uses Hadamard, CX and
+/// phase gates between neighboring qubits. If ``do_swaps`` is ``false``, the circuit implements
+/// the "QFT-with-reversal": applying the QFT and reversing the order of its output qubits.
+///
+/// As for ``qk_circuit_library_qft``, the circuits are cached.
+///
+/// @param num_qubits The number of qubits the QFT acts on.
+/// @param approximation_degree The degree of approximation, 0 for no approximation. The
+///   controlled-phase rotations with the ``approximation_degree`` smallest angles are replaced
+///   by swaps of the neighboring qubits.
+/// @param do_swaps Whether to implement the QFT rather than the QFT-with-reversal.
+/// @param inverse Whether to generate the inverse QFT.
+///
+/// @return A pointer to the generated circuit.
+///
+/// # Example
+/// ```c
+/// QkCircuit *qft = qk_circuit_library_qft_line(10, 0, true, false);
+/// qk_circuit_free(qft);
+/// ```
+///
+/// # References
+///
+/// [1]: A. G. Fowler, S. J. Devitt, and L. C. L. Hollenberg,
+/// "Implementation of Shor's algorithm on a linear nearest neighbour qubit array" (2004).
+/// [arXiv:quant-ph/0402196](https://arxiv.org/abs/quant-ph/0402196)
+#[unsafe(no_mangle)]
+pub extern "C" fn qk_circuit_library_qft_line(
+    num_qubits: u32,
+    approximation_degree: u32,
+    do_swaps: bool,
+    inverse: bool,
+) -> *mut CircuitData {
+    match qft_circuit(
+        num_qubits as usize,
+        approximation_degree as usize,
+        QftConnectivity::Line,
+        do_swaps,
+        inverse,
+        false,
+    ) {
+        Ok(circuit) => Box::into_raw(Box::new(CircuitData::clone(&circuit))),
+        Err(_) => std::ptr::null_mut(),
+    }
+}
@@ -0,0 +1,81 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+use num_complex::Complex64;
+use qiskit_circuit::circuit_data::CircuitData;
+use qiskit_synthesis::multi_controlled::sparse_state::synth_sparse_state;
+
+/// @ingroup QkCircuitLibrary
+/// Generate a circuit preparing a sparse state from the all-zeros state.
+///
+/// The state is given by its nonzero amplitudes: ``amplitudes[i]`` is the amplitude of the
+/// basis state ``indices[i]``, where qubit 0 is the least significant bit of the index. Basis
+/// states that are not listed have amplitude 0.
+///
+/// The circuit merges the basis states pairwise with multi-controlled rotations, following
+/// Gleinig and Hoefler [1], and uses multi-controlled X gates without ancillas. For a state
+/// with ``m`` nonzero amplitudes on ``n`` qubits, the number of gates is ``O(m n)`` rather than
+/// ``O(2^n)``, which makes this suitable for states on many qubits with few nonzero
+/// amplitudes.
+///
+/// @param num_qubits The number of qubits, at most 64.
+/// @param num_terms The number of basis states given.
+/// @param indices A pointer to an array of ``num_terms`` distinct basis states, each smaller
+///   than ``2^num_qubits``.
+/// @param amplitudes A pointer to an array of ``num_terms`` amplitudes, with norm 1.
+///
+/// @return A pointer to the generated circuit, or ``NULL`` if the input is invalid.
+///
+/// # Example
+/// ```c
+/// // Prepare (|0000> + i|1111>) / sqrt(2).
+/// uint64_t indices[2] = {0, 15};
+/// QkComplex64 amplitudes[2] = {{M_SQRT1_2, 0.0}, {0.0, M_SQRT1_2}};
+/// QkCircuit *circuit = qk_circuit_library_sparse_state_prep(4, 2, indices, amplitudes);
+/// qk_circuit_free(circuit);
+/// ```
+///
+/// # Safety
+///
+/// If ``num_terms`` is nonzero, ``indices`` and ``amplitudes`` must be aligned and valid for
+/// ``num_terms`` reads.
+///
+/// # References
+///
+/// [1]: N. Gleinig and T. Hoefler, "An Efficient Algorithm for Sparse Quantum State
+/// Preparation", DAC (2021).
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_circuit_library_sparse_state_prep(
+    num_qubits: u32,
+    num_terms: usize,
+    indices: *const u64,
+    amplitudes: *const Complex64,
+) -> *mut CircuitData {
+    if num_terms > 0 && (indices.is_null() || amplitudes.is_null()) {
+        return std::ptr::null_mut();
+    }
+    let (indices, amplitudes) = if num_terms == 0 {
+        (&[][..], &[][..])
+    } else {
+        // SAFETY: per documentation, both pointers are valid for `num_terms` reads.
+        unsafe {
+            (
+                ::std::slice::from_raw_parts(indices, num_terms),
+                ::std::slice::from_raw_parts(amplitudes, num_terms),
+            )
+        }
+    };
+    match synth_sparse_state(num_qubits, indices, amplitudes) {
+        Ok(circuit) => Box::into_raw(Box::new(circuit)),
+        Err(_) => std::ptr::null_mut(),
+    }
+}
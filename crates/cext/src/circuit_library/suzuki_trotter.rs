@@ -12,9 +12,34 @@
 
 use crate::pointers::const_ptr_as_ref;
 use qiskit_circuit::circuit_data::CircuitData;
-use qiskit_circuit_library::suzuki_trotter::suzuki_trotter_evolution;
+use qiskit_circuit_library::suzuki_trotter::{TermOrdering, suzuki_trotter_evolution};
 use qiskit_quantum_info::sparse_observable::SparseObservable;
 
+/// @ingroup QkCircuitLibrary
+/// How the terms of an observable are ordered in each time step of a product formula.
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum CTermOrdering {
+    /// Evolve the terms in the order of the observable.
+    Preserve = 0,
+    /// Reorder the terms to evolve terms on disjoint qubits in parallel, which reduces the depth.
+    Depth = 1,
+    /// Group commuting terms and order them to maximize the basis changes and CX gates shared by
+    /// the evolutions of consecutive terms, and cancel the shared gates. This reduces the number
+    /// of gates, and in particular of two-qubit gates.
+    Cancellation = 2,
+}
+
+impl From<CTermOrdering> for TermOrdering {
+    fn from(value: CTermOrdering) -> Self {
+        match value {
+            CTermOrdering::Preserve => TermOrdering::Preserve,
+            CTermOrdering::Depth => TermOrdering::Depth,
+            CTermOrdering::Cancellation => TermOrdering::Cancellation,
+        }
+    }
+}
+
 /// @ingroup QkCircuitLibrary
 /// Generate a circuit using the higher order Suzuki-Trotter product formula from an observable.
 ///
@@ -76,7 +101,79 @@ pub unsafe extern "C" fn qk_circuit_library_suzuki_trotter(
     // SAFETY: Per documentation, the pointer is non-null and aligned.
     let operator = unsafe { const_ptr_as_ref(op) };
 
-    match suzuki_trotter_evolution(operator, order, reps, time, preserve_order, insert_barriers) {
+    let ordering = if preserve_order {
+        TermOrdering::Preserve
+    } else {
+        TermOrdering::Depth
+    };
+    match suzuki_trotter_evolution(operator, order, reps, time, ordering, insert_barriers) {
+        Ok(circuit) => Box::into_raw(Box::new(circuit)),
+        Err(_) => std::ptr::null_mut(),
+    }
+}
+
+/// @ingroup QkCircuitLibrary
+/// Generate a circuit using the higher order Suzuki-Trotter product formula from an observable,
+/// with a choice of how to order its terms.
+///
+/// This is the same as ``qk_circuit_library_suzuki_trotter``, except that the ordering of the
+/// terms is given as a ``QkTermOrdering``. ``QkTermOrdering_Cancellation`` groups mutually
+/// commuting terms, orders each group so that consecutive terms share as many basis changes and
+/// CX gates as possible, and cancels the shared gates. The ordering is computed once and reused
+/// in all time steps.
+///
+/// @param op The ``QkObs`` containing the sum of the Pauli terms.
+/// @param order The order of the product formula.
+/// @param reps The number of time steps.
+/// @param time The evolution time.
+/// @param ordering How to order the terms of the operator in each time step.
+/// @param insert_barriers Whether to insert barriers between the terms evolutions. Barriers
+///   prevent the cancellation of gates between terms.
+///
+/// @return A pointer to the generated circuit, or ``NULL`` if the order is neither 1 nor even.
+///
+/// # Example
+/// ```c
+/// QkObs *obs = qk_obs_zero(3);
+///
+/// QkBitTerm op1_bits[3] = {QkBitTerm_X, QkBitTerm_X, QkBitTerm_X};
+/// QkObsTerm term1 = {(QkComplex64){1.0, 0.0}, 3, op1_bits, (uint32_t[3]){0, 1, 2}, 3};
+/// qk_obs_add_term(obs, &term1);
+///
+/// QkBitTerm op2_bits[3] = {QkBitTerm_X, QkBitTerm_Z, QkBitTerm_Z};
+/// QkObsTerm term2 = {(QkComplex64){0.5, 0.0}, 3, op2_bits, (uint32_t[3]){0, 1, 2}, 3};
+/// qk_obs_add_term(obs, &term2);
+///
+/// QkCircuit *qc =
+///     qk_circuit_library_suzuki_trotter_ordered(obs, 2, 4, 0.1, QkTermOrdering_Cancellation, false);
+///
+/// qk_obs_free(obs);
+/// qk_circuit_free(qc);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined ``op`` is not a valid, non-null pointer to a ``QkObs``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_circuit_library_suzuki_trotter_ordered(
+    op: *const SparseObservable,
+    order: u32,
+    reps: u32,
+    time: f64,
+    ordering: CTermOrdering,
+    insert_barriers: bool,
+) -> *mut CircuitData {
+    // SAFETY: Per documentation, the pointer is non-null and aligned.
+    let operator = unsafe { const_ptr_as_ref(op) };
+
+    match suzuki_trotter_evolution(
+        operator,
+        order,
+        reps,
+        time,
+        ordering.into(),
+        insert_barriers,
+    ) {
         Ok(circuit) => Box::into_raw(Box::new(circuit)),
         Err(_) => std::ptr::null_mut(),
     }
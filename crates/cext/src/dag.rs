@@ -11,20 +11,25 @@
 // that they have been altered from the originals.
 
 use anyhow::Error;
-use hashbrown::HashMap;
+use hashbrown::{HashMap, HashSet};
 use num_complex::Complex64;
+use rustworkx_core::petgraph::Direction;
+use rustworkx_core::petgraph::visit::{EdgeRef, IntoEdgeReferences};
 use smallvec::SmallVec;
+use std::collections::VecDeque;
+use std::ffi::c_void;
 
 use crate::exit_codes::ExitCode;
 use crate::transpiler::target::parse_params;
 use qiskit_circuit::bit::{ClassicalRegister, QuantumRegister};
 use qiskit_circuit::circuit_data::CircuitData;
-use qiskit_circuit::dag_circuit::{DAGCircuit, DAGError, NodeIndex, NodeType};
+use qiskit_circuit::dag_circuit::{DAGCircuit, DAGError, NodeIndex, NodeType, Wire};
 use qiskit_circuit::instruction::Parameters;
 use qiskit_circuit::operations::{
     ArrayType, Operation, OperationRef, Param, StandardGate, StandardInstruction, UnitaryGate,
 };
-use qiskit_circuit::{Clbit, Qubit};
+use qiskit_circuit::packed_instruction::{PackedInstruction, PackedOperation};
+use qiskit_circuit::{Block, BlocksMode, Clbit, Qubit, VarsMode};
 
 use crate::circuit::{CBlocksMode, CInstruction, CVarsMode};
 
@@ -301,6 +306,20 @@ pub enum CDagNodeType {
     VarOut = 6,
 }
 
+impl From<&NodeType> for CDagNodeType {
+    fn from(node: &NodeType) -> Self {
+        match node {
+            NodeType::QubitIn(_) => CDagNodeType::QubitIn,
+            NodeType::QubitOut(_) => CDagNodeType::QubitOut,
+            NodeType::ClbitIn(_) => CDagNodeType::ClbitIn,
+            NodeType::ClbitOut(_) => CDagNodeType::ClbitOut,
+            NodeType::VarIn(_) => CDagNodeType::VarIn,
+            NodeType::VarOut(_) => CDagNodeType::VarOut,
+            NodeType::Operation(_) => CDagNodeType::Operation,
+        }
+    }
+}
+
 /// @ingroup QkDag
 /// Get the type of the specified node.
 ///
@@ -319,15 +338,7 @@ pub enum CDagNodeType {
 pub unsafe extern "C" fn qk_dag_node_type(dag: *const DAGCircuit, node: u32) -> CDagNodeType {
     // SAFETY: Per documentation, the pointer is to valid data.
     let dag = unsafe { const_ptr_as_ref(dag) };
-    match dag.dag()[NodeIndex::new(node as usize)] {
-        NodeType::QubitIn(_) => CDagNodeType::QubitIn,
-        NodeType::QubitOut(_) => CDagNodeType::QubitOut,
-        NodeType::ClbitIn(_) => CDagNodeType::ClbitIn,
-        NodeType::ClbitOut(_) => CDagNodeType::ClbitOut,
-        NodeType::VarIn(_) => CDagNodeType::VarIn,
-        NodeType::VarOut(_) => CDagNodeType::VarOut,
-        NodeType::Operation(_) => CDagNodeType::Operation,
-    }
+    (&dag.dag()[NodeIndex::new(node as usize)]).into()
 }
 
 /// @ingroup QkDag
@@ -1206,6 +1217,469 @@ pub unsafe extern "C" fn qk_dag_neighbors_clear(neighbors: *mut CDagNeighbors) {
     neighbors.neighbors = std::ptr::null();
 }
 
+/// The type of wire carried by an edge of a ``QkDag``.
+#[derive(Copy, Clone, Debug)]
+#[repr(u8)]
+pub enum CDagWireType {
+    /// Qubit wire.
+    Qubit = 0,
+    /// Clbit wire.
+    Clbit = 1,
+    /// Classical variable wire.
+    Var = 2,
+}
+
+/// An edge of a ``QkDag`` as stored in a ``QkDagAdjacency`` snapshot.
+#[repr(C)]
+#[derive(Copy, Clone, Debug)]
+pub struct CDagEdge {
+    /// The node at the other end of the edge.
+    pub node: u32,
+    /// The index of the qubit, clbit or variable carried by the edge.
+    pub wire: u32,
+    /// The type of wire carried by the edge.
+    pub wire_type: CDagWireType,
+}
+
+/// A read-only snapshot of the graph structure of a ``QkDag`` in compressed sparse row (CSR)
+/// form, created by `qk_dag_adjacency_snapshot`.
+///
+/// The outgoing edges of node `n` are `successors[successor_offsets[n]]` up to (but excluding)
+/// `successors[successor_offsets[n + 1]]`, and likewise for the incoming edges in
+/// `predecessors`.  A node connected to another by several wires has one edge per wire; the
+/// edges of each node are sorted by wire type and then by wire index.
+///
+/// This object is read-only from C. To satisfy the safety guarantees of `qk_dag_adjacency_free`,
+/// you must not overwrite any of its fields or any pointed-to data.
+#[repr(C)]
+pub struct CDagAdjacency {
+    /// The upper bound of node indices in the DAG.  Node indices of removed nodes are not
+    /// reused until the DAG is modified, so this can be larger than the number of nodes.
+    pub num_nodes: u32,
+    /// Array of size `num_nodes` with the ``QkDagNodeType`` of each node index, or
+    /// `UINT8_MAX` if the index does not hold a node.
+    pub node_types: *const u8,
+    /// Array of size `num_nodes + 1` of offsets into `successors`.
+    pub successor_offsets: *const usize,
+    /// Array of size `num_edges` of the outgoing edges of all nodes.
+    pub successors: *const CDagEdge,
+    /// Array of size `num_nodes + 1` of offsets into `predecessors`.
+    pub predecessor_offsets: *const usize,
+    /// Array of size `num_edges` of the incoming edges of all nodes.
+    pub predecessors: *const CDagEdge,
+    /// The number of edges in the DAG.
+    pub num_edges: usize,
+    /// Array of size `num_op_nodes` of the operation nodes in topological order.
+    pub topological_op_nodes: *const u32,
+    /// The number of operation nodes in the DAG.
+    pub num_op_nodes: usize,
+}
+
+/// @ingroup QkDag
+/// Take a snapshot of the graph structure of the DAG in compressed sparse row (CSR) form.
+///
+/// The snapshot holds the type of every node, the successors and predecessors of every node
+/// along with the wire of each edge, and a topological order of the operation nodes, all in
+/// flat arrays that can be read directly from C.  This is built in a single pass over the DAG,
+/// so a full traversal does not need a `qk_dag_successors` or `qk_dag_predecessors` call (and
+/// an allocation) per node.
+///
+/// The snapshot is an independent copy: it stays valid after the DAG is modified or freed, but
+/// it does not reflect any change made to the DAG after it was taken.  Take a new snapshot
+/// after modifying the DAG.
+///
+/// You must free the returned snapshot with ``qk_dag_adjacency_free`` when done with it.
+///
+/// @param dag A pointer to the DAG.
+///
+/// @return A pointer to the snapshot.
+///
+/// # Example
+/// ```c
+/// QkDag *dag = qk_dag_new();
+/// QkQuantumRegister *qr = qk_quantum_register_new(2, "qr");
+/// qk_dag_add_quantum_register(dag, qr);
+/// qk_quantum_register_free(qr);
+/// qk_dag_apply_gate(dag, QkGate_H, (uint32_t[]){0}, NULL, false);
+/// qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){0, 1}, NULL, false);
+///
+/// QkDagAdjacency *adjacency = qk_dag_adjacency_snapshot(dag);
+/// for (size_t i = 0; i < adjacency->num_op_nodes; i++) {
+///     uint32_t node = adjacency->topological_op_nodes[i];
+///     for (size_t e = adjacency->successor_offsets[node];
+///          e < adjacency->successor_offsets[node + 1]; e++) {
+///         QkDagEdge edge = adjacency->successors[e];
+///         // `edge.node` follows `node` on wire `edge.wire`.
+///     }
+/// }
+///
+/// qk_dag_adjacency_free(adjacency);
+/// qk_dag_free(dag);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``dag`` is not a valid, non-null pointer to a ``QkDag``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_dag_adjacency_snapshot(dag: *const DAGCircuit) -> *mut CDagAdjacency {
+    // SAFETY: Per documentation, the pointer is to valid data.
+    let dag = unsafe { const_ptr_as_ref(dag) };
+    let graph = dag.dag();
+    let num_nodes = graph.node_bound();
+    let num_edges = graph.edge_count();
+
+    let as_edge = |node: NodeIndex, wire: &Wire| -> CDagEdge {
+        let (wire, wire_type) = match wire {
+            Wire::Qubit(qubit) => (qubit.0, CDagWireType::Qubit),
+            Wire::Clbit(clbit) => (clbit.0, CDagWireType::Clbit),
+            Wire::Var(var) => (var.index() as u32, CDagWireType::Var),
+        };
+        CDagEdge {
+            node: node.index() as u32,
+            wire,
+            wire_type,
+        }
+    };
+    let mut node_types = vec![u8::MAX; num_nodes];
+    let mut successor_offsets = Vec::with_capacity(num_nodes + 1);
+    let mut successors = Vec::with_capacity(num_edges);
+    let mut predecessor_offsets = Vec::with_capacity(num_nodes + 1);
+    let mut predecessors = Vec::with_capacity(num_edges);
+    for index in 0..num_nodes {
+        successor_offsets.push(successors.len());
+        predecessor_offsets.push(predecessors.len());
+        let node = NodeIndex::new(index);
+        let Some(weight) = graph.node_weight(node) else {
+            continue;
+        };
+        node_types[index] = CDagNodeType::from(weight) as u8;
+
+        let start = successors.len();
+        successors.extend(
+            graph
+                .edges_directed(node, Direction::Outgoing)
+                .map(|edge| as_edge(edge.target(), edge.weight())),
+        );
+        successors[start..].sort_unstable_by_key(|edge| (edge.wire_type as u8, edge.wire));
+        let start = predecessors.len();
+        predecessors.extend(
+            graph
+                .edges_directed(node, Direction::Incoming)
+                .map(|edge| as_edge(edge.source(), edge.weight())),
+        );
+        predecessors[start..].sort_unstable_by_key(|edge| (edge.wire_type as u8, edge.wire));
+    }
+    successor_offsets.push(successors.len());
+    predecessor_offsets.push(predecessors.len());
+    let topological_op_nodes: Box<[u32]> = dag
+        .topological_op_nodes(false)
+        .map(|node| node.index() as u32)
+        .collect();
+
+    let adjacency = CDagAdjacency {
+        num_nodes: num_nodes as u32,
+        node_types: Box::into_raw(node_types.into_boxed_slice()) as *const u8,
+        successor_offsets: Box::into_raw(successor_offsets.into_boxed_slice()) as *const usize,
+        successors: Box::into_raw(successors.into_boxed_slice()) as *const CDagEdge,
+        predecessor_offsets: Box::into_raw(predecessor_offsets.into_boxed_slice()) as *const usize,
+        predecessors: Box::into_raw(predecessors.into_boxed_slice()) as *const CDagEdge,
+        num_edges,
+        num_op_nodes: topological_op_nodes.len(),
+        topological_op_nodes: Box::into_raw(topological_op_nodes) as *const u32,
+    };
+    Box::into_raw(Box::new(adjacency))
+}
+
+/// @ingroup QkDag
+/// Free a snapshot created by ``qk_dag_adjacency_snapshot``.
+///
+/// @param adjacency A pointer to the snapshot to free.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``adjacency`` is not either null or a valid pointer to a
+/// ``QkDagAdjacency`` created by ``qk_dag_adjacency_snapshot``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_dag_adjacency_free(adjacency: *mut CDagAdjacency) {
+    if !adjacency.is_null() {
+        if !adjacency.is_aligned() {
+            panic!("Attempted to free a non-aligned pointer.")
+        }
+
+        // SAFETY: We have verified the pointer is non-null and aligned, and per documentation
+        // all the arrays were allocated by ``qk_dag_adjacency_snapshot`` with the stored lengths.
+        unsafe {
+            let adjacency = Box::from_raw(adjacency);
+            let num_nodes = adjacency.num_nodes as usize;
+            let _ = Box::from_raw(std::ptr::slice_from_raw_parts_mut(
+                adjacency.node_types as *mut u8,
+                num_nodes,
+            ));
+            let _ = Box::from_raw(std::ptr::slice_from_raw_parts_mut(
+                adjacency.successor_offsets as *mut usize,
+                num_nodes + 1,
+            ));
+            let _ = Box::from_raw(std::ptr::slice_from_raw_parts_mut(
+                adjacency.successors as *mut CDagEdge,
+                adjacency.num_edges,
+            ));
+            let _ = Box::from_raw(std::ptr::slice_from_raw_parts_mut(
+                adjacency.predecessor_offsets as *mut usize,
+                num_nodes + 1,
+            ));
+            let _ = Box::from_raw(std::ptr::slice_from_raw_parts_mut(
+                adjacency.predecessors as *mut CDagEdge,
+                adjacency.num_edges,
+            ));
+            let _ = Box::from_raw(std::ptr::slice_from_raw_parts_mut(
+                adjacency.topological_op_nodes as *mut u32,
+                adjacency.num_op_nodes,
+            ));
+        }
+    }
+}
+
+/// A struct for storing blocks of nodes collected by `qk_dag_collect_1q_runs`,
+/// `qk_dag_collect_2q_blocks` or `qk_dag_collect_blocks`.
+///
+/// The nodes of block `i` are `nodes[block_offsets[i]]` up to (but excluding)
+/// `nodes[block_offsets[i + 1]]`, in topological order.
+///
+/// This object is read-only from C. To satisfy the safety guarantees of
+/// `qk_dag_node_blocks_clear`, you must not overwrite any data initialized by the collection
+/// functions, including any pointed-to data.
+#[repr(C)]
+pub struct CDagNodeBlocks {
+    /// Array of size `num_nodes` of the node indices of all blocks.
+    pub nodes: *const u32,
+    /// The length of the `nodes` array.
+    pub num_nodes: usize,
+    /// Array of size `num_blocks + 1` of offsets into `nodes`.
+    pub block_offsets: *const usize,
+    /// The number of blocks.
+    pub num_blocks: usize,
+}
+
+impl CDagNodeBlocks {
+    fn from_blocks<I: IntoIterator<Item = Vec<NodeIndex>>>(blocks: I) -> Self {
+        let mut nodes = Vec::new();
+        let mut block_offsets = vec![0];
+        for block in blocks {
+            nodes.extend(block.into_iter().map(|node| node.index() as u32));
+            block_offsets.push(nodes.len());
+        }
+        let nodes = nodes.into_boxed_slice();
+        let block_offsets = block_offsets.into_boxed_slice();
+        CDagNodeBlocks {
+            num_nodes: nodes.len(),
+            nodes: Box::into_raw(nodes) as *const u32,
+            num_blocks: block_offsets.len() - 1,
+            block_offsets: Box::into_raw(block_offsets) as *const usize,
+        }
+    }
+}
+
+/// @ingroup QkDag
+/// Collect the runs of single-qubit gates in the DAG.
+///
+/// A run is a maximal chain of operation nodes that act on a single qubit, have no classical bits
+/// or unbound parameters, and are either standard gates or have a known matrix.  These are the
+/// runs merged by ``qk_transpiler_pass_optimize_1q_sequences``.  All runs are collected in a
+/// single pass over the DAG.
+///
+/// You must call the `qk_dag_node_blocks_clear` function when done to free the memory allocated
+/// for the struct.
+///
+/// @param dag A pointer to the DAG.
+///
+/// @return An instance of the `QkDagNodeBlocks` struct with one block per run.
+///
+/// # Example
+/// ```c
+/// QkDag *dag = qk_dag_new();
+/// QkQuantumRegister *qr = qk_quantum_register_new(2, "qr");
+/// qk_dag_add_quantum_register(dag, qr);
+/// qk_quantum_register_free(qr);
+/// qk_dag_apply_gate(dag, QkGate_H, (uint32_t[]){0}, NULL, false);
+/// qk_dag_apply_gate(dag, QkGate_S, (uint32_t[]){0}, NULL, false);
+/// qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){0, 1}, NULL, false);
+///
+/// QkDagNodeBlocks runs = qk_dag_collect_1q_runs(dag);  // one run with the H and S nodes
+///
+/// qk_dag_node_blocks_clear(&runs);
+/// qk_dag_free(dag);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``dag`` is not a valid, non-null pointer to a ``QkDag``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_dag_collect_1q_runs(dag: *const DAGCircuit) -> CDagNodeBlocks {
+    // SAFETY: Per documentation, the pointer is to valid data.
+    let dag = unsafe { const_ptr_as_ref(dag) };
+    CDagNodeBlocks::from_blocks(dag.collect_1q_runs().expect("a DAG has no cycles"))
+}
+
+/// @ingroup QkDag
+/// Collect the blocks of gates acting on at most two qubits in the DAG.
+///
+/// A block is a maximal set of connected gates without unbound parameters that act on at most
+/// two qubits, all of them within the same pair of qubits.  These are the blocks consolidated by
+/// ``qk_transpiler_pass_standalone_consolidate_blocks``.  All blocks are collected in a single
+/// pass over the DAG.
+///
+/// You must call the `qk_dag_node_blocks_clear` function when done to free the memory allocated
+/// for the struct.
+///
+/// @param dag A pointer to the DAG.
+///
+/// @return An instance of the `QkDagNodeBlocks` struct with one entry per block.
+///
+/// # Example
+/// ```c
+/// QkDag *dag = qk_dag_new();
+/// QkQuantumRegister *qr = qk_quantum_register_new(3, "qr");
+/// qk_dag_add_quantum_register(dag, qr);
+/// qk_quantum_register_free(qr);
+/// qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){0, 1}, NULL, false);
+/// qk_dag_apply_gate(dag, QkGate_H, (uint32_t[]){1}, NULL, false);
+/// qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){1, 0}, NULL, false);
+/// qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){1, 2}, NULL, false);
+///
+/// QkDagNodeBlocks blocks = qk_dag_collect_2q_blocks(dag);  // blocks of 3 and 1 nodes
+///
+/// qk_dag_node_blocks_clear(&blocks);
+/// qk_dag_free(dag);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``dag`` is not a valid, non-null pointer to a ``QkDag``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_dag_collect_2q_blocks(dag: *const DAGCircuit) -> CDagNodeBlocks {
+    // SAFETY: Per documentation, the pointer is to valid data.
+    let dag = unsafe { const_ptr_as_ref(dag) };
+    CDagNodeBlocks::from_blocks(dag.collect_2q_runs().expect("a DAG has no cycles"))
+}
+
+/// A function deciding whether an operation node of a ``QkDag`` belongs in a block, for
+/// `qk_dag_collect_blocks`.
+///
+/// It is called with the DAG, the index of the operation node and the user data passed to
+/// `qk_dag_collect_blocks`, and must not modify the DAG.
+pub type CDagNodeFilter =
+    Option<unsafe extern "C" fn(dag: *const DAGCircuit, node: u32, data: *mut c_void) -> bool>;
+
+/// @ingroup QkDag
+/// Collect the blocks of operation nodes of the DAG that match a filter function.
+///
+/// Starting from the inputs of the DAG, this greedily alternates between collecting the largest
+/// set of nodes that do not match ``filter`` and the largest set of nodes that do, until all
+/// operation nodes are collected.  Each set of matching nodes is then split into blocks over
+/// disjoint qubits, and only the blocks with at least ``min_block_size`` nodes are returned.
+/// This is the same strategy as the ``BlockCollector`` of the Python ``qiskit.dagcircuit``
+/// module.  ``filter`` is called exactly once per operation node.
+///
+/// You must call the `qk_dag_node_blocks_clear` function when done to free the memory allocated
+/// for the struct.
+///
+/// @param dag A pointer to the DAG.
+/// @param filter The filter function, returning ``true`` for nodes that belong in a block.  If
+///     this is NULL, every operation node matches, so the blocks are the groups of nodes
+///     connected through their qubits.
+/// @param data A pointer passed through to each call of ``filter``.  It may be NULL.
+/// @param min_block_size The minimum number of nodes in a returned block.
+///
+/// @return An instance of the `QkDagNodeBlocks` struct with one entry per block.
+///
+/// # Example
+/// ```c
+/// bool is_clifford_2q(const QkDag *dag, uint32_t node, void *data) {
+///     if (qk_dag_op_node_kind(dag, node) != QkOperationKind_Gate ||
+///         qk_dag_op_node_num_params(dag, node) != 0) {
+///         return false;
+///     }
+///     QkGate gate = qk_dag_op_node_gate_op(dag, node, NULL);
+///     return gate == QkGate_CX || gate == QkGate_CZ || gate == QkGate_H || gate == QkGate_S;
+/// }
+///
+/// QkDag *dag = qk_dag_new();
+/// QkQuantumRegister *qr = qk_quantum_register_new(2, "qr");
+/// qk_dag_add_quantum_register(dag, qr);
+/// qk_quantum_register_free(qr);
+/// qk_dag_apply_gate(dag, QkGate_H, (uint32_t[]){0}, NULL, false);
+/// qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){0, 1}, NULL, false);
+/// qk_dag_apply_gate(dag, QkGate_T, (uint32_t[]){1}, NULL, false);
+///
+/// QkDagNodeBlocks blocks = qk_dag_collect_blocks(dag, is_clifford_2q, NULL, 2);
+///
+/// qk_dag_node_blocks_clear(&blocks);
+/// qk_dag_free(dag);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``dag`` is not a valid, non-null pointer to a ``QkDag`` or if
+/// ``filter`` is not a valid function pointer or NULL.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_dag_collect_blocks(
+    dag: *const DAGCircuit,
+    filter: CDagNodeFilter,
+    data: *mut c_void,
+    min_block_size: usize,
+) -> CDagNodeBlocks {
+    // SAFETY: Per documentation, the pointer is to valid data.
+    let dag_ref = unsafe { const_ptr_as_ref(dag) };
+    let blocks = match filter {
+        // SAFETY: Per documentation, the filter is a valid function that does not modify the DAG.
+        Some(filter) => dag_ref.collect_blocks_by(
+            |node, _| unsafe { filter(dag, node.index() as u32, data) },
+            min_block_size,
+        ),
+        None => dag_ref.collect_blocks_by(|_, _| true, min_block_size),
+    };
+    CDagNodeBlocks::from_blocks(blocks)
+}
+
+/// @ingroup QkDag
+/// Clear the fields of the input `QkDagNodeBlocks` struct.
+///
+/// The function deallocates the memory pointed to by the `nodes` and `block_offsets` fields and
+/// sets them to NULL.  It also sets the `num_nodes` and `num_blocks` fields to 0.
+///
+/// @param blocks A pointer to a `QkDagNodeBlocks` object.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``blocks`` is not a valid, non-null pointer to a QkDagNodeBlocks
+/// object populated with ``qk_dag_collect_1q_runs``, ``qk_dag_collect_2q_blocks`` or
+/// ``qk_dag_collect_blocks``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_dag_node_blocks_clear(blocks: *mut CDagNodeBlocks) {
+    // SAFETY: Per documentation, the pointer is to a valid data.
+    let blocks = unsafe { mut_ptr_as_ref(blocks) };
+
+    if !blocks.block_offsets.is_null() {
+        // SAFETY: Per documentation, the arrays were allocated by a collection function with
+        // the stored lengths.
+        unsafe {
+            let _ = Box::from_raw(std::ptr::slice_from_raw_parts_mut(
+                blocks.nodes as *mut u32,
+                blocks.num_nodes,
+            ));
+            let _ = Box::from_raw(std::ptr::slice_from_raw_parts_mut(
+                blocks.block_offsets as *mut usize,
+                blocks.num_blocks + 1,
+            ));
+        }
+    }
+
+    blocks.nodes = std::ptr::null();
+    blocks.num_nodes = 0;
+    blocks.block_offsets = std::ptr::null();
+    blocks.num_blocks = 0;
+}
+
 /// @ingroup QkDag
 /// Return the details for an instruction in the circuit.
 ///
@@ -1813,6 +2287,514 @@ pub unsafe extern "C" fn qk_dag_substitute_node_with_unitary(
     .expect("Failed to substitute op.")
 }
 
+/// An instruction of a queued node substitution, on the bits of the DAG being rewritten.
+struct RewriteInstruction {
+    op: PackedOperation,
+    qubits: Vec<Qubit>,
+    clbits: Vec<Clbit>,
+    params: Option<Parameters<Block>>,
+    label: Option<String>,
+}
+
+/// An edit queued in a ``QkDagRewrite``.
+enum RewriteEdit {
+    /// Remove a node.
+    Remove,
+    /// Replace a node with a sequence of instructions.
+    Substitute {
+        instructions: Vec<RewriteInstruction>,
+        global_phase: Param,
+    },
+    /// Replace a block of nodes with a single unitary gate.
+    Unitary {
+        block: Vec<NodeIndex>,
+        qubits: Vec<Qubit>,
+        array: ArrayType,
+    },
+}
+
+/// A set of rewrites of a ``QkDag`` that are applied together, created by
+/// ``qk_dag_rewrite_begin``.
+pub struct DagRewrite {
+    dag: *mut DAGCircuit,
+    /// The index in `edits` of the edit each node is part of, or `usize::MAX`.
+    edit_of_node: Vec<usize>,
+    edits: Vec<RewriteEdit>,
+}
+
+impl DagRewrite {
+    /// Get the instruction of an operation node, if `node` is one.
+    fn operation<'a>(dag: &'a DAGCircuit, node: u32) -> Option<&'a PackedInstruction> {
+        match dag.dag().node_weight(NodeIndex::new(node as usize)) {
+            Some(NodeType::Operation(inst)) => Some(inst),
+            _ => None,
+        }
+    }
+
+    /// Queue an edit of `nodes`, unless any of them is already part of another edit.
+    fn queue(&mut self, nodes: &[NodeIndex], edit: RewriteEdit) -> ExitCode {
+        if nodes
+            .iter()
+            .any(|node| self.edit_of_node[node.index()] != usize::MAX)
+        {
+            return ExitCode::DagRewriteConflict;
+        }
+        for node in nodes {
+            self.edit_of_node[node.index()] = self.edits.len();
+        }
+        self.edits.push(edit);
+        ExitCode::Success
+    }
+
+    /// Rebuild `dag` with all the queued edits applied.
+    ///
+    /// The operation nodes are emitted in a topological order of the DAG with each block
+    /// contracted to a single node, so every edit is applied in the same pass.
+    fn apply(mut self, dag: &DAGCircuit) -> Result<DAGCircuit, ExitCode> {
+        let graph = dag.dag();
+        let bound = graph.node_bound();
+        let is_op = |node: NodeIndex| matches!(graph[node], NodeType::Operation(_));
+        // The unit each node is emitted in: the node itself, or its block.  Blocks are numbered
+        // after the nodes.
+        let unit_of: Vec<usize> = (0..bound)
+            .map(|node| match self.edit_of_node[node] {
+                usize::MAX => node,
+                edit => match self.edits[edit] {
+                    RewriteEdit::Unitary { .. } => bound + edit,
+                    _ => node,
+                },
+            })
+            .collect();
+
+        let mut in_degree = vec![0usize; bound + self.edits.len()];
+        for edge in graph.edge_references() {
+            if !is_op(edge.source()) || !is_op(edge.target()) {
+                continue;
+            }
+            let (source, target) = (
+                unit_of[edge.source().index()],
+                unit_of[edge.target().index()],
+            );
+            if source != target {
+                in_degree[target] += 1;
+            }
+        }
+        let mut ready = VecDeque::new();
+        let mut seen = vec![false; bound + self.edits.len()];
+        let mut num_units = 0;
+        for node in dag.op_node_indices(true) {
+            let unit = unit_of[node.index()];
+            if !seen[unit] {
+                seen[unit] = true;
+                num_units += 1;
+                if in_degree[unit] == 0 {
+                    ready.push_back(unit);
+                }
+            }
+        }
+
+        let mut out = dag
+            .copy_empty_like_with_same_capacity(VarsMode::Alike, BlocksMode::Keep)
+            .into_builder();
+        let mut num_done = 0;
+        let mut members = Vec::new();
+        while let Some(unit) = ready.pop_front() {
+            num_done += 1;
+            members.clear();
+            if unit < bound {
+                let node = NodeIndex::new(unit);
+                members.push(node);
+                let edit = match self.edit_of_node[unit] {
+                    usize::MAX => None,
+                    edit => Some(std::mem::replace(
+                        &mut self.edits[edit],
+                        RewriteEdit::Remove,
+                    )),
+                };
+                match edit {
+                    None => {
+                        out.push_back(graph[node].unwrap_operation().clone())
+                            .map_err(|_| ExitCode::DagError)?;
+                    }
+                    Some(RewriteEdit::Substitute {
+                        instructions,
+                        global_phase: phase,
+                    }) => {
+                        for inst in instructions {
+                            out.apply_operation_back(
+                                inst.op,
+                                &inst.qubits,
+                                &inst.clbits,
+                                inst.params,
+                                inst.label,
+                                #[cfg(feature = "cache_pygates")]
+                                None,
+                            )
+                            .map_err(|_| ExitCode::DagError)?;
+                        }
+                        out.add_global_phase(&phase)
+                            .map_err(|_| ExitCode::DagError)?;
+                    }
+                    _ => (),
+                }
+            } else {
+                let edit = std::mem::replace(&mut self.edits[unit - bound], RewriteEdit::Remove);
+                let RewriteEdit::Unitary {
+                    block,
+                    qubits,
+                    array,
+                } = edit
+                else {
+                    unreachable!("only unitary edits are numbered after the nodes");
+                };
+                out.apply_operation_back(
+                    Box::new(UnitaryGate { array }).into(),
+                    &qubits,
+                    &[],
+                    None,
+                    None,
+                    #[cfg(feature = "cache_pygates")]
+                    None,
+                )
+                .map_err(|_| ExitCode::DagError)?;
+                members.extend(block);
+            }
+            for node in &members {
+                for successor in graph.neighbors_directed(*node, Direction::Outgoing) {
+                    if !is_op(successor) {
+                        continue;
+                    }
+                    let next = unit_of[successor.index()];
+                    // There is one entry per edge, so this counts every wire between the units.
+                    if next != unit {
+                        in_degree[next] -= 1;
+                        if in_degree[next] == 0 {
+                            ready.push_back(next);
+                        }
+                    }
+                }
+            }
+        }
+        if num_done != num_units {
+            return Err(ExitCode::DagRewriteCycle);
+        }
+        Ok(out.build())
+    }
+}
+
+/// @ingroup QkDag
+/// Start a set of rewrites of a DAG that are applied together.
+///
+/// Replacing many nodes or blocks with ``qk_dag_substitute_node_with_dag`` or
+/// ``qk_dag_replace_block_with_unitary`` updates the graph once per call.  Instead, the edits can
+/// be queued in a ``QkDagRewrite`` with ``qk_dag_rewrite_remove_node``,
+/// ``qk_dag_rewrite_substitute_node_with_dag`` and ``qk_dag_rewrite_replace_block_with_unitary``,
+/// and then applied by ``qk_dag_rewrite_commit`` in a single rebuild of the DAG.  Each edit is
+/// checked when it is queued, and errors are reported as exit codes rather than by aborting.
+///
+/// The node indices passed to the queueing functions are those of ``dag`` when the rewrite was
+/// started, and the DAG must not be modified or freed until the rewrite is committed or freed.
+///
+/// @param dag A pointer to the DAG to rewrite.
+///
+/// @return A pointer to the rewrite, which must be given to ``qk_dag_rewrite_commit`` or
+///     ``qk_dag_rewrite_free``.
+///
+/// # Example
+/// ```c
+/// QkDag *dag = qk_dag_new();
+/// QkQuantumRegister *qr = qk_quantum_register_new(2, "qr");
+/// qk_dag_add_quantum_register(dag, qr);
+/// qk_quantum_register_free(qr);
+/// uint32_t node_h = qk_dag_apply_gate(dag, QkGate_H, (uint32_t[]){0}, NULL, false);
+/// uint32_t node_z = qk_dag_apply_gate(dag, QkGate_Z, (uint32_t[]){1}, NULL, false);
+///
+/// static const QkComplex64 mat_z[4] = {{1, 0}, {0, 0}, {0, 0}, {-1, 0}};
+/// QkDagRewrite *rewrite = qk_dag_rewrite_begin(dag);
+/// qk_dag_rewrite_remove_node(rewrite, node_h);
+/// qk_dag_rewrite_replace_block_with_unitary(rewrite, 1, &node_z, mat_z, 1, (uint32_t[]){1});
+/// QkExitCode exit_code = qk_dag_rewrite_commit(rewrite);
+///
+/// qk_dag_free(dag);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``dag`` is not a valid, non-null pointer to a ``QkDag``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_dag_rewrite_begin(dag: *mut DAGCircuit) -> *mut DagRewrite {
+    // SAFETY: Per documentation, the pointer is to valid data.
+    let dag_ref = unsafe { const_ptr_as_ref(dag) };
+    let rewrite = DagRewrite {
+        dag,
+        edit_of_node: vec![usize::MAX; dag_ref.dag().node_bound()],
+        edits: Vec::new(),
+    };
+    Box::into_raw(Box::new(rewrite))
+}
+
+/// @ingroup QkDag
+/// Queue the removal of an operation node in a DAG rewrite.
+///
+/// @param rewrite A pointer to the rewrite.
+/// @param node The index of the operation node to remove.
+///
+/// @return An exit code. This is ``QkExitCode_IndexError`` if ``node`` is not an operation node,
+///     and ``QkExitCode_DagRewriteConflict`` if ``node`` is already part of another queued edit.
+///     The rewrite is unchanged on error.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``rewrite`` is not a valid, non-null pointer to a ``QkDagRewrite``
+/// whose DAG is still valid.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_dag_rewrite_remove_node(
+    rewrite: *mut DagRewrite,
+    node: u32,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointer is to valid data.
+    let rewrite = unsafe { mut_ptr_as_ref(rewrite) };
+    // SAFETY: Per documentation, the DAG of the rewrite is valid.
+    let dag = unsafe { const_ptr_as_ref(rewrite.dag) };
+    if DagRewrite::operation(dag, node).is_none() {
+        return ExitCode::IndexError;
+    }
+    rewrite.queue(&[NodeIndex::new(node as usize)], RewriteEdit::Remove)
+}
+
+/// @ingroup QkDag
+/// Queue the substitution of an operation node with another DAG in a DAG rewrite.
+///
+/// This is the batched form of ``qk_dag_substitute_node_with_dag``: the qubits and clbits of
+/// ``replacement`` are mapped in order to the qubits and clbits of ``node``.  The operations of
+/// ``replacement`` are copied, so it can be freed as soon as this function returns.
+///
+/// @param rewrite A pointer to the rewrite.
+/// @param node The index of the operation node to replace.
+/// @param replacement A pointer to the DAG to replace ``node`` with. This must have as many
+///     qubits and clbits as the operation of ``node``, and no classical variables, stretches or
+///     control-flow operations.
+///
+/// @return An exit code. This is ``QkExitCode_IndexError`` if ``node`` is not an operation node,
+///     ``QkExitCode_MismatchedQubits`` if the bits of ``replacement`` don't match those of
+///     ``node``, ``QkExitCode_DagError`` if ``replacement`` contains classical variables,
+///     stretches or control flow, and ``QkExitCode_DagRewriteConflict`` if ``node`` is already
+///     part of another queued edit. The rewrite is unchanged on error.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``rewrite`` is not a valid, non-null pointer to a ``QkDagRewrite``
+/// whose DAG is still valid, or if ``replacement`` is not a valid, non-null pointer to a
+/// ``QkDag``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_dag_rewrite_substitute_node_with_dag(
+    rewrite: *mut DagRewrite,
+    node: u32,
+    replacement: *const DAGCircuit,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointers are to valid data.
+    let rewrite = unsafe { mut_ptr_as_ref(rewrite) };
+    let dag = unsafe { const_ptr_as_ref(rewrite.dag) };
+    let replacement = unsafe { const_ptr_as_ref(replacement) };
+
+    let Some(inst) = DagRewrite::operation(dag, node) else {
+        return ExitCode::IndexError;
+    };
+    let qargs = dag.get_qargs(inst.qubits);
+    let cargs = dag.get_cargs(inst.clbits);
+    if replacement.num_qubits() != qargs.len() || replacement.num_clbits() != cargs.len() {
+        return ExitCode::MismatchedQubits;
+    }
+    if !replacement.vars().is_empty() || replacement.num_stretches() > 0 {
+        return ExitCode::DagError;
+    }
+    let mut instructions = Vec::with_capacity(replacement.num_ops());
+    for index in replacement.topological_op_nodes(false) {
+        let inst = replacement[index].unwrap_operation();
+        if let Some(Parameters::Blocks(_)) = inst.params.as_deref() {
+            return ExitCode::DagError;
+        }
+        instructions.push(RewriteInstruction {
+            op: inst.op.clone(),
+            qubits: replacement
+                .get_qargs(inst.qubits)
+                .iter()
+                .map(|qubit| qargs[qubit.index()])
+                .collect(),
+            clbits: replacement
+                .get_cargs(inst.clbits)
+                .iter()
+                .map(|clbit| cargs[clbit.index()])
+                .collect(),
+            params: inst.params.as_deref().cloned(),
+            label: inst.label.as_deref().cloned(),
+        });
+    }
+    rewrite.queue(
+        &[NodeIndex::new(node as usize)],
+        RewriteEdit::Substitute {
+            instructions,
+            global_phase: replacement.global_phase().clone(),
+        },
+    )
+}
+
+/// @ingroup QkDag
+/// Queue the replacement of a block of operation nodes with a unitary gate in a DAG rewrite.
+///
+/// This is the batched form of ``qk_dag_replace_block_with_unitary``.  The block must be
+/// contiguous, in that contracting it to a single node must not introduce a cycle in the DAG;
+/// this is checked by ``qk_dag_rewrite_commit`` for all blocks at once.
+///
+/// @param rewrite A pointer to the rewrite.
+/// @param num_block_ids Number of entries in ``block_ids``. This number must be nonzero.
+/// @param block_ids Pointer to an array of the distinct operation nodes to replace.
+/// @param matrix Pointer to an initialized row-major unitary matrix of size
+///     ``4**num_qubits``.
+/// @param num_qubits The number of qubits the resulting unitary gate acts on.
+/// @param qubits Pointer to an array of distinct qubit indices the unitary gate acts on, which
+///     must include all the qubits of the nodes in the block.
+///
+/// @return An exit code. This is ``QkExitCode_IndexError`` if an entry of ``block_ids`` is not
+///     an operation node or an entry of ``qubits`` is out of range,
+///     ``QkExitCode_DuplicateIndexError`` if ``block_ids`` or ``qubits`` has duplicate entries,
+///     ``QkExitCode_MismatchedQubits`` if a node of the block acts on clbits or on qubits not
+///     in ``qubits``, and ``QkExitCode_DagRewriteConflict`` if a node is already part of
+///     another queued edit. The rewrite is unchanged on error.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``rewrite`` is not a valid, non-null pointer to a ``QkDagRewrite``
+/// whose DAG is still valid, if ``block_ids`` is not an aligned pointer to ``num_block_ids``
+/// initialized values, if ``matrix`` is not an aligned pointer to ``4**num_qubits`` initialized
+/// values, or if ``qubits`` is not an aligned pointer to ``num_qubits`` initialized values.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_dag_rewrite_replace_block_with_unitary(
+    rewrite: *mut DagRewrite,
+    num_block_ids: u32,
+    block_ids: *const u32,
+    matrix: *const Complex64,
+    num_qubits: u32,
+    qubits: *const u32,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointers are to valid data.
+    let rewrite = unsafe { mut_ptr_as_ref(rewrite) };
+    let dag = unsafe { const_ptr_as_ref(rewrite.dag) };
+    if num_block_ids == 0 {
+        return ExitCode::CInputError;
+    }
+    // SAFETY: per documentation, `block_ids` is aligned and valid for `num_block_ids` reads, and
+    // `num_block_ids` is nonzero so `block_ids` cannot be null.
+    let block_ids = unsafe { ::std::slice::from_raw_parts(block_ids, num_block_ids as usize) };
+    let qubits: &[Qubit] = if num_qubits == 0 {
+        &[]
+    } else {
+        // SAFETY: per documentation, `qubits` is aligned and valid for `num_qubits` reads, and
+        // `num_qubits` is nonzero so `qubits` cannot be null.
+        unsafe { ::std::slice::from_raw_parts(qubits as *const Qubit, num_qubits as usize) }
+    };
+
+    let mut in_block = HashSet::with_capacity(qubits.len());
+    for qubit in qubits {
+        if qubit.index() >= dag.num_qubits() {
+            return ExitCode::IndexError;
+        }
+        if !in_block.insert(*qubit) {
+            return ExitCode::DuplicateIndexError;
+        }
+    }
+    let mut block = Vec::with_capacity(block_ids.len());
+    for node in block_ids {
+        let Some(inst) = DagRewrite::operation(dag, *node) else {
+            return ExitCode::IndexError;
+        };
+        if !dag.get_cargs(inst.clbits).is_empty()
+            || dag
+                .get_qargs(inst.qubits)
+                .iter()
+                .any(|qubit| !in_block.contains(qubit))
+        {
+            return ExitCode::MismatchedQubits;
+        }
+        block.push(NodeIndex::new(*node as usize));
+    }
+    block.sort_unstable();
+    if block.windows(2).any(|pair| pair[0] == pair[1]) {
+        return ExitCode::DuplicateIndexError;
+    }
+
+    // SAFETY: per documentation, `matrix` is aligned and valid for `4**num_qubits` reads of
+    // initialized data.
+    let array = unsafe { unitary_from_pointer(matrix, num_qubits, None) }
+        .expect("infallible without tolerance checking");
+    rewrite.queue(
+        &block.clone(),
+        RewriteEdit::Unitary {
+            block,
+            qubits: qubits.to_vec(),
+            array,
+        },
+    )
+}
+
+/// @ingroup QkDag
+/// Apply all the edits queued in a DAG rewrite, and free the rewrite.
+///
+/// The DAG is rebuilt once with all the edits applied, in a topological order in which each
+/// block replaced with a unitary gate is contracted to a single node.  If contracting the blocks
+/// would introduce a cycle, the DAG is left unchanged.  On success, all the node indices of the
+/// DAG are invalidated, as the rebuilt DAG numbers its nodes afresh.
+///
+/// The rewrite is freed whether or not it succeeds, and must not be used afterwards.
+///
+/// @param rewrite A pointer to the rewrite.
+///
+/// @return An exit code. This is ``QkExitCode_DagRewriteCycle`` if contracting the blocks would
+///     introduce a cycle, in which case the DAG is unchanged.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``rewrite`` is not a valid, non-null pointer to a ``QkDagRewrite``
+/// whose DAG is still valid and has not been modified since the rewrite was started.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_dag_rewrite_commit(rewrite: *mut DagRewrite) -> ExitCode {
+    // SAFETY: Per documentation, the pointer is to valid data that we now own.
+    let rewrite = unsafe { Box::from_raw(rewrite) };
+    // SAFETY: Per documentation, the DAG of the rewrite is valid.
+    let dag = unsafe { mut_ptr_as_ref(rewrite.dag) };
+    match rewrite.apply(dag) {
+        Ok(out) => {
+            *dag = out;
+            ExitCode::Success
+        }
+        Err(code) => code,
+    }
+}
+
+/// @ingroup QkDag
+/// Free a DAG rewrite without applying its edits.
+///
+/// @param rewrite A pointer to the rewrite to free.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``rewrite`` is not either null or a valid pointer to a
+/// ``QkDagRewrite``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_dag_rewrite_free(rewrite: *mut DagRewrite) {
+    if !rewrite.is_null() {
+        if !rewrite.is_aligned() {
+            panic!("Attempted to free a non-aligned pointer.")
+        }
+
+        // SAFETY: We have verified the pointer is non-null and aligned, so it should be
+        // readable by Box.
+        unsafe {
+            let _ = Box::from_raw(rewrite);
+        }
+    }
+}
+
 /// @ingroup QkDag
 /// Pass ownership of a `QkDag` object to Python.
 ///
@@ -68,10 +68,18 @@ pub enum ExitCode {
     DagComposeMismatch = 501,
     /// One or more bit indices were not found during compose.
     DagComposeMissingBit = 502,
+    /// A node is part of more than one queued rewrite of a ``QkDag``.
+    DagRewriteConflict = 503,
+    /// Applying the queued rewrites of a ``QkDag`` would introduce a cycle.
+    DagRewriteCycle = 504,
     /// Errors concerning parameter handling.
     ParameterError = 600,
     /// Parameter name conflict.
     ParameterNameConflict = 601,
+    /// The circuit cannot be simulated.
+    SimulationError = 700,
+    /// The circuit cannot be serialized.
+    SerializationError = 800,
 }
 
 impl From<ArithmeticError> for ExitCode {
@@ -0,0 +1,380 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+use std::sync::Arc;
+
+use crate::pointers::{const_ptr_as_ref, mut_ptr_as_ref};
+
+#[cfg(feature = "python_binding")]
+use pyo3::prelude::*;
+use qiskit_circuit::circuit_data::CircuitData;
+#[cfg(feature = "python_binding")]
+use qiskit_circuit::circuit_data::PyCircuitData;
+
+/// The owner of the circuit behind a [SharedCircuit].
+enum Owner {
+    /// A circuit owned by C handles only.
+    Native(Arc<CircuitData>),
+    /// A circuit owned by a Python ``CircuitData`` object, which handles hold a reference to.
+    #[cfg(feature = "python_binding")]
+    Python(Py<PyCircuitData>),
+}
+
+/// A reference-counted handle to a circuit, shared between C handles and Python objects.
+///
+/// Creating, cloning and passing a handle to and from Python never copies the circuit.  The
+/// circuit is only copied when it is mutated through a handle while it is also referenced from
+/// somewhere else, so that every other holder keeps seeing the original circuit.
+///
+/// Copy-on-write only applies to mutation through handles.  Python code holding the same
+/// ``CircuitData`` object can still modify it in place, and every handle referring to that object
+/// sees the change; Python has no hook that would let us copy first.
+pub struct SharedCircuit {
+    owner: Owner,
+}
+
+impl SharedCircuit {
+    fn circuit(&self) -> *const CircuitData {
+        match &self.owner {
+            Owner::Native(circuit) => Arc::as_ptr(circuit),
+            #[cfg(feature = "python_binding")]
+            Owner::Python(ob) => {
+                // SAFETY: per the documentation of the C functions, the caller is attached to a
+                // Python interpreter when the handle refers to a Python object.
+                let py = unsafe { Python::assume_attached() };
+                // The pointer outlives the borrow, as for `qk_circuit_borrow_from_python`; it stays
+                // valid as long as the Python object, which the handle keeps alive.
+                &ob.borrow(py).inner
+            }
+        }
+    }
+
+    fn circuit_mut(&mut self) -> *mut CircuitData {
+        #[cfg(feature = "python_binding")]
+        if let Owner::Python(ob) = &self.owner {
+            // SAFETY: per the documentation of the C functions, the caller is attached to a Python
+            // interpreter when the handle refers to a Python object.
+            let py = unsafe { Python::assume_attached() };
+            let bound = ob.bind(py);
+            if bound.get_refcnt() == 1
+                && let Ok(mut data) = bound.try_borrow_mut()
+            {
+                return &mut data.inner;
+            }
+            // The Python object is referenced from elsewhere, so detach from it.
+            let copy = bound.borrow().inner.clone();
+            self.owner = Owner::Native(Arc::new(copy));
+        }
+        match &mut self.owner {
+            Owner::Native(circuit) => Arc::make_mut(circuit),
+            #[cfg(feature = "python_binding")]
+            Owner::Python(_) => unreachable!("Python-owned circuits are detached above"),
+        }
+    }
+
+    fn is_unique(&self) -> bool {
+        match &self.owner {
+            Owner::Native(circuit) => Arc::strong_count(circuit) == 1,
+            #[cfg(feature = "python_binding")]
+            Owner::Python(ob) => {
+                // SAFETY: per the documentation of the C functions, the caller is attached to a
+                // Python interpreter when the handle refers to a Python object.
+                let py = unsafe { Python::assume_attached() };
+                ob.get_refcnt(py) == 1
+            }
+        }
+    }
+}
+
+impl Clone for SharedCircuit {
+    fn clone(&self) -> Self {
+        let owner = match &self.owner {
+            Owner::Native(circuit) => Owner::Native(circuit.clone()),
+            #[cfg(feature = "python_binding")]
+            Owner::Python(ob) => {
+                // SAFETY: per the documentation of the C functions, the caller is attached to a
+                // Python interpreter when the handle refers to a Python object.
+                let py = unsafe { Python::assume_attached() };
+                Owner::Python(ob.clone_ref(py))
+            }
+        };
+        SharedCircuit { owner }
+    }
+}
+
+/// @ingroup QkSharedCircuit
+/// Create a shared circuit handle from a circuit, taking ownership of the circuit.
+///
+/// This does not copy the circuit.
+///
+/// @param circuit A pointer to the owned circuit. It must not be used or freed after this call.
+///
+/// @return A pointer to the new handle, which must be freed with ``qk_shared_circuit_free``.
+///
+/// # Example
+///
+/// ```c
+///     QkCircuit *qc = qk_circuit_new(2, 0);
+///     QkSharedCircuit *shared = qk_shared_circuit_new(qc);
+///     qk_shared_circuit_free(shared);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``circuit`` is not a valid, non-null pointer to an owned
+/// ``QkCircuit``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_shared_circuit_new(circuit: *mut CircuitData) -> *mut SharedCircuit {
+    // SAFETY: Per documentation, the pointer is non-null, aligned and owned.
+    let circuit = unsafe { Box::from_raw(mut_ptr_as_ref(circuit)) };
+    let shared = SharedCircuit {
+        owner: Owner::Native(Arc::from(circuit)),
+    };
+    Box::into_raw(Box::new(shared))
+}
+
+/// @ingroup QkSharedCircuit
+/// Create a new handle to the circuit of a shared circuit handle.
+///
+/// This does not copy the circuit: both handles refer to the same circuit until one of them is
+/// mutated with ``qk_shared_circuit_get_mut``.
+///
+/// @param shared A pointer to the handle to clone.
+///
+/// @return A pointer to the new handle, which must be freed with ``qk_shared_circuit_free``.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``shared`` is not a valid, non-null pointer to a ``QkSharedCircuit``.
+/// If the handle refers to a Python object, the caller must be attached to a Python interpreter.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_shared_circuit_clone(
+    shared: *const SharedCircuit,
+) -> *mut SharedCircuit {
+    // SAFETY: Per documentation, the pointer is non-null and aligned.
+    let shared = unsafe { const_ptr_as_ref(shared) };
+    Box::into_raw(Box::new(shared.clone()))
+}
+
+/// @ingroup QkSharedCircuit
+/// Check whether a shared circuit handle is the only reference to its circuit.
+///
+/// @param shared A pointer to the handle.
+///
+/// @return ``true`` if no other handle or Python object refers to the circuit, in which case
+///     ``qk_shared_circuit_get_mut`` does not copy it.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``shared`` is not a valid, non-null pointer to a ``QkSharedCircuit``.
+/// If the handle refers to a Python object, the caller must be attached to a Python interpreter.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_shared_circuit_is_unique(shared: *const SharedCircuit) -> bool {
+    // SAFETY: Per documentation, the pointer is non-null and aligned.
+    let shared = unsafe { const_ptr_as_ref(shared) };
+    shared.is_unique()
+}
+
+/// @ingroup QkSharedCircuit
+/// Get a read-only pointer to the circuit of a shared circuit handle.
+///
+/// The circuit must not be modified through this pointer. The pointer is borrowed from the handle,
+/// and is invalidated when the handle is freed or passed to ``qk_shared_circuit_get_mut`` or
+/// ``qk_shared_circuit_to_python``.
+///
+/// @param shared A pointer to the handle.
+///
+/// @return A borrowed pointer to the circuit.
+///
+/// # Example
+///
+/// ```c
+///     QkSharedCircuit *shared = qk_shared_circuit_new(qk_circuit_new(2, 0));
+///     uint32_t num_qubits = qk_circuit_num_qubits(qk_shared_circuit_get(shared));
+///     qk_shared_circuit_free(shared);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``shared`` is not a valid, non-null pointer to a ``QkSharedCircuit``.
+/// If the handle refers to a Python object, the caller must be attached to a Python interpreter.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_shared_circuit_get(shared: *const SharedCircuit) -> *const CircuitData {
+    // SAFETY: Per documentation, the pointer is non-null and aligned.
+    let shared = unsafe { const_ptr_as_ref(shared) };
+    shared.circuit()
+}
+
+/// @ingroup QkSharedCircuit
+/// Get a mutable pointer to the circuit of a shared circuit handle.
+///
+/// If other handles or Python objects refer to the same circuit, the circuit is copied first and
+/// the handle is moved to the copy, so that the other holders are not affected by the changes.
+/// Otherwise, the circuit is modified in place.
+///
+/// The pointer is borrowed from the handle, and is invalidated when the handle is freed or passed
+/// to ``qk_shared_circuit_get_mut`` or ``qk_shared_circuit_to_python`` again.
+///
+/// @param shared A pointer to the handle.
+///
+/// @return A borrowed pointer to the circuit.
+///
+/// # Example
+///
+/// ```c
+///     QkSharedCircuit *shared = qk_shared_circuit_new(qk_circuit_new(2, 0));
+///     QkSharedCircuit *other = qk_shared_circuit_clone(shared);
+///     // This copies the circuit, so the circuit of `shared` is left empty.
+///     qk_circuit_gate(qk_shared_circuit_get_mut(other), QkGate_H, (uint32_t[]){0}, NULL);
+///     qk_shared_circuit_free(other);
+///     qk_shared_circuit_free(shared);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``shared`` is not a valid, non-null pointer to a ``QkSharedCircuit``.
+/// If the handle refers to a Python object, the caller must be attached to a Python interpreter.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_shared_circuit_get_mut(shared: *mut SharedCircuit) -> *mut CircuitData {
+    // SAFETY: Per documentation, the pointer is non-null and aligned.
+    let shared = unsafe { mut_ptr_as_ref(shared) };
+    shared.circuit_mut()
+}
+
+/// @ingroup QkSharedCircuit
+/// Free a shared circuit handle.
+///
+/// The circuit itself is freed once no handle or Python object refers to it anymore.
+///
+/// @param shared A pointer to the handle to free.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``shared`` is not a valid pointer to a ``QkSharedCircuit`` or
+/// ``NULL``. If the handle refers to a Python object, the caller must be attached to a Python
+/// interpreter.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_shared_circuit_free(shared: *mut SharedCircuit) {
+    if !shared.is_null() {
+        if !shared.is_aligned() {
+            panic!("Attempted to free a non-aligned pointer.")
+        }
+        // SAFETY: We have verified the pointer is non-null and aligned, so it should be
+        // readable by Box.
+        unsafe {
+            let _ = Box::from_raw(shared);
+        }
+    }
+}
+
+#[cfg(feature = "python_binding")]
+mod py {
+    use super::*;
+    use qiskit_circuit::operations::Param;
+
+    /// @ingroup QkSharedCircuit
+    /// Create a shared circuit handle referring to a Python ``CircuitData`` object.
+    ///
+    /// Note that the input to this function should _not_ be ``QuantumCircuit``, but the output of
+    /// ``QuantumCircuit._data``.
+    ///
+    /// This does not copy the circuit: the handle holds a new reference to the Python object,
+    /// so unlike the pointer returned by ``qk_circuit_borrow_from_python``, it stays valid after
+    /// ``ob`` is released. If the circuit is modified with ``qk_shared_circuit_get_mut`` while the
+    /// Python object is still referenced from Python, the handle moves to a copy of the circuit.
+    ///
+    /// The reverse is not true: modifying the object from Python, for example through the
+    /// ``QuantumCircuit`` that owns it, modifies it in place, and the change is visible through
+    /// every handle that refers to it. Copy the circuit in Python first if the handles must not see
+    /// later changes.
+    ///
+    /// @param ob A borrowed Python object.
+    /// @return A pointer to the new handle, or ``NULL`` if the Python object is the wrong type, in
+    ///     which case the exception state of the Python interpreter is set.
+    ///
+    /// # Safety
+    ///
+    /// The caller must be attached to a Python interpreter.  Behavior is undefined if ``ob`` is
+    /// not a valid non-null pointer to a Python object.
+    #[unsafe(no_mangle)]
+    pub unsafe extern "C" fn qk_shared_circuit_from_python(
+        ob: *mut ::pyo3::ffi::PyObject,
+    ) -> *mut SharedCircuit {
+        // SAFETY: per documentation, we are attached to a Python interpreter.
+        let py = unsafe { Python::assume_attached() };
+        // SAFETY: per documentation, `ob` points to a valid PyObject.
+        let ob = unsafe { Borrowed::from_ptr(py, ob) };
+        match ob.cast::<PyCircuitData>() {
+            Ok(ob) => Box::into_raw(Box::new(SharedCircuit {
+                owner: Owner::Python(ob.to_owned().unbind()),
+            })),
+            Err(e) => {
+                PyErr::from(e).restore(py);
+                ::std::ptr::null_mut()
+            }
+        }
+    }
+
+    /// @ingroup QkSharedCircuit
+    /// Get a Python ``CircuitData`` object for the circuit of a shared circuit handle.
+    ///
+    /// If the handle already refers to a Python object, a new reference to it is returned. If the
+    /// circuit is only referenced by this handle, it is moved into a new Python object without
+    /// copying. Otherwise, it is copied once. In the last two cases, the handle then refers to the
+    /// new Python object, so passing the circuit to Python again is free. As for
+    /// ``qk_shared_circuit_from_python``, changes made to the returned object from Python are seen
+    /// by every handle that refers to it.
+    ///
+    /// The handle remains valid and owned by the caller, and must still be freed.
+    ///
+    /// @param shared A pointer to the handle.
+    /// @return An owned Python reference to the ``CircuitData`` object, or ``NULL`` if it could not
+    ///     be created, in which case the exception state of the Python interpreter is set.
+    ///
+    /// # Safety
+    ///
+    /// The caller must be attached to a Python interpreter.  Behavior is undefined if ``shared`` is
+    /// not a valid, non-null pointer to a ``QkSharedCircuit``.
+    #[unsafe(no_mangle)]
+    pub unsafe extern "C" fn qk_shared_circuit_to_python(
+        shared: *mut SharedCircuit,
+    ) -> *mut ::pyo3::ffi::PyObject {
+        // SAFETY: per documentation, we are attached to a Python interpreter.
+        let py = unsafe { Python::assume_attached() };
+        // SAFETY: Per documentation, the pointer is non-null and aligned.
+        let shared = unsafe { mut_ptr_as_ref(shared) };
+        let circuit = match &mut shared.owner {
+            Owner::Python(ob) => return ob.clone_ref(py).into_ptr(),
+            Owner::Native(circuit) => match Arc::get_mut(circuit) {
+                // Move the circuit out of its only reference rather than copying it.
+                Some(circuit) => ::std::mem::replace(
+                    circuit,
+                    CircuitData::with_capacity(0, 0, 0, Param::Float(0.0))
+                        .expect("an empty circuit is valid"),
+                ),
+                None => circuit.as_ref().clone(),
+            },
+        };
+        match Py::new(py, PyCircuitData::from(circuit)) {
+            Ok(ob) => {
+                shared.owner = Owner::Python(ob.clone_ref(py));
+                ob.into_ptr()
+            }
+            Err(e) => {
+                e.restore(py);
+                ::std::ptr::null_mut()
+            }
+        }
+    }
+}
+#[cfg(feature = "python_binding")]
+pub use py::*;
@@ -11,6 +11,7 @@
 // that they have been altered from the originals.
 
 pub mod neighbors;
+pub mod pass_manager;
 pub mod passes;
 pub mod target;
 pub mod transpile_function;
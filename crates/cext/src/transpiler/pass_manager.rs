@@ -0,0 +1,501 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+use std::ffi::{CString, c_char, c_void};
+use std::fmt;
+
+use qiskit_circuit::circuit_data::CircuitData;
+use qiskit_circuit::dag_circuit::DAGCircuit;
+use qiskit_transpiler::commutation_checker::{
+    CommutationChecker, get_standard_commutation_checker,
+};
+use qiskit_transpiler::passes::{
+    Optimize1qGatesDecompositionState, cancel_commutations,
+    run_inverse_cancellation_standard_gates, run_optimize_1q_gates_decomposition,
+    run_remove_diagonal_before_measure, run_remove_identity_equiv, run_restore_final_layout,
+};
+use qiskit_transpiler::target::Target;
+use qiskit_transpiler::transpile_layout::TranspileLayout;
+use qiskit_transpiler::transpiler::{PassInsertionPoint, transpile_with_passes};
+
+use crate::exit_codes::ExitCode;
+use crate::pointers::{const_ptr_as_ref, mut_ptr_as_ref};
+use crate::transpiler::transpile_function::{TranspileOptions, TranspileResult};
+
+/// The point of the transpiler pipeline at which a pass of a ``QkPassManager`` runs.
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum CPassInsertionPoint {
+    /// Before the init stage, on the virtual circuit.
+    BeforeInit = 0,
+    /// After the init stage, on the virtual circuit.
+    AfterInit = 1,
+    /// After the layout stage, once the circuit is defined over the physical qubits of the
+    /// target.
+    AfterLayout = 2,
+    /// After the routing stage.
+    AfterRouting = 3,
+    /// After the translation stage.
+    AfterTranslation = 4,
+    /// In every iteration of the optimization loop, after the preset optimizations of the
+    /// iteration. The circuit is translated to the target again afterwards if needed. The
+    /// optimization loop does not run at optimization level 0.
+    OptimizationLoop = 5,
+    /// After the optimization stage, at the end of the pipeline.
+    AfterOptimization = 6,
+}
+
+impl From<CPassInsertionPoint> for PassInsertionPoint {
+    fn from(value: CPassInsertionPoint) -> Self {
+        match value {
+            CPassInsertionPoint::BeforeInit => PassInsertionPoint::BeforeInit,
+            CPassInsertionPoint::AfterInit => PassInsertionPoint::AfterInit,
+            CPassInsertionPoint::AfterLayout => PassInsertionPoint::AfterLayout,
+            CPassInsertionPoint::AfterRouting => PassInsertionPoint::AfterRouting,
+            CPassInsertionPoint::AfterTranslation => PassInsertionPoint::AfterTranslation,
+            CPassInsertionPoint::OptimizationLoop => PassInsertionPoint::OptimizationLoop,
+            CPassInsertionPoint::AfterOptimization => PassInsertionPoint::AfterOptimization,
+        }
+    }
+}
+
+/// The native passes that can be added to a ``QkPassManager``.
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum CNativePass {
+    /// Cancel pairs of adjacent self-inverse and inverse standard gates, see
+    /// ``qk_transpiler_pass_inverse_cancellation``.
+    InverseCancellation = 0,
+    /// Cancel gates using commutation relations, see
+    /// ``qk_transpiler_pass_commutative_cancellation``.
+    CommutativeCancellation = 1,
+    /// Resynthesize runs of single-qubit gates, see ``qk_transpiler_pass_optimize_1q_sequences``.
+    Optimize1qSequences = 2,
+    /// Remove gates equivalent to the identity, see
+    /// ``qk_transpiler_pass_remove_identity_equivalent``.
+    RemoveIdentityEquivalent = 3,
+    /// Remove diagonal gates before measurements, see
+    /// ``qk_transpiler_pass_remove_diagonal_gates_before_measure``.
+    RemoveDiagonalGatesBeforeMeasure = 4,
+    /// Append swaps that undo the output permutation of the layout, see
+    /// ``qk_transpiler_pass_restore_final_layout``. The swaps are only translated to the target
+    /// if the pass runs before the translation stage or in the optimization loop, so at the other
+    /// points after routing it fails unless the target supports swaps. It fails before the
+    /// layout stage.
+    RestoreFinalLayout = 5,
+}
+
+/// The number of randomized trials of ``CNativePass::RestoreFinalLayout``, as in the Python
+/// ``LayoutTransformation`` pass.
+const RESTORE_FINAL_LAYOUT_TRIALS: usize = 4;
+
+/// A pass run by a ``QkPassManager`` on the circuit being transpiled.
+///
+/// The pass receives the circuit as a ``QkDag`` it can modify in place, the target, the layout
+/// found so far and the user data given to ``qk_pass_manager_add_pass``. It must return
+/// ``QkExitCode_Success``; any other exit code stops the transpilation, and is returned by
+/// ``qk_pass_manager_run``.
+pub type CPassCallback = Option<
+    unsafe extern "C" fn(
+        *mut DAGCircuit,
+        *const Target,
+        *mut TranspileLayout,
+        *mut c_void,
+    ) -> ExitCode,
+>;
+
+enum Pass {
+    Native(CNativePass),
+    Callback(
+        unsafe extern "C" fn(
+            *mut DAGCircuit,
+            *const Target,
+            *mut TranspileLayout,
+            *mut c_void,
+        ) -> ExitCode,
+        *mut c_void,
+    ),
+}
+
+/// The error returned through the transpiler when a callback pass fails.
+#[derive(Debug)]
+struct CallbackError {
+    point: PassInsertionPoint,
+    code: ExitCode,
+}
+
+impl fmt::Display for CallbackError {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(
+            f,
+            "A pass at {:?} failed with exit code {:?}",
+            self.point, self.code
+        )
+    }
+}
+
+impl std::error::Error for CallbackError {}
+
+/// A transpiler pipeline with extra passes.
+///
+/// This runs the same stages as ``qk_transpile``, and the native and callback passes added to it
+/// at their insertion points, all on the same in-flight ``QkDag``.
+pub struct PassManager {
+    options: TranspileOptions,
+    passes: Vec<(PassInsertionPoint, Pass)>,
+}
+
+/// Native passes need some state that is reused across the insertion points of a run.
+struct NativePassState {
+    commutation_checker: Option<CommutationChecker>,
+    optimize_1q_state: Option<Optimize1qGatesDecompositionState>,
+    seed: Option<u64>,
+}
+
+impl NativePassState {
+    fn run(
+        &mut self,
+        pass: CNativePass,
+        point: PassInsertionPoint,
+        dag: &mut DAGCircuit,
+        target: &Target,
+        layout: &mut TranspileLayout,
+        approximation_degree: Option<f64>,
+    ) -> anyhow::Result<()> {
+        // Before the layout stage the qubits of the circuit are not physical qubits of the target.
+        let physical_target = match point {
+            PassInsertionPoint::BeforeInit | PassInsertionPoint::AfterInit => None,
+            _ => Some(target),
+        };
+        match pass {
+            CNativePass::InverseCancellation => run_inverse_cancellation_standard_gates(dag),
+            CNativePass::CommutativeCancellation => {
+                let checker = self
+                    .commutation_checker
+                    .get_or_insert_with(get_standard_commutation_checker);
+                cancel_commutations(dag, checker, None, 1.0)?;
+            }
+            CNativePass::Optimize1qSequences => {
+                let state = self.optimize_1q_state.get_or_insert_with(|| {
+                    Optimize1qGatesDecompositionState::new(target.num_qubits.unwrap_or(0) as usize)
+                });
+                run_optimize_1q_gates_decomposition(dag, state, physical_target, None, None)?;
+            }
+            CNativePass::RemoveIdentityEquivalent => {
+                run_remove_identity_equiv(dag, approximation_degree, physical_target)?;
+            }
+            CNativePass::RemoveDiagonalGatesBeforeMeasure => {
+                run_remove_diagonal_before_measure(dag)
+            }
+            CNativePass::RestoreFinalLayout => {
+                match point {
+                    PassInsertionPoint::BeforeInit | PassInsertionPoint::AfterInit => {
+                        anyhow::bail!("RestoreFinalLayout cannot run before the layout stage")
+                    }
+                    PassInsertionPoint::AfterTranslation
+                    | PassInsertionPoint::AfterOptimization
+                        if !target.contains_key("swap") =>
+                    {
+                        anyhow::bail!(
+                            "RestoreFinalLayout cannot run after translation to a target without swaps"
+                        )
+                    }
+                    _ => (),
+                }
+                run_restore_final_layout(
+                    dag,
+                    target,
+                    layout,
+                    RESTORE_FINAL_LAYOUT_TRIALS,
+                    self.seed,
+                )?;
+            }
+        }
+        Ok(())
+    }
+}
+
+/// @ingroup QkPassManager
+/// Create a new pass manager.
+///
+/// The pass manager runs the same stages as ``qk_transpile`` with the given options. Passes can
+/// then be added to run at points of the pipeline with ``qk_pass_manager_add_pass`` and
+/// ``qk_pass_manager_add_native_pass``.
+///
+/// @param options A pointer to an options object that defines user options. If this is a null
+///   pointer the default values will be used. See ``qk_transpiler_default_options``
+///   for more details on the default values.
+///
+/// @return A pointer to the new pass manager, which must be freed with ``qk_pass_manager_free``.
+///
+/// # Example
+///
+/// ```c
+///     QkTranspileOptions options = qk_transpiler_default_options();
+///     options.optimization_level = 3;
+///     QkPassManager *pm = qk_pass_manager_new(&options);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``options`` is not a valid pointer to a ``QkTranspileOptions`` or
+/// ``NULL``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_pass_manager_new(options: *const TranspileOptions) -> *mut PassManager {
+    let options = if options.is_null() {
+        TranspileOptions::default()
+    } else {
+        // SAFETY: We checked the pointer is not null, then, per documentation, it is a valid
+        // and aligned pointer.
+        *unsafe { const_ptr_as_ref(options) }
+    };
+    // Validate the options up front rather than when the pass manager is run.
+    options.optimization_level();
+    options.approximation_degree();
+    Box::into_raw(Box::new(PassManager {
+        options,
+        passes: Vec::new(),
+    }))
+}
+
+/// @ingroup QkPassManager
+/// Add a C callback pass to a pass manager.
+///
+/// The pass runs at ``point`` every time the pipeline reaches it, after any pass added to the
+/// same point earlier. It receives the circuit being transpiled as a ``QkDag`` that it can modify
+/// in place, the target, the ``QkTranspileLayout`` found so far and ``data``. The pointers are
+/// only valid during the call, and the pass must not free them. Passes added after the
+/// translation stage, except in the optimization loop, must leave the circuit supported by the
+/// target.
+///
+/// @param pm A pointer to the pass manager.
+/// @param point The point of the pipeline at which the pass runs.
+/// @param pass The callback implementing the pass.
+/// @param data A pointer passed to every call of ``pass``. This can be ``NULL``.
+///
+/// @return ``QkExitCode_Success`` if the pass was added, or ``QkExitCode_NullPointerError`` if
+///   ``pass`` is ``NULL``.
+///
+/// # Example
+///
+/// ```c
+///     QkExitCode count_calls(QkDag *dag, const QkTarget *target, QkTranspileLayout *layout,
+///                            void *data) {
+///         *(int *)data += 1;
+///         return QkExitCode_Success;
+///     }
+///
+///     int calls = 0;
+///     QkPassManager *pm = qk_pass_manager_new(NULL);
+///     qk_pass_manager_add_pass(pm, QkPassInsertionPoint_OptimizationLoop, count_calls, &calls);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``pm`` is not a valid, non-null pointer to a ``QkPassManager``, or
+/// if ``data`` is not valid for every call of ``pass`` while the pass manager is run.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_pass_manager_add_pass(
+    pm: *mut PassManager,
+    point: CPassInsertionPoint,
+    pass: CPassCallback,
+    data: *mut c_void,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointer is non-null and aligned.
+    let pm = unsafe { mut_ptr_as_ref(pm) };
+    let Some(pass) = pass else {
+        return ExitCode::NullPointerError;
+    };
+    pm.passes.push((point.into(), Pass::Callback(pass, data)));
+    ExitCode::Success
+}
+
+/// @ingroup QkPassManager
+/// Add a native pass to a pass manager.
+///
+/// The pass runs at ``point`` every time the pipeline reaches it, after any pass added to the
+/// same point earlier. Passes that use the target only use it once the circuit is defined over
+/// physical qubits, from ``QkPassInsertionPoint_AfterLayout`` onwards.
+///
+/// @param pm A pointer to the pass manager.
+/// @param point The point of the pipeline at which the pass runs.
+/// @param pass The native pass to run.
+///
+/// # Example
+///
+/// ```c
+///     QkPassManager *pm = qk_pass_manager_new(NULL);
+///     qk_pass_manager_add_native_pass(pm, QkPassInsertionPoint_AfterInit,
+///                                     QkNativePass_InverseCancellation);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``pm`` is not a valid, non-null pointer to a ``QkPassManager``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_pass_manager_add_native_pass(
+    pm: *mut PassManager,
+    point: CPassInsertionPoint,
+    pass: CNativePass,
+) {
+    // SAFETY: Per documentation, the pointer is non-null and aligned.
+    let pm = unsafe { mut_ptr_as_ref(pm) };
+    pm.passes.push((point.into(), Pass::Native(pass)));
+}
+
+/// @ingroup QkPassManager
+/// Transpile a single circuit with a pass manager.
+///
+/// This runs the same pipeline as ``qk_transpile``, and the passes of the pass manager at their
+/// insertion points. The circuit is converted to a ``QkDag`` once at the start of the pipeline,
+/// and back to a circuit once at the end, so the passes run without any conversion in between.
+/// The same restrictions as ``qk_transpile`` apply to the circuit.
+///
+/// @param pm A pointer to the pass manager.
+/// @param qc A pointer to the circuit to run the transpiler on.
+/// @param target A pointer to the target to compile the circuit for.
+/// @param result A pointer to the memory location of the transpiler result. On a successful
+///   execution (return code 0) the output of the transpiler will be written to the pointer. The
+///   members of the result struct are owned by the caller and you are responsible for freeing
+///   the members using the respective free functions.
+/// @param error A pointer to a pointer with an nul terminated string with an error description.
+///   If the transpiler fails a pointer to the string with the error description will be written
+///   to this pointer. That pointer needs to be freed with ``qk_str_free``. This can be a null
+///   pointer in which case the error will not be written out.
+///
+/// @returns ``QkExitCode_Success`` on success. If a callback pass fails, the exit code it returned,
+///   and ``QkExitCode_TranspilerError`` if any other part of the pipeline fails.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``pm``, ``qc``, ``target``, or ``result``, are not valid, non-null
+/// pointers to a ``QkPassManager``, ``QkCircuit``, ``QkTarget``, or ``QkTranspileResult``
+/// respectively. ``error`` must be a valid pointer to a ``char`` pointer or ``NULL``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_pass_manager_run(
+    pm: *const PassManager,
+    qc: *const CircuitData,
+    target: *const Target,
+    result: *mut TranspileResult,
+    error: *mut *mut c_char,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointers are non-null and aligned.
+    let pm = unsafe { const_ptr_as_ref(pm) };
+    let qc = unsafe { const_ptr_as_ref(qc) };
+    let target = unsafe { const_ptr_as_ref(target) };
+    let write_error = |message: String| {
+        if !error.is_null() {
+            // SAFETY: Per documentation, error is a char* (and we checked it's not NULL)
+            unsafe { *error = CString::new(message).unwrap().into_raw() };
+        }
+    };
+
+    if let Some(target_qubits) = target.num_qubits
+        && target_qubits < qc.num_qubits() as u32
+    {
+        write_error(format!(
+            "Insufficient qubits in target: {}, the circuit uses {}",
+            target_qubits,
+            qc.num_qubits()
+        ));
+        return ExitCode::TranspilerError;
+    }
+
+    let approximation_degree = pm.options.approximation_degree();
+    let mut native_state = NativePassState {
+        commutation_checker: None,
+        optimize_1q_state: None,
+        seed: pm.options.seed(),
+    };
+    let mut run_passes = |point: PassInsertionPoint,
+                          dag: &mut DAGCircuit,
+                          layout: &mut TranspileLayout|
+     -> anyhow::Result<()> {
+        for (_, pass) in pm
+            .passes
+            .iter()
+            .filter(|(pass_point, _)| *pass_point == point)
+        {
+            match pass {
+                Pass::Native(pass) => {
+                    native_state.run(*pass, point, dag, target, layout, approximation_degree)?
+                }
+                Pass::Callback(callback, data) => {
+                    // SAFETY: Per the documentation of `qk_pass_manager_add_pass`, the callback
+                    // and its data are valid for the duration of the run.
+                    let code = unsafe { callback(dag, target, layout, *data) };
+                    if code != ExitCode::Success {
+                        return Err(CallbackError { point, code }.into());
+                    }
+                }
+            }
+        }
+        Ok(())
+    };
+
+    match transpile_with_passes(
+        qc,
+        target,
+        pm.options.optimization_level(),
+        approximation_degree,
+        pm.options.seed(),
+        &mut run_passes,
+    ) {
+        Ok((circuit, layout)) => {
+            // SAFETY: Per documentation, result is a valid pointer to a QkTranspileResult.
+            unsafe {
+                *result = TranspileResult {
+                    circuit: Box::into_raw(Box::new(circuit)),
+                    layout: Box::into_raw(Box::new(layout)),
+                };
+            }
+            ExitCode::Success
+        }
+        Err(e) => match e.downcast::<CallbackError>() {
+            Ok(e) => {
+                write_error(e.to_string());
+                e.code
+            }
+            Err(e) => {
+                // As for `qk_transpile`, return a backtrace of the error until Rust errors are
+                // normalized into user facing messages.
+                write_error(format!(
+                    "Transpilation failed with this backtrace: {}",
+                    e.backtrace()
+                ));
+                ExitCode::TranspilerError
+            }
+        },
+    }
+}
+
+/// @ingroup QkPassManager
+/// Free a pass manager.
+///
+/// @param pm A pointer to the pass manager to free.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``pm`` is not a valid pointer to a ``QkPassManager`` or ``NULL``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_pass_manager_free(pm: *mut PassManager) {
+    if !pm.is_null() {
+        if !pm.is_aligned() {
+            panic!("Attempted to free a non-aligned pointer.")
+        }
+        // SAFETY: We have verified the pointer is non-null and aligned, so it should be
+        // readable by Box.
+        unsafe {
+            let _ = Box::from_raw(pm);
+        }
+    }
+}
@@ -21,8 +21,10 @@ pub mod litinski_transformation;
 pub mod optimize_1q_sequences;
 pub mod remove_diagonal_gates_before_measure;
 pub mod remove_identity_equiv;
+pub mod restore_final_layout;
 pub mod sabre_layout;
 pub mod split_2q_unitaries;
+pub mod template_optimization;
 pub mod two_qubit_peephole;
 pub mod unitary_synthesis;
 pub mod vf2;
@@ -0,0 +1,139 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+use crate::exit_codes::ExitCode;
+use crate::pointers::{const_ptr_as_ref, mut_ptr_as_ref};
+
+use qiskit_circuit::circuit_data::CircuitData;
+use qiskit_circuit::dag_circuit::DAGCircuit;
+use qiskit_transpiler::passes::{TokenSwappingError, run_restore_final_layout};
+use qiskit_transpiler::target::Target;
+use qiskit_transpiler::transpile_layout::TranspileLayout;
+
+fn exit_code(result: Result<usize, TokenSwappingError>) -> ExitCode {
+    match result {
+        Ok(_) => ExitCode::Success,
+        Err(TokenSwappingError::Dag(_)) => ExitCode::DagError,
+        Err(_) => ExitCode::TranspilerError,
+    }
+}
+
+/// @ingroup QkTranspilerPassesStandalone
+/// Run the ``RestoreFinalLayout`` pass on a circuit.
+///
+/// Refer to the ``qk_transpiler_pass_restore_final_layout`` function for more details about the
+/// pass. The swaps are added as ``QkGate_Swap`` gates, so translate the circuit again afterwards
+/// if the target does not support swaps natively. Within ``qk_pass_manager_run``, add
+/// ``QkNativePass_RestoreFinalLayout`` after routing instead, so that the swaps are translated
+/// with the rest of the circuit.
+///
+/// @param circuit A pointer to the physical circuit to append the swaps to.
+/// @param target A pointer to the target the circuit was routed for.
+/// @param layout A pointer to the layout of ``circuit``. Its output permutation is updated to
+///     account for the added swaps.
+/// @param trials The number of randomized trials of the token swapping search.
+/// @param seed The seed of the search. If negative, the search is seeded from system entropy.
+///
+/// @return ``QkExitCode_Success`` on success, or ``QkExitCode_TranspilerError`` if the
+///     permutation cannot be implemented on the target, for example because the coupling graph
+///     is disconnected or the widths of the circuit and target differ.
+///
+/// # Example
+///
+/// ```c
+/// QkTranspileResult result;
+/// qk_transpile(circuit, target, NULL, &result, NULL);
+/// qk_transpiler_pass_standalone_restore_final_layout(result.circuit, target, result.layout, 8, 42);
+/// // Translate the added swaps to the gates of the target.
+/// qk_transpiler_pass_standalone_basis_translator(result.circuit, target, 0);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``circuit``, ``target`` or ``layout`` are not valid, non-null
+/// pointers to a ``QkCircuit``, ``QkTarget`` and ``QkTranspileLayout`` respectively.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_transpiler_pass_standalone_restore_final_layout(
+    circuit: *mut CircuitData,
+    target: *const Target,
+    layout: *mut TranspileLayout,
+    trials: u32,
+    seed: i64,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointers are non-null and aligned.
+    let circuit = unsafe { mut_ptr_as_ref(circuit) };
+    let target = unsafe { const_ptr_as_ref(target) };
+    let layout = unsafe { mut_ptr_as_ref(layout) };
+
+    let mut dag = DAGCircuit::from_circuit_data(circuit, false, None, None, None, None)
+        .expect("Circuit to DAG conversion failed");
+    let seed = (seed >= 0).then_some(seed as u64);
+    let result = run_restore_final_layout(&mut dag, target, layout, trials as usize, seed);
+    if matches!(result, Ok(num_swaps) if num_swaps > 0) {
+        *circuit = CircuitData::from_dag_ref(&dag).expect("DAG to circuit conversion failed");
+    }
+    exit_code(result)
+}
+
+/// @ingroup QkTranspilerPasses
+/// Run the ``RestoreFinalLayout`` pass on a DAG.
+///
+/// After routing, the qubits of a physical circuit generally end on different physical qubits
+/// than they started on, which is tracked by the output permutation of its layout. This pass
+/// appends swaps between coupled qubits of the target that undo the output permutation, so
+/// that every qubit ends on the physical qubit it started on.
+///
+/// The swaps are found with an approximate token swapping algorithm on the coupling graph of
+/// the target, keeping the best of ``trials`` randomized trials, which run in parallel on
+/// large targets. The swap sequences are cached by coupling graph, moved qubits, ``trials``
+/// and ``seed``, so that restoring the same final layout again, for example across a batch of
+/// circuits, is immediate. The swaps are added as ``QkGate_Swap`` gates, so this pass should run
+/// before the translation stage if the target does not support swaps natively. The pass is
+/// available to ``qk_pass_manager_run`` as ``QkNativePass_RestoreFinalLayout``.
+///
+/// @param dag A pointer to the physical DAG to append the swaps to.
+/// @param target A pointer to the target the DAG was routed for.
+/// @param layout A pointer to the layout of ``dag``. Its output permutation is updated to account
+///     for the added swaps.
+/// @param trials The number of randomized trials of the token swapping search.
+/// @param seed The seed of the search. If negative, the search is seeded from system entropy.
+///
+/// @return ``QkExitCode_Success`` on success, or ``QkExitCode_TranspilerError`` if the
+///     permutation cannot be implemented on the target, for example because the coupling graph
+///     is disconnected or the widths of the DAG and target differ.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``dag``, ``target`` or ``layout`` are not valid, non-null pointers to
+/// a ``QkDag``, ``QkTarget`` and ``QkTranspileLayout`` respectively.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_transpiler_pass_restore_final_layout(
+    dag: *mut DAGCircuit,
+    target: *const Target,
+    layout: *mut TranspileLayout,
+    trials: u32,
+    seed: i64,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointers are non-null and aligned.
+    let dag = unsafe { mut_ptr_as_ref(dag) };
+    let target = unsafe { const_ptr_as_ref(target) };
+    let layout = unsafe { mut_ptr_as_ref(layout) };
+
+    let seed = (seed >= 0).then_some(seed as u64);
+    exit_code(run_restore_final_layout(
+        dag,
+        target,
+        layout,
+        trials as usize,
+        seed,
+    ))
+}
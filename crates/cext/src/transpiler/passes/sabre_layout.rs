@@ -18,10 +18,10 @@ use rand_pcg::Pcg64Mcg;
 use qiskit_circuit::circuit_data::CircuitData;
 use qiskit_circuit::dag_circuit::DAGCircuit;
 use qiskit_circuit::{PhysicalQubit, Qubit};
-use qiskit_transpiler::passes::sabre::heuristic;
 use qiskit_transpiler::passes::sabre::sabre_layout_and_routing;
 use qiskit_transpiler::target::Target;
 use qiskit_transpiler::transpile_layout::TranspileLayout;
+use qiskit_transpiler::transpiler::get_windowed_sabre_heuristic;
 
 /// The options for running ``qk_transpiler_pass_standalone_sabre_layout``. This struct is used
 /// as an input to control the behavior of the layout and routing algorithms.
@@ -38,13 +38,22 @@ pub struct SabreLayoutOptions {
     num_random_trials: usize,
     /// A seed value for the pRNG used internally.
     seed: u64,
+    /// The number of lookahead layers (the "extended set") considered by the routing heuristic
+    /// beyond the front layer. Set this to 0 to have the number of layers scale with the number of
+    /// qubits in the target, which is typically a better choice for devices with many hundreds of
+    /// qubits. Must be less than 65,536.
+    lookahead_layers: u32,
+    /// The multiplicative factor applied to the heuristic weight of each successive lookahead
+    /// layer. Must be in the range ``(0, 1]``; a value of 1 weights all lookahead layers equally.
+    lookahead_decay: f64,
 }
 
 /// @ingroup QkSabreLayoutOptions
 ///
 /// Build a default sabre layout options object. This builds a sabre layout with ``max_iterations``
-/// set to 4, both ``num_swap_trials`` and ``num_random_trials`` set to 20, and the seed selected
-/// by a RNG seeded from system entropy.
+/// set to 4, both ``num_swap_trials`` and ``num_random_trials`` set to 20, the seed selected
+/// by a RNG seeded from system entropy, and a single lookahead layer (``lookahead_layers`` set to
+/// 1 and ``lookahead_decay`` set to 1.0).
 ///
 /// @return A ``QkSabreLayoutOptions`` object with default settings.
 #[unsafe(no_mangle)]
@@ -54,6 +63,8 @@ pub extern "C" fn qk_sabre_layout_options_default() -> SabreLayoutOptions {
         num_swap_trials: 20,
         num_random_trials: 20,
         seed: Pcg64Mcg::try_from_rng(&mut SysRng).unwrap().random(),
+        lookahead_layers: 1,
+        lookahead_decay: 1.0,
     }
 }
 
@@ -99,7 +110,8 @@ pub extern "C" fn qk_sabre_layout_options_default() -> SabreLayoutOptions {
 /// @param options A pointer to the options for SabreLayout
 ///
 /// @return The transpile layout that describes the layout and output permutation caused
-///     by the pass
+///     by the pass, or ``NULL`` if ``lookahead_layers`` is 65,536 or more or ``lookahead_decay``
+///     is outside ``(0, 1]``, in which case the circuit is left unchanged.
 ///
 /// # Safety
 ///
@@ -114,24 +126,21 @@ pub unsafe extern "C" fn qk_transpiler_pass_standalone_sabre_layout(
     let circuit = unsafe { mut_ptr_as_ref(circuit) };
     let target = unsafe { const_ptr_as_ref(target) };
     let options = unsafe { const_ptr_as_ref(options) };
+    // Invalid options are reported with a null pointer rather than a panic across the FFI.
+    let lookahead_layers = match options.lookahead_layers {
+        0 => None,
+        layers => match u16::try_from(layers) {
+            Ok(layers) => Some(layers),
+            Err(_) => return std::ptr::null_mut(),
+        },
+    };
+    let Ok(heuristic) =
+        get_windowed_sabre_heuristic(target, lookahead_layers, options.lookahead_decay)
+    else {
+        return std::ptr::null_mut();
+    };
     let mut dag = DAGCircuit::from_circuit_data(circuit, false, None, None, None, None)
         .unwrap_or_else(|_| panic!("Internal circuit to DAG conversion failed."));
-    let heuristic = heuristic::Heuristic::new(
-        Some(heuristic::BasicHeuristic::new(
-            1.0,
-            heuristic::SetScaling::Constant,
-        )),
-        Some(
-            heuristic::LookaheadHeuristic::new(
-                vec![0.5 / target.num_qubits.unwrap_or(20) as f64],
-                heuristic::SetScaling::Constant,
-            )
-            .expect("number of layers should be valid"),
-        ),
-        Some(heuristic::DecayHeuristic::new(0.001, 5)),
-        Some(10 * target.num_qubits.unwrap() as usize),
-        1e-10,
-    );
     let (result, initial_layout, final_layout) = sabre_layout_and_routing(
         &mut dag,
         target,
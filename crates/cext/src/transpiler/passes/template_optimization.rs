@@ -0,0 +1,229 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+use crate::exit_codes::ExitCode;
+use crate::pointers::{const_ptr_as_ref, mut_ptr_as_ref};
+
+use qiskit_circuit::circuit_data::CircuitData;
+use qiskit_circuit::dag_circuit::DAGCircuit;
+use qiskit_transpiler::passes::{TemplateLibrary, run_template_optimization};
+
+/// @ingroup QkTemplateLibrary
+/// Create a new, empty template library.
+///
+/// @return A pointer to the new library, which must be freed with ``qk_template_library_free``.
+///
+/// # Example
+///
+/// ```c
+///     QkTemplateLibrary *library = qk_template_library_new();
+/// ```
+#[unsafe(no_mangle)]
+pub extern "C" fn qk_template_library_new() -> *mut TemplateLibrary {
+    Box::into_raw(Box::new(TemplateLibrary::default()))
+}
+
+/// @ingroup QkTemplateLibrary
+/// Add a template to a template library.
+///
+/// A template is a circuit that is equivalent to the identity, up to a global phase. It must only
+/// contain standard gates with numeric parameters, and act on at most 10 qubits. The template is
+/// copied into the library, so ``template`` can be freed or modified afterwards.
+///
+/// @param library A pointer to the library to add the template to.
+/// @param template A pointer to the template circuit.
+///
+/// @return ``QkExitCode_Success`` on success, or ``QkExitCode_CInputError`` if the template
+///     contains unsupported instructions, has too many qubits or is not equivalent to the
+///     identity. The library is unchanged on error.
+///
+/// # Example
+///
+/// ```c
+///     QkTemplateLibrary *library = qk_template_library_new();
+///     QkCircuit *template = qk_circuit_new(2, 0);
+///     qk_circuit_gate(template, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+///     qk_circuit_gate(template, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+///     qk_template_library_add(library, template);
+///     qk_circuit_free(template);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``library`` or ``template`` are not valid, non-null pointers to a
+/// ``QkTemplateLibrary`` and ``QkCircuit`` respectively.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_template_library_add(
+    library: *mut TemplateLibrary,
+    template: *const CircuitData,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointers are non-null and aligned.
+    let library = unsafe { mut_ptr_as_ref(library) };
+    let template = unsafe { const_ptr_as_ref(template) };
+    match library.add_template(template) {
+        Ok(()) => ExitCode::Success,
+        Err(_) => ExitCode::CInputError,
+    }
+}
+
+/// @ingroup QkTemplateLibrary
+/// Get the number of templates in a template library.
+///
+/// @param library A pointer to the library.
+///
+/// @return The number of templates successfully added to the library.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``library`` is not a valid, non-null pointer to a
+/// ``QkTemplateLibrary``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_template_library_num_templates(
+    library: *const TemplateLibrary,
+) -> usize {
+    // SAFETY: Per documentation, the pointer is non-null and aligned.
+    let library = unsafe { const_ptr_as_ref(library) };
+    library.num_templates()
+}
+
+/// @ingroup QkTemplateLibrary
+/// Free a template library.
+///
+/// @param library A pointer to the library to free.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``library`` is not a valid pointer to a ``QkTemplateLibrary`` or
+/// ``NULL``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_template_library_free(library: *mut TemplateLibrary) {
+    if !library.is_null() {
+        if !library.is_aligned() {
+            panic!("Attempted to free a non-aligned pointer.")
+        }
+        // SAFETY: We have verified the pointer is non-null and aligned, so it should be
+        // readable by Box.
+        unsafe {
+            let _ = Box::from_raw(library);
+        }
+    }
+}
+
+/// @ingroup QkTranspilerPassesStandalone
+/// Run the template optimization pass on a circuit.
+///
+/// Refer to the ``qk_transpiler_pass_template_optimization`` function for more details about the
+/// pass.
+///
+/// @param circuit A pointer to the circuit to optimize. If any match is replaced, the original
+///     circuit is replaced by the optimized circuit.
+/// @param library A pointer to the templates to match.
+/// @param num_replaced A pointer to write the number of replaced matches to, or ``NULL``.
+///
+/// @return ``QkExitCode_Success`` on success, or ``QkExitCode_TranspilerError`` if the matches
+///     could not be replaced, in which case the circuit is unchanged and nothing is written to
+///     ``num_replaced``.
+///
+/// # Example
+///
+/// ```c
+///     QkCircuit *qc = qk_circuit_new(2, 0);
+///     for (int i = 0; i < 3; i++) {
+///         qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+///     }
+///     // With the CX-CX template of the ``qk_template_library_add`` example, this leaves
+///     // a single CX gate.
+///     size_t num_replaced;
+///     qk_transpiler_pass_standalone_template_optimization(qc, library, &num_replaced);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``circuit`` or ``library`` are not valid, non-null pointers to a
+/// ``QkCircuit`` and ``QkTemplateLibrary`` respectively, or if ``num_replaced`` is not ``NULL``
+/// or an aligned pointer that is writeable for a ``size_t``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_transpiler_pass_standalone_template_optimization(
+    circuit: *mut CircuitData,
+    library: *const TemplateLibrary,
+    num_replaced: *mut usize,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointers are non-null and aligned.
+    let circuit = unsafe { mut_ptr_as_ref(circuit) };
+    let library = unsafe { const_ptr_as_ref(library) };
+
+    let mut dag = DAGCircuit::from_circuit_data(circuit, false, None, None, None, None)
+        .expect("Internal circuit -> DAG conversion failed");
+    let Ok(replaced) = run_template_optimization(&mut dag, library) else {
+        return ExitCode::TranspilerError;
+    };
+    if replaced > 0 {
+        *circuit =
+            CircuitData::from_dag_ref(&dag).expect("Internal DAG -> circuit conversion failed");
+    }
+    if !num_replaced.is_null() {
+        // SAFETY: Per documentation, the pointer is aligned and writeable.
+        unsafe { num_replaced.write(replaced) };
+    }
+    ExitCode::Success
+}
+
+/// @ingroup QkTranspilerPasses
+/// Run the template optimization pass on a DAG.
+///
+/// Each template of ``library`` is equivalent to the identity, so any part of it, taken in cyclic
+/// order, is equivalent to the inverse of the rest of the template. This pass replaces every part
+/// of a template found in the DAG by the inverse of the rest, when that has fewer multi-qubit
+/// gates, or as many multi-qubit gates and fewer gates in total.
+///
+/// The parts are indexed by their first gate, and parts containing more qubits or more gates of
+/// any kind than the DAG are skipped, so large libraries can be matched against large circuits.
+/// The gates of a part on each qubit must be consecutive on the wires of the DAG, so gates are not
+/// moved through commuting gates to find matches. The matches starting at each gate are searched
+/// in parallel for large DAGs, and all replacements are done in a single rebuild of the DAG.
+///
+/// This pass is not part of the optimization stage of ``qk_transpile``, as the preset pass managers
+/// of Qiskit do not run template optimization and there is no default library of templates. To
+/// run it within the preset pipelines, call it from a ``QkPassManager`` pass added at
+/// ``QkPassInsertionPoint_OptimizationLoop``, passing the library as the pass data.
+///
+/// @param dag A pointer to the DAG to optimize.
+/// @param library A pointer to the templates to match.
+/// @param num_replaced A pointer to write the number of replaced matches to, or ``NULL``.
+///
+/// @return ``QkExitCode_Success`` on success, or ``QkExitCode_TranspilerError`` if the matches
+///     could not be replaced, in which case the DAG is unchanged and nothing is written to
+///     ``num_replaced``.
+///
+/// # Safety
+///
+/// Behavior is undefined if ``dag`` or ``library`` are not valid, non-null pointers to a
+/// ``QkDag`` and ``QkTemplateLibrary`` respectively, or if ``num_replaced`` is not ``NULL`` or an
+/// aligned pointer that is writeable for a ``size_t``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_transpiler_pass_template_optimization(
+    dag: *mut DAGCircuit,
+    library: *const TemplateLibrary,
+    num_replaced: *mut usize,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointers are non-null and aligned.
+    let dag = unsafe { mut_ptr_as_ref(dag) };
+    let library = unsafe { const_ptr_as_ref(library) };
+    let Ok(replaced) = run_template_optimization(dag, library) else {
+        return ExitCode::TranspilerError;
+    };
+    if !num_replaced.is_null() {
+        // SAFETY: Per documentation, the pointer is aligned and writeable.
+        unsafe { num_replaced.write(replaced) };
+    }
+    ExitCode::Success
+}
@@ -16,13 +16,16 @@ use std::ptr::null_mut;
 use qiskit_circuit::circuit_data::CircuitData;
 use qiskit_circuit::dag_circuit::DAGCircuit;
 use qiskit_transpiler::commutation_checker::get_standard_commutation_checker;
-use qiskit_transpiler::passes::{UnitarySynthesisConfig, UnitarySynthesisState, unitary_synthesis};
+use qiskit_transpiler::passes::{
+    DynamicalDecoupling, UnitarySynthesisConfig, UnitarySynthesisState, unitary_synthesis,
+};
 use qiskit_transpiler::standard_equivalence_library::generate_standard_equivalence_library;
 use qiskit_transpiler::target::Target;
 use qiskit_transpiler::transpile;
 use qiskit_transpiler::transpile_layout::TranspileLayout;
 use qiskit_transpiler::transpiler::{
-    LayoutSource, get_sabre_heuristic, init_stage, layout_stage, optimization_stage, routing_stage,
+    LayoutSource, OptimizationLevel, SchedulingConfig, SchedulingMethod, get_sabre_heuristic,
+    init_stage, layout_stage, optimization_stage, routing_stage, scheduling_stage,
     translation_stage,
 };
 
@@ -43,9 +46,9 @@ use crate::pointers::{const_ptr_as_ref, mut_ptr_as_ref};
 #[repr(C)]
 pub struct TranspileResult {
     /// The compiled circuit.
-    circuit: *mut CircuitData,
+    pub(crate) circuit: *mut CircuitData,
     /// Metadata about the initial and final virtual-to-physical layouts.
-    layout: *mut TranspileLayout,
+    pub(crate) layout: *mut TranspileLayout,
 }
 
 /// A container collecting individual attributes shared by the transpiler stages.
@@ -165,6 +168,7 @@ pub unsafe extern "C" fn qk_transpile_state_layout_set(
 
 /// The options for running the transpiler
 #[repr(C)]
+#[derive(Clone, Copy)]
 pub struct TranspileOptions {
     /// The optimization level to run the transpiler with. Valid values are 0, 1, 2, or 3.
     optimization_level: u8,
@@ -187,6 +191,43 @@ impl Default for TranspileOptions {
     }
 }
 
+impl TranspileOptions {
+    /// The optimization level, panicking if it is not valid.
+    pub(crate) fn optimization_level(&self) -> OptimizationLevel {
+        if !(0..=3u8).contains(&self.optimization_level) {
+            panic!(
+                "Invalid optimization level specified {}",
+                self.optimization_level
+            );
+        }
+        self.optimization_level.into()
+    }
+
+    /// The seed, or `None` if the RNGs should be seeded from system entropy.
+    pub(crate) fn seed(&self) -> Option<u64> {
+        if self.seed < 0 {
+            None
+        } else {
+            Some(self.seed as u64)
+        }
+    }
+
+    /// The approximation degree, or `None` to approximate up to the error rates in the target.
+    /// Panics if the approximation degree is not valid.
+    pub(crate) fn approximation_degree(&self) -> Option<f64> {
+        if self.approximation_degree.is_nan() {
+            None
+        } else {
+            if !(0.0..=1.0).contains(&self.approximation_degree) {
+                panic!(
+                    "Invalid value provided for approximation degree, only NAN or values between 0.0 and 1.0 inclusive are valid"
+                );
+            }
+            Some(self.approximation_degree)
+        }
+    }
+}
+
 /// @ingroup QkTranspiler
 ///
 /// Generate transpiler options defaults
@@ -877,6 +918,210 @@ pub unsafe extern "C" fn qk_transpile_stage_layout(
     }
 }
 
+/// The method used to choose the start time of each instruction when scheduling a circuit.
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum CSchedulingMethod {
+    /// Start every instruction as late as possible.
+    Alap = 0,
+    /// Start every instruction as soon as possible.
+    Asap = 1,
+}
+
+/// The dynamical-decoupling sequence inserted into idle windows when scheduling a circuit.
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum CDynamicalDecoupling {
+    /// Fill idle windows with delays only.
+    None = 0,
+    /// Two ``X`` gates.
+    XX = 1,
+    /// The four-pulse ``X``-``Y``-``X``-``Y`` sequence.
+    XY4 = 2,
+}
+
+/// The options for the scheduling stage of the transpiler.
+#[repr(C)]
+pub struct SchedulingOptions {
+    /// The ``QkSchedulingMethod`` used to choose the start time of each instruction.
+    method: u8,
+    /// The ``QkDynamicalDecoupling`` sequence to insert into idle windows on each qubit.
+    /// Sequences are only inserted where the target supports all of their gates on the qubit and
+    /// they fit in the window with every gate aligned to the target's ``pulse_alignment``; any
+    /// other idle time is filled with a delay.
+    dynamical_decoupling: u8,
+    /// The latency, in units of ``dt``, between the start of a measurement and the write to its
+    /// classical bit.
+    clbit_write_latency: u32,
+}
+
+impl Default for SchedulingOptions {
+    fn default() -> Self {
+        SchedulingOptions {
+            method: CSchedulingMethod::Alap as u8,
+            dynamical_decoupling: CDynamicalDecoupling::None as u8,
+            clbit_write_latency: 0,
+        }
+    }
+}
+
+impl SchedulingOptions {
+    /// The scheduling method, or `None` if the field does not hold a ``QkSchedulingMethod``.
+    fn method(&self) -> Option<SchedulingMethod> {
+        match self.method {
+            x if x == CSchedulingMethod::Alap as u8 => Some(SchedulingMethod::Alap),
+            x if x == CSchedulingMethod::Asap as u8 => Some(SchedulingMethod::Asap),
+            _ => None,
+        }
+    }
+
+    /// The dynamical-decoupling sequence, or `None` if the field does not hold a
+    /// ``QkDynamicalDecoupling``.
+    fn dynamical_decoupling(&self) -> Option<Option<DynamicalDecoupling>> {
+        match self.dynamical_decoupling {
+            x if x == CDynamicalDecoupling::None as u8 => Some(None),
+            x if x == CDynamicalDecoupling::XX as u8 => Some(Some(DynamicalDecoupling::XX)),
+            x if x == CDynamicalDecoupling::XY4 as u8 => Some(Some(DynamicalDecoupling::XY4)),
+            _ => None,
+        }
+    }
+}
+
+/// @ingroup QkTranspiler
+/// Generate the default options for the scheduling stage of the transpiler.
+///
+/// This currently is as-late-as-possible scheduling, with no dynamical decoupling and no clbit
+/// write latency.
+///
+/// @return A ``QkSchedulingOptions`` object with default settings.
+#[unsafe(no_mangle)]
+pub extern "C" fn qk_transpiler_default_scheduling_options() -> SchedulingOptions {
+    SchedulingOptions::default()
+}
+
+/// @ingroup QkTranspiler
+/// Run the scheduling stage of the transpiler on a circuit
+///
+/// This function schedules a circuit that has already been transpiled for the target, so it
+/// must be defined over the target's physical qubits and contain only instructions the target
+/// supports. Every instruction is assigned a start time, using the durations of the
+/// instructions in the target in units of ``dt``, and its ``pulse_alignment`` and
+/// ``acquire_alignment`` constraints. As in the Python ``ConstrainedReschedule`` pass, gates start
+/// on multiples of ``pulse_alignment`` and both measurements and resets on multiples of
+/// ``acquire_alignment``. All idle time on every qubit is then made explicit with
+/// ``delay`` instructions (in units of ``dt``) or dynamical-decoupling sequences, so the
+/// resulting circuit encodes its own timing. You can refer to
+/// @verbatim embed:rst:inline :ref:`transpiler-preset-stage-scheduling` @endverbatim for more
+/// details.
+///
+/// This function should only be used with circuits constructed
+/// using Qiskit's C API. It makes assumptions on the circuit only using features exposed via C,
+/// if you are in a mixed Python and C environment it is typically better to invoke the transpiler
+/// via Python.
+///
+/// @param dag A pointer to the circuit to schedule.
+/// @param target A pointer to the target to schedule the circuit for. The target must define
+///   ``dt`` and the duration of every instruction in the circuit.
+/// @param options A pointer to an options object that defines user options. If this is a null
+///   pointer the default values will be used. See ``qk_transpiler_default_scheduling_options``
+///   for more details on the default values.
+/// @param duration A pointer to write the total duration of the scheduled circuit to, in units
+///   of ``dt``. This can be a null pointer in which case the duration will not be written out.
+/// @param error A pointer to a pointer with an nul terminated string with an error description.
+///   If the transpiler fails a pointer to the string with the error description will be written
+///   to this pointer. That pointer needs to be freed with ``qk_str_free``. This can be a null
+///   pointer in which case the error will not be written out.
+///
+/// @returns The return code for the transpiler, ``QkExitCode_Success`` means success and all
+///   other values indicate an error. ``QkExitCode_CInputError`` is returned if ``options`` holds
+///   a ``method`` or ``dynamical_decoupling`` that is not a valid ``QkSchedulingMethod`` or
+///   ``QkDynamicalDecoupling``.
+///
+/// # Example
+///
+/// ```c
+///     QkSchedulingOptions options = qk_transpiler_default_scheduling_options();
+///     options.dynamical_decoupling = QkDynamicalDecoupling_XX;
+///     uint64_t duration;
+///     qk_transpile_stage_scheduling(dag, target, &options, &duration, NULL);
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``dag`` and ``target`` are not valid, non-null
+/// pointers to a ``QkDag``, ``QkTarget`` respectively. ``options`` must be a valid pointer a to
+/// a ``QkSchedulingOptions`` or ``NULL``. ``duration`` must be a valid pointer to a ``uint64_t``
+/// or ``NULL``. ``error`` must be a valid pointer to a ``char`` pointer or ``NULL``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_transpile_stage_scheduling(
+    dag: *mut DAGCircuit,
+    target: *const Target,
+    options: *const SchedulingOptions,
+    duration: *mut u64,
+    error: *mut *mut c_char,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointer is non-null and aligned.
+    let dag = unsafe { mut_ptr_as_ref(dag) };
+    let target = unsafe { const_ptr_as_ref(target) };
+    let options = if options.is_null() {
+        &SchedulingOptions::default()
+    } else {
+        // SAFETY: We checked the pointer is not null, then, per documentation, it is a valid
+        // and aligned pointer.
+        unsafe { const_ptr_as_ref(options) }
+    };
+    let (Some(method), Some(dynamical_decoupling)) =
+        (options.method(), options.dynamical_decoupling())
+    else {
+        if !error.is_null() {
+            // SAFETY: Per documentation, error is a valid pointer to a char pointer (and we
+            // checked it's not NULL).
+            unsafe {
+                *error = CString::new(format!(
+                    "Invalid scheduling options: method {}, dynamical decoupling {}",
+                    options.method, options.dynamical_decoupling
+                ))
+                .unwrap()
+                .into_raw();
+            }
+        }
+        return ExitCode::CInputError;
+    };
+    let config = SchedulingConfig {
+        method,
+        dynamical_decoupling,
+        clbit_write_latency: options.clbit_write_latency as u64,
+    };
+
+    match scheduling_stage(dag, target, &config) {
+        Ok(total) => {
+            if !duration.is_null() {
+                // SAFETY: Per documentation, duration is a valid pointer to a u64 (and we checked
+                // it's not NULL).
+                unsafe { *duration = total };
+            }
+            ExitCode::Success
+        }
+        Err(e) => {
+            if !error.is_null() {
+                unsafe {
+                    // Right now we return a backtrace of the error. This at least gives a hint as to
+                    // which pass failed when we have rust errors normalized we can actually have error
+                    // messages which are user facing. But most likely this will be a PyErr and panic
+                    // when trying to extract the string.
+                    *error = CString::new(format!(
+                        "Transpilation failed with this backtrace: {}",
+                        e.backtrace()
+                    ))
+                    .unwrap()
+                    .into_raw();
+                }
+            }
+            ExitCode::TranspilerError
+        }
+    }
+}
+
 /// @ingroup QkTranspiler
 /// Transpile a single circuit.
 ///
@@ -935,28 +1180,9 @@ pub unsafe extern "C" fn qk_transpile(
         unsafe { const_ptr_as_ref(options) }
     };
 
-    if !(0..=3u8).contains(&options.optimization_level) {
-        panic!(
-            "Invalid optimization level specified {}",
-            options.optimization_level
-        );
-    }
-
-    let seed = if options.seed < 0 {
-        None
-    } else {
-        Some(options.seed as u64)
-    };
-    let approximation_degree = if options.approximation_degree.is_nan() {
-        None
-    } else {
-        if !(0.0..=1.0).contains(&options.approximation_degree) {
-            panic!(
-                "Invalid value provided for approximation degree, only NAN or values between 0.0 and 1.0 inclusive are valid"
-            );
-        }
-        Some(options.approximation_degree)
-    };
+    let optimization_level = options.optimization_level();
+    let seed = options.seed();
+    let approximation_degree = options.approximation_degree();
 
     if let Some(target_qubits) = target.num_qubits
         && target_qubits < qc.num_qubits() as u32
@@ -975,13 +1201,7 @@ pub unsafe extern "C" fn qk_transpile(
         return ExitCode::TranspilerError;
     }
 
-    match transpile(
-        qc,
-        target,
-        options.optimization_level.into(),
-        approximation_degree,
-        seed,
-    ) {
+    match transpile(qc, target, optimization_level, approximation_degree, seed) {
         Ok(transpile_result) => {
             unsafe {
                 *result = TranspileResult {
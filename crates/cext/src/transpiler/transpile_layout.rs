@@ -10,9 +10,14 @@
 // copyright notice, and modified files need to carry a notice indicating
 // that they have been altered from the originals.
 
-use crate::pointers::const_ptr_as_ref;
+use crate::exit_codes::ExitCode;
+use crate::pointers::{const_ptr_as_ref, mut_ptr_as_ref};
+use qiskit_circuit::circuit_data::CircuitData;
 use qiskit_circuit::dag_circuit::DAGCircuit;
 use qiskit_circuit::nlayout::{NLayout, PhysicalQubit};
+use qiskit_transpiler::equivalence_check::{
+    Equivalence, EquivalenceCheckOptions, check_transpiled_equivalence,
+};
 use qiskit_transpiler::target::Target;
 use qiskit_transpiler::transpile_layout::TranspileLayout;
 
@@ -20,8 +25,6 @@ use qiskit_transpiler::transpile_layout::TranspileLayout;
 use pyo3::Python;
 #[cfg(feature = "python_binding")]
 use pyo3::ffi::PyObject;
-#[cfg(feature = "python_binding")]
-use qiskit_circuit::circuit_data::CircuitData;
 
 /// @ingroup QkTranspileLayout
 /// Return the number of qubits in the input circuit to the transpiler.
@@ -298,6 +301,188 @@ pub unsafe extern "C" fn qk_transpile_layout_free(layout: *mut TranspileLayout)
     }
 }
 
+/// The outcome of an equivalence check.
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum CEquivalence {
+    /// The circuits are equivalent, exactly or on every fingerprint tried.
+    Equivalent = 0,
+    /// The circuits are not equivalent.
+    NotEquivalent = 1,
+    /// Some fingerprints grew beyond the term limit and the circuits are too large to simulate,
+    /// while every other fingerprint matched, or no fingerprints were requested for circuits that
+    /// are not Clifford.
+    Inconclusive = 2,
+}
+
+/// The options for checking the equivalence of a circuit and its transpiled output.
+#[repr(C)]
+pub struct EquivCheckOptions {
+    /// The number of random fingerprints to compare non-Clifford circuits on. The fingerprints
+    /// are distinct, and if there are at least as many trials as the ``3n`` single-qubit Pauli
+    /// observables on the ``n`` output qubits, every one of them is tried. If zero, circuits that
+    /// are not Clifford are not compared and the outcome is ``QkEquivalence_Inconclusive``.
+    num_trials: u32,
+    /// The seed of the first fingerprint, from which the others are generated. If negative, the
+    /// seed is sourced from system entropy.
+    seed: i64,
+    /// The largest number of Pauli terms a fingerprint may grow to before it is abandoned.
+    max_terms: usize,
+}
+
+impl Default for EquivCheckOptions {
+    fn default() -> Self {
+        let options = EquivalenceCheckOptions::default();
+        EquivCheckOptions {
+            num_trials: options.num_trials as u32,
+            seed: -1,
+            max_terms: options.max_terms,
+        }
+    }
+}
+
+/// The result of checking the equivalence of a circuit and its transpiled output.
+#[repr(C)]
+pub struct EquivCheckResult {
+    /// Whether the circuits are equivalent.
+    outcome: CEquivalence,
+    /// Whether the outcome is exact, which it is for Clifford circuits, rather than based on
+    /// random fingerprints.
+    exact: bool,
+    /// Whether ``counterexample_seed`` is set.
+    has_counterexample: bool,
+    /// The seed of a fingerprint on which the circuits differ. Checking again with this seed and
+    /// a single trial reproduces the failure.
+    counterexample_seed: u64,
+}
+
+/// @ingroup QkTranspileLayout
+/// Generate the default options for ``qk_transpile_layout_equiv_check``.
+///
+/// This currently is 128 fingerprints from a seed sourced from system entropy, each limited to
+/// 65536 Pauli terms.
+///
+/// @return A ``QkEquivCheckOptions`` object with default settings.
+#[unsafe(no_mangle)]
+pub extern "C" fn qk_equiv_check_options_default() -> EquivCheckOptions {
+    EquivCheckOptions::default()
+}
+
+/// @ingroup QkTranspileLayout
+/// Check that a transpiled circuit implements the same unitary as its input, up to a global
+/// phase.
+///
+/// The qubits of the input circuit start on the qubits of the output given by the initial layout
+/// of ``layout``, and must end on those given by its final layout. Any ancillas of the output
+/// start in, and must be returned to, the zero state.
+///
+/// Circuits made only of Clifford gates, including rotations by multiples of pi/2, are compared
+/// exactly through their stabilizer tableaus. Other circuits are compared on random fingerprints:
+/// a single-qubit Pauli observable on the output is propagated backwards through both circuits
+/// and the results are compared. This only involves the gates in the light cone of the
+/// observable, so it scales to circuits with many more qubits than can be simulated, and the
+/// fingerprints are checked in parallel. If a fingerprint grows beyond ``max_terms`` terms, the
+/// circuits are compared on their statevectors instead if they have at most 30 qubits, and the
+/// result is ``QkEquivalence_Inconclusive`` otherwise.
+///
+/// The fingerprints are drawn without replacement from the ``3n`` single-qubit Pauli observables
+/// on the ``n`` qubits of the output. If ``d`` of them catch a difference between the circuits,
+/// the probability that ``num_trials`` fingerprints all miss it is
+/// ``C(3n - d, num_trials) / C(3n, num_trials)``, which is at most
+/// ``(1 - d / 3n)^num_trials``. With ``num_trials >= 3n`` every observable is tried, and since
+/// two unitaries that differ by more than a global phase differ on at least one of them, no
+/// difference is missed.
+///
+/// @param input A pointer to the circuit that was transpiled.
+/// @param output A pointer to the transpiled circuit.
+/// @param layout A pointer to the layout of the transpilation. If ``NULL``, the circuits must have
+///     the same qubits.
+/// @param options A pointer to the options of the check. If ``NULL``, the defaults from
+///     ``qk_equiv_check_options_default`` are used.
+/// @param result A pointer to write the result of the check to.
+///
+/// @return An exit code, which is ``QkExitCode_MismatchedQubits`` if the numbers of qubits of the
+///     circuits don't match ``layout``, or each other without one, and
+///     ``QkExitCode_SimulationError`` if the circuits contain operations that are not unitary.
+///
+/// # Example
+/// ```c
+///     QkCircuit *circuit = ...;
+///     QkTarget *target = ...;
+///     QkTranspileResult transpiled;
+///     qk_transpile(circuit, target, NULL, &transpiled, NULL);
+///     QkEquivCheckOptions options = qk_equiv_check_options_default();
+///     options.seed = 42;
+///     QkEquivCheckResult result;
+///     qk_transpile_layout_equiv_check(circuit, transpiled.circuit, transpiled.layout, &options,
+///                                     &result);
+///     if (result.outcome == QkEquivalence_NotEquivalent && result.has_counterexample) {
+///         printf("Failed on seed %llu\n", (unsigned long long)result.counterexample_seed);
+///     }
+/// ```
+///
+/// # Safety
+///
+/// Behavior is undefined if ``input`` or ``output`` is not a valid, non-null pointer to a
+/// ``QkCircuit``, if ``layout`` or ``options`` is not either null or a valid pointer to a
+/// ``QkTranspileLayout`` or ``QkEquivCheckOptions`` respectively, or if ``result`` is not a valid,
+/// non-null pointer to a ``QkEquivCheckResult``.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn qk_transpile_layout_equiv_check(
+    input: *const CircuitData,
+    output: *const CircuitData,
+    layout: *const TranspileLayout,
+    options: *const EquivCheckOptions,
+    result: *mut EquivCheckResult,
+) -> ExitCode {
+    // SAFETY: Per documentation, the pointers are to valid data.
+    let input = unsafe { const_ptr_as_ref(input) };
+    let output = unsafe { const_ptr_as_ref(output) };
+    let result = unsafe { mut_ptr_as_ref(result) };
+    let layout = if layout.is_null() {
+        if input.num_qubits() != output.num_qubits() {
+            return ExitCode::MismatchedQubits;
+        }
+        None
+    } else {
+        // SAFETY: Per documentation, the non-null pointer is to valid data.
+        let layout = unsafe { const_ptr_as_ref(layout) };
+        if layout.num_input_qubits() as usize != input.num_qubits()
+            || layout.num_output_qubits() as usize != output.num_qubits()
+        {
+            return ExitCode::MismatchedQubits;
+        }
+        Some(layout)
+    };
+    let options = if options.is_null() {
+        &EquivCheckOptions::default()
+    } else {
+        // SAFETY: Per documentation, the non-null pointer is to valid data.
+        unsafe { const_ptr_as_ref(options) }
+    };
+    let options = EquivalenceCheckOptions {
+        num_trials: options.num_trials as usize,
+        seed: (options.seed >= 0).then_some(options.seed as u64),
+        max_terms: options.max_terms,
+    };
+    match check_transpiled_equivalence(input, output, layout, &options) {
+        Ok(report) => {
+            *result = EquivCheckResult {
+                outcome: match report.outcome {
+                    Equivalence::Equivalent => CEquivalence::Equivalent,
+                    Equivalence::NotEquivalent => CEquivalence::NotEquivalent,
+                    Equivalence::Inconclusive => CEquivalence::Inconclusive,
+                },
+                exact: report.exact,
+                has_counterexample: report.counterexample_seed.is_some(),
+                counterexample_seed: report.counterexample_seed.unwrap_or(0),
+            };
+            ExitCode::Success
+        }
+        Err(_) => ExitCode::SimulationError,
+    }
+}
+
 /// @ingroup QkTranspileLayout
 /// Generate a Python-space ``TranspileLayout`` object from a ``QkTranspileLayout``.
 ///
@@ -0,0 +1,1955 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+//! A compact, versioned binary layout of [CircuitData].
+//!
+//! The layout is meant for handing circuits between processes that share the same Qiskit build,
+//! such as through shared memory or a memory-mapped file.  It is not a replacement for QPY, which
+//! is the stable interchange format.
+//!
+//! All integers are little endian.  A buffer starts with a 16-byte header (the [MAGIC] bytes, the
+//! `u16` [VERSION], two reserved bytes, the `u32` number of sections and four reserved bytes),
+//! followed by a table with the `u64` byte offset and `u64` record count of each section.  Every
+//! section is an array of fixed-size records, so any record can be read in place from the buffer
+//! without parsing what comes before it.  The records refer to each other by `u32` index, with
+//! `u32::MAX` marking an absent value.
+//!
+//! The bits, registers and symbols of the circuit and all its control-flow blocks are stored once,
+//! in shared tables, so that blocks refer to the same bits as their outer circuit.  The first
+//! record of the circuit section is the outer circuit, and blocks always have a higher index than
+//! the circuit that contains them.  Every block belongs to exactly one circuit, and control flow is
+//! nested at most [MAX_BLOCK_DEPTH] deep.
+
+use std::collections::VecDeque;
+use std::num::NonZero;
+use std::sync::Arc;
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+use hashbrown::HashMap;
+use nalgebra::{Matrix2, Matrix4};
+use ndarray::Array2;
+use num_bigint::BigUint;
+use num_complex::Complex64;
+use smallvec::SmallVec;
+use thiserror::Error;
+use uuid::Uuid;
+
+use crate::bit::{ClassicalRegister, QuantumRegister, ShareableClbit, ShareableQubit};
+use crate::circuit_data::{CircuitData, CircuitDataError};
+use crate::duration::Duration;
+use crate::instruction::Parameters;
+use crate::interner::Interned;
+use crate::operations::{
+    ArrayType, BoxDuration, CaseSpecifier, Condition, ControlFlow, ControlFlowInstruction,
+    DelayUnit, ForCollection, LoopParam, Operation, OperationRef, Param, PyRange, StandardGate,
+    StandardInstruction, SwitchTarget, UnitaryGate,
+};
+use crate::packed_instruction::{PackedInstruction, PackedOperation};
+use crate::parameter::parameter_expression::{
+    OPReplay, OpCode, ParameterError, ParameterExpression, ParameterValueType, PyParameter,
+};
+use crate::parameter::symbol_expr::{Symbol, SymbolVector};
+use crate::{Block, Clbit, Qubit};
+
+/// The bytes at the start of every serialized circuit.
+pub const MAGIC: [u8; 4] = *b"QKCB";
+/// The version of the layout written by [serialize].
+pub const VERSION: u16 = 1;
+
+/// Marker for an absent index.
+const NONE: u32 = u32::MAX;
+const HEADER_LEN: usize = 16;
+const SECTION_ENTRY_LEN: usize = 16;
+const NUM_SECTIONS: usize = 14;
+/// The deepest nesting of control-flow blocks that [deserialize] accepts.
+pub const MAX_BLOCK_DEPTH: usize = 256;
+
+// Kinds of operations, stored in the low byte of the first field of an instruction record.
+const KIND_STANDARD_GATE: u32 = 0;
+const KIND_STANDARD_INSTRUCTION: u32 = 1;
+const KIND_UNITARY: u32 = 2;
+const KIND_CONTROL_FLOW: u32 = 3;
+
+// Flags of a register record.
+const REGISTER_ALIAS: u32 = 1;
+const REGISTER_ANCILLA: u32 = 2;
+
+// Kinds of parameter records.
+const PARAM_FLOAT: u32 = 0;
+const PARAM_EXPRESSION: u32 = 1;
+
+// Kinds of the operands of a parameter expression replay.
+const OPERAND_NONE: u32 = 0;
+const OPERAND_INT: u32 = 1;
+const OPERAND_FLOAT: u32 = 2;
+const OPERAND_COMPLEX: u32 = 3;
+const OPERAND_SYMBOL: u32 = 4;
+
+/// The sections of a serialized circuit, in the order of the section table.
+#[derive(Clone, Copy, Debug)]
+enum Section {
+    /// UTF-8 bytes of all strings.
+    StringBytes,
+    /// `[offset, len]` of a string in [Section::StringBytes].
+    Strings,
+    /// A flat array of `u32`, sliced by other records.
+    Indices,
+    /// A flat array of `u64`, holding matrices and control-flow data.
+    Words,
+    /// `[register, index]` of a qubit, or `[NONE, is_ancilla]` for anonymous qubits.
+    Qubits,
+    /// `[register, index]` of a clbit, or `[NONE, 0]` for anonymous clbits.
+    Clbits,
+    /// `[name, flags, len, bits]` of a quantum register, with `bits` in [Section::Indices] for
+    /// aliasing registers.
+    Qregs,
+    /// `[name, flags, len, bits]` of a classical register.
+    Cregs,
+    /// `[name, vector_len, index, 0, uuid x 4]` of a symbol, with `vector_len` set to [NONE] for
+    /// standalone symbols.  The name and uuid of vector elements are those of the vector.
+    Symbols,
+    /// `[kind, replay, value_lo, value_hi]` of a parameter, where expressions are a range of
+    /// [Section::Replay] of length `value_lo`.
+    Params,
+    /// `[op, lhs_kind, lhs_lo, lhs_hi, rhs_kind, rhs_lo, rhs_hi, 0]` of a replay step.
+    Replay,
+    /// `[start, len]` of an interned argument list in [Section::Indices].
+    Args,
+    /// The records of the circuit and its blocks, see [CircuitRecord].
+    Circuits,
+    /// `[kind | code << 8, arg, qargs, cargs, params, num_params, label, extra]` of an
+    /// instruction.
+    Instructions,
+}
+
+impl Section {
+    const ALL: [Section; NUM_SECTIONS] = [
+        Section::StringBytes,
+        Section::Strings,
+        Section::Indices,
+        Section::Words,
+        Section::Qubits,
+        Section::Clbits,
+        Section::Qregs,
+        Section::Cregs,
+        Section::Symbols,
+        Section::Params,
+        Section::Replay,
+        Section::Args,
+        Section::Circuits,
+        Section::Instructions,
+    ];
+
+    /// The size of a record in bytes.
+    const fn record_size(self) -> usize {
+        match self {
+            Section::StringBytes => 1,
+            Section::Indices => 4,
+            Section::Strings
+            | Section::Words
+            | Section::Qubits
+            | Section::Clbits
+            | Section::Args => 8,
+            Section::Qregs | Section::Cregs | Section::Params => 16,
+            Section::Symbols | Section::Replay | Section::Instructions => 32,
+            Section::Circuits => 64,
+        }
+    }
+}
+
+/// The fields of a record in [Section::Circuits].
+struct CircuitRecord {
+    num_qubits: u32,
+    qubits: u32,
+    num_clbits: u32,
+    clbits: u32,
+    num_qregs: u32,
+    qregs: u32,
+    num_cregs: u32,
+    cregs: u32,
+    global_phase: u32,
+    num_qargs: u32,
+    qargs: u32,
+    num_cargs: u32,
+    cargs: u32,
+    num_instructions: u32,
+    instructions: u32,
+}
+
+impl CircuitRecord {
+    fn to_fields(&self) -> [u32; 16] {
+        [
+            self.num_qubits,
+            self.qubits,
+            self.num_clbits,
+            self.clbits,
+            self.num_qregs,
+            self.qregs,
+            self.num_cregs,
+            self.cregs,
+            self.global_phase,
+            self.num_qargs,
+            self.qargs,
+            self.num_cargs,
+            self.cargs,
+            self.num_instructions,
+            self.instructions,
+            0,
+        ]
+    }
+
+    fn from_fields(fields: [u32; 16]) -> Self {
+        Self {
+            num_qubits: fields[0],
+            qubits: fields[1],
+            num_clbits: fields[2],
+            clbits: fields[3],
+            num_qregs: fields[4],
+            qregs: fields[5],
+            num_cregs: fields[6],
+            cregs: fields[7],
+            global_phase: fields[8],
+            num_qargs: fields[9],
+            qargs: fields[10],
+            num_cargs: fields[11],
+            cargs: fields[12],
+            num_instructions: fields[13],
+            instructions: fields[14],
+        }
+    }
+}
+
+#[derive(Error, Debug)]
+pub enum BinaryFormatError {
+    #[error("cannot serialize {0}")]
+    Unsupported(String),
+    #[error("the circuit is too large to serialize")]
+    TooLarge,
+    #[error("unsupported binary circuit version {0}")]
+    UnsupportedVersion(u16),
+    #[error("invalid binary circuit: {0}")]
+    Invalid(&'static str),
+    #[error(transparent)]
+    CircuitData(#[from] CircuitDataError),
+    #[error(transparent)]
+    Parameter(#[from] ParameterError),
+}
+
+/// Serialize a circuit to the binary layout described in the module documentation.
+///
+/// This fails if the circuit contains classical variables or stretches, operations without a
+/// native Rust representation, parameters that are Python objects, or control flow that depends on
+/// classical expressions or box annotations.
+pub fn serialize(circuit: &CircuitData) -> Result<Vec<u8>, BinaryFormatError> {
+    let mut writer = Writer::default();
+    let mut queue = VecDeque::from([(writer.reserve_circuit(), circuit)]);
+    while let Some((index, circuit)) = queue.pop_front() {
+        writer.write_circuit(index, circuit, &mut queue)?;
+    }
+    writer.finish()
+}
+
+/// Deserialize a circuit written by [serialize].
+///
+/// The bytes are validated, so this returns an error rather than panicking for any malformed or
+/// truncated input.
+pub fn deserialize(bytes: &[u8]) -> Result<CircuitData, BinaryFormatError> {
+    CircuitBuffer::new(bytes)?.to_circuit_data()
+}
+
+#[derive(Default)]
+struct Writer {
+    sections: [Vec<u8>; NUM_SECTIONS],
+    strings: HashMap<String, u32>,
+    qubits: HashMap<ShareableQubit, u32>,
+    clbits: HashMap<ShareableClbit, u32>,
+    qregs: HashMap<QuantumRegister, u32>,
+    cregs: HashMap<ClassicalRegister, u32>,
+    symbols: HashMap<Symbol, u32>,
+}
+
+impl Writer {
+    fn len(&self, section: Section) -> u32 {
+        (self.sections[section as usize].len() / section.record_size()) as u32
+    }
+
+    fn push(&mut self, section: Section, fields: &[u32]) -> u32 {
+        debug_assert_eq!(fields.len() * 4, section.record_size());
+        let index = self.len(section);
+        let out = &mut self.sections[section as usize];
+        for field in fields {
+            out.extend_from_slice(&field.to_le_bytes());
+        }
+        index
+    }
+
+    fn set(&mut self, section: Section, index: u32, fields: &[u32]) {
+        let start = index as usize * section.record_size();
+        let out = &mut self.sections[section as usize][start..start + 4 * fields.len()];
+        for (chunk, field) in out.chunks_exact_mut(4).zip(fields) {
+            chunk.copy_from_slice(&field.to_le_bytes());
+        }
+    }
+
+    fn push_indices(&mut self, indices: impl IntoIterator<Item = u32>) -> u32 {
+        let start = self.len(Section::Indices);
+        let out = &mut self.sections[Section::Indices as usize];
+        for index in indices {
+            out.extend_from_slice(&index.to_le_bytes());
+        }
+        start
+    }
+
+    fn push_word(&mut self, word: u64) -> u32 {
+        let index = self.len(Section::Words);
+        self.sections[Section::Words as usize].extend_from_slice(&word.to_le_bytes());
+        index
+    }
+
+    fn push_biguint(&mut self, value: &BigUint) {
+        let digits = value.to_u64_digits();
+        self.push_word(digits.len() as u64);
+        for digit in digits {
+            self.push_word(digit);
+        }
+    }
+
+    fn push_string(&mut self, string: &str) -> u32 {
+        if let Some(index) = self.strings.get(string) {
+            return *index;
+        }
+        let offset = self.sections[Section::StringBytes as usize].len() as u32;
+        self.sections[Section::StringBytes as usize].extend_from_slice(string.as_bytes());
+        let index = self.push(Section::Strings, &[offset, string.len() as u32]);
+        self.strings.insert(string.to_owned(), index);
+        index
+    }
+
+    fn reserve_circuit(&mut self) -> u32 {
+        self.push(Section::Circuits, &[0; 16])
+    }
+
+    fn qreg(&mut self, register: &QuantumRegister) -> Result<u32, BinaryFormatError> {
+        if let Some(index) = self.qregs.get(register) {
+            return Ok(*index);
+        }
+        let name = self.push_string(register.name());
+        let mut flags = if register.is_ancilla() {
+            REGISTER_ANCILLA
+        } else {
+            0
+        };
+        let owning = register
+            .get(0)
+            .and_then(|bit| bit.owning_register())
+            .is_some_and(|owner| &owner == register);
+        let bits = if owning {
+            0
+        } else {
+            flags |= REGISTER_ALIAS;
+            let bits = register
+                .iter()
+                .map(|bit| self.qubit(&bit))
+                .collect::<Result<Vec<_>, _>>()?;
+            self.push_indices(bits)
+        };
+        let index = self.push(Section::Qregs, &[name, flags, register.len() as u32, bits]);
+        self.qregs.insert(register.clone(), index);
+        Ok(index)
+    }
+
+    fn creg(&mut self, register: &ClassicalRegister) -> u32 {
+        if let Some(index) = self.cregs.get(register) {
+            return *index;
+        }
+        let name = self.push_string(register.name());
+        let owning = register
+            .get(0)
+            .and_then(|bit| bit.owning_register())
+            .is_some_and(|owner| &owner == register);
+        let (flags, bits) = if owning {
+            (0, 0)
+        } else {
+            let bits = register
+                .iter()
+                .map(|bit| self.clbit(&bit))
+                .collect::<Vec<_>>();
+            (REGISTER_ALIAS, self.push_indices(bits))
+        };
+        let index = self.push(Section::Cregs, &[name, flags, register.len() as u32, bits]);
+        self.cregs.insert(register.clone(), index);
+        index
+    }
+
+    fn qubit(&mut self, bit: &ShareableQubit) -> Result<u32, BinaryFormatError> {
+        if let Some(index) = self.qubits.get(bit) {
+            return Ok(*index);
+        }
+        let fields = match (bit.owning_register(), bit.owning_register_index()) {
+            (Some(register), Some(index)) => [self.qreg(&register)?, index],
+            _ => [NONE, bit.is_ancilla() as u32],
+        };
+        let index = self.push(Section::Qubits, &fields);
+        self.qubits.insert(bit.clone(), index);
+        Ok(index)
+    }
+
+    fn clbit(&mut self, bit: &ShareableClbit) -> u32 {
+        if let Some(index) = self.clbits.get(bit) {
+            return *index;
+        }
+        let fields = match (bit.owning_register(), bit.owning_register_index()) {
+            (Some(register), Some(index)) => [self.creg(&register), index],
+            _ => [NONE, 0],
+        };
+        let index = self.push(Section::Clbits, &fields);
+        self.clbits.insert(bit.clone(), index);
+        index
+    }
+
+    fn symbol(&mut self, symbol: &Symbol) -> u32 {
+        if let Some(index) = self.symbols.get(symbol) {
+            return *index;
+        }
+        let (name, vector_len, element, uuid) = match symbol {
+            Symbol::Standalone { name, uuid } => (name, NONE, 0, uuid.as_u128()),
+            Symbol::Element { index, base } => (
+                &base.name,
+                base.len.load(Ordering::Relaxed) as u32,
+                *index as u32,
+                base.uuid.as_u128(),
+            ),
+        };
+        let name = self.push_string(name);
+        let uuid = [
+            uuid as u32,
+            (uuid >> 32) as u32,
+            (uuid >> 64) as u32,
+            (uuid >> 96) as u32,
+        ];
+        let index = self.push(
+            Section::Symbols,
+            &[
+                name, vector_len, element, 0, uuid[0], uuid[1], uuid[2], uuid[3],
+            ],
+        );
+        self.symbols.insert(symbol.clone(), index);
+        index
+    }
+
+    fn operand(&mut self, operand: &Option<ParameterValueType>) -> [u32; 3] {
+        let (kind, value) = match operand {
+            None => (OPERAND_NONE, 0),
+            Some(ParameterValueType::Int(value)) => (OPERAND_INT, *value as u64),
+            Some(ParameterValueType::Float(value)) => (OPERAND_FLOAT, value.to_bits()),
+            Some(ParameterValueType::Complex(value)) => {
+                let start = self.push_word(value.re.to_bits());
+                self.push_word(value.im.to_bits());
+                (OPERAND_COMPLEX, start as u64)
+            }
+            Some(ParameterValueType::Parameter(PyParameter(symbol))) => {
+                (OPERAND_SYMBOL, self.symbol(symbol) as u64)
+            }
+        };
+        [kind, value as u32, (value >> 32) as u32]
+    }
+
+    fn param(&mut self, param: &Param) -> Result<u32, BinaryFormatError> {
+        let fields = match param {
+            Param::Float(value) => {
+                let bits = value.to_bits();
+                [PARAM_FLOAT, 0, bits as u32, (bits >> 32) as u32]
+            }
+            Param::ParameterExpression(expr) => {
+                let replay = expr.qpy_replay();
+                let start = self.len(Section::Replay);
+                for OPReplay { op, lhs, rhs } in &replay {
+                    let [lhs_kind, lhs_lo, lhs_hi] = self.operand(lhs);
+                    let [rhs_kind, rhs_lo, rhs_hi] = self.operand(rhs);
+                    self.push(
+                        Section::Replay,
+                        &[
+                            *op as u32, lhs_kind, lhs_lo, lhs_hi, rhs_kind, rhs_lo, rhs_hi, 0,
+                        ],
+                    );
+                }
+                [PARAM_EXPRESSION, start, replay.len() as u32, 0]
+            }
+            Param::Obj(_) => {
+                return Err(BinaryFormatError::Unsupported(
+                    "parameters that are Python objects".to_string(),
+                ));
+            }
+        };
+        Ok(self.push(Section::Params, &fields))
+    }
+
+    fn params(&mut self, params: &[Param]) -> Result<u32, BinaryFormatError> {
+        let start = self.len(Section::Params);
+        for param in params {
+            self.param(param)?;
+        }
+        Ok(start)
+    }
+
+    fn write_circuit<'a>(
+        &mut self,
+        index: u32,
+        circuit: &'a CircuitData,
+        queue: &mut VecDeque<(u32, &'a CircuitData)>,
+    ) -> Result<(), BinaryFormatError> {
+        if circuit.vars_stretches_view().num_identifiers() > 0 {
+            return Err(BinaryFormatError::Unsupported(
+                "classical variables or stretches".to_string(),
+            ));
+        }
+        let qubits = circuit
+            .qubits()
+            .objects()
+            .iter()
+            .map(|bit| self.qubit(bit))
+            .collect::<Result<Vec<_>, _>>()?;
+        let clbits = circuit
+            .clbits()
+            .objects()
+            .iter()
+            .map(|bit| self.clbit(bit))
+            .collect::<Vec<_>>();
+        let qregs = circuit
+            .qregs()
+            .iter()
+            .map(|register| self.qreg(register))
+            .collect::<Result<Vec<_>, _>>()?;
+        let cregs = circuit
+            .cregs()
+            .iter()
+            .map(|register| self.creg(register))
+            .collect::<Vec<_>>();
+        let mut record = CircuitRecord {
+            num_qubits: qubits.len() as u32,
+            qubits: self.push_indices(qubits),
+            num_clbits: clbits.len() as u32,
+            clbits: self.push_indices(clbits),
+            num_qregs: qregs.len() as u32,
+            qregs: self.push_indices(qregs),
+            num_cregs: cregs.len() as u32,
+            cregs: self.push_indices(cregs),
+            global_phase: self.param(circuit.global_phase())?,
+            num_qargs: circuit.qargs_interner().len() as u32,
+            qargs: self.len(Section::Args),
+            num_cargs: circuit.cargs_interner().len() as u32,
+            cargs: 0,
+            num_instructions: circuit.data().len() as u32,
+            instructions: 0,
+        };
+
+        // The instructions refer to their arguments by position in the tables of the circuit.
+        let mut qargs = HashMap::with_capacity(record.num_qargs as usize);
+        for (position, (key, args)) in circuit.qargs_interner().items().enumerate() {
+            let start = self.push_indices(args.iter().map(|qubit| qubit.0));
+            self.push(Section::Args, &[start, args.len() as u32]);
+            qargs.insert(key, position as u32);
+        }
+        record.cargs = self.len(Section::Args);
+        let mut cargs = HashMap::with_capacity(record.num_cargs as usize);
+        for (position, (key, args)) in circuit.cargs_interner().items().enumerate() {
+            let start = self.push_indices(args.iter().map(|clbit| clbit.0));
+            self.push(Section::Args, &[start, args.len() as u32]);
+            cargs.insert(key, position as u32);
+        }
+
+        record.instructions = self.len(Section::Instructions);
+        let mut blocks = HashMap::new();
+        for inst in circuit.data() {
+            let label = match inst.label.as_deref() {
+                Some(label) => self.push_string(label),
+                None => NONE,
+            };
+            let (kind, code, arg, params, num_params, extra) = match inst.op.view() {
+                OperationRef::StandardGate(gate) => {
+                    let params = inst.params_view();
+                    let start = self.params(params)?;
+                    (KIND_STANDARD_GATE, gate as u32, 0, start, params.len(), 0)
+                }
+                OperationRef::StandardInstruction(instruction) => {
+                    let (code, arg) = match instruction {
+                        StandardInstruction::Barrier(num_qubits) => (0, num_qubits),
+                        StandardInstruction::Delay(unit) => (1, unit as u32),
+                        StandardInstruction::Measure => (2, 0),
+                        StandardInstruction::Reset => (3, 0),
+                    };
+                    let params = inst.params_view();
+                    let start = self.params(params)?;
+                    (KIND_STANDARD_INSTRUCTION, code, arg, start, params.len(), 0)
+                }
+                OperationRef::Unitary(gate) => {
+                    let matrix = gate.matrix().expect("unitary gates have a matrix");
+                    let start = self.len(Section::Words);
+                    for value in matrix.iter() {
+                        self.push_word(value.re.to_bits());
+                        self.push_word(value.im.to_bits());
+                    }
+                    (KIND_UNITARY, 0, gate.num_qubits(), 0, 0, start)
+                }
+                OperationRef::ControlFlow(control_flow) => {
+                    let mut children = Vec::with_capacity(inst.blocks_view().len());
+                    for block in inst.blocks_view() {
+                        let child = match blocks.get(block) {
+                            Some(child) => *child,
+                            None => {
+                                let child = self.reserve_circuit();
+                                queue.push_back((child, &circuit.blocks()[*block]));
+                                blocks.insert(*block, child);
+                                child
+                            }
+                        };
+                        children.push(child);
+                    }
+                    let num_children = children.len();
+                    let start = self.push_indices(children);
+                    let (code, extra) = self.control_flow(control_flow)?;
+                    (
+                        KIND_CONTROL_FLOW,
+                        code,
+                        control_flow.num_qubits,
+                        start,
+                        num_children,
+                        extra,
+                    )
+                }
+                op => {
+                    return Err(BinaryFormatError::Unsupported(format!(
+                        "the operation '{}'",
+                        op.name()
+                    )));
+                }
+            };
+            self.push(
+                Section::Instructions,
+                &[
+                    kind | code << 8,
+                    arg,
+                    qargs[&inst.qubits],
+                    cargs[&inst.clbits],
+                    params,
+                    num_params as u32,
+                    label,
+                    extra,
+                ],
+            );
+        }
+        self.set(Section::Circuits, index, &record.to_fields());
+        Ok(())
+    }
+
+    fn condition(&mut self, condition: &Condition) -> Result<(), BinaryFormatError> {
+        match condition {
+            Condition::Bit(bit, value) => {
+                self.push_word(0);
+                let bit = self.clbit(bit);
+                self.push_word(bit as u64);
+                self.push_word(*value as u64);
+            }
+            Condition::Register(register, value) => {
+                self.push_word(1);
+                let register = self.creg(register);
+                self.push_word(register as u64);
+                self.push_biguint(value);
+            }
+            Condition::Expr(_) => {
+                return Err(BinaryFormatError::Unsupported(
+                    "conditions on classical expressions".to_string(),
+                ));
+            }
+        }
+        Ok(())
+    }
+
+    /// Write the data of a control-flow operation to the words section.  Returns the code of the
+    /// operation and the index of its first word.
+    fn control_flow(
+        &mut self,
+        control_flow: &ControlFlowInstruction,
+    ) -> Result<(u32, u32), BinaryFormatError> {
+        let start = self.push_word(control_flow.num_clbits as u64);
+        let code = match &control_flow.control_flow {
+            ControlFlow::Box {
+                duration,
+                annotations,
+            } => {
+                if !annotations.is_empty() {
+                    return Err(BinaryFormatError::Unsupported(
+                        "box annotations".to_string(),
+                    ));
+                }
+                let (unit, value) = match duration {
+                    None => (0, 0),
+                    Some(BoxDuration::Duration(duration)) => match *duration {
+                        Duration::dt(value) => (1, value as u64),
+                        Duration::ps(value) => (2, value.to_bits()),
+                        Duration::ns(value) => (3, value.to_bits()),
+                        Duration::us(value) => (4, value.to_bits()),
+                        Duration::ms(value) => (5, value.to_bits()),
+                        Duration::s(value) => (6, value.to_bits()),
+                    },
+                    Some(BoxDuration::Expr(_)) => {
+                        return Err(BinaryFormatError::Unsupported(
+                            "box durations that are classical expressions".to_string(),
+                        ));
+                    }
+                };
+                self.push_word(unit);
+                self.push_word(value);
+                0
+            }
+            ControlFlow::BreakLoop => 1,
+            ControlFlow::ContinueLoop => 2,
+            ControlFlow::ForLoop {
+                collection,
+                loop_param,
+            } => {
+                match collection {
+                    ForCollection::PyRange(range) => {
+                        self.push_word(0);
+                        self.push_word(range.start as u64);
+                        self.push_word(range.stop as u64);
+                        self.push_word(range.step.get() as u64);
+                    }
+                    ForCollection::List(values) => {
+                        self.push_word(1);
+                        self.push_word(values.len() as u64);
+                        for value in values {
+                            self.push_word(*value as u64);
+                        }
+                    }
+                }
+                let symbol = match loop_param {
+                    None => u64::MAX,
+                    Some(LoopParam::Parameter(symbol)) => self.symbol(symbol) as u64,
+                    Some(LoopParam::Variable(_)) => {
+                        return Err(BinaryFormatError::Unsupported(
+                            "loops over classical variables".to_string(),
+                        ));
+                    }
+                };
+                self.push_word(symbol);
+                3
+            }
+            ControlFlow::IfElse { condition } => {
+                self.condition(condition)?;
+                4
+            }
+            ControlFlow::Switch {
+                target,
+                label_spec,
+                cases: _,
+            } => {
+                match target {
+                    SwitchTarget::Bit(bit) => {
+                        self.push_word(0);
+                        let bit = self.clbit(bit);
+                        self.push_word(bit as u64);
+                    }
+                    SwitchTarget::Register(register) => {
+                        self.push_word(1);
+                        let register = self.creg(register);
+                        self.push_word(register as u64);
+                    }
+                    SwitchTarget::Expr(_) => {
+                        return Err(BinaryFormatError::Unsupported(
+                            "switches on classical expressions".to_string(),
+                        ));
+                    }
+                }
+                self.push_word(label_spec.len() as u64);
+                for specifiers in label_spec {
+                    self.push_word(specifiers.len() as u64);
+                    for specifier in specifiers {
+                        match specifier {
+                            CaseSpecifier::Uint(value) => {
+                                self.push_word(0);
+                                self.push_biguint(value);
+                            }
+                            CaseSpecifier::Default => {
+                                self.push_word(1);
+                            }
+                        }
+                    }
+                }
+                5
+            }
+            ControlFlow::While { condition } => {
+                self.condition(condition)?;
+                6
+            }
+        };
+        Ok((code, start))
+    }
+
+    fn finish(self) -> Result<Vec<u8>, BinaryFormatError> {
+        if self
+            .sections
+            .iter()
+            .zip(Section::ALL)
+            .any(|(data, section)| data.len() / section.record_size() > NONE as usize)
+        {
+            return Err(BinaryFormatError::TooLarge);
+        }
+        let table_len = HEADER_LEN + NUM_SECTIONS * SECTION_ENTRY_LEN;
+        let data_len = self
+            .sections
+            .iter()
+            .map(|data| data.len().next_multiple_of(8))
+            .sum::<usize>();
+        let mut out = Vec::with_capacity(table_len + data_len);
+        out.extend_from_slice(&MAGIC);
+        out.extend_from_slice(&VERSION.to_le_bytes());
+        out.extend_from_slice(&[0; 2]);
+        out.extend_from_slice(&(NUM_SECTIONS as u32).to_le_bytes());
+        out.extend_from_slice(&[0; 4]);
+        // Sections start on 8-byte boundaries, relative to the start of the buffer.
+        let mut offset = table_len;
+        for (data, section) in self.sections.iter().zip(Section::ALL) {
+            out.extend_from_slice(&(offset as u64).to_le_bytes());
+            out.extend_from_slice(&((data.len() / section.record_size()) as u64).to_le_bytes());
+            offset += data.len().next_multiple_of(8);
+        }
+        for data in &self.sections {
+            out.extend_from_slice(data);
+            out.resize(out.len().next_multiple_of(8), 0);
+        }
+        Ok(out)
+    }
+}
+
+/// A read-only view of a serialized circuit.
+///
+/// Creating the view only validates the header and the bounds of the sections; the records are
+/// read in place from the borrowed bytes, so the bytes can be a memory-mapped file or a region of
+/// shared memory.
+pub struct CircuitBuffer<'a> {
+    sections: [&'a [u8]; NUM_SECTIONS],
+}
+
+impl<'a> CircuitBuffer<'a> {
+    pub fn new(bytes: &'a [u8]) -> Result<Self, BinaryFormatError> {
+        let table_len = HEADER_LEN + NUM_SECTIONS * SECTION_ENTRY_LEN;
+        if bytes.len() < table_len || bytes[..4] != MAGIC {
+            return Err(BinaryFormatError::Invalid("missing header"));
+        }
+        let version = u16::from_le_bytes([bytes[4], bytes[5]]);
+        if version != VERSION {
+            return Err(BinaryFormatError::UnsupportedVersion(version));
+        }
+        if read_u32(&bytes[8..12]) as usize != NUM_SECTIONS {
+            return Err(BinaryFormatError::Invalid("unexpected number of sections"));
+        }
+        let mut sections = [&bytes[..0]; NUM_SECTIONS];
+        for (i, section) in Section::ALL.into_iter().enumerate() {
+            let entry = HEADER_LEN + i * SECTION_ENTRY_LEN;
+            let offset = read_u64(&bytes[entry..entry + 8]);
+            let count = read_u64(&bytes[entry + 8..entry + 16]);
+            sections[i] = usize::try_from(count)
+                .ok()
+                .and_then(|count| count.checked_mul(section.record_size()))
+                .zip(usize::try_from(offset).ok())
+                .and_then(|(len, offset)| bytes.get(offset..offset.checked_add(len)?))
+                .ok_or(BinaryFormatError::Invalid("section out of bounds"))?;
+        }
+        let buffer = Self { sections };
+        if buffer.count(Section::Circuits) == 0 {
+            return Err(BinaryFormatError::Invalid("no circuit"));
+        }
+        Ok(buffer)
+    }
+
+    /// The number of qubits of the serialized circuit.
+    pub fn num_qubits(&self) -> usize {
+        self.outer().map_or(0, |record| record.num_qubits as usize)
+    }
+
+    /// The number of clbits of the serialized circuit.
+    pub fn num_clbits(&self) -> usize {
+        self.outer().map_or(0, |record| record.num_clbits as usize)
+    }
+
+    /// The number of instructions of the serialized circuit, excluding those in control-flow
+    /// blocks.
+    pub fn num_instructions(&self) -> usize {
+        self.outer()
+            .map_or(0, |record| record.num_instructions as usize)
+    }
+
+    /// Build the serialized circuit.
+    pub fn to_circuit_data(&self) -> Result<CircuitData, BinaryFormatError> {
+        Reader::new(self)?.circuits()
+    }
+
+    fn outer(&self) -> Result<CircuitRecord, BinaryFormatError> {
+        self.record(Section::Circuits, 0)
+            .map(CircuitRecord::from_fields)
+    }
+
+    fn count(&self, section: Section) -> usize {
+        self.sections[section as usize].len() / section.record_size()
+    }
+
+    /// Check that the `len` records of `section` starting at `start` all exist.  Counts read from
+    /// the buffer are untrusted, so they're checked with this before any space is reserved for
+    /// them.
+    fn check_range(&self, section: Section, start: u32, len: u32) -> Result<(), BinaryFormatError> {
+        (start as usize)
+            .checked_add(len as usize)
+            .filter(|end| *end <= self.count(section))
+            .map(|_| ())
+            .ok_or(BinaryFormatError::Invalid("index out of bounds"))
+    }
+
+    /// Read the first `N` fields of a record.
+    fn record<const N: usize>(
+        &self,
+        section: Section,
+        index: usize,
+    ) -> Result<[u32; N], BinaryFormatError> {
+        debug_assert!(N * 4 <= section.record_size());
+        let start = index
+            .checked_mul(section.record_size())
+            .ok_or(BinaryFormatError::Invalid("index out of bounds"))?;
+        let bytes = self.sections[section as usize]
+            .get(start..start + N * 4)
+            .ok_or(BinaryFormatError::Invalid("index out of bounds"))?;
+        let mut fields = [0; N];
+        for (field, chunk) in fields.iter_mut().zip(bytes.chunks_exact(4)) {
+            *field = read_u32(chunk);
+        }
+        Ok(fields)
+    }
+
+    fn indices(
+        &self,
+        start: u32,
+        len: u32,
+    ) -> Result<impl ExactSizeIterator<Item = u32> + 'a, BinaryFormatError> {
+        let start = start as usize * 4;
+        let bytes = self.sections[Section::Indices as usize]
+            .get(start..start + len as usize * 4)
+            .ok_or(BinaryFormatError::Invalid("index out of bounds"))?;
+        Ok(bytes.chunks_exact(4).map(read_u32))
+    }
+
+    /// A cursor over the words section, starting at `start`.
+    fn words(&self, start: u32) -> Result<Words<'a>, BinaryFormatError> {
+        self.sections[Section::Words as usize]
+            .get(start as usize * 8..)
+            .map(|bytes| Words { bytes })
+            .ok_or(BinaryFormatError::Invalid("index out of bounds"))
+    }
+
+    fn string(&self, index: u32) -> Result<&'a str, BinaryFormatError> {
+        let [offset, len] = self.record(Section::Strings, index as usize)?;
+        let bytes = self.sections[Section::StringBytes as usize]
+            .get(offset as usize..offset as usize + len as usize)
+            .ok_or(BinaryFormatError::Invalid("string out of bounds"))?;
+        std::str::from_utf8(bytes).map_err(|_| BinaryFormatError::Invalid("string is not UTF-8"))
+    }
+}
+
+fn read_u32(bytes: &[u8]) -> u32 {
+    u32::from_le_bytes(bytes.try_into().expect("caller should pass four bytes"))
+}
+
+fn read_u64(bytes: &[u8]) -> u64 {
+    u64::from_le_bytes(bytes.try_into().expect("caller should pass eight bytes"))
+}
+
+/// A cursor over the words of a control-flow operation.
+struct Words<'a> {
+    bytes: &'a [u8],
+}
+
+impl Words<'_> {
+    fn next(&mut self) -> Result<u64, BinaryFormatError> {
+        let (word, rest) = self
+            .bytes
+            .split_first_chunk::<8>()
+            .ok_or(BinaryFormatError::Invalid("truncated words"))?;
+        self.bytes = rest;
+        Ok(u64::from_le_bytes(*word))
+    }
+
+    fn next_index(&mut self) -> Result<usize, BinaryFormatError> {
+        usize::try_from(self.next()?).map_err(|_| BinaryFormatError::Invalid("index out of bounds"))
+    }
+
+    fn next_f64(&mut self) -> Result<f64, BinaryFormatError> {
+        self.next().map(f64::from_bits)
+    }
+
+    fn next_biguint(&mut self) -> Result<BigUint, BinaryFormatError> {
+        // The digits are little-endian words, so together they are the little-endian bytes of the
+        // value.
+        let len = usize::try_from(self.next()?)
+            .ok()
+            .and_then(|num_digits| num_digits.checked_mul(8))
+            .filter(|len| *len <= self.bytes.len())
+            .ok_or(BinaryFormatError::Invalid("truncated words"))?;
+        let (digits, rest) = self.bytes.split_at(len);
+        self.bytes = rest;
+        Ok(BigUint::from_bytes_le(digits))
+    }
+}
+
+/// The shared tables of a [CircuitBuffer], from which its circuits are built.
+struct Reader<'b, 'a> {
+    buffer: &'b CircuitBuffer<'a>,
+    qubits: Vec<ShareableQubit>,
+    clbits: Vec<ShareableClbit>,
+    qregs: Vec<QuantumRegister>,
+    cregs: Vec<ClassicalRegister>,
+    symbols: Vec<Arc<Symbol>>,
+}
+
+impl<'b, 'a> Reader<'b, 'a> {
+    fn new(buffer: &'b CircuitBuffer<'a>) -> Result<Self, BinaryFormatError> {
+        let (qubits, qregs) = Self::quantum_bits(buffer)?;
+        let (clbits, cregs) = Self::classical_bits(buffer)?;
+        let mut vectors: HashMap<u128, Arc<SymbolVector>> = HashMap::new();
+        let symbols = (0..buffer.count(Section::Symbols))
+            .map(|index| {
+                let [name, vector_len, element, _, uuid @ ..] =
+                    buffer.record::<8>(Section::Symbols, index)?;
+                let name = buffer.string(name)?;
+                let uuid = uuid
+                    .iter()
+                    .rev()
+                    .fold(0u128, |acc, part| acc << 32 | *part as u128);
+                if vector_len == NONE {
+                    return Ok(Arc::new(Symbol::standalone(
+                        name.to_owned(),
+                        Some(Uuid::from_u128(uuid)),
+                    )));
+                }
+                if element >= vector_len {
+                    return Err(BinaryFormatError::Invalid("vector element out of bounds"));
+                }
+                let base = vectors.entry(uuid).or_insert_with(|| {
+                    Arc::new(SymbolVector {
+                        name: name.to_owned(),
+                        uuid: Uuid::from_u128(uuid),
+                        len: AtomicUsize::new(vector_len as usize),
+                    })
+                });
+                Ok(Arc::new(Symbol::Element {
+                    index: element as usize,
+                    base: base.clone(),
+                }))
+            })
+            .collect::<Result<_, _>>()?;
+        Ok(Self {
+            buffer,
+            qubits,
+            clbits,
+            qregs,
+            cregs,
+            symbols,
+        })
+    }
+
+    /// Build the qubits and quantum registers.  Owning registers are built first, since the qubits
+    /// refer to them, and aliasing registers last, since they refer to the qubits.
+    fn quantum_bits(
+        buffer: &CircuitBuffer,
+    ) -> Result<(Vec<ShareableQubit>, Vec<QuantumRegister>), BinaryFormatError> {
+        let records = (0..buffer.count(Section::Qregs))
+            .map(|index| buffer.record::<4>(Section::Qregs, index))
+            .collect::<Result<Vec<_>, _>>()?;
+        let mut registers = records
+            .iter()
+            .map(|[name, flags, len, _]| {
+                if flags & REGISTER_ALIAS != 0 {
+                    return Ok(None);
+                }
+                let name = buffer.string(*name)?.to_owned();
+                Ok(Some(if flags & REGISTER_ANCILLA != 0 {
+                    QuantumRegister::new_ancilla_owning(name, *len)
+                } else {
+                    QuantumRegister::new_owning(name, *len)
+                }))
+            })
+            .collect::<Result<Vec<_>, BinaryFormatError>>()?;
+        let qubits = (0..buffer.count(Section::Qubits))
+            .map(|index| match buffer.record::<2>(Section::Qubits, index)? {
+                [NONE, 0] => Ok(ShareableQubit::new_anonymous()),
+                [NONE, 1] => Ok(ShareableQubit::new_anonymous_ancilla()),
+                [register, index] => registers
+                    .get(register as usize)
+                    .and_then(|register| register.as_ref()?.get(index as usize))
+                    .ok_or(BinaryFormatError::Invalid(
+                        "invalid owning register of a qubit",
+                    )),
+            })
+            .collect::<Result<Vec<_>, _>>()?;
+        for (register, [name, flags, len, bits]) in registers.iter_mut().zip(&records) {
+            if register.is_some() {
+                continue;
+            }
+            let name = buffer.string(*name)?.to_owned();
+            let bits = buffer
+                .indices(*bits, *len)?
+                .map(|bit| qubits.get(bit as usize).cloned())
+                .collect::<Option<Vec<_>>>()
+                .ok_or(BinaryFormatError::Invalid("qubit out of bounds"))?;
+            *register = Some(if flags & REGISTER_ANCILLA != 0 {
+                QuantumRegister::new_ancilla_alias(name, bits).ok_or(BinaryFormatError::Invalid(
+                    "ancilla register of non-ancilla qubits",
+                ))?
+            } else {
+                QuantumRegister::new_alias(Some(name), bits)
+            });
+        }
+        Ok((qubits, registers.into_iter().flatten().collect()))
+    }
+
+    /// Build the clbits and classical registers, in the same order as [Self::quantum_bits].
+    fn classical_bits(
+        buffer: &CircuitBuffer,
+    ) -> Result<(Vec<ShareableClbit>, Vec<ClassicalRegister>), BinaryFormatError> {
+        let records = (0..buffer.count(Section::Cregs))
+            .map(|index| buffer.record::<4>(Section::Cregs, index))
+            .collect::<Result<Vec<_>, _>>()?;
+        let mut registers = records
+            .iter()
+            .map(|[name, flags, len, _]| {
+                if flags & REGISTER_ALIAS != 0 {
+                    return Ok(None);
+                }
+                Ok(Some(ClassicalRegister::new_owning(
+                    buffer.string(*name)?,
+                    *len,
+                )))
+            })
+            .collect::<Result<Vec<_>, BinaryFormatError>>()?;
+        let clbits = (0..buffer.count(Section::Clbits))
+            .map(|index| match buffer.record::<2>(Section::Clbits, index)? {
+                [NONE, 0] => Ok(ShareableClbit::new_anonymous()),
+                [register, index] => registers
+                    .get(register as usize)
+                    .and_then(|register| register.as_ref()?.get(index as usize))
+                    .ok_or(BinaryFormatError::Invalid(
+                        "invalid owning register of a clbit",
+                    )),
+            })
+            .collect::<Result<Vec<_>, _>>()?;
+        for (register, [name, _, len, bits]) in registers.iter_mut().zip(&records) {
+            if register.is_some() {
+                continue;
+            }
+            let name = buffer.string(*name)?.to_owned();
+            let bits = buffer
+                .indices(*bits, *len)?
+                .map(|bit| clbits.get(bit as usize).cloned())
+                .collect::<Option<Vec<_>>>()
+                .ok_or(BinaryFormatError::Invalid("clbit out of bounds"))?;
+            *register = Some(ClassicalRegister::new_alias(Some(name), bits));
+        }
+        Ok((clbits, registers.into_iter().flatten().collect()))
+    }
+
+    fn operand(
+        &self,
+        kind: u32,
+        lo: u32,
+        hi: u32,
+    ) -> Result<Option<ParameterValueType>, BinaryFormatError> {
+        let value = lo as u64 | (hi as u64) << 32;
+        let operand = match kind {
+            OPERAND_NONE => None,
+            OPERAND_INT => Some(ParameterValueType::Int(value as i64)),
+            OPERAND_FLOAT => Some(ParameterValueType::Float(f64::from_bits(value))),
+            OPERAND_COMPLEX => {
+                let mut words = self.buffer.words(lo)?;
+                let re = words.next_f64()?;
+                let im = words.next_f64()?;
+                Some(ParameterValueType::Complex(Complex64::new(re, im)))
+            }
+            OPERAND_SYMBOL => {
+                let symbol = self
+                    .symbols
+                    .get(lo as usize)
+                    .ok_or(BinaryFormatError::Invalid("symbol out of bounds"))?;
+                Some(ParameterValueType::Parameter(PyParameter(symbol.clone())))
+            }
+            _ => return Err(BinaryFormatError::Invalid("unknown operand kind")),
+        };
+        Ok(operand)
+    }
+
+    fn param(&self, index: u32) -> Result<Param, BinaryFormatError> {
+        let [kind, start, lo, hi] = self.buffer.record(Section::Params, index as usize)?;
+        match kind {
+            PARAM_FLOAT => Ok(Param::Float(f64::from_bits(lo as u64 | (hi as u64) << 32))),
+            PARAM_EXPRESSION => {
+                self.buffer.check_range(Section::Replay, start, lo)?;
+                let mut replay = Vec::with_capacity(lo as usize);
+                // Check the stack discipline of the replay up front, since
+                // `ParameterExpression::from_qpy` panics on an invalid replay.
+                let mut depth = 0usize;
+                for step in start as usize..start as usize + lo as usize {
+                    let [op, lhs_kind, lhs_lo, lhs_hi, rhs_kind, rhs_lo, rhs_hi] =
+                        self.buffer.record(Section::Replay, step)?;
+                    let op = u8::try_from(op)
+                        .ok()
+                        .and_then(|op| ::bytemuck::checked::try_cast::<u8, OpCode>(op).ok())
+                        .filter(|op| !matches!(op, OpCode::GRAD | OpCode::SUBSTITUTE))
+                        .ok_or(BinaryFormatError::Invalid("unknown expression operation"))?;
+                    let lhs = self.operand(lhs_kind, lhs_lo, lhs_hi)?;
+                    let rhs = self.operand(rhs_kind, rhs_lo, rhs_hi)?;
+                    depth += lhs.is_some() as usize + rhs.is_some() as usize;
+                    let num_operands = match op {
+                        OpCode::ADD
+                        | OpCode::SUB
+                        | OpCode::MUL
+                        | OpCode::DIV
+                        | OpCode::POW
+                        | OpCode::RSUB
+                        | OpCode::RDIV
+                        | OpCode::RPOW => 2,
+                        _ => 1,
+                    };
+                    depth = depth
+                        .checked_sub(num_operands)
+                        .ok_or(BinaryFormatError::Invalid("invalid expression"))?
+                        + 1;
+                    replay.push(OPReplay { op, lhs, rhs });
+                }
+                if depth == 0 {
+                    return Err(BinaryFormatError::Invalid("empty expression"));
+                }
+                let expr = ParameterExpression::from_qpy(&replay)?;
+                Ok(Param::ParameterExpression(Arc::new(expr)))
+            }
+            _ => Err(BinaryFormatError::Invalid("unknown parameter kind")),
+        }
+    }
+
+    fn params(
+        &self,
+        start: u32,
+        len: u32,
+    ) -> Result<Option<Box<Parameters<Block>>>, BinaryFormatError> {
+        if len == 0 {
+            return Ok(None);
+        }
+        let params = (start..start.saturating_add(len))
+            .map(|index| self.param(index))
+            .collect::<Result<SmallVec<_>, _>>()?;
+        Ok(Some(Box::new(Parameters::Params(params))))
+    }
+
+    fn clbit(&self, index: usize) -> Result<ShareableClbit, BinaryFormatError> {
+        self.clbits
+            .get(index)
+            .cloned()
+            .ok_or(BinaryFormatError::Invalid("clbit out of bounds"))
+    }
+
+    fn creg(&self, index: usize) -> Result<ClassicalRegister, BinaryFormatError> {
+        self.cregs
+            .get(index)
+            .cloned()
+            .ok_or(BinaryFormatError::Invalid("register out of bounds"))
+    }
+
+    fn condition(&self, words: &mut Words) -> Result<Condition, BinaryFormatError> {
+        match words.next()? {
+            0 => {
+                let bit = self.clbit(words.next_index()?)?;
+                Ok(Condition::Bit(bit, words.next()? != 0))
+            }
+            1 => {
+                let register = self.creg(words.next_index()?)?;
+                Ok(Condition::Register(register, words.next_biguint()?))
+            }
+            _ => Err(BinaryFormatError::Invalid("unknown condition kind")),
+        }
+    }
+
+    fn control_flow(
+        &self,
+        code: u32,
+        start: u32,
+        num_qubits: u32,
+        num_blocks: usize,
+    ) -> Result<ControlFlowInstruction, BinaryFormatError> {
+        let mut words = self.buffer.words(start)?;
+        let num_clbits = u32::try_from(words.next()?)
+            .map_err(|_| BinaryFormatError::Invalid("clbit count out of bounds"))?;
+        let (control_flow, expected_blocks) = match code {
+            0 => {
+                let unit = words.next()?;
+                let value = words.next()?;
+                let duration = match unit {
+                    0 => None,
+                    1 => Some(Duration::dt(value as i64)),
+                    2 => Some(Duration::ps(f64::from_bits(value))),
+                    3 => Some(Duration::ns(f64::from_bits(value))),
+                    4 => Some(Duration::us(f64::from_bits(value))),
+                    5 => Some(Duration::ms(f64::from_bits(value))),
+                    6 => Some(Duration::s(f64::from_bits(value))),
+                    _ => return Err(BinaryFormatError::Invalid("unknown duration unit")),
+                };
+                let control_flow = ControlFlow::Box {
+                    duration: duration.map(BoxDuration::Duration),
+                    annotations: Vec::new(),
+                };
+                (control_flow, 1..=1)
+            }
+            1 => (ControlFlow::BreakLoop, 0..=0),
+            2 => (ControlFlow::ContinueLoop, 0..=0),
+            3 => {
+                let collection = match words.next()? {
+                    0 => {
+                        let start = words.next()? as isize;
+                        let stop = words.next()? as isize;
+                        let step = NonZero::new(words.next()? as isize)
+                            .ok_or(BinaryFormatError::Invalid("zero range step"))?;
+                        ForCollection::PyRange(PyRange { start, stop, step })
+                    }
+                    1 => {
+                        let len = words.next()?;
+                        let values = (0..len)
+                            .map(|_| words.next().map(|value| value as isize))
+                            .collect::<Result<Vec<_>, _>>()?;
+                        ForCollection::List(values)
+                    }
+                    _ => return Err(BinaryFormatError::Invalid("unknown loop collection")),
+                };
+                let loop_param = match words.next()? {
+                    u64::MAX => None,
+                    index => {
+                        let symbol = usize::try_from(index)
+                            .ok()
+                            .and_then(|index| self.symbols.get(index))
+                            .ok_or(BinaryFormatError::Invalid("symbol out of bounds"))?;
+                        Some(LoopParam::Parameter(Symbol::clone(symbol)))
+                    }
+                };
+                let control_flow = ControlFlow::ForLoop {
+                    collection,
+                    loop_param,
+                };
+                (control_flow, 1..=1)
+            }
+            4 => {
+                let condition = self.condition(&mut words)?;
+                (ControlFlow::IfElse { condition }, 1..=2)
+            }
+            5 => {
+                let target = match words.next()? {
+                    0 => SwitchTarget::Bit(self.clbit(words.next_index()?)?),
+                    1 => SwitchTarget::Register(self.creg(words.next_index()?)?),
+                    _ => return Err(BinaryFormatError::Invalid("unknown switch target")),
+                };
+                let num_cases = words.next_index()?;
+                let label_spec = (0..num_cases)
+                    .map(|_| {
+                        let num_specifiers = words.next()?;
+                        (0..num_specifiers)
+                            .map(|_| match words.next()? {
+                                0 => Ok(CaseSpecifier::Uint(words.next_biguint()?)),
+                                1 => Ok(CaseSpecifier::Default),
+                                _ => Err(BinaryFormatError::Invalid("unknown case specifier")),
+                            })
+                            .collect::<Result<Vec<_>, _>>()
+                    })
+                    .collect::<Result<Vec<_>, _>>()?;
+                let control_flow = ControlFlow::Switch {
+                    target,
+                    label_spec,
+                    cases: num_cases as u32,
+                };
+                (control_flow, num_cases..=num_cases)
+            }
+            6 => {
+                let condition = self.condition(&mut words)?;
+                (ControlFlow::While { condition }, 1..=1)
+            }
+            _ => return Err(BinaryFormatError::Invalid("unknown control-flow operation")),
+        };
+        if !expected_blocks.contains(&num_blocks) {
+            return Err(BinaryFormatError::Invalid("wrong number of blocks"));
+        }
+        Ok(ControlFlowInstruction {
+            control_flow,
+            num_qubits,
+            num_clbits,
+        })
+    }
+
+    /// Build the outer circuit.
+    ///
+    /// The circuits are built from the last to the first, so the blocks of each circuit, which
+    /// always have a higher index, are built before it without any recursion.
+    fn circuits(&self) -> Result<CircuitData, BinaryFormatError> {
+        let mut built = Vec::new();
+        built.resize_with(self.buffer.count(Section::Circuits), || None);
+        for index in (0..built.len()).rev() {
+            let circuit = self.circuit(index as u32, &mut built)?;
+            built[index] = Some(circuit);
+        }
+        let (circuit, _) = built[0]
+            .take()
+            .expect("the buffer has at least one circuit");
+        Ok(circuit)
+    }
+
+    /// Build the circuit at `index`, taking its blocks out of `built`.  Returns the circuit with
+    /// the depth of the control flow nested in it.
+    fn circuit(
+        &self,
+        index: u32,
+        built: &mut [Option<(CircuitData, usize)>],
+    ) -> Result<(CircuitData, usize), BinaryFormatError> {
+        let record =
+            CircuitRecord::from_fields(self.buffer.record(Section::Circuits, index as usize)?);
+        self.buffer.check_range(
+            Section::Instructions,
+            record.instructions,
+            record.num_instructions,
+        )?;
+        self.buffer
+            .check_range(Section::Args, record.qargs, record.num_qargs)?;
+        self.buffer
+            .check_range(Section::Args, record.cargs, record.num_cargs)?;
+        let mut circuit = CircuitData::with_capacity(
+            0,
+            0,
+            record.num_instructions as usize,
+            self.param(record.global_phase)?,
+        )?;
+        for bit in self.buffer.indices(record.qubits, record.num_qubits)? {
+            let bit = self
+                .qubits
+                .get(bit as usize)
+                .ok_or(BinaryFormatError::Invalid("qubit out of bounds"))?;
+            circuit.add_qubit(bit.clone(), true)?;
+        }
+        for bit in self.buffer.indices(record.clbits, record.num_clbits)? {
+            circuit.add_clbit(self.clbit(bit as usize)?, true)?;
+        }
+        for register in self.buffer.indices(record.qregs, record.num_qregs)? {
+            let register = self
+                .qregs
+                .get(register as usize)
+                .ok_or(BinaryFormatError::Invalid("register out of bounds"))?;
+            circuit.add_qreg(register.clone(), true)?;
+        }
+        for register in self.buffer.indices(record.cregs, record.num_cregs)? {
+            circuit.add_creg(self.creg(register as usize)?, true)?;
+        }
+
+        // Intern each argument list once, so instructions only copy the interned keys.
+        let mut qarg_keys = Vec::with_capacity(record.num_qargs as usize);
+        let mut qargs = Vec::new();
+        for args in 0..record.num_qargs {
+            let [start, len] = self
+                .buffer
+                .record(Section::Args, record.qargs as usize + args as usize)?;
+            qargs.clear();
+            for qubit in self.buffer.indices(start, len)? {
+                if qubit >= record.num_qubits {
+                    return Err(BinaryFormatError::Invalid("qubit out of bounds"));
+                }
+                qargs.push(Qubit(qubit));
+            }
+            qarg_keys.push(circuit.add_qargs(&qargs));
+        }
+        let mut carg_keys = Vec::with_capacity(record.num_cargs as usize);
+        let mut cargs = Vec::new();
+        for args in 0..record.num_cargs {
+            let [start, len] = self
+                .buffer
+                .record(Section::Args, record.cargs as usize + args as usize)?;
+            cargs.clear();
+            for clbit in self.buffer.indices(start, len)? {
+                if clbit >= record.num_clbits {
+                    return Err(BinaryFormatError::Invalid("clbit out of bounds"));
+                }
+                cargs.push(Clbit(clbit));
+            }
+            carg_keys.push(circuit.add_cargs(&cargs));
+        }
+
+        let mut blocks: HashMap<u32, Block> = HashMap::new();
+        let mut depth = 0;
+        for position in 0..record.num_instructions as usize {
+            let [op, arg, qargs, cargs, params, num_params, label, extra] = self.buffer.record(
+                Section::Instructions,
+                record.instructions as usize + position,
+            )?;
+            let qubits: Interned<[Qubit]> = *qarg_keys
+                .get(qargs as usize)
+                .ok_or(BinaryFormatError::Invalid("qargs out of bounds"))?;
+            let clbits: Interned<[Clbit]> = *carg_keys
+                .get(cargs as usize)
+                .ok_or(BinaryFormatError::Invalid("cargs out of bounds"))?;
+            let num_qargs = circuit.get_qargs(qubits).len();
+            let num_cargs = circuit.get_cargs(clbits).len();
+            let label = match label {
+                NONE => None,
+                label => Some(Box::new(self.buffer.string(label)?.to_owned())),
+            };
+            let (op, params) = match (op & 0xff, op >> 8) {
+                (KIND_STANDARD_GATE, code) => {
+                    let gate = u8::try_from(code)
+                        .ok()
+                        .and_then(|code| {
+                            ::bytemuck::checked::try_cast::<u8, StandardGate>(code).ok()
+                        })
+                        .ok_or(BinaryFormatError::Invalid("unknown standard gate"))?;
+                    if gate.num_qubits() as usize != num_qargs
+                        || gate.num_params() != num_params
+                        || num_cargs != 0
+                    {
+                        return Err(BinaryFormatError::Invalid("mismatched gate arguments"));
+                    }
+                    (gate.into(), self.params(params, num_params)?)
+                }
+                (KIND_STANDARD_INSTRUCTION, code) => {
+                    let instruction = match code {
+                        0 => StandardInstruction::Barrier(arg),
+                        1 => {
+                            let unit = u8::try_from(arg)
+                                .ok()
+                                .and_then(|unit| {
+                                    ::bytemuck::checked::try_cast::<u8, DelayUnit>(unit).ok()
+                                })
+                                .ok_or(BinaryFormatError::Invalid("unknown delay unit"))?;
+                            StandardInstruction::Delay(unit)
+                        }
+                        2 => StandardInstruction::Measure,
+                        3 => StandardInstruction::Reset,
+                        _ => {
+                            return Err(BinaryFormatError::Invalid("unknown standard instruction"));
+                        }
+                    };
+                    if instruction.num_qubits() as usize != num_qargs
+                        || instruction.num_clbits() as usize != num_cargs
+                        || instruction.num_params() != num_params
+                    {
+                        return Err(BinaryFormatError::Invalid(
+                            "mismatched instruction arguments",
+                        ));
+                    }
+                    (
+                        PackedOperation::from_standard_instruction(instruction),
+                        self.params(params, num_params)?,
+                    )
+                }
+                (KIND_UNITARY, _) => {
+                    if arg as usize != num_qargs || arg >= 32 {
+                        return Err(BinaryFormatError::Invalid("mismatched unitary arguments"));
+                    }
+                    let dim = 1usize << arg;
+                    let mut words = self.buffer.words(extra)?;
+                    let values = (0..dim * dim)
+                        .map(|_| Ok(Complex64::new(words.next_f64()?, words.next_f64()?)))
+                        .collect::<Result<Vec<_>, BinaryFormatError>>()?;
+                    let array = match arg {
+                        1 => ArrayType::OneQ(Matrix2::from_fn(|i, j| values[i * dim + j])),
+                        2 => ArrayType::TwoQ(Matrix4::from_fn(|i, j| values[i * dim + j])),
+                        _ => ArrayType::NDArray(
+                            Array2::from_shape_vec((dim, dim), values)
+                                .expect("the number of values matches the shape"),
+                        ),
+                    };
+                    let gate = Box::new(UnitaryGate { array });
+                    (PackedOperation::from_unitary(gate), None)
+                }
+                (KIND_CONTROL_FLOW, code) => {
+                    if arg as usize != num_qargs {
+                        return Err(BinaryFormatError::Invalid("mismatched control-flow qubits"));
+                    }
+                    let children = self.buffer.indices(params, num_params)?;
+                    let control_flow = self.control_flow(code, extra, arg, children.len())?;
+                    if control_flow.num_clbits as usize != num_cargs {
+                        return Err(BinaryFormatError::Invalid("mismatched control-flow clbits"));
+                    }
+                    let mut block_ids = Vec::with_capacity(children.len());
+                    for child in children {
+                        // Blocks always follow the circuit containing them, which also rules out
+                        // cycles in malformed input.
+                        if child <= index || child as usize >= built.len() {
+                            return Err(BinaryFormatError::Invalid("block out of order"));
+                        }
+                        // A circuit may use the same block several times, but no other circuit
+                        // may use it, so each block is only built once.
+                        let block = match blocks.get(&child) {
+                            Some(block) => *block,
+                            None => {
+                                let (block, block_depth) = built[child as usize].take().ok_or(
+                                    BinaryFormatError::Invalid("block used by several circuits"),
+                                )?;
+                                depth = depth.max(block_depth + 1);
+                                if depth > MAX_BLOCK_DEPTH {
+                                    return Err(BinaryFormatError::Invalid(
+                                        "control flow nested too deeply",
+                                    ));
+                                }
+                                let block = circuit.add_block(block);
+                                blocks.insert(child, block);
+                                block
+                            }
+                        };
+                        let block_circuit = &circuit.blocks()[block];
+                        if block_circuit.num_qubits() != num_qargs
+                            || block_circuit.num_clbits() != num_cargs
+                        {
+                            return Err(BinaryFormatError::Invalid("mismatched block width"));
+                        }
+                        block_ids.push(block);
+                    }
+                    (
+                        PackedOperation::from_control_flow(Box::new(control_flow)),
+                        Some(Box::new(Parameters::Blocks(block_ids))),
+                    )
+                }
+                _ => return Err(BinaryFormatError::Invalid("unknown operation kind")),
+            };
+            circuit.push(PackedInstruction {
+                op,
+                qubits,
+                clbits,
+                params,
+                label,
+                #[cfg(feature = "cache_pygates")]
+                py_op: Default::default(),
+            })?;
+        }
+        Ok((circuit, depth))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn section_start(bytes: &[u8], section: Section) -> usize {
+        let entry = HEADER_LEN + section as usize * SECTION_ENTRY_LEN;
+        read_u64(&bytes[entry..entry + 8]) as usize
+    }
+
+    fn bits_circuit(qubit: &ShareableQubit, clbit: &ShareableClbit) -> CircuitData {
+        let mut circuit = CircuitData::with_capacity(0, 0, 1, Param::Float(0.0)).unwrap();
+        circuit.add_qubit(qubit.clone(), true).unwrap();
+        circuit.add_clbit(clbit.clone(), true).unwrap();
+        circuit
+    }
+
+    /// Append an if-else on the first qubit and clbit of `circuit`, with `body` as its block.
+    fn push_if(circuit: &mut CircuitData, body: CircuitData) {
+        let condition = Condition::Bit(circuit.clbits().objects()[0].clone(), true);
+        let block = circuit.add_block(body);
+        let qubits = circuit.add_qargs(&[Qubit(0)]);
+        let clbits = circuit.add_cargs(&[Clbit(0)]);
+        let control_flow = ControlFlowInstruction {
+            control_flow: ControlFlow::IfElse { condition },
+            num_qubits: 1,
+            num_clbits: 1,
+        };
+        circuit
+            .push(PackedInstruction::from_control_flow(
+                control_flow,
+                vec![block],
+                qubits,
+                clbits,
+                None,
+            ))
+            .unwrap();
+    }
+
+    /// An X gate nested in `depth` if-else blocks.
+    fn nested_ifs(depth: usize) -> CircuitData {
+        let qubit = ShareableQubit::new_anonymous();
+        let clbit = ShareableClbit::new_anonymous();
+        let mut circuit = bits_circuit(&qubit, &clbit);
+        circuit
+            .push_packed_operation(StandardGate::X.into(), None, &[Qubit(0)], &[])
+            .unwrap();
+        for _ in 0..depth {
+            let mut outer = bits_circuit(&qubit, &clbit);
+            push_if(&mut outer, circuit);
+            circuit = outer;
+        }
+        circuit
+    }
+
+    #[test]
+    fn test_roundtrip_gates_and_registers() {
+        let qreg = QuantumRegister::new_owning("q", 2);
+        let creg = ClassicalRegister::new_owning("c", 2);
+        let mut circuit = CircuitData::with_capacity(0, 0, 4, Param::Float(0.5)).unwrap();
+        circuit.add_qreg(qreg.clone(), true).unwrap();
+        circuit.add_creg(creg.clone(), true).unwrap();
+        circuit
+            .add_qubit(ShareableQubit::new_anonymous(), true)
+            .unwrap();
+        let theta = Symbol::standalone("theta".to_string(), None);
+        let param =
+            Param::ParameterExpression(Arc::new(ParameterExpression::from_symbol(theta.clone())));
+        circuit
+            .push_packed_operation(StandardGate::H.into(), None, &[Qubit(0)], &[])
+            .unwrap();
+        circuit
+            .push_packed_operation(
+                StandardGate::RZ.into(),
+                Some(Parameters::Params(SmallVec::from_elem(param, 1))),
+                &[Qubit(2)],
+                &[],
+            )
+            .unwrap();
+        circuit
+            .push_packed_operation(StandardGate::CX.into(), None, &[Qubit(0), Qubit(1)], &[])
+            .unwrap();
+        circuit
+            .push_packed_operation(
+                PackedOperation::from_standard_instruction(StandardInstruction::Measure),
+                None,
+                &[Qubit(1)],
+                &[Clbit(1)],
+            )
+            .unwrap();
+
+        let bytes = serialize(&circuit).unwrap();
+        let buffer = CircuitBuffer::new(&bytes).unwrap();
+        assert_eq!(buffer.num_qubits(), 3);
+        assert_eq!(buffer.num_clbits(), 2);
+        assert_eq!(buffer.num_instructions(), 4);
+        let decoded = buffer.to_circuit_data().unwrap();
+
+        assert_eq!(decoded.qregs(), &[qreg]);
+        assert_eq!(decoded.cregs(), &[creg]);
+        assert_eq!(decoded.global_phase(), &Param::Float(0.5));
+        assert_eq!(decoded.num_parameters(), 1);
+        for (left, right) in circuit.data().iter().zip(decoded.data()) {
+            assert_eq!(left.op.name(), right.op.name());
+            assert_eq!(
+                circuit.get_qargs(left.qubits),
+                decoded.get_qargs(right.qubits)
+            );
+            assert_eq!(
+                circuit.get_cargs(left.clbits),
+                decoded.get_cargs(right.clbits)
+            );
+        }
+        let Param::ParameterExpression(expr) = &decoded.data()[1].params_view()[0] else {
+            panic!("expected a symbolic parameter");
+        };
+        // Symbols keep their identity across the round trip.
+        assert_eq!(expr.iter_symbols().collect::<Vec<_>>(), vec![&theta]);
+    }
+
+    #[test]
+    fn test_roundtrip_control_flow() {
+        let mut body = CircuitData::with_capacity(1, 1, 1, Param::Float(0.0)).unwrap();
+        body.push_packed_operation(StandardGate::X.into(), None, &[Qubit(0)], &[])
+            .unwrap();
+        let mut circuit = CircuitData::with_capacity(0, 0, 1, Param::Float(0.0)).unwrap();
+        for bit in body.qubits().objects() {
+            circuit.add_qubit(bit.clone(), true).unwrap();
+        }
+        for bit in body.clbits().objects() {
+            circuit.add_clbit(bit.clone(), true).unwrap();
+        }
+        let condition = Condition::Bit(body.clbits().objects()[0].clone(), true);
+        let block = circuit.add_block(body);
+        let qubits = circuit.add_qargs(&[Qubit(0)]);
+        let clbits = circuit.add_cargs(&[Clbit(0)]);
+        let control_flow = ControlFlowInstruction {
+            control_flow: ControlFlow::IfElse { condition },
+            num_qubits: 1,
+            num_clbits: 1,
+        };
+        circuit
+            .push(PackedInstruction::from_control_flow(
+                control_flow,
+                vec![block],
+                qubits,
+                clbits,
+                None,
+            ))
+            .unwrap();
+
+        let decoded = deserialize(&serialize(&circuit).unwrap()).unwrap();
+        let view = decoded
+            .try_view_control_flow(&decoded.data()[0])
+            .expect("expected control flow");
+        let blocks = view.blocks();
+        let [body] = blocks[..] else {
+            panic!("expected a single block");
+        };
+        assert_eq!(body.data().len(), 1);
+        // The block refers to the same bits as the outer circuit.
+        assert_eq!(body.qubits().objects(), decoded.qubits().objects());
+        assert_eq!(body.clbits().objects(), decoded.clbits().objects());
+    }
+
+    #[test]
+    fn test_invalid_bytes() {
+        let circuit = CircuitData::with_capacity(2, 0, 0, Param::Float(0.0)).unwrap();
+        let mut bytes = serialize(&circuit).unwrap();
+        assert!(deserialize(&bytes[..bytes.len() - 8]).is_err());
+        bytes[4] = 99;
+        assert!(matches!(
+            deserialize(&bytes),
+            Err(BinaryFormatError::UnsupportedVersion(99))
+        ));
+        assert!(deserialize(b"QKCB").is_err());
+
+        // Counts which run past the end of their section are rejected before anything is
+        // allocated for them.
+        let theta = Symbol::standalone("theta".to_string(), None);
+        let phase = Param::ParameterExpression(Arc::new(ParameterExpression::from_symbol(theta)));
+        let mut circuit = CircuitData::with_capacity(1, 0, 1, phase).unwrap();
+        circuit
+            .push_packed_operation(StandardGate::H.into(), None, &[Qubit(0)], &[])
+            .unwrap();
+        let bytes = serialize(&circuit).unwrap();
+        let circuit_record = section_start(&bytes, Section::Circuits);
+        let global_phase = CircuitBuffer::new(&bytes)
+            .unwrap()
+            .outer()
+            .unwrap()
+            .global_phase;
+        let phase_record = section_start(&bytes, Section::Params)
+            + global_phase as usize * Section::Params.record_size();
+        // `num_qargs`, `num_cargs` and `num_instructions` of the circuit, and the replay length of
+        // its global phase.
+        for offset in [
+            circuit_record + 9 * 4,
+            circuit_record + 11 * 4,
+            circuit_record + 13 * 4,
+            phase_record + 2 * 4,
+        ] {
+            let mut inflated = bytes.clone();
+            inflated[offset..offset + 4].copy_from_slice(&u32::MAX.to_le_bytes());
+            assert!(matches!(
+                deserialize(&inflated),
+                Err(BinaryFormatError::Invalid("index out of bounds"))
+            ));
+        }
+    }
+
+    #[test]
+    fn test_block_depth() {
+        assert!(deserialize(&serialize(&nested_ifs(MAX_BLOCK_DEPTH)).unwrap()).is_ok());
+        assert!(matches!(
+            deserialize(&serialize(&nested_ifs(MAX_BLOCK_DEPTH + 1)).unwrap()),
+            Err(BinaryFormatError::Invalid("control flow nested too deeply"))
+        ));
+    }
+
+    #[test]
+    fn test_block_used_by_several_circuits() {
+        let qubit = ShareableQubit::new_anonymous();
+        let clbit = ShareableClbit::new_anonymous();
+        let mut circuit = bits_circuit(&qubit, &clbit);
+        for _ in 0..2 {
+            let mut block = bits_circuit(&qubit, &clbit);
+            push_if(&mut block, bits_circuit(&qubit, &clbit));
+            push_if(&mut circuit, block);
+        }
+        let mut bytes = serialize(&circuit).unwrap();
+        assert!(deserialize(&bytes).is_ok());
+        // Circuits 1 and 2 are the blocks of the outer circuit, and 3 and 4 are their blocks.
+        // Point the if-else of circuit 2 at circuit 3 as well.
+        let offset = {
+            let buffer = CircuitBuffer::new(&bytes).unwrap();
+            let record = CircuitRecord::from_fields(buffer.record(Section::Circuits, 2).unwrap());
+            let [_, _, _, _, children] = buffer
+                .record(Section::Instructions, record.instructions as usize)
+                .unwrap();
+            section_start(&bytes, Section::Indices) + children as usize * 4
+        };
+        assert_eq!(read_u32(&bytes[offset..offset + 4]), 4);
+        bytes[offset..offset + 4].copy_from_slice(&3u32.to_le_bytes());
+        assert!(matches!(
+            deserialize(&bytes),
+            Err(BinaryFormatError::Invalid("block used by several circuits"))
+        ));
+    }
+
+    #[test]
+    fn test_mismatched_block_width() {
+        let qubit = ShareableQubit::new_anonymous();
+        let clbit = ShareableClbit::new_anonymous();
+        let mut circuit = bits_circuit(&qubit, &clbit);
+        push_if(&mut circuit, bits_circuit(&qubit, &clbit));
+        let mut bytes = serialize(&circuit).unwrap();
+        assert!(deserialize(&bytes).is_ok());
+        // Drop the clbit of the block, which its if-else still has.
+        let offset =
+            section_start(&bytes, Section::Circuits) + Section::Circuits.record_size() + 2 * 4;
+        bytes[offset..offset + 4].copy_from_slice(&0u32.to_le_bytes());
+        assert!(matches!(
+            deserialize(&bytes),
+            Err(BinaryFormatError::Invalid("mismatched block width"))
+        ));
+    }
+
+    #[test]
+    fn test_delay_without_duration() {
+        let mut circuit = CircuitData::with_capacity(1, 0, 1, Param::Float(0.0)).unwrap();
+        circuit
+            .push_packed_operation(
+                PackedOperation::from_standard_instruction(StandardInstruction::Delay(
+                    DelayUnit::DT,
+                )),
+                Some(Parameters::Params(SmallVec::from_elem(
+                    Param::Float(100.0),
+                    1,
+                ))),
+                &[Qubit(0)],
+                &[],
+            )
+            .unwrap();
+        let mut bytes = serialize(&circuit).unwrap();
+        assert!(deserialize(&bytes).is_ok());
+        // Drop the duration of the delay.
+        let offset = section_start(&bytes, Section::Instructions) + 5 * 4;
+        bytes[offset..offset + 4].copy_from_slice(&0u32.to_le_bytes());
+        assert!(matches!(
+            deserialize(&bytes),
+            Err(BinaryFormatError::Invalid(
+                "mismatched instruction arguments"
+            ))
+        ));
+    }
+
+    #[test]
+    fn test_biguint_words() {
+        let value = (BigUint::from(1u8) << 100u32) + 5u8;
+        let mut writer = Writer::default();
+        writer.push_biguint(&value);
+        writer.push_word(7);
+        let mut words = Words {
+            bytes: &writer.sections[Section::Words as usize],
+        };
+        assert_eq!(words.next_biguint().unwrap(), value);
+        assert_eq!(words.next().unwrap(), 7);
+        // A digit count beyond the end of the words.
+        let mut truncated = Words {
+            bytes: &u64::MAX.to_le_bytes(),
+        };
+        assert!(truncated.next_biguint().is_err());
+    }
+}
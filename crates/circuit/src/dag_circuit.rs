@@ -5859,6 +5859,103 @@ impl DAGCircuit {
         rustworkx_core::dag_algo::collect_bicolor_runs(&self.dag, filter_fn, color_fn).unwrap()
     }
 
+    /// Return the blocks of op nodes that match a filter function.
+    ///
+    /// This is the greedy algorithm of the Python `BlockCollector`: starting from the inputs of
+    /// the circuit, it alternately collects the largest set of nodes that do not match `filter`
+    /// and the largest set of nodes that do, until every op node is collected.  Each matching
+    /// set is split into blocks over disjoint qubits, and the blocks with fewer than
+    /// `min_block_size` nodes are dropped.  Nodes without qubits are not part of any block.
+    ///
+    /// `filter` is called once per op node, and the nodes of each block are in topological order.
+    pub fn collect_blocks_by<F: FnMut(NodeIndex, &PackedInstruction) -> bool>(
+        &self,
+        mut filter: F,
+        min_block_size: usize,
+    ) -> Vec<Vec<NodeIndex>> {
+        let is_op = |node: &NodeIndex| matches!(self.dag[*node], NodeType::Operation(_));
+        let mut matching = vec![false; self.dag.node_bound()];
+        // The number of uncollected op node predecessors of each node.
+        let mut in_degree = vec![0usize; self.dag.node_bound()];
+        let mut pending = Vec::new();
+        for (node, inst) in self.op_nodes(true) {
+            matching[node.index()] = filter(node, inst);
+            in_degree[node.index()] = self.predecessors(node).filter(is_op).count();
+            if in_degree[node.index()] == 0 {
+                pending.push(node);
+            }
+        }
+
+        // Collect the largest set of nodes whose filter result is `target`, starting from the
+        // nodes in `pending`.  The nodes that can't be collected are left in `pending`.
+        let collect = |target: bool, pending: &mut Vec<NodeIndex>, in_degree: &mut [usize]| {
+            let mut collected = Vec::new();
+            let mut unprocessed = std::mem::take(pending);
+            while let Some(node) = unprocessed.pop() {
+                if matching[node.index()] != target {
+                    pending.push(node);
+                    continue;
+                }
+                collected.push(node);
+                for successor in self.successors(node).filter(is_op) {
+                    in_degree[successor.index()] -= 1;
+                    if in_degree[successor.index()] == 0 {
+                        unprocessed.push(successor);
+                    }
+                }
+            }
+            collected
+        };
+
+        // A disjoint-set forest over the qubits, to split the collected nodes into blocks over
+        // disjoint qubits.  Only the touched qubits are reset after each block.
+        fn find(parent: &mut [usize], mut qubit: usize) -> usize {
+            while parent[qubit] != qubit {
+                parent[qubit] = parent[parent[qubit]];
+                qubit = parent[qubit];
+            }
+            qubit
+        }
+        let mut parent: Vec<usize> = (0..self.num_qubits()).collect();
+        let mut touched = Vec::new();
+
+        let mut blocks = Vec::new();
+        while !pending.is_empty() {
+            collect(false, &mut pending, &mut in_degree);
+            let collected = collect(true, &mut pending, &mut in_degree);
+            for node in &collected {
+                let qargs = self.get_qargs(self.dag[*node].unwrap_operation().qubits);
+                for pair in qargs.windows(2) {
+                    let (a, b) = (
+                        find(&mut parent, pair[0].index()),
+                        find(&mut parent, pair[1].index()),
+                    );
+                    parent[a] = b;
+                }
+                touched.extend(qargs.iter().map(|qubit| qubit.index()));
+            }
+            let mut block_of_set: HashMap<usize, usize> = HashMap::new();
+            for node in collected {
+                let qargs = self.get_qargs(self.dag[node].unwrap_operation().qubits);
+                let Some(first) = qargs.first() else {
+                    continue;
+                };
+                let block = *block_of_set
+                    .entry(find(&mut parent, first.index()))
+                    .or_insert_with(|| {
+                        blocks.push(Vec::new());
+                        blocks.len() - 1
+                    });
+                blocks[block].push(node);
+            }
+            for qubit in touched.drain(..) {
+                parent[qubit] = qubit;
+            }
+        }
+        blocks.retain(|block| block.len() >= min_block_size);
+        blocks
+    }
+
     /// Track an instruction from the [DAGCircuit].  This updates the name-count and blocks tracking
     /// information.
     ///
@@ -106,6 +106,7 @@ pub static PAULI_GATE: ImportOnceCell = ImportOnceCell::new("qiskit.circuit.libr
 pub static PAULI_EVOLUTION_GATE: ImportOnceCell =
     ImportOnceCell::new("qiskit.circuit.library", "PauliEvolutionGate");
 pub static MCMT_GATE: ImportOnceCell = ImportOnceCell::new("qiskit.circuit.library", "MCMTGate");
+pub static QFT_GATE: ImportOnceCell = ImportOnceCell::new("qiskit.circuit.library", "QFTGate");
 pub static BLUEPRINT_CIRCUIT: ImportOnceCell =
     ImportOnceCell::new("qiskit.circuit.library", "BlueprintCircuit");
 pub static PAULI_ROTATION_TRACE_AND_DIM: ImportOnceCell = ImportOnceCell::new(
@@ -11,6 +11,7 @@
 // that they have been altered from the originals.
 
 pub mod annotation;
+pub mod binary_format;
 pub mod bit;
 pub mod bit_locator;
 mod blocks;
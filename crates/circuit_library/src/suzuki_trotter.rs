@@ -11,11 +11,15 @@
 // that they have been altered from the originals.
 
 use qiskit_circuit::circuit_data::CircuitData;
-use qiskit_circuit::operations::{Param, StandardInstruction, multiply_param, radd_param};
+use qiskit_circuit::operations::{
+    Param, StandardGate, StandardInstruction, multiply_param, radd_param,
+};
 use qiskit_circuit::packed_instruction::PackedOperation;
 use qiskit_circuit::{Clbit, Qubit};
 use qiskit_quantum_info::sparse_observable::SparseObservable;
-use qiskit_synthesis::evolution::suzuki_trotter::{evolution, reorder_terms};
+use qiskit_synthesis::evolution::suzuki_trotter::{
+    evolution, order_terms_for_cancellation, reorder_terms,
+};
 use qiskit_synthesis::pauli_evolution::sparse_term_evolution;
 use smallvec::{SmallVec, smallvec};
 use thiserror::Error;
@@ -28,12 +32,24 @@ pub type Instruction = (
     Vec<Clbit>,
 );
 
+/// How to order the terms of the observable in each time step.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum TermOrdering {
+    /// Evolve the terms in the order of the observable.
+    Preserve,
+    /// Reorder the terms to evolve terms on disjoint qubits in parallel, to reduce the depth.
+    Depth,
+    /// Group commuting terms and reorder them to maximize the gates shared by the evolutions of
+    /// consecutive terms, and cancel these gates, to reduce the gate count.
+    Cancellation,
+}
+
 pub fn suzuki_trotter_evolution(
     observable: &SparseObservable,
     order: u32,
     reps: u32,
     time: f64,
-    preserve_order: bool,
+    ordering: TermOrdering,
     insert_barriers: bool,
 ) -> Result<CircuitData, EvolutionError> {
     if order > 1 && !order.is_multiple_of(2) || order == 0 {
@@ -44,14 +60,20 @@ pub fn suzuki_trotter_evolution(
         view.coeff.re *= time * 2.0 / (reps as f64);
         view
     });
-    let terms = if preserve_order || observable.bit_terms().len() <= 1 {
-        terms_iter.collect()
-    } else {
-        match reorder_terms(terms_iter) {
+    let terms: Vec<_> = match ordering {
+        _ if observable.bit_terms().len() <= 1 => terms_iter.collect(),
+        TermOrdering::Preserve => terms_iter.collect(),
+        TermOrdering::Depth => match reorder_terms(terms_iter) {
             Ok(terms) => terms,
             Err(msg) => return Err(EvolutionError::TermsReorder(msg.to_string())),
-        }
+        },
+        TermOrdering::Cancellation => order_terms_for_cancellation(terms_iter),
     };
+    // The labels are shared by all the evolutions of each term.
+    let labels: Vec<String> = terms
+        .iter()
+        .map(|view| view.bit_terms.iter().map(|bit| bit.py_label()).collect())
+        .collect();
 
     // execute evolution
     let evo: Vec<(usize, f64)> = evolution(order, terms.len());
@@ -70,11 +92,7 @@ pub fn suzuki_trotter_evolution(
             modified_phase = true;
         }
         let instructions = sparse_term_evolution(
-            view.bit_terms
-                .iter()
-                .map(|bit| bit.py_label())
-                .collect::<String>()
-                .leak(),
+            &labels[*index],
             view.indices.into(),
             (view.coeff.re * coeff).into(),
             false,
@@ -88,12 +106,26 @@ pub fn suzuki_trotter_evolution(
         instructions.chain(maybe_barrier)
     });
 
-    match CircuitData::from_packed_operations(
-        observable.num_qubits(),
-        0,
-        repeated_evo,
-        Param::Float(0.0),
-    ) {
+    let circuit = if ordering == TermOrdering::Cancellation {
+        repeated_evo
+            .collect::<Result<Vec<_>, _>>()
+            .and_then(|instructions| {
+                CircuitData::from_packed_operations(
+                    observable.num_qubits(),
+                    0,
+                    cancel_adjacent_gates(observable.num_qubits(), instructions).map(Ok),
+                    Param::Float(0.0),
+                )
+            })
+    } else {
+        CircuitData::from_packed_operations(
+            observable.num_qubits(),
+            0,
+            repeated_evo,
+            Param::Float(0.0),
+        )
+    };
+    match circuit {
         Ok(mut circuit) => {
             if modified_phase {
                 let _ = circuit.set_global_phase_param(multiply_param(&global_phase, -0.5));
@@ -104,6 +136,85 @@ pub fn suzuki_trotter_evolution(
     }
 }
 
+/// Cancel the pairs of consecutive gates on the same qubits that are inverse to each other, and
+/// merge consecutive rotations of the same kind on the same qubits.
+///
+/// The last surviving instruction on each qubit is tracked with a stack, so that the cancellation
+/// of a pair of gates exposes the gates before them to further cancellations, such as the CX
+/// ladders of consecutive Pauli evolutions.
+fn cancel_adjacent_gates(
+    num_qubits: u32,
+    instructions: Vec<Instruction>,
+) -> impl Iterator<Item = Instruction> {
+    let mut output: Vec<Option<Instruction>> = Vec::with_capacity(instructions.len());
+    let mut stacks: Vec<Vec<usize>> = vec![Vec::new(); num_qubits as usize];
+    for instruction in instructions {
+        let (op, params, qubits, _) = &instruction;
+        let previous = qubits
+            .first()
+            .and_then(|qubit| stacks[qubit.index()].last().copied())
+            .filter(|previous| {
+                qubits
+                    .iter()
+                    .all(|qubit| stacks[qubit.index()].last() == Some(previous))
+            });
+        if let Some(previous) = previous
+            && let Some(gate) = op.try_standard_gate()
+            && let Some((previous_op, previous_params, previous_qubits, _)) = &mut output[previous]
+            && previous_qubits == qubits
+            && let Some(previous_gate) = previous_op.try_standard_gate()
+        {
+            if is_inverse_pair(previous_gate, gate) {
+                output[previous] = None;
+                for qubit in qubits {
+                    stacks[qubit.index()].pop();
+                }
+                continue;
+            }
+            if previous_gate == gate && is_mergeable_rotation(gate) {
+                previous_params[0] = radd_param(previous_params[0].clone(), params[0].clone());
+                continue;
+            }
+        }
+        for qubit in qubits {
+            stacks[qubit.index()].push(output.len());
+        }
+        output.push(Some(instruction));
+    }
+    output.into_iter().flatten()
+}
+
+fn is_inverse_pair(first: StandardGate, second: StandardGate) -> bool {
+    matches!(
+        (first, second),
+        (StandardGate::H, StandardGate::H)
+            | (StandardGate::X, StandardGate::X)
+            | (StandardGate::Y, StandardGate::Y)
+            | (StandardGate::Z, StandardGate::Z)
+            | (StandardGate::CX, StandardGate::CX)
+            | (StandardGate::CZ, StandardGate::CZ)
+            | (StandardGate::Swap, StandardGate::Swap)
+            | (StandardGate::S, StandardGate::Sdg)
+            | (StandardGate::Sdg, StandardGate::S)
+            | (StandardGate::SX, StandardGate::SXdg)
+            | (StandardGate::SXdg, StandardGate::SX)
+    )
+}
+
+fn is_mergeable_rotation(gate: StandardGate) -> bool {
+    matches!(
+        gate,
+        StandardGate::RX
+            | StandardGate::RY
+            | StandardGate::RZ
+            | StandardGate::Phase
+            | StandardGate::RXX
+            | StandardGate::RYY
+            | StandardGate::RZZ
+            | StandardGate::RZX
+    )
+}
+
 fn create_barrier(num_qubits: u32) -> Instruction {
     (
         PackedOperation::from_standard_instruction(StandardInstruction::Barrier(num_qubits)),
@@ -0,0 +1,352 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+// Compressed QPY payloads
+//
+// This module writes and decodes the compressed variant of QPY described by `CompressedQPYHeader`.
+// Every program is compressed into its own frame, so the frames can be compressed and decompressed
+// in parallel, and single programs can be decompressed without touching the others. Deep circuits
+// repeat the same instruction headers and qarg lists over and over, so the frames may share a
+// dictionary trained on the encodings of the instructions being written.
+//
+// Two codecs are supported: zstd, which compresses best, and LZ4, which compresses and above all
+// decompresses faster at a worse ratio.  LZ4 frames are raw LZ4 blocks, whose decompressed size is
+// recorded in the frame table, and an LZ4 dictionary is raw sample data rather than a trained zstd
+// dictionary.
+
+use binrw::{BinRead, Endian, VecArgs};
+use rayon::prelude::*;
+use zstd::bulk::Compressor;
+use zstd::stream::read::Decoder;
+
+use crate::bytes::Bytes;
+use crate::error::QpyError;
+use crate::formats::{CompressedFrameV1Pack, CompressedQPYHeader, QPYFileHeader};
+use crate::index::{QPY_FILE_HEADER_SIZE, instruction_ranges};
+use crate::value::{CompressionCodec, serialize};
+
+use std::io::{Cursor, Read};
+
+/// The version of the compressed container format written by this module.
+pub const COMPRESSED_FORMAT_VERSION: u8 = 1;
+
+/// The size in bytes of `CompressedQPYHeader`: the magic bytes, the format version, the codec, the
+/// QPY file header and the dictionary size.
+pub const COMPRESSED_HEADER_SIZE: usize = 4 + 2 + QPY_FILE_HEADER_SIZE + 8;
+
+/// The size in bytes of a single `CompressedFrameV1Pack` in the frame table.
+pub const FRAME_TABLE_ENTRY_SIZE: usize = 24;
+
+// The maximum size of a trained dictionary, and the amount of instruction data it is trained on.
+// The zstd documentation recommends around a hundred times as much sample data as dictionary.
+const DICTIONARY_MAX_SIZE: usize = 16 * 1024;
+const DICTIONARY_SAMPLES_SIZE: usize = 100 * DICTIONARY_MAX_SIZE;
+
+// The most output a single byte of an LZ4 block can produce: a length byte of 255 extends a literal
+// run or match by 255 bytes.
+const LZ4_MAX_EXPANSION: usize = 255;
+
+/// How to compress the programs of a QPY payload.
+#[derive(Debug, Clone, Copy)]
+pub struct CompressionOptions {
+    pub codec: CompressionCodec,
+    pub level: i32,
+    pub train_dictionary: bool,
+}
+
+/// Train a dictionary for ``codec`` on the encodings of the instructions of the given serialized
+/// programs.
+///
+/// The dictionary is empty if there is too little instruction data to train one on.
+pub fn train_dictionary(
+    programs: &[Bytes],
+    qpy_version: u8,
+    codec: CompressionCodec,
+) -> Result<Bytes, QpyError> {
+    let mut samples: Vec<&[u8]> = Vec::new();
+    let mut samples_size = 0;
+    'programs: for program in programs {
+        for range in instruction_ranges(program, qpy_version)? {
+            if samples_size + range.len() > DICTIONARY_SAMPLES_SIZE {
+                break 'programs;
+            }
+            samples_size += range.len();
+            samples.push(&program[range]);
+        }
+    }
+    match codec {
+        // zstd refuses to train on too few samples, in which case the frames don't use a
+        // dictionary.
+        CompressionCodec::Zstd => Ok(zstd::dict::from_samples(&samples, DICTIONARY_MAX_SIZE)
+            .unwrap_or_default()
+            .into()),
+        // LZ4 matches directly against the dictionary bytes, so the samples themselves are used.
+        CompressionCodec::Lz4 => Ok(samples
+            .into_iter()
+            .flatten()
+            .take(DICTIONARY_MAX_SIZE)
+            .copied()
+            .collect::<Vec<u8>>()
+            .into()),
+    }
+}
+
+/// Compress each of the serialized programs into its own frame.
+pub fn compress_programs(
+    programs: &[Bytes],
+    options: &CompressionOptions,
+    dictionary: &[u8],
+    parallel: bool,
+) -> Result<Vec<Vec<u8>>, QpyError> {
+    match options.codec {
+        CompressionCodec::Zstd => {
+            if parallel {
+                programs
+                    .par_iter()
+                    .map_init(
+                        || Compressor::with_dictionary(options.level, dictionary),
+                        |compressor, program| match compressor {
+                            Ok(compressor) => compressor.compress(program).map_err(QpyError::from),
+                            Err(err) => Err(QpyError::SerializationError(format!(
+                                "failed to set up compression: {err}"
+                            ))),
+                        },
+                    )
+                    .collect()
+            } else {
+                let mut compressor = Compressor::with_dictionary(options.level, dictionary)?;
+                programs
+                    .iter()
+                    .map(|program| compressor.compress(program).map_err(QpyError::from))
+                    .collect()
+            }
+        }
+        CompressionCodec::Lz4 => {
+            let compress = |program: &Bytes| -> Result<Vec<u8>, QpyError> {
+                Ok(lz4_flex::block::compress_with_dict(program, dictionary))
+            };
+            if parallel {
+                programs.par_iter().map(compress).collect()
+            } else {
+                programs.iter().map(compress).collect()
+            }
+        }
+    }
+}
+
+/// Decompress a single frame, checking that it decompresses to ``size`` bytes.
+pub fn decompress_frame(
+    frame: &[u8],
+    size: u64,
+    codec: CompressionCodec,
+    dictionary: &[u8],
+) -> Result<Bytes, QpyError> {
+    match codec {
+        CompressionCodec::Zstd => {
+            let decoder = Decoder::with_dictionary(frame, dictionary)?;
+            // The size is untrusted, so it bounds the output rather than being used to
+            // preallocate it.
+            let mut program = Vec::new();
+            decoder
+                .take(size.saturating_add(1))
+                .read_to_end(&mut program)?;
+            if program.len() as u64 != size {
+                return Err(QpyError::InvalidFormat(format!(
+                    "compressed program has {} bytes rather than {size}",
+                    program.len()
+                )));
+            }
+            Ok(program.into())
+        }
+        CompressionCodec::Lz4 => {
+            // A single byte of an LZ4 block expands to at most 255 bytes of output, so larger sizes
+            // are invalid, and are rejected before the size is used to allocate the output.
+            let size = usize::try_from(size)?;
+            if size > frame.len().saturating_mul(LZ4_MAX_EXPANSION) {
+                return Err(QpyError::InvalidFormat(format!(
+                    "LZ4 frame of {} bytes cannot decompress to {size} bytes",
+                    frame.len()
+                )));
+            }
+            let program = lz4_flex::block::decompress_with_dict(frame, size, dictionary)
+                .map_err(|err| QpyError::InvalidFormat(format!("invalid LZ4 frame: {err}")))?;
+            if program.len() != size {
+                return Err(QpyError::InvalidFormat(format!(
+                    "compressed program has {} bytes rather than {size}",
+                    program.len()
+                )));
+            }
+            Ok(program.into())
+        }
+    }
+}
+
+/// Decompress frames, given along with their expected size, into serialized programs.
+pub fn decompress_frames(
+    frames: &[(Bytes, u64)],
+    codec: CompressionCodec,
+    dictionary: &[u8],
+    parallel: bool,
+) -> Result<Vec<Bytes>, QpyError> {
+    let decompress =
+        |(frame, size): &(Bytes, u64)| decompress_frame(frame, *size, codec, dictionary);
+    if parallel {
+        frames.par_iter().map(decompress).collect()
+    } else {
+        frames.iter().map(decompress).collect()
+    }
+}
+
+/// Build a compressed QPY payload from a file header and the serialized programs it describes.
+pub fn compress_qpy(
+    qpy_header: QPYFileHeader,
+    programs: &[Bytes],
+    options: &CompressionOptions,
+    parallel: bool,
+) -> Result<Bytes, QpyError> {
+    let dictionary = if options.train_dictionary {
+        train_dictionary(programs, qpy_header.qpy_version, options.codec)?
+    } else {
+        Bytes::new()
+    };
+    let frames = compress_programs(programs, options, &dictionary, parallel)?;
+    let header = CompressedQPYHeader {
+        format_version: COMPRESSED_FORMAT_VERSION,
+        codec: options.codec,
+        qpy_header,
+        dictionary_size: dictionary.len() as u64,
+    };
+    let serialized_header = serialize(&header)?;
+
+    let frames_start_offset =
+        serialized_header.len() + dictionary.len() + frames.len() * FRAME_TABLE_ENTRY_SIZE;
+    let frames_size: usize = frames.iter().map(|frame| frame.len()).sum();
+    let mut output = Vec::<u8>::with_capacity(frames_start_offset + frames_size);
+    output.extend_from_slice(&serialized_header);
+    output.extend_from_slice(&dictionary);
+    let mut current_offset = frames_start_offset as u64;
+    for (program, frame) in programs.iter().zip(&frames) {
+        let entry = CompressedFrameV1Pack {
+            offset: current_offset,
+            compressed_size: frame.len() as u64,
+            size: program.len() as u64,
+        };
+        output.extend_from_slice(&serialize(&entry)?);
+        current_offset += frame.len() as u64;
+    }
+    for frame in frames {
+        output.extend_from_slice(&frame);
+    }
+    Ok(Bytes::from(output))
+}
+
+/// Read the frame table found at the start of ``data``.
+pub fn read_frame_table(
+    data: &[u8],
+    num_programs: usize,
+) -> Result<Vec<CompressedFrameV1Pack>, QpyError> {
+    if data.len() / FRAME_TABLE_ENTRY_SIZE < num_programs {
+        return Err(QpyError::InvalidFormat(
+            "the compressed program table is truncated".to_string(),
+        ));
+    }
+    let frames = Vec::<CompressedFrameV1Pack>::read_options(
+        &mut Cursor::new(data),
+        Endian::Big,
+        VecArgs {
+            count: num_programs,
+            inner: (),
+        },
+    )?;
+    Ok(frames)
+}
+
+/// Check that the container header describes a payload this module can decompress.
+pub fn check_compressed_header(header: &CompressedQPYHeader) -> Result<(), QpyError> {
+    if header.format_version != COMPRESSED_FORMAT_VERSION {
+        return Err(QpyError::InvalidFormat(format!(
+            "unsupported compressed QPY format version {}",
+            header.format_version
+        )));
+    }
+    Ok(())
+}
+
+#[cfg(test)]
+#[allow(clippy::unwrap_used)]
+mod tests {
+    use super::*;
+
+    // Repetitive data shaped like instruction encodings, with some noise from a fixed xorshift
+    // sequence so that not everything matches.
+    fn sample(len: usize, seed: u64) -> Vec<u8> {
+        let mut state = seed | 1;
+        let mut data = Vec::with_capacity(len);
+        while data.len() < len {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            data.extend_from_slice(b"\x00\x02cx\x00\x00\x00\x00\x02");
+            data.extend_from_slice(&state.to_be_bytes()[..(state % 5) as usize]);
+        }
+        data.truncate(len);
+        data
+    }
+
+    #[test]
+    fn test_frame_roundtrip() {
+        let dictionary = sample(4096, 1);
+        for codec in [CompressionCodec::Zstd, CompressionCodec::Lz4] {
+            let options = CompressionOptions {
+                codec,
+                level: 3,
+                train_dictionary: false,
+            };
+            for (len, seed) in [(0, 2), (1, 3), (17, 4), (1000, 5), (100_000, 6)] {
+                let program: Bytes = sample(len, seed).into();
+                for dictionary in [&[][..], &dictionary[..]] {
+                    let frames = compress_programs(
+                        std::slice::from_ref(&program),
+                        &options,
+                        dictionary,
+                        false,
+                    )
+                    .unwrap();
+                    let size = program.len() as u64;
+                    let decompressed = decompress_frame(&frames[0], size, codec, dictionary);
+                    assert_eq!(&decompressed.unwrap()[..], &program[..]);
+                }
+            }
+        }
+    }
+
+    #[test]
+    fn test_invalid_frames() {
+        for codec in [CompressionCodec::Zstd, CompressionCodec::Lz4] {
+            let options = CompressionOptions {
+                codec,
+                level: 3,
+                train_dictionary: false,
+            };
+            let program: Bytes = sample(10_000, 7).into();
+            let frame = compress_programs(std::slice::from_ref(&program), &options, &[], false)
+                .unwrap()
+                .remove(0);
+            let size = program.len() as u64;
+            assert!(decompress_frame(&frame, size - 1, codec, &[]).is_err());
+            assert!(decompress_frame(&frame, size + 1, codec, &[]).is_err());
+            assert!(decompress_frame(&frame, u64::MAX, codec, &[]).is_err());
+            assert!(decompress_frame(&frame[..frame.len() / 2], size, codec, &[]).is_err());
+            assert!(decompress_frame(&[], size, codec, &[]).is_err());
+        }
+    }
+}
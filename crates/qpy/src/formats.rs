@@ -15,8 +15,9 @@ use crate::error::{QpyError, to_binrw_error};
 use crate::expr::{read_expression, write_expression};
 use crate::params::ParameterType;
 use crate::value::{
-    BitType, CircuitInstructionType, ExpressionType, ExpressionVarDeclaration, ModifierType,
-    ProgramType, QPYReadData, QPYWriteData, RegisterType, SymbolicEncoding, ValueType,
+    BitType, CircuitInstructionType, CompressionCodec, ExpressionType, ExpressionVarDeclaration,
+    ModifierType, ProgramType, QPYReadData, QPYWriteData, RegisterType, SymbolicEncoding,
+    ValueType,
 };
 use binrw::{BinRead, BinResult, BinWrite, Endian, binread, binrw, binwrite};
 use qiskit_circuit::classical::expr::Expr;
@@ -48,6 +49,34 @@ pub struct QPYFileHeader {
     pub type_key: ProgramType,
 }
 
+// A compressed QPY payload is a container around a regular one:
+// 1) The magic bytes "QPYZ", the version of the container format and the compression codec.
+// 2) The file header of the QPY payload being compressed.
+// 3) The size of the compression dictionary shared by all programs, which may be empty.
+// This header is followed by the dictionary, a table with a `CompressedFrameV1Pack` per program
+// and the compressed programs themselves. Each program is compressed on its own, so that single
+// programs can still be located and decoded without touching the others.
+#[binrw]
+#[brw(big)]
+#[derive(Debug)]
+pub struct CompressedQPYHeader {
+    #[brw(magic = b"QPYZ")]
+    pub format_version: u8,
+    pub codec: CompressionCodec,
+    pub qpy_header: QPYFileHeader,
+    pub dictionary_size: u64,
+}
+
+// The location of a compressed program in the payload, and its size after and before compression
+#[binrw]
+#[brw(big)]
+#[derive(Debug)]
+pub struct CompressedFrameV1Pack {
+    pub offset: u64,
+    pub compressed_size: u64,
+    pub size: u64,
+}
+
 // the main circuit data structure:
 // 1) Header: Contains the global data such as name, number of qubits etc.
 // 2) Standalone vars: Contains the qiskit_circuit::Var elements used in expressions
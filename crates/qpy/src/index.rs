@@ -0,0 +1,361 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+// QPY program index
+//
+// This module locates the byte range of every program in a QPY payload without unpacking any of
+// them, so that a single program can be read and decoded on its own. Since QPY version 16 the file
+// header is followed by a table of program offsets, which gives the start of every program. The
+// table doesn't record where the last program ends, and older payloads have no table at all and
+// store their programs back to back, so these boundaries are recovered by skimming over programs
+// using only the size fields of their sections; instructions are stepped over without being
+// parsed.
+//
+// The offsets in the table are relative to the start of the payload. Payloads written at a nonzero
+// stream position by older versions of Qiskit have offsets relative to the start of the stream
+// instead. The first program always directly follows the table, so either way the table is rebased
+// so its first offset points there. A table which still isn't consistent with the payload is
+// ignored, and the programs are skimmed over instead.
+
+use binrw::{BinRead, Endian, VecArgs};
+
+use crate::error::QpyError;
+use crate::formats::{
+    CalibrationsPack, ConditionType, ExpressionVarDeclarationPack, QPYFileHeader, extras_key_parts,
+};
+use crate::value::deserialize;
+
+use std::io::Cursor;
+use std::ops::Range;
+
+/// The first QPY version whose file header is followed by a table of program offsets.
+pub const QPY_OFFSET_TABLE_MIN_VERSION: u8 = 16;
+
+/// The size in bytes of the QPY file header: the magic bytes, the QPY and Qiskit versions, the
+/// number of programs, the symbolic encoding and the program type.
+pub const QPY_FILE_HEADER_SIZE: usize = 20;
+
+/// The size in bytes of a single entry of the program offset table.
+pub const OFFSET_TABLE_ENTRY_SIZE: usize = 8;
+
+/// The file header of a QPY payload, along with the byte range of each of its programs.
+#[derive(Debug)]
+pub struct QpyIndex {
+    pub header: QPYFileHeader,
+    programs: Vec<Range<usize>>,
+    end: usize,
+}
+
+impl QpyIndex {
+    /// Build the index of a QPY payload held in memory.
+    pub fn new(data: &[u8]) -> Result<Self, QpyError> {
+        let (header, header_size) = deserialize::<QPYFileHeader>(data)?;
+        let num_programs = usize::try_from(header.num_programs)?;
+        let programs = if header.qpy_version >= QPY_OFFSET_TABLE_MIN_VERSION {
+            let table = data.get(header_size..).unwrap_or_default();
+            let offsets = read_offset_table(table, num_programs)?;
+            let table_end = header_size + num_programs * OFFSET_TABLE_ENTRY_SIZE;
+            match program_starts(&offsets, table_end, data.len()) {
+                Some(starts) => {
+                    let mut ranges: Vec<Range<usize>> =
+                        starts.windows(2).map(|pair| pair[0]..pair[1]).collect();
+                    if let Some(&last) = starts.last() {
+                        ranges.push(last..program_end(data, last, header.qpy_version)?);
+                    }
+                    ranges
+                }
+                None => skim_programs(data, table_end, num_programs, header.qpy_version)?,
+            }
+        } else {
+            skim_programs(data, header_size, num_programs, header.qpy_version)?
+        };
+        let end = match programs.last() {
+            Some(range) => range.end,
+            None => header_size + num_programs * OFFSET_TABLE_ENTRY_SIZE,
+        };
+        Ok(QpyIndex {
+            header,
+            programs,
+            end,
+        })
+    }
+
+    pub fn num_programs(&self) -> usize {
+        self.programs.len()
+    }
+
+    /// The size of the payload, which ends with its last program. Any data after it isn't part of
+    /// the payload.
+    pub fn end(&self) -> usize {
+        self.end
+    }
+
+    /// The byte range of the program at ``index`` within the payload.
+    pub fn range(&self, index: usize) -> Result<Range<usize>, QpyError> {
+        self.programs.get(index).cloned().ok_or_else(|| {
+            QpyError::InvalidParameter(format!(
+                "program index {index} is out of range for a payload with {} programs",
+                self.programs.len()
+            ))
+        })
+    }
+
+    /// The raw bytes of the program at ``index``.
+    pub fn program<'a>(&self, data: &'a [u8], index: usize) -> Result<&'a [u8], QpyError> {
+        data.get(self.range(index)?)
+            .ok_or_else(|| QpyError::InvalidFormat("program data is truncated".to_string()))
+    }
+}
+
+/// Read the big-endian program offset table found at the start of ``data``.
+pub fn read_offset_table(data: &[u8], num_programs: usize) -> Result<Vec<u64>, QpyError> {
+    if data.len() / OFFSET_TABLE_ENTRY_SIZE < num_programs {
+        return Err(QpyError::InvalidFormat(
+            "the program offset table is truncated".to_string(),
+        ));
+    }
+    let offsets = Vec::<u64>::read_options(
+        &mut Cursor::new(data),
+        Endian::Big,
+        VecArgs {
+            count: num_programs,
+            inner: (),
+        },
+    )?;
+    Ok(offsets)
+}
+
+/// Turn a table of program offsets into the start of every program relative to the start of the
+/// payload, where ``table_end`` is the end of the offset table and ``size`` is the number of bytes
+/// available to the payload. Returns ``None`` if the table isn't consistent with the payload.
+pub fn program_starts(offsets: &[u64], table_end: usize, size: usize) -> Option<Vec<usize>> {
+    let base = match offsets.first() {
+        Some(first) => first.checked_sub(table_end as u64)?,
+        None => 0,
+    };
+    let mut starts = Vec::with_capacity(offsets.len());
+    let mut previous = table_end;
+    for offset in offsets {
+        let start = usize::try_from(offset.checked_sub(base)?).ok()?;
+        if start < previous || start > size {
+            return None;
+        }
+        starts.push(start);
+        previous = start;
+    }
+    Some(starts)
+}
+
+/// The end of the program which starts at ``start`` within ``data``, found by skimming over it.
+pub fn program_end(data: &[u8], start: usize, version: u8) -> Result<usize, QpyError> {
+    let mut skim = Skim {
+        cursor: Cursor::new(data),
+        instructions: None,
+    };
+    skim.cursor.set_position(start as u64);
+    skim.circuit(version)?;
+    Ok(skim.position())
+}
+
+// Recover the program boundaries of a payload without an offset table, by skimming over each
+// program in turn starting from ``start``.
+fn skim_programs(
+    data: &[u8],
+    start: usize,
+    num_programs: usize,
+    version: u8,
+) -> Result<Vec<Range<usize>>, QpyError> {
+    let mut skim = Skim {
+        cursor: Cursor::new(data),
+        instructions: None,
+    };
+    skim.cursor.set_position(start as u64);
+    // The program count is untrusted, so the ranges aren't preallocated.
+    let mut ranges = Vec::new();
+    for _ in 0..num_programs {
+        let program_start = skim.position();
+        skim.circuit(version)?;
+        ranges.push(program_start..skim.position());
+    }
+    Ok(ranges)
+}
+
+/// The byte ranges of the top-level instructions of a single serialized program.
+pub fn instruction_ranges(program: &[u8], version: u8) -> Result<Vec<Range<usize>>, QpyError> {
+    let mut skim = Skim {
+        cursor: Cursor::new(program),
+        instructions: Some(Vec::new()),
+    };
+    skim.circuit(version)?;
+    Ok(skim.instructions.unwrap_or_default())
+}
+
+// A cursor which steps over the sections of a serialized `QPYCircuit`, reading only the size
+// fields it needs to find where each section ends. The layout mirrors the structures in
+// `formats.rs`, which should be kept in sync with it.
+struct Skim<'a> {
+    cursor: Cursor<&'a [u8]>,
+    // If set, the byte range of every instruction stepped over is recorded here.
+    instructions: Option<Vec<Range<usize>>>,
+}
+
+impl Skim<'_> {
+    fn position(&self) -> usize {
+        self.cursor.position() as usize
+    }
+
+    fn skip(&mut self, size: u64) -> Result<(), QpyError> {
+        let position = self
+            .cursor
+            .position()
+            .checked_add(size)
+            .filter(|position| *position <= self.cursor.get_ref().len() as u64)
+            .ok_or_else(|| QpyError::InvalidFormat("program data is truncated".to_string()))?;
+        self.cursor.set_position(position);
+        Ok(())
+    }
+
+    fn read<T>(&mut self) -> Result<T, QpyError>
+    where
+        T: for<'b> BinRead<Args<'b> = ()>,
+    {
+        Ok(T::read_options(&mut self.cursor, Endian::Big, ())?)
+    }
+
+    fn circuit(&mut self, version: u8) -> Result<(), QpyError> {
+        // CircuitHeaderV12Pack
+        let name_size = self.read::<u16>()?;
+        self.skip(1)?; // global_phase_type
+        let global_phase_size = self.read::<u16>()?;
+        self.skip(8)?; // num_qubits, num_clbits
+        let metadata_size = self.read::<u64>()?;
+        let num_registers = self.read::<u32>()?;
+        let num_instructions = self.read::<u64>()?;
+        let num_vars = self.read::<u32>()?;
+        self.skip(name_size as u64 + global_phase_size as u64)?;
+        self.skip(metadata_size)?;
+        for _ in 0..num_registers {
+            self.register()?;
+        }
+        // The variable declarations carry variable-length types, and are few enough to parse.
+        Vec::<ExpressionVarDeclarationPack>::read_options(
+            &mut self.cursor,
+            Endian::Big,
+            VecArgs {
+                count: num_vars as usize,
+                inner: (),
+            },
+        )?;
+        if version >= 15 {
+            // AnnotationHeaderStaticPack
+            let num_namespaces = self.read::<u32>()?;
+            for _ in 0..num_namespaces {
+                let namespace_size = self.read::<u32>()?;
+                let state_size = self.read::<u64>()?;
+                self.skip(namespace_size as u64)?;
+                self.skip(state_size)?;
+            }
+        }
+        // CustomCircuitInstructionsPack
+        let num_custom_instructions = self.read::<u64>()?;
+        for _ in 0..num_custom_instructions {
+            let gate_name_size = self.read::<u16>()?;
+            self.skip(10)?; // gate_type, num_qubits, num_clbits, custom_definition
+            let size = self.read::<u64>()?;
+            self.skip(8)?; // num_ctrl_qubits, ctrl_state
+            let base_gate_size = self.read::<u64>()?;
+            self.skip(gate_name_size as u64)?;
+            self.skip(size)?;
+            self.skip(base_gate_size)?;
+        }
+        for _ in 0..num_instructions {
+            let instruction_start = self.position();
+            self.instruction()?;
+            let instruction_end = self.position();
+            if let Some(instructions) = self.instructions.as_mut() {
+                instructions.push(instruction_start..instruction_end);
+            }
+        }
+        // Calibrations are obsolete and almost always empty, so these are simply parsed.
+        CalibrationsPack::read_options(&mut self.cursor, Endian::Big, (version,))?;
+        self.layout()
+    }
+
+    // CircuitInstructionV2Pack
+    fn instruction(&mut self) -> Result<(), QpyError> {
+        let name_size = self.read::<u16>()?;
+        let label_size = self.read::<u16>()?;
+        let num_parameters = self.read::<u16>()?;
+        let num_qargs = self.read::<u32>()?;
+        let num_cargs = self.read::<u32>()?;
+        let extras_key = self.read::<u8>()?;
+        let condition_register_size = self.read::<u16>()?;
+        self.skip(16)?; // condition_value, num_ctrl_qubits, ctrl_state
+        self.skip(name_size as u64 + label_size as u64)?;
+        match ConditionType::try_from(extras_key & extras_key_parts::CONDITIONAL)? {
+            ConditionType::None => (),
+            ConditionType::TwoTuple => self.skip(condition_register_size as u64)?,
+            ConditionType::Expression => self.generic_data()?,
+        }
+        // CircuitInstructionArgPack: a bit type and a u32 index per bit.
+        self.skip(5 * (num_qargs as u64 + num_cargs as u64))?;
+        for _ in 0..num_parameters {
+            self.generic_data()?;
+        }
+        if extras_key & extras_key_parts::ANNOTATIONS != 0 {
+            let num_annotations = self.read::<u32>()?;
+            for _ in 0..num_annotations {
+                self.skip(4)?; // namespace_index
+                let payload_size = self.read::<u64>()?;
+                self.skip(payload_size)?;
+            }
+        }
+        Ok(())
+    }
+
+    // GenericDataPack
+    fn generic_data(&mut self) -> Result<(), QpyError> {
+        self.skip(1)?; // type_key
+        let data_len = self.read::<u64>()?;
+        self.skip(data_len)
+    }
+
+    // RegisterV4Pack
+    fn register(&mut self) -> Result<(), QpyError> {
+        self.skip(2)?; // register_type, standalone
+        let size = self.read::<u32>()?;
+        let name_size = self.read::<u16>()?;
+        self.skip(1)?; // in_circuit
+        self.skip(name_size as u64)?;
+        self.skip(8 * size as u64)
+    }
+
+    // LayoutV2Pack
+    fn layout(&mut self) -> Result<(), QpyError> {
+        self.skip(1)?; // exists
+        let initial_layout_size = self.read::<i32>()?;
+        let input_mapping_size = self.read::<i32>()?;
+        let final_layout_size = self.read::<i32>()?;
+        let extra_registers_length = self.read::<u32>()?;
+        self.skip(4)?; // input_qubit_count
+        for _ in 0..extra_registers_length {
+            self.register()?;
+        }
+        for _ in 0..initial_layout_size.max(0) {
+            self.skip(4)?; // index_value
+            let register_name_length = self.read::<i32>()?;
+            self.skip(register_name_length.max(0) as u64)?;
+        }
+        self.skip(4 * input_mapping_size.max(0) as u64)?;
+        self.skip(4 * final_layout_size.max(0) as u64)
+    }
+}
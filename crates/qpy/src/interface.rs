@@ -16,20 +16,29 @@
 // quantum circuits to/from QPY format. It handles the complete file structure
 // including headers, circuit tables, and multiple circuits.
 
-use binrw::{BinRead, Endian, VecArgs};
 use pyo3::PyResult;
 use pyo3::prelude::*;
 use pyo3::types::{PyAny, PyDict};
 use qiskit_circuit::converters::QuantumCircuitData;
+use qiskit_util::getenv_use_multiple_threads;
+use rayon::prelude::*;
 
 use crate::bytes::Bytes;
 use crate::circuit_reader::unpack_circuit;
 use crate::circuit_writer::pack_circuit;
+use crate::compression::{
+    COMPRESSED_HEADER_SIZE, CompressionOptions, FRAME_TABLE_ENTRY_SIZE, check_compressed_header,
+    compress_qpy, decompress_frames, read_frame_table,
+};
 use crate::error::QpyError;
-use crate::formats::{QPYCircuit, QPYFileHeader};
-use crate::value::{ProgramType, SymbolicEncoding, deserialize, deserialize_with_args, serialize};
-
-use std::io::{Cursor, Seek};
+use crate::formats::{CompressedQPYHeader, QPYCircuit, QPYFileHeader};
+use crate::index::{
+    OFFSET_TABLE_ENTRY_SIZE, QPY_FILE_HEADER_SIZE, QPY_OFFSET_TABLE_MIN_VERSION, QpyIndex,
+    program_end, program_starts, read_offset_table,
+};
+use crate::value::{
+    CompressionCodec, ProgramType, SymbolicEncoding, deserialize, deserialize_with_args, serialize,
+};
 
 // helper function to parse int from ascii at compile time
 const fn parse_u8_from_ascii(s: &str) -> u8 {
@@ -57,12 +66,18 @@ const fn parse_version() -> (u8, u8, u8) {
 const QISKIT_VERSION: (u8, u8, u8) = parse_version();
 const QPY_READ_MIN_VERSION: u8 = 13;
 const QPY_WRITE_MIN_VERSION: u8 = 17;
+// The binary encoding and decoding of programs is spread across threads once a payload holds at
+// least this many programs. Packing circuits into (and unpacking them from) their QPY structures
+// calls into Python, so that part is always done serially.
+const PARALLEL_PROGRAMS_THRESHOLD: usize = 8;
+
 pub fn dump_qpy(
     mut circuits: Vec<QuantumCircuitData>,
     metadata_serializer: Option<Bound<PyAny>>,
     use_symengine: bool,
     qpy_version: u8,
     annotation_factories: Bound<PyDict>,
+    compression: Option<CompressionOptions>,
 ) -> Result<Bytes, QpyError> {
     if qpy_version < QPY_WRITE_MIN_VERSION {
         Err(QpyError::UnsupportedFeatureForVersion {
@@ -71,18 +86,35 @@ pub fn dump_qpy(
             min_version: QPY_WRITE_MIN_VERSION,
         })?;
     }
-    let serialized_circuits: Vec<Bytes> = circuits
-        .iter_mut()
-        .map(|circuit| {
-            serialize(&pack_circuit(
-                circuit,
-                metadata_serializer.as_ref(),
-                use_symengine,
-                qpy_version,
-                &annotation_factories,
-            )?)
-        })
-        .collect::<Result<Vec<Bytes>, QpyError>>()?;
+    let pack = |circuit: &mut QuantumCircuitData| {
+        pack_circuit(
+            circuit,
+            metadata_serializer.as_ref(),
+            use_symengine,
+            qpy_version,
+            &annotation_factories,
+        )
+    };
+    let parallel = getenv_use_multiple_threads() && circuits.len() >= PARALLEL_PROGRAMS_THRESHOLD;
+    let serialized_circuits: Vec<Bytes> = if parallel {
+        let packed_circuits = circuits
+            .iter_mut()
+            .map(&pack)
+            .collect::<Result<Vec<QPYCircuit>, QpyError>>()?;
+        // Each circuit is written into its own buffer, and the buffers are concatenated in
+        // order below, so the output is identical to that of the serial path.
+        annotation_factories.py().detach(|| {
+            packed_circuits
+                .par_iter()
+                .map(serialize)
+                .collect::<Result<Vec<Bytes>, QpyError>>()
+        })?
+    } else {
+        circuits
+            .iter_mut()
+            .map(|circuit| serialize(&pack(circuit)?))
+            .collect::<Result<Vec<Bytes>, QpyError>>()?
+    };
     let symbolic_encoding = match use_symengine {
         true => SymbolicEncoding::Symengine,
         false => SymbolicEncoding::Sympy,
@@ -94,6 +126,11 @@ pub fn dump_qpy(
         symbolic_encoding,
         type_key: ProgramType::Circuit, //for now, no other value type is used
     };
+    if let Some(options) = compression {
+        return annotation_factories
+            .py()
+            .detach(|| compress_qpy(qpy_header, &serialized_circuits, &options, parallel));
+    }
     let serialized_qpy_header = serialize(&qpy_header)?;
 
     // At this point we have collected all the relevant data
@@ -125,6 +162,8 @@ pub fn dump_qpy(
 
 #[pyfunction]
 #[pyo3(name = "dump")]
+#[pyo3(signature = (programs, file_obj, metadata_serializer, use_symengine, version, annotation_factories, compression=None, compression_level=3, train_dictionary=false))]
+#[allow(clippy::too_many_arguments)]
 pub fn py_dump_qpy(
     py: Python,
     programs: &Bound<PyAny>,
@@ -133,67 +172,34 @@ pub fn py_dump_qpy(
     use_symengine: Option<bool>,
     version: u8,
     annotation_factories: Option<Bound<PyDict>>,
+    compression: Option<&str>,
+    compression_level: i32,
+    train_dictionary: bool,
 ) -> PyResult<()> {
     let annotation_factories = annotation_factories.unwrap_or(PyDict::new(py));
+    let compression = compression
+        .map(|codec| -> Result<CompressionOptions, QpyError> {
+            Ok(CompressionOptions {
+                codec: CompressionCodec::try_from(codec)?,
+                level: compression_level,
+                train_dictionary,
+            })
+        })
+        .transpose()?;
     let serialized_qpy = dump_qpy(
         programs.extract()?,
         metadata_serializer,
         use_symengine.unwrap_or(false),
         version,
         annotation_factories,
+        compression,
     )?;
     file_obj.call_method1("write", (pyo3::types::PyBytes::new(py, &serialized_qpy),))?;
     Ok(())
 }
 
-// reads the offset table and splits the raw bytes into circuits accordingly
-pub fn read_raw_circuits(
-    cursor: &mut Cursor<&[u8]>,
-    num_programs: usize,
-) -> Result<Vec<Bytes>, QpyError> {
-    let circuit_table = Vec::<u64>::read_options(
-        cursor,
-        Endian::Big,
-        VecArgs {
-            count: num_programs,
-            inner: (),
-        },
-    )?;
-
-    // Read circuits using offset differences to determine sizes
-    let mut circuits = Vec::with_capacity(num_programs);
-
-    for i in 0..num_programs {
-        let size = if i + 1 < circuit_table.len() {
-            (circuit_table[i + 1] - circuit_table[i]) as usize
-        } else {
-            // Last circuit: read remaining bytes
-            let current_pos = cursor.stream_position()?;
-            let end_pos = cursor.seek(std::io::SeekFrom::End(0))?;
-            cursor.seek(std::io::SeekFrom::Start(current_pos))?;
-            (end_pos - current_pos) as usize
-        };
-
-        let circuit = Bytes::read_options(
-            cursor,
-            Endian::Big,
-            VecArgs::<Vec<u8>> {
-                count: size,
-                inner: Vec::new(),
-            },
-        )?;
-        circuits.push(circuit);
-    }
-    Ok(circuits)
-}
-
-pub fn load_qpy(
-    py: Python,
-    data: &Bytes,
-    qpy_version: u8,
-    metadata_deserializer: Option<&Bound<PyAny>>,
-    annotation_factories: &Bound<PyDict>,
-) -> Result<Vec<Py<PyAny>>, QpyError> {
+// checks that the payload described by a QPY file header can be loaded by the Rust reader
+fn check_file_header(header: &QPYFileHeader, qpy_version: u8) -> Result<(), QpyError> {
     if qpy_version < QPY_READ_MIN_VERSION {
         Err(QpyError::UnsupportedFeatureForVersion {
             feature: "Rust QPY".to_string(),
@@ -201,86 +207,332 @@ pub fn load_qpy(
             min_version: QPY_READ_MIN_VERSION,
         })?;
     }
-    let (qpy_file_header, header_size) = deserialize::<QPYFileHeader>(data)?;
     // Verify the type key is for circuits
-    if qpy_file_header.type_key == ProgramType::Schedule {
+    if header.type_key == ProgramType::Schedule {
         return Err(QpyError::PayloadTypeError(
             "Payloads of type `Schedule` cannot be loaded as of Qiskit 2.0. \nUse an earlier version of Qiskit if you want to load `Schedule` payloads.".to_string()
         ));
     }
-    if qpy_file_header.type_key != ProgramType::Circuit {
+    if header.type_key != ProgramType::Circuit {
         return Err(QpyError::PayloadTypeError(format!(
             "Invalid payload format data kind '{}'",
-            qpy_file_header.type_key
+            header.type_key
         )));
     }
-    let num_programs = qpy_file_header.num_programs as usize;
-    let use_symengine = matches!(
-        qpy_file_header.symbolic_encoding,
-        SymbolicEncoding::Symengine
-    );
-    let mut circuits = vec![py.None(); num_programs];
-    let mut cursor = Cursor::new(data as &[u8]);
-    cursor.seek(std::io::SeekFrom::Start(header_size as u64))?;
-    if qpy_file_header.qpy_version >= 16 {
-        let qpy_raw_circuits = read_raw_circuits(&mut cursor, num_programs)?;
-        for (index, raw_circuit) in qpy_raw_circuits.iter().enumerate() {
-            let (packed_circuit, _) = deserialize_with_args::<QPYCircuit, (u8,)>(
-                raw_circuit,
-                (qpy_file_header.qpy_version,),
-            )?;
-            circuits[index] = unpack_circuit(
-                py,
-                &packed_circuit,
-                qpy_file_header.qpy_version,
-                metadata_deserializer,
-                use_symengine,
-                annotation_factories,
-            )?;
-        }
+    Ok(())
+}
+
+// unpacks the raw bytes of each program into a Python circuit
+fn unpack_programs<'a>(
+    py: Python,
+    header: &QPYFileHeader,
+    raw_programs: impl IntoIterator<Item = &'a [u8]>,
+    metadata_deserializer: Option<&Bound<PyAny>>,
+    annotation_factories: &Bound<PyDict>,
+) -> Result<Vec<Py<PyAny>>, QpyError> {
+    let use_symengine = matches!(header.symbolic_encoding, SymbolicEncoding::Symengine);
+    let parse = |raw_program: &[u8]| -> Result<QPYCircuit, QpyError> {
+        let (packed_circuit, _) =
+            deserialize_with_args::<QPYCircuit, (u8,)>(raw_program, (header.qpy_version,))?;
+        Ok(packed_circuit)
+    };
+    let unpack = |packed_circuit: &QPYCircuit| {
+        unpack_circuit(
+            py,
+            packed_circuit,
+            header.qpy_version,
+            metadata_deserializer,
+            use_symengine,
+            annotation_factories,
+        )
+    };
+    let raw_programs: Vec<&[u8]> = raw_programs.into_iter().collect();
+    if getenv_use_multiple_threads() && raw_programs.len() >= PARALLEL_PROGRAMS_THRESHOLD {
+        // The program boundaries are already known, so every program can be parsed on its own.
+        let packed_circuits = py.detach(|| {
+            raw_programs
+                .par_iter()
+                .map(|raw_program| parse(raw_program))
+                .collect::<Result<Vec<QPYCircuit>, QpyError>>()
+        })?;
+        packed_circuits.iter().map(unpack).collect()
     } else {
-        // QPY version < 16, no offset table
-        let packed_qpy_circuits = Vec::<QPYCircuit>::read_options(
-            &mut cursor,
-            Endian::Big,
-            VecArgs {
-                count: num_programs,
-                inner: (qpy_file_header.qpy_version,),
-            },
-        )?;
-        for (index, packed_circuit) in packed_qpy_circuits.iter().enumerate() {
-            circuits[index] = unpack_circuit(
-                py,
-                packed_circuit,
-                qpy_file_header.qpy_version,
-                metadata_deserializer,
-                use_symengine,
-                annotation_factories,
-            )?;
+        raw_programs
+            .into_iter()
+            .map(|raw_program| unpack(&parse(raw_program)?))
+            .collect()
+    }
+}
+
+/// Load the programs at the given indices of a QPY payload, in the order given, or every program
+/// if ``programs`` is ``None``. Only the requested programs are unpacked.
+pub fn load_qpy(
+    py: Python,
+    data: &Bytes,
+    qpy_version: u8,
+    programs: Option<&[usize]>,
+    metadata_deserializer: Option<&Bound<PyAny>>,
+    annotation_factories: &Bound<PyDict>,
+) -> Result<Vec<Py<PyAny>>, QpyError> {
+    let (qpy_file_header, _) = deserialize::<QPYFileHeader>(data)?;
+    check_file_header(&qpy_file_header, qpy_version)?;
+    let index = QpyIndex::new(data)?;
+    load_indexed(
+        py,
+        data,
+        &index,
+        programs,
+        metadata_deserializer,
+        annotation_factories,
+    )
+}
+
+// unpacks the requested programs of a QPY payload which has already been indexed
+fn load_indexed(
+    py: Python,
+    data: &[u8],
+    index: &QpyIndex,
+    programs: Option<&[usize]>,
+    metadata_deserializer: Option<&Bound<PyAny>>,
+    annotation_factories: &Bound<PyDict>,
+) -> Result<Vec<Py<PyAny>>, QpyError> {
+    let raw_programs = match programs {
+        Some(programs) => programs
+            .iter()
+            .map(|program| index.program(data, *program))
+            .collect::<Result<Vec<&[u8]>, QpyError>>()?,
+        None => (0..index.num_programs())
+            .map(|program| index.program(data, program))
+            .collect::<Result<Vec<&[u8]>, QpyError>>()?,
+    };
+    unpack_programs(
+        py,
+        &index.header,
+        raw_programs,
+        metadata_deserializer,
+        annotation_factories,
+    )
+}
+
+// reads the file header and the raw bytes of the requested programs from a QPY file object,
+// seeking past the programs which were not requested by means of the offset table. Payloads which
+// predate the offset table, or whose table is inconsistent, are read in full and indexed by
+// skimming them instead. Either way, the file object is left at the end of the payload.
+fn read_programs(
+    file_obj: &Bound<PyAny>,
+    qpy_version: u8,
+    programs: &[usize],
+) -> Result<(QPYFileHeader, Vec<Bytes>), QpyError> {
+    let start: u64 = file_obj.call_method0("tell")?.extract()?;
+    let header_data: Bytes = file_obj
+        .call_method1("read", (QPY_FILE_HEADER_SIZE,))?
+        .extract()?;
+    let (qpy_file_header, _) = deserialize::<QPYFileHeader>(&header_data)?;
+    check_file_header(&qpy_file_header, qpy_version)?;
+    if qpy_file_header.qpy_version >= QPY_OFFSET_TABLE_MIN_VERSION {
+        if let Some(raw_programs) = seek_programs(file_obj, start, &qpy_file_header, programs)? {
+            return Ok((qpy_file_header, raw_programs));
         }
+        file_obj.call_method1("seek", (start + QPY_FILE_HEADER_SIZE as u64,))?;
     }
-    Ok(circuits)
+    let rest: Bytes = file_obj.call_method0("read")?.extract()?;
+    let data = [header_data.as_slice(), rest.as_slice()].concat();
+    let index = QpyIndex::new(&data)?;
+    let raw_programs = programs
+        .iter()
+        .map(|program| Ok(Bytes::from(index.program(&data, *program)?)))
+        .collect::<Result<Vec<Bytes>, QpyError>>()?;
+    file_obj.call_method1("seek", (start + index.end() as u64,))?;
+    Ok((index.header, raw_programs))
+}
+
+// reads the requested programs of a payload starting at ``start`` in a file object, whose file
+// header has already been read, by seeking to each of them by means of the offset table. Returns
+// ``None`` if the offset table isn't consistent with the file.
+fn seek_programs(
+    file_obj: &Bound<PyAny>,
+    start: u64,
+    qpy_file_header: &QPYFileHeader,
+    programs: &[usize],
+) -> Result<Option<Vec<Bytes>>, QpyError> {
+    let num_programs = usize::try_from(qpy_file_header.num_programs)?;
+    let table_size = num_programs
+        .checked_mul(OFFSET_TABLE_ENTRY_SIZE)
+        .ok_or_else(|| QpyError::InvalidFormat("too many programs".to_string()))?;
+    let table_data: Bytes = file_obj.call_method1("read", (table_size,))?.extract()?;
+    let offsets = read_offset_table(&table_data, num_programs)?;
+    let table_end = QPY_FILE_HEADER_SIZE + table_size;
+    let size: u64 = file_obj.call_method1("seek", (0, 2))?.extract()?;
+    let size = usize::try_from(size.saturating_sub(start))?;
+    let Some(starts) = program_starts(&offsets, table_end, size) else {
+        return Ok(None);
+    };
+    let read_at = |offset: usize, size: Option<usize>| -> Result<Bytes, QpyError> {
+        file_obj.call_method1("seek", (start + offset as u64,))?;
+        let data = match size {
+            Some(size) => file_obj.call_method1("read", (size,))?,
+            None => file_obj.call_method0("read")?,
+        };
+        Ok(data.extract()?)
+    };
+    // The table doesn't record where the last program ends, so it's found by skimming over it.
+    let (last_program, payload_end) = match starts.last() {
+        Some(&last_start) => {
+            let rest = read_at(last_start, None)?;
+            let last_size = program_end(&rest, 0, qpy_file_header.qpy_version)?;
+            (Bytes::from(&rest[..last_size]), last_start + last_size)
+        }
+        None => (Bytes::new(), table_end),
+    };
+    let raw_programs = programs
+        .iter()
+        .map(|&program| {
+            if program + 1 == num_programs {
+                Ok(last_program.clone())
+            } else if program < num_programs {
+                read_at(starts[program], Some(starts[program + 1] - starts[program]))
+            } else {
+                Err(QpyError::InvalidParameter(format!(
+                    "program index {program} is out of range for a payload with {num_programs} programs"
+                )))
+            }
+        })
+        .collect::<Result<Vec<Bytes>, QpyError>>()?;
+    file_obj.call_method1("seek", (start + payload_end as u64,))?;
+    Ok(Some(raw_programs))
 }
 
 #[pyfunction]
 #[pyo3(name = "load")]
+#[pyo3(signature = (file_obj, metadata_deserializer, version, annotation_factories, programs=None))]
 pub fn py_load_qpy(
     py: Python,
     file_obj: &Bound<PyAny>,
     metadata_deserializer: Option<Bound<PyAny>>,
     version: u8,
     annotation_factories: Option<Bound<PyDict>>,
+    programs: Option<Vec<usize>>,
 ) -> Result<Vec<Py<PyAny>>, QpyError> {
     let annotation_factories = annotation_factories.unwrap_or(PyDict::new(py));
 
-    // Read all data from file object
-    // TODO: When we read from a rust native stream, maybe we can seek according to the circuit offsets instead of reading everything at once
-    let data: Bytes = file_obj.call_method0("read")?.extract()?;
+    // When only some programs are requested, seek directly to them rather than reading everything.
+    if let Some(programs) = programs {
+        let (qpy_file_header, raw_programs) = read_programs(file_obj, version, &programs)?;
+        return unpack_programs(
+            py,
+            &qpy_file_header,
+            raw_programs
+                .iter()
+                .map(|raw_program| raw_program.as_slice()),
+            metadata_deserializer.as_ref(),
+            &annotation_factories,
+        );
+    }
 
-    load_qpy(
+    let start: u64 = file_obj.call_method0("tell")?.extract()?;
+    let data: Bytes = file_obj.call_method0("read")?.extract()?;
+    let (qpy_file_header, _) = deserialize::<QPYFileHeader>(&data)?;
+    check_file_header(&qpy_file_header, version)?;
+    let index = QpyIndex::new(&data)?;
+    let programs = load_indexed(
         py,
         &data,
-        version,
+        &index,
+        None,
+        metadata_deserializer.as_ref(),
+        &annotation_factories,
+    )?;
+    // Leave the file object at the end of the payload, rather than after any data following it.
+    file_obj.call_method1("seek", (start + index.end() as u64,))?;
+    Ok(programs)
+}
+
+// reads the file header and the raw bytes of the requested programs (or of every program) from a
+// compressed QPY file object. Only the frames of the requested programs are read and decompressed.
+fn read_compressed_programs(
+    file_obj: &Bound<PyAny>,
+    programs: Option<&[usize]>,
+) -> Result<(QPYFileHeader, Vec<Bytes>), QpyError> {
+    let start: u64 = file_obj.call_method0("tell")?.extract()?;
+    let header_data: Bytes = file_obj
+        .call_method1("read", (COMPRESSED_HEADER_SIZE,))?
+        .extract()?;
+    let (header, _) = deserialize::<CompressedQPYHeader>(&header_data)?;
+    check_compressed_header(&header)?;
+    check_file_header(&header.qpy_header, header.qpy_header.qpy_version)?;
+    let dictionary_size = usize::try_from(header.dictionary_size)?;
+    let dictionary: Bytes = file_obj
+        .call_method1("read", (dictionary_size,))?
+        .extract()?;
+    if dictionary.len() != dictionary_size {
+        return Err(QpyError::InvalidFormat(
+            "the compression dictionary is truncated".to_string(),
+        ));
+    }
+    let num_programs = usize::try_from(header.qpy_header.num_programs)?;
+    let table_size = num_programs
+        .checked_mul(FRAME_TABLE_ENTRY_SIZE)
+        .ok_or_else(|| QpyError::InvalidFormat("too many programs".to_string()))?;
+    let table_data: Bytes = file_obj.call_method1("read", (table_size,))?.extract()?;
+    let frame_table = read_frame_table(&table_data, num_programs)?;
+    let selected: Vec<usize> = match programs {
+        Some(programs) => programs.to_vec(),
+        None => (0..num_programs).collect(),
+    };
+    let frames = selected
+        .iter()
+        .map(|program| {
+            let frame = frame_table.get(*program).ok_or_else(|| {
+                QpyError::InvalidParameter(format!(
+                    "program index {program} is out of range for a payload with {num_programs} programs"
+                ))
+            })?;
+            let compressed_size = usize::try_from(frame.compressed_size)?;
+            file_obj.call_method1("seek", (start.saturating_add(frame.offset),))?;
+            let data: Bytes = file_obj
+                .call_method1("read", (compressed_size,))?
+                .extract()?;
+            if data.len() != compressed_size {
+                return Err(QpyError::InvalidFormat(format!(
+                    "compressed program {program} is truncated"
+                )));
+            }
+            Ok((data, frame.size))
+        })
+        .collect::<Result<Vec<(Bytes, u64)>, QpyError>>()?;
+    let parallel = getenv_use_multiple_threads() && frames.len() >= PARALLEL_PROGRAMS_THRESHOLD;
+    let raw_programs = file_obj
+        .py()
+        .detach(|| decompress_frames(&frames, header.codec, &dictionary, parallel))?;
+    // Leave the file object at the end of the payload (the end of its last frame), rather than
+    // after whichever frame was read last or after any data following the payload.
+    let table_end = (COMPRESSED_HEADER_SIZE + dictionary_size + table_size) as u64;
+    let payload_end = frame_table
+        .iter()
+        .map(|frame| frame.offset.saturating_add(frame.compressed_size))
+        .fold(table_end, u64::max);
+    file_obj.call_method1("seek", (start.saturating_add(payload_end),))?;
+    Ok((header.qpy_header, raw_programs))
+}
+
+#[pyfunction]
+#[pyo3(name = "load_compressed")]
+#[pyo3(signature = (file_obj, metadata_deserializer, annotation_factories, programs=None))]
+pub fn py_load_compressed_qpy(
+    py: Python,
+    file_obj: &Bound<PyAny>,
+    metadata_deserializer: Option<Bound<PyAny>>,
+    annotation_factories: Option<Bound<PyDict>>,
+    programs: Option<Vec<usize>>,
+) -> Result<Vec<Py<PyAny>>, QpyError> {
+    let annotation_factories = annotation_factories.unwrap_or(PyDict::new(py));
+    let (qpy_file_header, raw_programs) = read_compressed_programs(file_obj, programs.as_deref())?;
+    unpack_programs(
+        py,
+        &qpy_file_header,
+        raw_programs
+            .iter()
+            .map(|raw_program| raw_program.as_slice()),
         metadata_deserializer.as_ref(),
         &annotation_factories,
     )
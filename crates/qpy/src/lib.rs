@@ -23,10 +23,12 @@ mod annotations;
 mod bytes;
 mod circuit_reader;
 mod circuit_writer;
+mod compression;
 mod consts;
 mod error;
 mod expr;
 mod formats;
+mod index;
 mod interface;
 mod params;
 mod py_methods;
@@ -39,5 +41,6 @@ pub fn qpy(module: &Bound<PyModule>) -> PyResult<()> {
     module.add_function(wrap_pyfunction!(circuit_reader::py_read_circuit, module)?)?;
     module.add_function(wrap_pyfunction!(interface::py_dump_qpy, module)?)?;
     module.add_function(wrap_pyfunction!(interface::py_load_qpy, module)?)?;
+    module.add_function(wrap_pyfunction!(interface::py_load_compressed_qpy, module)?)?;
     Ok(())
 }
@@ -222,6 +222,29 @@ impl std::fmt::Display for ProgramType {
     }
 }
 
+// The codec used to compress the programs of a compressed QPY payload
+#[binrw]
+#[brw(repr = u8)]
+#[repr(u8)]
+#[derive(Debug, PartialEq, Clone, Copy)]
+pub enum CompressionCodec {
+    Zstd = b'z',
+    Lz4 = b'l',
+}
+
+impl TryFrom<&str> for CompressionCodec {
+    type Error = QpyError;
+    fn try_from(value: &str) -> Result<Self, Self::Error> {
+        match value {
+            "zstd" => Ok(Self::Zstd),
+            "lz4" => Ok(Self::Lz4),
+            _ => Err(QpyError::InvalidParameter(format!(
+                "unknown compression codec '{value}'"
+            ))),
+        }
+    }
+}
+
 // The types of nodes inside Expressions (not to be confused with ParameterExpressions)
 #[binrw]
 #[derive(Debug)]
@@ -10,14 +10,17 @@
 // copyright notice, and modified files need to carry a notice indicating
 // that they have been altered from the originals.
 
-mod pauli_network;
+pub mod pauli_network;
 
 use pyo3::prelude::*;
 use pyo3::types::PyList;
 
 use qiskit_circuit::circuit_data::PyCircuitData;
+use qiskit_quantum_info::sparse_observable::PySparseObservable;
 
-use crate::evolution::pauli_network::pauli_network_synthesis_inner;
+use crate::evolution::pauli_network::{
+    pauli_network_synthesis_inner, pauli_network_synthesis_observable,
+};
 
 /// Calls Rustiq's pauli network synthesis algorithm and returns the
 /// Qiskit circuit data with Clifford gates and rotations.
@@ -72,8 +75,51 @@ pub fn pauli_network_synthesis(
     .map(Into::into)
 }
 
+/// Calls Rustiq's pauli network synthesis algorithm on the time evolution of an observable
+/// and returns the Qiskit circuit data with Clifford gates and rotations.
+///
+/// This is equivalent to calling [pauli_network_synthesis] on the first-order Lie-Trotter
+/// expansion of the observable with a single repetition, but reads the terms directly from the
+/// observable without building a sparse list of strings in Python.
+///
+/// # Arguments
+///
+/// * observable: the observable to evolve. It may only contain Pauli terms with real
+///     coefficients.
+/// * time: the evolution time.
+///
+/// See [pauli_network_synthesis] for the meaning of the other arguments.
+#[pyfunction]
+#[pyo3(signature = (observable, time, optimize_count=true, preserve_order=true, upto_clifford=false, upto_phase=false, resynth_clifford_method=1))]
+#[allow(clippy::too_many_arguments)]
+pub fn pauli_network_synthesis_sparse_observable(
+    observable: PyRef<PySparseObservable>,
+    time: f64,
+    optimize_count: bool,
+    preserve_order: bool,
+    upto_clifford: bool,
+    upto_phase: bool,
+    resynth_clifford_method: usize,
+) -> PyResult<PyCircuitData> {
+    let observable = observable.as_inner()?;
+    pauli_network_synthesis_observable(
+        &observable,
+        time,
+        optimize_count,
+        preserve_order,
+        upto_clifford,
+        upto_phase,
+        resynth_clifford_method,
+    )
+    .map(Into::into)
+}
+
 pub fn evolution(m: &Bound<PyModule>) -> PyResult<()> {
     m.add_function(wrap_pyfunction!(pauli_network_synthesis, m)?)?;
+    m.add_function(wrap_pyfunction!(
+        pauli_network_synthesis_sparse_observable,
+        m
+    )?)?;
     Ok(())
 }
 
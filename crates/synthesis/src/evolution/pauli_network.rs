@@ -18,8 +18,9 @@ use pyo3::types::{PyList, PyString, PyTuple};
 use smallvec::{SmallVec, smallvec};
 
 use qiskit_circuit::Qubit;
-use qiskit_circuit::circuit_data::CircuitData;
+use qiskit_circuit::circuit_data::{CircuitData, CircuitDataError};
 use qiskit_circuit::operations::{Param, StandardGate, multiply_param, radd_param};
+use qiskit_quantum_info::sparse_observable::{BitTerm, SparseObservable};
 
 use rustiq_core::structures::{
     CliffordCircuit, CliffordGate, IsometryTableau, Metric, PauliLike, PauliSet,
@@ -27,24 +28,97 @@ use rustiq_core::structures::{
 use rustiq_core::synthesis::clifford::isometry::isometry_synthesis;
 use rustiq_core::synthesis::pauli_network::greedy_pauli_network;
 
-use rustworkx_core::petgraph::Incoming;
-use rustworkx_core::petgraph::graph::NodeIndex;
-use rustworkx_core::petgraph::prelude::StableDiGraph;
-
 /// A Qiskit gate. The quantum circuit data returned by the pauli network
 /// synthesis algorithm will consist of clifford and rotation gates.
 type QiskitGate = (StandardGate, SmallVec<[Param; 3]>, SmallVec<[Qubit; 2]>);
 
-/// Expands the sparse pauli string representation to the full representation.
+/// The pauli rotations of a network, packed into bits as they are read.
 ///
-/// For example: for the input `sparse_pauli = "XY", qubits = [1, 3], num_qubits = 6`,
-/// the function returns `"IXIYII"`.
-fn expand_pauli(sparse_pauli: String, qubits: &[u32], num_qubits: usize) -> String {
-    let mut v: Vec<char> = vec!['I'; num_qubits];
-    for (q, p) in qubits.iter().zip(sparse_pauli.chars()) {
-        v[*q as usize] = p;
+/// The paulis are inserted into Rustiq's [PauliSet] directly from their bits, without expanding
+/// them to dense strings first. The bits are also kept in words of 64 qubits for fast
+/// commutation checks, along with the qubits each pauli acts on.
+struct PauliRotations {
+    num_qubits: usize,
+    num_words: usize,
+    paulis: PauliSet,
+    angles: Vec<Param>,
+    /// The X bits of pauli `i` are in `x_words[i * num_words..(i + 1) * num_words]`.
+    x_words: Vec<u64>,
+    /// The Z bits of pauli `i`, in the same layout as `x_words`.
+    z_words: Vec<u64>,
+    /// The paulis acting on each qubit, in increasing order.
+    qubit_paulis: Vec<Vec<u32>>,
+    /// A dense representation of the pauli being inserted, in Rustiq's format of the X bits of
+    /// every qubit followed by the Z bits. Only the entries of the qubits in `touched` are set.
+    scratch: Vec<bool>,
+    touched: Vec<usize>,
+}
+
+impl PauliRotations {
+    fn with_capacity(num_qubits: usize, capacity: usize) -> Self {
+        let num_words = num_qubits.div_ceil(64);
+        PauliRotations {
+            num_qubits,
+            num_words,
+            paulis: PauliSet::new(num_qubits),
+            angles: Vec::with_capacity(capacity),
+            x_words: Vec::with_capacity(capacity * num_words),
+            z_words: Vec::with_capacity(capacity * num_words),
+            qubit_paulis: vec![Vec::new(); num_qubits],
+            scratch: vec![false; 2 * num_qubits],
+            touched: Vec::new(),
+        }
+    }
+
+    /// Set the X and Z bits of a qubit of the pauli being inserted. Later values for the same
+    /// qubit replace earlier ones.
+    fn set(&mut self, qubit: usize, x: bool, z: bool) {
+        if !self.scratch[qubit] && !self.scratch[qubit + self.num_qubits] {
+            self.touched.push(qubit);
+        }
+        self.scratch[qubit] = x;
+        self.scratch[qubit + self.num_qubits] = z;
+    }
+
+    /// Insert the pauli made of the bits set since the last insertion as a rotation by `angle`.
+    fn insert(&mut self, angle: Param) {
+        let index = self.angles.len();
+        let offset = self.x_words.len();
+        self.x_words.resize(offset + self.num_words, 0);
+        self.z_words.resize(offset + self.num_words, 0);
+        self.touched.sort_unstable();
+        self.touched.dedup();
+        for &qubit in &self.touched {
+            let (x, z) = (self.scratch[qubit], self.scratch[qubit + self.num_qubits]);
+            if !x && !z {
+                continue;
+            }
+            let (word, bit) = (offset + qubit / 64, qubit % 64);
+            self.x_words[word] |= (x as u64) << bit;
+            self.z_words[word] |= (z as u64) << bit;
+            self.qubit_paulis[qubit].push(index as u32);
+        }
+        self.paulis.insert_vec_bool(&self.scratch, false);
+        for &qubit in &self.touched {
+            self.scratch[qubit] = false;
+            self.scratch[qubit + self.num_qubits] = false;
+        }
+        self.touched.clear();
+        self.angles.push(angle);
+    }
+
+    /// Return whether paulis `i` and `j` commute.
+    fn commute(&self, i: usize, j: usize) -> bool {
+        let (a, b) = (i * self.num_words, j * self.num_words);
+        let anticommuting = (0..self.num_words)
+            .map(|w| {
+                ((self.x_words[a + w] & self.z_words[b + w])
+                    ^ (self.z_words[a + w] & self.x_words[b + w]))
+                    .count_ones()
+            })
+            .sum::<u32>();
+        anticommuting % 2 == 0
     }
-    v.into_iter().collect()
 }
 
 /// Return the Qiskit's gate corresponding to the given Rustiq's Clifford gate.
@@ -68,26 +142,42 @@ fn to_qiskit_clifford_gate(rustiq_gate: &CliffordGate) -> QiskitGate {
     }
 }
 
+/// Return the qubits the given Rustiq's Clifford gate acts on.
+fn clifford_gate_qubits(rustiq_gate: &CliffordGate) -> SmallVec<[usize; 2]> {
+    match rustiq_gate {
+        CliffordGate::CNOT(i, j) | CliffordGate::CZ(i, j) => smallvec![*i, *j],
+        CliffordGate::H(i)
+        | CliffordGate::S(i)
+        | CliffordGate::Sd(i)
+        | CliffordGate::SqrtX(i)
+        | CliffordGate::SqrtXd(i) => smallvec![*i],
+    }
+}
+
+/// Append the given Qiskit gate to the circuit.
+fn push_gate(circuit: &mut CircuitData, gate: QiskitGate) -> Result<(), CircuitDataError> {
+    circuit.push_standard_gate(gate.0, &gate.1, &gate.2)
+}
+
 /// Return the Qiskit rotation gate corresponding to the single-qubit Pauli rotation.
 ///
 /// # Arguments
 ///
-/// * py: a GIL handle, needed to negate rotation parameters in Python space.
 /// * paulis: Rustiq's data structure storing pauli rotations.
+/// * n: the number of qubits of the paulis.
 /// * i: index of the single-qubit Pauli rotation.
 /// * angle: Qiskit's rotation angle.
-fn qiskit_rotation_gate(paulis: &PauliSet, i: usize, angle: &Param) -> QiskitGate {
-    let (phase, pauli_str) = paulis.get(i);
-    for (q, c) in pauli_str.chars().enumerate() {
-        if c != 'I' {
-            let standard_gate = match c {
-                'X' => StandardGate::RX,
-                'Y' => StandardGate::RY,
-                'Z' => StandardGate::RZ,
-                _ => unreachable!("Only X, Y and Z are possible characters at this point."),
+fn qiskit_rotation_gate(paulis: &PauliSet, n: usize, i: usize, angle: &Param) -> QiskitGate {
+    for q in 0..n {
+        let (x, z) = (paulis.get_entry(q, i), paulis.get_entry(q + n, i));
+        if x || z {
+            let standard_gate = match (x, z) {
+                (true, false) => StandardGate::RX,
+                (true, true) => StandardGate::RY,
+                _ => StandardGate::RZ,
             };
             // We need to negate the angle when there is a phase.
-            let param = match phase {
+            let param = match paulis.get_phase(i) {
                 false => angle.clone(),
                 true => multiply_param(angle, -1.0),
             };
@@ -114,119 +204,171 @@ fn qiskit_rotation_gate(paulis: &PauliSet, i: usize, angle: &Param) -> QiskitGat
 // When this happens, we will be able to significantly simplify the code that follows.
 
 /// A DAG that stores ordered Paulis, up to commutativity.
+///
+/// Pauli `i` precedes pauli `j` if `i < j` and they anticommute. Only the number of remaining
+/// predecessors of each pauli is tracked, along with the successors to update when a pauli is
+/// removed.
 struct CommutativityDag {
-    /// Rustworkx's DAG
-    dag: StableDiGraph<usize, ()>,
+    /// The number of predecessors of each pauli that have not been removed.
+    num_predecessors: Vec<u32>,
+    /// The successors of each pauli.
+    successors: Vec<Vec<u32>>,
 }
 
 impl CommutativityDag {
-    /// Construct a DAG corresponding to `paulis`.
+    /// Construct a DAG corresponding to `rotations`.
     /// When `add_edges` is `true`, we add an edge between pauli `i` and pauli `j`
-    /// iff they commute. When `add_edges` is `false`, we do not add any edges.
-    fn from_paulis(paulis: &PauliSet, add_edges: bool) -> Self {
-        let mut dag = StableDiGraph::<usize, ()>::new();
-
-        let node_indices: Vec<NodeIndex> = (0..paulis.len()).map(|i| dag.add_node(i)).collect();
+    /// iff they anticommute. When `add_edges` is `false`, we do not add any edges.
+    fn from_paulis(rotations: &PauliRotations, add_edges: bool) -> Self {
+        let num_paulis = rotations.angles.len();
+        let mut num_predecessors = vec![0; num_paulis];
+        let mut successors = vec![Vec::new(); num_paulis];
 
         if add_edges {
-            for i in 0..paulis.len() {
-                let pauli_i = paulis.get_as_pauli(i);
-                for j in i + 1..paulis.len() {
-                    let pauli_j = paulis.get_as_pauli(j);
-
-                    if !pauli_i.commutes(&pauli_j) {
-                        dag.add_edge(node_indices[i], node_indices[j], ());
+            // Only paulis that share a qubit can anticommute, so the candidates for the
+            // successors of pauli `i` are the later paulis on each of its qubits.
+            let mut last_seen = vec![usize::MAX; num_paulis];
+            for (i, successors_i) in successors.iter_mut().enumerate() {
+                let offset = i * rotations.num_words;
+                for word in 0..rotations.num_words {
+                    let mut support =
+                        rotations.x_words[offset + word] | rotations.z_words[offset + word];
+                    while support != 0 {
+                        let qubit = 64 * word + support.trailing_zeros() as usize;
+                        support &= support - 1;
+                        let on_qubit = &rotations.qubit_paulis[qubit];
+                        let start = on_qubit.partition_point(|j| *j as usize <= i);
+                        for &j in &on_qubit[start..] {
+                            let j = j as usize;
+                            if last_seen[j] == i {
+                                continue;
+                            }
+                            last_seen[j] = i;
+                            if !rotations.commute(i, j) {
+                                successors_i.push(j as u32);
+                                num_predecessors[j] += 1;
+                            }
+                        }
                     }
                 }
             }
         }
 
-        CommutativityDag { dag }
+        CommutativityDag {
+            num_predecessors,
+            successors,
+        }
     }
 
     /// Return whether the given node is a front node (i.e. has no predecessors).
     fn is_front_node(&self, index: usize) -> bool {
-        self.dag
-            .neighbors_directed(NodeIndex::new(index), Incoming)
-            .next()
-            .is_none()
+        self.num_predecessors[index] == 0
     }
 
     /// Remove node from the DAG.
     fn remove_node(&mut self, index: usize) {
-        self.dag.remove_node(NodeIndex::new(index));
+        for &j in &self.successors[index] {
+            self.num_predecessors[j as usize] -= 1;
+        }
     }
 }
 
-/// Return a Qiskit circuit with Clifford gates and rotations.
+/// Append Clifford gates and rotations to a Qiskit circuit, and return the global phase of the
+/// all-identity rotations.
 ///
 /// The rotations are assumed to be ordered (up to commutativity).
 ///
 /// # Arguments
 ///
-/// * py: a GIL handle, needed to negate rotation parameters in Python space.
+/// * circuit: the circuit to append the gates to.
 /// * gates: the sequence of Rustiq's Clifford gates returned by Rustiq's
 ///   pauli network synthesis algorithm.
-/// * paulis: Rustiq's data structure storing the pauli rotations.
-/// * angles: Qiskit's rotation angles corresponding to the pauli rotations.
+/// * rotations: the pauli rotations and their angles.
 /// * preserve_order: specifies whether the order of paulis should be preserved,
 ///   up to commutativity.
 fn inject_rotations(
+    circuit: &mut CircuitData,
     gates: &[CliffordGate],
-    paulis: &PauliSet,
-    angles: &[Param],
+    rotations: &PauliRotations,
     preserve_order: bool,
-) -> (Vec<QiskitGate>, Param) {
-    let mut out_gates: Vec<QiskitGate> = Vec::with_capacity(gates.len() + paulis.len());
+) -> Result<Param, CircuitDataError> {
+    let num_qubits = rotations.num_qubits;
+    let angles = &rotations.angles;
     let mut global_phase = Param::Float(0.0);
 
-    let mut cur_paulis = paulis.clone();
-    let mut hit_paulis: Vec<bool> = vec![false; cur_paulis.len()];
+    let mut cur_paulis = rotations.paulis.clone();
+    let mut dag = CommutativityDag::from_paulis(rotations, preserve_order);
 
-    let mut dag = CommutativityDag::from_paulis(paulis, preserve_order);
+    // The support sizes of the paulis are updated incrementally, since each Clifford gate only
+    // changes them on its own qubits.
+    let mut support_sizes: Vec<usize> = (0..angles.len())
+        .map(|i| cur_paulis.support_size(i))
+        .collect();
+    let on_qubit = |paulis: &PauliSet, i: usize, q: usize| {
+        paulis.get_entry(q, i) || paulis.get_entry(q + num_qubits, i)
+    };
 
     // check which paulis are hit at the very start
-    for i in 0..cur_paulis.len() {
-        let pauli_support_size = cur_paulis.support_size(i);
-        if pauli_support_size == 0 {
+    let mut remaining: Vec<usize> = Vec::with_capacity(angles.len());
+    for i in 0..angles.len() {
+        if support_sizes[i] == 0 {
             // in case of an all-identity rotation, update global phase by subtracting
             // the angle
             global_phase = radd_param(global_phase, multiply_param(&angles[i], -0.5));
-            hit_paulis[i] = true;
             dag.remove_node(i);
-        } else if pauli_support_size == 1 && dag.is_front_node(i) {
-            out_gates.push(qiskit_rotation_gate(&cur_paulis, i, &angles[i]));
-            hit_paulis[i] = true;
+        } else if support_sizes[i] == 1 && dag.is_front_node(i) {
+            push_gate(
+                circuit,
+                qiskit_rotation_gate(&cur_paulis, num_qubits, i, &angles[i]),
+            )?;
             dag.remove_node(i);
+        } else {
+            remaining.push(i);
         }
     }
 
     for gate in gates {
-        out_gates.push(to_qiskit_clifford_gate(gate));
-
+        push_gate(circuit, to_qiskit_clifford_gate(gate))?;
+
+        let qubits = clifford_gate_qubits(gate);
+        for &i in &remaining {
+            support_sizes[i] -= qubits
+                .iter()
+                .filter(|q| on_qubit(&cur_paulis, i, **q))
+                .count();
+        }
         cur_paulis.conjugate_with_gate(gate);
+        for &i in &remaining {
+            support_sizes[i] += qubits
+                .iter()
+                .filter(|q| on_qubit(&cur_paulis, i, **q))
+                .count();
+        }
 
         // check which paulis are hit now
-        for i in 0..cur_paulis.len() {
-            if !hit_paulis[i] && cur_paulis.support_size(i) == 1 && dag.is_front_node(i) {
-                out_gates.push(qiskit_rotation_gate(&cur_paulis, i, &angles[i]));
-                hit_paulis[i] = true;
+        let mut result = Ok(());
+        remaining.retain(|&i| {
+            if result.is_ok() && support_sizes[i] == 1 && dag.is_front_node(i) {
+                result = push_gate(
+                    circuit,
+                    qiskit_rotation_gate(&cur_paulis, num_qubits, i, &angles[i]),
+                );
                 dag.remove_node(i);
+                false
+            } else {
+                true
             }
-        }
+        });
+        result?;
     }
 
-    (out_gates, global_phase)
+    Ok(global_phase)
 }
 
 /// Return the vector of Qiskit's gate corresponding to the given vector
 /// of Rustiq's Clifford gate.
-fn to_qiskit_clifford_gates(gates: &Vec<CliffordGate>) -> Vec<QiskitGate> {
-    let mut qiskit_gates: Vec<QiskitGate> = Vec::with_capacity(gates.len());
-    for gate in gates {
-        qiskit_gates.push(to_qiskit_clifford_gate(gate));
-    }
-    qiskit_gates
+fn to_qiskit_clifford_gates(gates: &[CliffordGate]) -> Vec<QiskitGate> {
+    gates.iter().map(to_qiskit_clifford_gate).collect()
 }
 
 /// Returns the number of CNOTs.
@@ -235,15 +377,21 @@ fn cnot_count(qgates: &[QiskitGate]) -> usize {
 }
 
 /// Given the Clifford circuit returned by Rustiq's pauli network synthesis algorithm,
-/// generates a sequence of Qiskit gates that implements this circuit.
+/// appends a sequence of Qiskit gates that implements this circuit to `circuit`.
 /// If `fix_clifford_method` is `0`, the original circuit is inverted; if `1`, it is
 /// resynthesized using Qiskit; and if `2` it is resynthesized using Rustiq.
 fn synthesize_final_clifford(
+    circuit: &mut CircuitData,
     rcircuit: &CliffordCircuit,
     resynth_clifford_method: usize,
-) -> Vec<QiskitGate> {
-    match resynth_clifford_method {
-        0 => to_qiskit_clifford_gates(&rcircuit.gates),
+) -> Result<(), CircuitDataError> {
+    let gates = match resynth_clifford_method {
+        0 => {
+            for gate in &rcircuit.gates {
+                push_gate(circuit, to_qiskit_clifford_gate(gate))?;
+            }
+            return Ok(());
+        }
         1 => {
             // Qiskit-based resynthesis
             let qcircuit = to_qiskit_clifford_gates(&rcircuit.gates);
@@ -264,7 +412,63 @@ fn synthesize_final_clifford(
                 to_qiskit_clifford_gates(&rcircuit.gates)
             }
         }
+    };
+    for gate in gates {
+        push_gate(circuit, gate)?;
     }
+    Ok(())
+}
+
+/// Calls Rustiq's pauli network synthesis algorithm on the given rotations and returns the
+/// Qiskit circuit data with Clifford gates and rotations.
+///
+/// See [pauli_network_synthesis_inner] for the meaning of the arguments.
+fn synthesize_pauli_network(
+    rotations: &PauliRotations,
+    optimize_count: bool,
+    preserve_order: bool,
+    upto_clifford: bool,
+    upto_phase: bool,
+    resynth_clifford_method: usize,
+) -> Result<CircuitData, CircuitDataError> {
+    let metric = match optimize_count {
+        true => Metric::COUNT,
+        false => Metric::DEPTH,
+    };
+
+    // Call Rustiq's synthesis algorithm
+    let rcircuit =
+        greedy_pauli_network(&rotations.paulis, &metric, preserve_order, 0, false, false);
+
+    // post-process algorithm's output, translating to Qiskit's gates and inserting rotation
+    // gates straight into the output circuit
+    let num_clifford_gates = match upto_clifford {
+        true => rcircuit.gates.len(),
+        false => 2 * rcircuit.gates.len(),
+    };
+    let mut circuit = CircuitData::with_capacity(
+        rotations.num_qubits as u32,
+        0,
+        num_clifford_gates + rotations.angles.len(),
+        Param::Float(0.0),
+    )?;
+    let global_phase = inject_rotations(&mut circuit, &rcircuit.gates, rotations, preserve_order)?;
+
+    // if the circuit needs to be synthesized exactly, we cannot use either Rustiq's
+    // or Qiskit's synthesis methods for Cliffords, since they do not necessarily preserve
+    // the global phase.
+    let resynth_clifford_method = match upto_phase {
+        true => resynth_clifford_method,
+        false => 0,
+    };
+
+    // synthesize the final Clifford
+    if !upto_clifford {
+        synthesize_final_clifford(&mut circuit, &rcircuit.dagger(), resynth_clifford_method)?;
+    }
+
+    circuit.set_global_phase_param(global_phase)?;
+    Ok(circuit)
 }
 
 /// Calls Rustiq's pauli network synthesis algorithm and returns the
@@ -272,7 +476,6 @@ fn synthesize_final_clifford(
 ///
 /// # Arguments
 ///
-/// * py: a GIL handle, needed to add and negate rotation parameters in Python space.
 /// * num_qubits: total number of qubits.
 /// * pauli_network: pauli network represented in sparse format. It's a list
 ///   of triples such as `[("XX", [0, 3], theta), ("ZZ", [0, 1], 0.1)]`.
@@ -306,62 +509,155 @@ pub fn pauli_network_synthesis_inner(
     upto_phase: bool,
     resynth_clifford_method: usize,
 ) -> PyResult<CircuitData> {
-    let mut paulis: Vec<String> = Vec::with_capacity(pauli_network.len());
-    let mut angles: Vec<Param> = Vec::with_capacity(pauli_network.len());
-
-    let allowed_chars = ['I', 'X', 'Y', 'Z'];
+    let mut rotations = PauliRotations::with_capacity(num_qubits, pauli_network.len());
 
-    // go over the input pauli network and extract a list of pauli rotations and
-    // the corresponding rotation angles
+    // go over the input pauli network and pack each pauli rotation into bits directly
     for item in pauli_network {
         let tuple = item.cast::<PyTuple>()?;
 
-        let sparse_pauli: String = tuple.get_item(0)?.cast::<PyString>()?.extract()?;
+        let sparse_pauli = tuple.get_item(0)?;
+        let sparse_pauli = sparse_pauli.cast::<PyString>()?.to_str()?;
         let qubits: Vec<u32> = tuple.get_item(1)?.extract()?;
         let angle: Param = tuple.get_item(2)?.extract()?;
 
-        if sparse_pauli.chars().any(|c| !allowed_chars.contains(&c)) {
+        if sparse_pauli.bytes().any(|c| !b"IXYZ".contains(&c)) {
             return Err(QiskitError::new_err(format!(
                 "Pauli network contains invalid Pauli string {sparse_pauli}"
             )));
         }
 
-        paulis.push(expand_pauli(sparse_pauli, &qubits, num_qubits));
-        angles.push(angle);
+        for (q, p) in qubits.iter().zip(sparse_pauli.bytes()) {
+            if *q as usize >= num_qubits {
+                return Err(QiskitError::new_err(format!(
+                    "Pauli network contains qubit {q}, but only has {num_qubits} qubits"
+                )));
+            }
+            let (x, z) = match p {
+                b'X' => (true, false),
+                b'Y' => (true, true),
+                b'Z' => (false, true),
+                _ => (false, false),
+            };
+            rotations.set(*q as usize, x, z);
+        }
+        rotations.insert(angle);
     }
 
-    let paulis = PauliSet::from_slice(&paulis);
-    let metric = match optimize_count {
-        true => Metric::COUNT,
-        false => Metric::DEPTH,
-    };
+    Ok(synthesize_pauli_network(
+        &rotations,
+        optimize_count,
+        preserve_order,
+        upto_clifford,
+        upto_phase,
+        resynth_clifford_method,
+    )?)
+}
 
-    // Call Rustiq's synthesis algorithm
-    let circuit = greedy_pauli_network(&paulis, &metric, preserve_order, 0, false, false);
+/// Calls Rustiq's pauli network synthesis algorithm on the time evolution of an observable and
+/// returns the Qiskit circuit data with Clifford gates and rotations.
+///
+/// Each term `c P` of the observable becomes a rotation `exp(-i c t P)`, in the order of the
+/// terms, where `t` is `time`. The terms are packed into bits straight from the observable.
+/// The observable must only contain Pauli terms with real coefficients.
+///
+/// See [pauli_network_synthesis_inner] for the meaning of the other arguments.
+#[allow(clippy::too_many_arguments)]
+pub fn pauli_network_synthesis_observable(
+    observable: &SparseObservable,
+    time: f64,
+    optimize_count: bool,
+    preserve_order: bool,
+    upto_clifford: bool,
+    upto_phase: bool,
+    resynth_clifford_method: usize,
+) -> PyResult<CircuitData> {
+    let num_qubits = observable.num_qubits() as usize;
+    let mut rotations = PauliRotations::with_capacity(num_qubits, observable.num_terms());
+    for term in observable.iter() {
+        if term.coeff.im.abs() > 1e-12 {
+            return Err(QiskitError::new_err(format!(
+                "Cannot evolve an observable with the complex coefficient {}",
+                term.coeff
+            )));
+        }
+        for (bit_term, q) in term.bit_terms.iter().zip(term.indices) {
+            let (x, z) = match bit_term {
+                BitTerm::X => (true, false),
+                BitTerm::Y => (true, true),
+                BitTerm::Z => (false, true),
+                _ => {
+                    return Err(QiskitError::new_err(format!(
+                        "Cannot evolve an observable containing the projector {}",
+                        bit_term.py_label()
+                    )));
+                }
+            };
+            rotations.set(*q as usize, x, z);
+        }
+        rotations.insert(Param::Float(2.0 * term.coeff.re * time));
+    }
 
-    // post-process algorithm's output, translating to Qiskit's gates and inserting rotation gates
-    let (mut gates, global_phase) =
-        inject_rotations(&circuit.gates, &paulis, &angles, preserve_order);
+    Ok(synthesize_pauli_network(
+        &rotations,
+        optimize_count,
+        preserve_order,
+        upto_clifford,
+        upto_phase,
+        resynth_clifford_method,
+    )?)
+}
 
-    // if the circuit needs to be synthesized exactly, we cannot use either Rustiq's
-    // or Qiskit's synthesis methods for Cliffords, since they do not necessarily preserve
-    // the global phase.
-    let resynth_clifford_method = match upto_phase {
-        true => resynth_clifford_method,
-        false => 0,
-    };
+#[cfg(all(test, not(miri)))]
+mod test {
+    use super::pauli_network_synthesis_observable;
+    use crate::matrix::sim::sim_unitary_circuit;
+    use approx::abs_diff_eq;
+    use ndarray::{Array2, array, linalg::kron};
+    use num_complex::Complex64;
+    use qiskit_quantum_info::sparse_observable::{BitTerm, SparseObservable};
+
+    fn rotation(pauli: &Array2<Complex64>, angle: f64) -> Array2<Complex64> {
+        Array2::eye(pauli.nrows()) * Complex64::new(angle.cos(), 0.0)
+            - pauli * Complex64::new(0.0, angle.sin())
+    }
 
-    // synthesize the final Clifford
-    if !upto_clifford {
-        let final_clifford = synthesize_final_clifford(&circuit.dagger(), resynth_clifford_method);
-        for gate in final_clifford {
-            gates.push(gate);
-        }
+    #[test]
+    fn test_observable_evolution() {
+        let observable = SparseObservable::new(
+            2,
+            vec![Complex64::new(0.3, 0.0), Complex64::new(0.2, 0.0)],
+            vec![BitTerm::Z, BitTerm::Z, BitTerm::X],
+            vec![0, 1, 0],
+            vec![0, 2, 3],
+        )
+        .unwrap();
+        let circuit =
+            pauli_network_synthesis_observable(&observable, 1.5, true, true, false, false, 0)
+                .unwrap();
+
+        let one = Complex64::new(1.0, 0.0);
+        let zero = Complex64::new(0.0, 0.0);
+        let x = array![[zero, one], [one, zero]];
+        let z = array![[one, zero], [zero, -one]];
+        let expected = rotation(&kron(&Array2::eye(2), &x), 0.2 * 1.5)
+            .dot(&rotation(&kron(&z, &z), 0.3 * 1.5));
+        let simulated = sim_unitary_circuit(&circuit).unwrap();
+        assert!(abs_diff_eq!(simulated, expected, epsilon = 1e-10));
     }
 
-    Ok(CircuitData::from_standard_gates(
-        num_qubits as u32,
-        gates,
-        global_phase,
-    )?)
+    #[test]
+    fn test_observable_projectors() {
+        let observable = SparseObservable::new(
+            1,
+            vec![Complex64::new(1.0, 0.0)],
+            vec![BitTerm::Zero],
+            vec![0],
+            vec![0, 1],
+        )
+        .unwrap();
+        assert!(
+            pauli_network_synthesis_observable(&observable, 1.0, true, true, false, false, 0)
+                .is_err()
+        );
+    }
 }
@@ -12,7 +12,7 @@
 
 use hashbrown::HashSet;
 use itertools::Itertools;
-use qiskit_quantum_info::sparse_observable::SparseTermView;
+use qiskit_quantum_info::sparse_observable::{BitTerm, SparseTermView};
 use qiskit_util::IndexMap;
 use rustworkx_core::coloring::{ColoringStrategy, greedy_node_color_with_coloring_strategy};
 use rustworkx_core::petgraph::graph::NodeIndex;
@@ -101,3 +101,149 @@ pub fn reorder_terms<'a>(
         Err(_) => Err("Unexpected error when coloring Pauli sparse terms"),
     }
 }
+
+/// Return whether two sparse terms commute.
+///
+/// Terms containing projectors are only considered to commute with terms on other qubits.
+fn terms_commute(a: &SparseTermView, b: &SparseTermView) -> bool {
+    let mut anticommuting = 0;
+    for (bit_a, index_a) in a.bit_terms.iter().zip(a.indices) {
+        let Some(position) = b.indices.iter().position(|index_b| index_b == index_a) else {
+            continue;
+        };
+        let bit_b = &b.bit_terms[position];
+        if !is_pauli(bit_a) || !is_pauli(bit_b) {
+            return false;
+        }
+        anticommuting += (bit_a != bit_b) as usize;
+    }
+    anticommuting % 2 == 0
+}
+
+fn is_pauli(bit_term: &BitTerm) -> bool {
+    matches!(bit_term, BitTerm::X | BitTerm::Y | BitTerm::Z)
+}
+
+/// Return whether a term is evolved with a native rotation gate, rather than with basis changes
+/// and a CX chain, by [sparse_term_evolution](crate::pauli_evolution::sparse_term_evolution).
+fn is_native_rotation(term: &SparseTermView) -> bool {
+    match term.bit_terms {
+        [bit_term] => is_pauli(bit_term),
+        [BitTerm::X, BitTerm::X]
+        | [BitTerm::Y, BitTerm::Y]
+        | [BitTerm::Z, BitTerm::Z]
+        | [BitTerm::Z, BitTerm::X]
+        | [BitTerm::X, BitTerm::Z] => true,
+        _ => false,
+    }
+}
+
+/// The gates that cancel between the evolutions of two consecutive terms, as the number of CX
+/// gates and then the number of single-qubit basis changes.
+///
+/// This follows the structure of the circuits of
+/// [sparse_term_evolution](crate::pauli_evolution::sparse_term_evolution): the evolution of a
+/// term changes the basis of its qubits, computes the parity of its Pauli qubits with a chain of
+/// CX gates ending on its first Pauli qubit, and then uncomputes both. The end of one evolution
+/// cancels with the start of the next on each qubit where both terms have the same letter, and
+/// the CX gates at the far end of the chains cancel while the chains run over the same qubits.
+fn cancellation(a: &SparseTermView, b: &SparseTermView) -> (usize, usize) {
+    if a.indices == b.indices && a.bit_terms == b.bit_terms {
+        // The rotations merge.
+        return (a.indices.len(), a.indices.len());
+    }
+    let is_chain =
+        |term: &SparseTermView| !is_native_rotation(term) && term.bit_terms.iter().all(is_pauli);
+    if !is_chain(a) || !is_chain(b) {
+        return (0, 0);
+    }
+    let basis_changes = a
+        .bit_terms
+        .iter()
+        .zip(a.indices)
+        .filter(|(bit_a, index_a)| {
+            bit_a.has_x_component()
+                && b.indices
+                    .iter()
+                    .position(|index_b| index_b == *index_a)
+                    .is_some_and(|position| b.bit_terms[position] == **bit_a)
+        })
+        .count();
+    let common = a
+        .bit_terms
+        .iter()
+        .zip(a.indices)
+        .rev()
+        .zip(b.bit_terms.iter().zip(b.indices).rev())
+        .take_while(|(link_a, link_b)| link_a == link_b)
+        .count();
+    (common.saturating_sub(1), basis_changes)
+}
+
+/// Reorder the terms of a product formula to maximize the gates that cancel between the
+/// evolutions of consecutive terms.
+///
+/// The terms are first grouped into sets of mutually commuting terms, each term joining the
+/// first group it commutes with. The terms of each group can be freely reordered without
+/// changing the evolution of the group, and are ordered by a greedy nearest-neighbor tour that
+/// always continues with the term sharing the most gates with the previous one, where a cancelled
+/// CX gate outweighs any number of single-qubit gates. The tour then continues into the group
+/// whose best term shares the most gates with the last term of the previous group.
+///
+/// The ordering only depends on the terms, so it is computed once for all time steps.
+pub fn order_terms_for_cancellation<'a>(
+    terms: impl Iterator<Item = SparseTermView<'a>>,
+) -> Vec<SparseTermView<'a>> {
+    let terms: Vec<SparseTermView<'a>> = terms.collect();
+    let mut groups: Vec<Vec<usize>> = Vec::new();
+    for (index, term) in terms.iter().enumerate() {
+        match groups.iter_mut().find(|group| {
+            group
+                .iter()
+                .all(|other| terms_commute(term, &terms[*other]))
+        }) {
+            Some(group) => group.push(index),
+            None => groups.push(vec![index]),
+        }
+    }
+
+    let mut ordered = Vec::with_capacity(terms.len());
+    let mut last: Option<usize> = None;
+    while !groups.is_empty() {
+        // The group and term to continue the tour with, choosing the earliest of equally good
+        // candidates so that the output is deterministic.
+        let best_in = |group: &[usize], last: Option<usize>| {
+            group
+                .iter()
+                .enumerate()
+                .map(|(position, index)| {
+                    let score =
+                        last.map_or((0, 0), |last| cancellation(&terms[last], &terms[*index]));
+                    (score, position)
+                })
+                .max_by(|(score_a, position_a), (score_b, position_b)| {
+                    score_a.cmp(score_b).then(position_b.cmp(position_a))
+                })
+                .expect("groups are not empty")
+        };
+        let (group_index, (_, mut position)) = groups
+            .iter()
+            .enumerate()
+            .map(|(group_index, group)| (group_index, best_in(group, last)))
+            .max_by(|(index_a, (score_a, _)), (index_b, (score_b, _))| {
+                score_a.cmp(score_b).then(index_b.cmp(index_a))
+            })
+            .expect("groups are not empty");
+        let mut group = groups.remove(group_index);
+        loop {
+            let index = group.remove(position);
+            ordered.push(terms[index]);
+            last = Some(index);
+            if group.is_empty() {
+                break;
+            }
+            position = best_in(&group, last).1;
+        }
+    }
+    ordered
+}
@@ -18,11 +18,11 @@ pub mod linalg;
 pub mod linear;
 pub mod linear_phase;
 pub mod matrix;
-mod multi_controlled;
+pub mod multi_controlled;
 pub mod pauli_evolution;
 pub mod pauli_products;
 mod permutation;
-mod qft;
+pub mod qft;
 pub mod qsd;
 pub mod ross_selinger;
 pub mod two_qubit_decompose;
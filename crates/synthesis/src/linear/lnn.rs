@@ -10,8 +10,7 @@
 // copyright notice, and modified files need to carry a notice indicating
 // that they have been altered from the originals.
 
-use crate::linear::utils::{_col_op, _row_op, _row_sum, calc_inverse_matrix_inner};
-use ndarray::{Array1, Array2, ArrayView1, ArrayView2, ArrayViewMut2};
+use crate::linear::binary_matrix::BinaryMatrix;
 use numpy::PyReadonlyArray2;
 use smallvec::smallvec;
 
@@ -34,25 +33,31 @@ type InstructionList = Vec<(usize, usize)>;
 /// Add a cx gate to the instructions and update the matrix mat
 fn _row_op_update_instructions(
     cx_instructions: &mut InstructionList,
-    mat: ArrayViewMut2<bool>,
+    mat: &mut BinaryMatrix,
     a: usize,
     b: usize,
 ) {
     cx_instructions.push((a, b));
-    _row_op(mat, a, b);
+    mat.add_row(a, b);
+}
+
+/// The inner product of two packed rows, modulo 2
+fn _dot(row_1: &[u64], row_2: &[u64]) -> bool {
+    row_1
+        .iter()
+        .zip(row_2)
+        .fold(0, |acc, (a, b)| acc ^ (a & b).count_ones())
+        & 1
+        == 1
 }
 
 /// Get the instructions for a lower triangular basis change of a matrix mat.
 /// See the proof of Proposition 7.3 in [1].
 /// mat_inv needs to be the inverted matrix of mat
-/// The outputs are the permuted versions of mat and mat_inv
-fn _get_lower_triangular<'a>(
-    n: usize,
-    mat: ArrayView2<bool>,
-    mut mat_inv: ArrayViewMut2<'a, bool>,
-) -> (Array2<bool>, ArrayViewMut2<'a, bool>) {
-    let mut mat = mat.to_owned();
-    let mut mat_t = mat.to_owned();
+/// Returns the permuted version of mat, and permutes mat_inv in place
+fn _get_lower_triangular(n: usize, mat: &BinaryMatrix, mat_inv: &mut BinaryMatrix) -> BinaryMatrix {
+    let mut mat = mat.clone();
+    let mut mat_t = mat.clone();
 
     let mut cx_instructions_rows: InstructionList = Vec::new();
     // Use the instructions in U, which contains only gates of the form cx(a,b) a>b
@@ -62,46 +67,45 @@ fn _get_lower_triangular<'a>(
     for i in (0..n).rev() {
         // Find the last "1" in row i, use COL operations to the left in order to
         // zero out all other "1"s in that row.
-        let cols_to_update: Vec<usize> = (0..n).rev().filter(|&j| mat[[i, j]]).collect();
+        let cols_to_update: Vec<usize> = (0..n).rev().filter(|&j| mat.get(i, j)).collect();
         let (first_j, cols_to_update) = cols_to_update.split_first().unwrap();
         cols_to_update.iter().for_each(|j| {
-            _col_op(mat.view_mut(), *first_j, *j);
+            mat.add_col(*first_j, *j);
         });
 
         // Use row operations directed upwards to zero out all "1"s above the remaining "1" in row i
-        let rows_to_update: Vec<usize> = (0..i).rev().filter(|k| mat[[*k, *first_j]]).collect();
+        let rows_to_update: Vec<usize> = (0..i).rev().filter(|k| mat.get(*k, *first_j)).collect();
         rows_to_update.into_iter().for_each(|k| {
-            _row_op_update_instructions(&mut cx_instructions_rows, mat.view_mut(), i, k);
+            _row_op_update_instructions(&mut cx_instructions_rows, &mut mat, i, k);
         });
     }
     // Apply only U instructions to get the permuted L
     for (ctrl, trgt) in cx_instructions_rows {
-        _row_op(mat_t.view_mut(), ctrl, trgt);
-        _col_op(mat_inv.view_mut(), trgt, ctrl); // performs an inverted col_op
+        mat_t.add_row(ctrl, trgt);
+        mat_inv.add_col(trgt, ctrl); // performs an inverted col_op
     }
-    (mat_t, mat_inv)
+    mat_t
 }
 
 /// For each row in mat_t, save the column index of the last "1"
-fn _get_label_arr(n: usize, mat_t: ArrayView2<bool>) -> Vec<usize> {
+fn _get_label_arr(n: usize, mat_t: &BinaryMatrix) -> Vec<usize> {
     (0..n)
-        .map(|i| (0..n).find(|&j| mat_t[[i, n - 1 - j]]).unwrap_or(n))
+        .map(|i| (0..n).find(|&j| mat_t.get(i, n - 1 - j)).unwrap_or(n))
         .collect()
 }
 
 /// Check if "row" is a linear combination of all rows in mat_inv_t not including the row labeled by k
+///
+/// The columns of mat_inv_t are given as the rows of its transpose mat_inv_t_cols.
 fn _in_linear_combination(
     label_arr_t: &[usize],
-    mat_inv_t: ArrayView2<bool>,
-    row: ArrayView1<bool>,
+    mat_inv_t_cols: &BinaryMatrix,
+    row: &[u64],
     k: usize,
 ) -> bool {
-    // Find the linear combination of mat_t rows which produces "row"
-    !(0..row.len())
-        .filter(|&row_l| row[row_l])
-        .fold(Array1::from_elem(row.len(), false), |w_needed, row_l| {
-            _row_sum(w_needed.view(), mat_inv_t.row(row_l)).unwrap()
-        })[label_arr_t[k]]
+    // The linear combination of mat_t rows which produces "row" is the sum of the rows of
+    // mat_inv_t selected by "row", and we only need its entry in column label_arr_t[k]
+    !_dot(row, mat_inv_t_cols.row(label_arr_t[k]))
 }
 
 /// Returns label_arr_t = label_arr^(-1)
@@ -115,14 +119,16 @@ fn _get_label_arr_t(n: usize, label_arr: &[usize]) -> Vec<usize> {
 /// by Proposition 7.3 in [1]
 fn _matrix_to_north_west(
     n: usize,
-    mut mat: ArrayViewMut2<bool>,
-    mut mat_inv: ArrayViewMut2<bool>,
+    mat: &mut BinaryMatrix,
+    mut mat_inv: BinaryMatrix,
 ) -> InstructionList {
     // The rows of mat_t hold all w_j vectors (see [1]). mat_inv_t is the inverted matrix of mat_t
     // To save time on needless copying, we change mat_inv into mat_inv_t, since we won't need mat_inv anymore
-    let (mat_t, mat_inv_t) = _get_lower_triangular(n, mat.view(), mat_inv.view_mut());
+    let mat_t = _get_lower_triangular(n, mat, &mut mat_inv);
+    // Only single columns of mat_inv_t are ever needed, so store them contiguously
+    let mat_inv_t_cols = mat_inv.transpose();
     // Get all pi(i) labels
-    let mut label_arr = _get_label_arr(n, mat_t.view());
+    let mut label_arr = _get_label_arr(n, &mat_t);
 
     // Save the original labels, exchange index <-> value
     let label_arr_t = _get_label_arr_t(n, &label_arr);
@@ -139,47 +145,37 @@ fn _matrix_to_north_west(
             if label_arr[i] > label_arr[i + 1] {
                 at_least_one_needed = true;
                 // iterate on column indices, output rows as Vec<bool>
-                let row_sum = _row_sum(mat.row(i), mat.row(i + 1)).unwrap();
+                let row_sum: Vec<u64> = mat
+                    .row(i)
+                    .iter()
+                    .zip(mat.row(i + 1))
+                    .map(|(a, b)| a ^ b)
+                    .collect();
                 // "Let W be the span of all w_l for l!=k" (see [1])
                 // " We can perform a box on <i> and <i + 1> that writes a vector in W to wire <i + 1>."
                 // (see [1])
                 if _in_linear_combination(
                     &label_arr_t,
-                    mat_inv_t.view(),
+                    &mat_inv_t_cols,
                     mat.row(i + 1),
                     label_arr[i + 1],
                 ) {
                     // do nothing
                 } else if _in_linear_combination(
                     &label_arr_t,
-                    mat_inv_t.view(),
-                    row_sum.view(),
+                    &mat_inv_t_cols,
+                    &row_sum,
                     label_arr[i + 1],
                 ) {
-                    _row_op_update_instructions(
-                        &mut cx_instructions_rows,
-                        mat.view_mut(),
-                        i,
-                        i + 1,
-                    );
+                    _row_op_update_instructions(&mut cx_instructions_rows, mat, i, i + 1);
                 } else if _in_linear_combination(
                     &label_arr_t,
-                    mat_inv_t.view(),
+                    &mat_inv_t_cols,
                     mat.row(i),
                     label_arr[i + 1],
                 ) {
-                    _row_op_update_instructions(
-                        &mut cx_instructions_rows,
-                        mat.view_mut(),
-                        i + 1,
-                        i,
-                    );
-                    _row_op_update_instructions(
-                        &mut cx_instructions_rows,
-                        mat.view_mut(),
-                        i,
-                        i + 1,
-                    );
+                    _row_op_update_instructions(&mut cx_instructions_rows, mat, i + 1, i);
+                    _row_op_update_instructions(&mut cx_instructions_rows, mat, i, i + 1);
                 }
                 (label_arr[i], label_arr[i + 1]) = (label_arr[i + 1], label_arr[i]);
             }
@@ -199,7 +195,7 @@ fn _matrix_to_north_west(
 }
 
 /// Transform a north-west triangular matrix to identity in depth 3*n by Proposition 7.4 of [1]
-fn _north_west_to_identity(n: usize, mut mat: ArrayViewMut2<bool>) -> InstructionList {
+fn _north_west_to_identity(n: usize, mat: &mut BinaryMatrix) -> InstructionList {
     // At start the labels are in reversed order
     let mut label_arr: Vec<usize> = (0..n).rev().collect();
     let mut first_qubit = 0;
@@ -214,17 +210,12 @@ fn _north_west_to_identity(n: usize, mut mat: ArrayViewMut2<bool>) -> Instructio
                 at_least_one_needed = true;
                 // If row i has "1" in column i+1, swap and remove the "1" (in depth 2)
                 // otherwise, only do a swap (in depth 3)
-                if !mat[[i, label_arr[i + 1]]] {
+                if !mat.get(i, label_arr[i + 1]) {
                     // Adding this turns the operation to a SWAP
-                    _row_op_update_instructions(
-                        &mut cx_instructions_rows,
-                        mat.view_mut(),
-                        i + 1,
-                        i,
-                    );
+                    _row_op_update_instructions(&mut cx_instructions_rows, mat, i + 1, i);
                 }
-                _row_op_update_instructions(&mut cx_instructions_rows, mat.view_mut(), i, i + 1);
-                _row_op_update_instructions(&mut cx_instructions_rows, mat.view_mut(), i + 1, i);
+                _row_op_update_instructions(&mut cx_instructions_rows, mat, i, i + 1);
+                _row_op_update_instructions(&mut cx_instructions_rows, mat, i + 1, i);
 
                 (label_arr[i], label_arr[i + 1]) = (label_arr[i + 1], label_arr[i]);
             }
@@ -263,25 +254,22 @@ fn _north_west_to_identity(n: usize, mut mat: ArrayViewMut2<bool>) -> Instructio
 /// [1]: Kutin, S., Moulton, D. P., Smithline, L. (2007).
 /// Computation at a Distance.
 /// `arXiv:quant-ph/0701194 <https://arxiv.org/abs/quant-ph/0701194>`_.
-pub fn synth_cnot_lnn_instructions(
-    arrayview: ArrayView2<bool>,
-) -> (InstructionList, InstructionList) {
+pub fn synth_cnot_lnn_instructions(mat: &BinaryMatrix) -> (InstructionList, InstructionList) {
     // According to [1] the synthesis is done on the inverse matrix
     // so the matrix mat is inverted at this step
-    let mut mat_inv: Array2<bool> = arrayview.to_owned();
-    let mut mat_cpy = calc_inverse_matrix_inner(mat_inv.view(), false).unwrap();
+    let mat_inv = mat.clone();
+    let mut mat_cpy = mat_inv.inverse().unwrap();
 
     let n = mat_cpy.nrows();
 
     // Transform an arbitrary invertible matrix to a north-west triangular matrix
     // by Proposition 7.3 of [1]
 
-    let cx_instructions_rows_m2nw =
-        _matrix_to_north_west(n, mat_cpy.view_mut(), mat_inv.view_mut());
+    let cx_instructions_rows_m2nw = _matrix_to_north_west(n, &mut mat_cpy, mat_inv);
     // Transform a north-west triangular matrix to identity in depth 3*n
     // by Proposition 7.4 of [1]
 
-    let cx_instructions_rows_nw2id = _north_west_to_identity(n, mat_cpy.view_mut());
+    let cx_instructions_rows_nw2id = _north_west_to_identity(n, &mut mat_cpy);
 
     (cx_instructions_rows_m2nw, cx_instructions_rows_nw2id)
 }
@@ -296,7 +284,9 @@ pub fn synth_cnot_lnn_instructions(
 pub fn py_synth_cnot_lnn_instructions(
     mat: PyReadonlyArray2<bool>,
 ) -> PyResult<(InstructionList, InstructionList)> {
-    Ok(synth_cnot_lnn_instructions(mat.as_array()))
+    Ok(synth_cnot_lnn_instructions(&BinaryMatrix::from_array(
+        mat.as_array(),
+    )))
 }
 
 /// Synthesize CX circuit in depth bounded by 5n for LNN connectivity.
@@ -308,7 +298,7 @@ pub fn py_synth_cnot_lnn_instructions(
 pub fn py_synth_cnot_depth_line_kms(mat: PyReadonlyArray2<bool>) -> PyResult<PyCircuitData> {
     let num_qubits = mat.as_array().nrows(); // is a quadratic matrix
     let (cx_instructions_rows_m2nw, cx_instructions_rows_nw2id) =
-        synth_cnot_lnn_instructions(mat.as_array());
+        synth_cnot_lnn_instructions(&BinaryMatrix::from_array(mat.as_array()));
 
     let instructions = cx_instructions_rows_m2nw
         .into_iter()
@@ -15,6 +15,7 @@ use numpy::{IntoPyArray, PyArray2, PyReadonlyArray2, PyReadwriteArray2};
 use pyo3::IntoPyObjectExt;
 use pyo3::prelude::*;
 
+pub mod binary_matrix;
 pub mod lnn;
 mod pmh;
 pub mod utils;
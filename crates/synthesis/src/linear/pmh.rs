@@ -11,9 +11,9 @@
 // that they have been altered from the originals.
 
 use hashbrown::HashMap;
-use ndarray::{Array1, Array2, ArrayViewMut2, Axis, s};
+use hashbrown::hash_map::Entry;
 use numpy::PyReadonlyArray2;
-use smallvec::smallvec;
+use smallvec::{SmallVec, smallvec};
 use std::cmp;
 
 use qiskit_circuit::Qubit;
@@ -22,12 +22,7 @@ use qiskit_circuit::operations::{Param, StandardGate};
 
 use pyo3::prelude::*;
 
-use super::utils::_add_row_or_col;
-
-/// This helper function allows transposed access to a matrix.
-fn _index(transpose: bool, i: usize, j: usize) -> (usize, usize) {
-    if transpose { (j, i) } else { (i, j) }
-}
+use super::binary_matrix::BinaryMatrix;
 
 fn _ceil_fraction(numerator: usize, denominator: usize) -> usize {
     let mut fraction = numerator / denominator;
@@ -65,77 +60,63 @@ fn _ceil_fraction(numerator: usize, denominator: usize) -> usize {
 ///
 /// Returns:
 ///     A vector of CX locations (control, target) that need to be applied.
-fn lower_cnot_synth(
-    mut matrix: ArrayViewMut2<bool>,
-    section_size: usize,
-    transpose: bool,
-) -> Vec<(usize, usize)> {
+fn lower_cnot_synth(matrix: &mut BinaryMatrix, section_size: usize) -> Vec<(usize, usize)> {
     // The vector of CNOTs to be applied. Called ``circuit`` here for consistency with the paper.
     let mut circuit: Vec<(usize, usize)> = Vec::new();
     let cutoff = 1;
 
-    // to apply to the transposed matrix, we can just set axis = 1
-    let row_axis = if transpose { Axis(1) } else { Axis(0) };
-
     // get number of columns (same as rows) and the number of sections
-    let n = matrix.raw_dim()[0];
+    let n = matrix.nrows();
     let num_sections = _ceil_fraction(n, section_size);
 
     // iterate over the columns
     for section in 1..num_sections + 1 {
         // store sub section row patterns here, which we saw already
-        let mut patterns: HashMap<Array1<bool>, usize> = HashMap::new();
-        let section_slice = s![(section - 1) * section_size..cmp::min(section * section_size, n)];
+        let mut patterns: HashMap<SmallVec<[u64; 1]>, usize> = HashMap::new();
+        let section_start = (section - 1) * section_size;
+        let section_end = cmp::min(section * section_size, n);
 
         // iterate over the rows (note we only iterate from the diagonal downwards)
-        for row_idx in (section - 1) * section_size..n {
+        for row_idx in section_start..n {
             // we need to keep track of the rows we saw already, called ``pattern`` here
-            let pattern: Array1<bool> = matrix
-                .index_axis(row_axis, row_idx)
-                .slice(section_slice)
-                .to_owned();
+            let pattern = matrix.row_segment(row_idx, section_start, section_end);
 
             // skip if the row is empty (i.e. all elements are false)
-            if pattern.iter().any(|&el| el) {
-                if patterns.contains_key(&pattern) {
-                    // store CX location
-                    circuit.push((patterns[&pattern], row_idx));
-                    // remove the row
-                    _add_row_or_col(matrix.view_mut(), &transpose, patterns[&pattern], row_idx);
-                } else {
-                    // if we have not seen this pattern yet, keep track of it
-                    patterns.insert(pattern, row_idx);
+            if pattern.iter().any(|&word| word != 0) {
+                match patterns.entry(pattern) {
+                    Entry::Occupied(entry) => {
+                        // store CX location
+                        circuit.push((*entry.get(), row_idx));
+                        // remove the row
+                        matrix.add_row(*entry.get(), row_idx);
+                    }
+                    Entry::Vacant(entry) => {
+                        // if we have not seen this pattern yet, keep track of it
+                        entry.insert(row_idx);
+                    }
                 }
             }
         }
 
         // gaussian eliminate the remainder of the section
-        for col_idx in (section - 1) * section_size..cmp::min(section * section_size, n) {
-            let mut diag_el = matrix[[col_idx, col_idx]];
+        for col_idx in section_start..section_end {
+            let mut diag_el = matrix.get(col_idx, col_idx);
 
             for r in col_idx + 1..n {
-                if matrix[_index(transpose, r, col_idx)] {
+                if matrix.get(r, col_idx) {
                     if !diag_el {
-                        _add_row_or_col(matrix.view_mut(), &transpose, r, col_idx);
+                        matrix.add_row(r, col_idx);
                         circuit.push((r, col_idx));
                         diag_el = true
                     }
-                    _add_row_or_col(matrix.view_mut(), &transpose, col_idx, r);
+                    matrix.add_row(col_idx, r);
                     circuit.push((col_idx, r));
                 }
 
-                // back-reduce to the pivot row: this one-line-magic checks if the logical AND
-                // between the two target rows has more ``true`` elements is larger than the cutoff
-                if matrix
-                    .index_axis(row_axis, col_idx)
-                    .iter()
-                    .zip(matrix.index_axis(row_axis, r).iter())
-                    .map(|(&i, &j)| i & j)
-                    .filter(|&x| x)
-                    .count()
-                    > cutoff
-                {
-                    _add_row_or_col(matrix.view_mut(), &transpose, r, col_idx);
+                // back-reduce to the pivot row: this checks if the logical AND between the two
+                // target rows has more ``true`` elements than the cutoff
+                if matrix.row_overlap(col_idx, r) > cutoff {
+                    matrix.add_row(r, col_idx);
                     circuit.push((r, col_idx));
                 }
             }
@@ -153,8 +134,7 @@ pub fn synth_cnot_count_full_pmh(
     matrix: PyReadonlyArray2<bool>,
     section_size: Option<i64>,
 ) -> PyResult<PyCircuitData> {
-    let arrayview = matrix.as_array();
-    let mut mat: Array2<bool> = arrayview.to_owned();
+    let mut mat = BinaryMatrix::from_array(matrix.as_array());
     let num_qubits = mat.nrows(); // is a quadratic matrix
 
     // If given, use the user-specified input size. If None, we default to
@@ -170,8 +150,8 @@ pub fn synth_cnot_count_full_pmh(
 
     // compute the synthesis for the lower triangular part of the matrix, and then
     // apply it on the transposed part for the full synthesis
-    let lower_cnots = lower_cnot_synth(mat.view_mut(), blocksize, false);
-    let upper_cnots = lower_cnot_synth(mat.view_mut(), blocksize, true);
+    let lower_cnots = lower_cnot_synth(&mut mat, blocksize);
+    let upper_cnots = lower_cnot_synth(&mut mat.transpose(), blocksize);
 
     // iterator over the gates
     let instructions = upper_cnots
@@ -10,59 +10,20 @@
 // copyright notice, and modified files need to carry a notice indicating
 // that they have been altered from the originals.
 
-use ndarray::{
-    Array1, Array2, ArrayView1, ArrayView2, ArrayViewMut2, Axis, Zip, azip, concatenate, s,
-};
+use ndarray::{Array1, Array2, ArrayView1, ArrayView2, ArrayViewMut2, Axis, Zip, azip, s};
 use rand::prelude::*;
 use rand::rngs::SysRng;
 use rand_pcg::Pcg64Mcg;
-use rayon::iter::{IndexedParallelIterator, ParallelIterator};
-use rayon::prelude::IntoParallelIterator;
 
-use qiskit_util::getenv_use_multiple_threads;
-
-/// Specifies the minimum number of qubits in order to parallelize computations
-/// (this number is chosen based on several local experiments).
-const PARALLEL_THRESHOLD: usize = 10;
+use super::binary_matrix::BinaryMatrix;
 
 /// Binary matrix multiplication
 pub fn binary_matmul_inner(
     mat1: ArrayView2<bool>,
     mat2: ArrayView2<bool>,
 ) -> Result<Array2<bool>, String> {
-    let n1_rows = mat1.nrows();
-    let n1_cols = mat1.ncols();
-    let n2_rows = mat2.nrows();
-    let n2_cols = mat2.ncols();
-    if n1_cols != n2_rows {
-        return Err(format!(
-            "Cannot multiply matrices with inappropriate dimensions {n1_cols}, {n2_rows}"
-        ));
-    }
-
-    let run_in_parallel = getenv_use_multiple_threads();
-
-    if n1_rows < PARALLEL_THRESHOLD || !run_in_parallel {
-        Ok(Array2::from_shape_fn((n1_rows, n2_cols), |(i, j)| {
-            (0..n2_rows)
-                .map(|k| mat1[[i, k]] & mat2[[k, j]])
-                .fold(false, |acc, v| acc ^ v)
-        }))
-    } else {
-        let mut result = Array2::from_elem((n1_rows, n2_cols), false);
-        result
-            .axis_iter_mut(Axis(0))
-            .into_par_iter()
-            .enumerate()
-            .for_each(|(i, mut row)| {
-                for j in 0..n2_cols {
-                    row[j] = (0..n2_rows)
-                        .map(|k| mat1[[i, k]] & mat2[[k, j]])
-                        .fold(false, |acc, v| acc ^ v)
-                }
-            });
-        Ok(result)
-    }
+    let product = BinaryMatrix::from_array(mat1).matmul(&BinaryMatrix::from_array(mat2))?;
+    Ok(product.to_array())
 }
 
 /// Gauss elimination of a matrix mat with m rows and n columns.
@@ -74,58 +35,9 @@ pub fn gauss_elimination_with_perm_inner(
     ncols: Option<usize>,
     full_elim: Option<bool>,
 ) -> Vec<usize> {
-    let (m, mut n) = (mat.nrows(), mat.ncols()); // no. of rows and columns
-    if let Some(ncols_val) = ncols {
-        n = usize::min(n, ncols_val); // no. of active columns
-    }
-    let mut perm: Vec<usize> = Vec::from_iter(0..m);
-
-    let mut r = 0; // current rank
-    let k = 0; // current pivot column
-    let mut new_k = 0;
-    while (r < m) && (k < n) {
-        let mut is_non_zero = false;
-        let mut new_r = r;
-        for j in k..n {
-            new_k = k;
-            for i in r..m {
-                if mat[(i, j)] {
-                    is_non_zero = true;
-                    new_k = j;
-                    new_r = i;
-                    break;
-                }
-            }
-            if is_non_zero {
-                break;
-            }
-        }
-        if !is_non_zero {
-            return perm; // A is in the canonical form
-        }
-
-        if new_r != r {
-            let temp_r = mat.slice_mut(s![r, ..]).to_owned();
-            let temp_new_r = mat.slice_mut(s![new_r, ..]).to_owned();
-            mat.slice_mut(s![r, ..]).assign(&temp_new_r);
-            mat.slice_mut(s![new_r, ..]).assign(&temp_r);
-            perm.swap(r, new_r);
-        }
-
-        // Copy source row to avoid trying multiple borrows at once
-        let row0 = mat.row(r).to_owned();
-        mat.axis_iter_mut(Axis(0))
-            .enumerate()
-            .filter(|(i, row)| {
-                (full_elim == Some(true) && (*i < r) && row[new_k])
-                    || (*i > r && *i < m && row[new_k])
-            })
-            .for_each(|(_i, mut row)| {
-                row.zip_mut_with(&row0, |x, &y| *x ^= y);
-            });
-
-        r += 1;
-    }
+    let mut packed = BinaryMatrix::from_array(mat.view());
+    let perm = packed.gauss_elimination_with_perm(ncols, full_elim == Some(true));
+    packed.write_to(mat.view_mut());
     perm
 }
 
@@ -141,9 +53,7 @@ pub fn compute_rank_after_gauss_elim_inner(mat: ArrayView2<bool>) -> usize {
 
 /// Given a boolean matrix mat computes its rank
 pub fn compute_rank_inner(mat: ArrayView2<bool>) -> usize {
-    let mut temp_mat = mat.to_owned();
-    gauss_elimination_with_perm_inner(temp_mat.view_mut(), None, Some(false));
-    compute_rank_after_gauss_elim_inner(temp_mat.view())
+    BinaryMatrix::from_array(mat).rank()
 }
 
 /// Given a square boolean matrix mat, tries to compute its inverse.
@@ -154,30 +64,14 @@ pub fn calc_inverse_matrix_inner(
     if mat.shape()[0] != mat.shape()[1] {
         return Err("Matrix to invert is a non-square matrix.".to_string());
     }
-    let n = mat.shape()[0];
-
-    // concatenate the matrix and identity
-    let identity_matrix: Array2<bool> = Array2::from_shape_fn((n, n), |(i, j)| i == j);
-    let mut mat1 = concatenate(Axis(1), &[mat.view(), identity_matrix.view()]).unwrap();
-
-    gauss_elimination_with_perm_inner(mat1.view_mut(), None, Some(true));
-
-    let r = compute_rank_after_gauss_elim_inner(mat1.slice(s![.., 0..n]));
-    if r < n {
-        return Err("The matrix is not invertible.".to_string());
-    }
+    let packed = BinaryMatrix::from_array(mat);
+    let invmat = packed.inverse()?;
 
-    let invmat = mat1.slice(s![.., n..2 * n]).to_owned();
-
-    if verify {
-        let mat2 = binary_matmul_inner(mat, (&invmat).into())?;
-        let identity_matrix: Array2<bool> = Array2::from_shape_fn((n, n), |(i, j)| i == j);
-        if mat2.ne(&identity_matrix) {
-            return Err("The inverse matrix is not correct.".to_string());
-        }
+    if verify && packed.matmul(&invmat)? != BinaryMatrix::identity(mat.nrows()) {
+        return Err("The inverse matrix is not correct.".to_string());
     }
 
-    Ok(invmat)
+    Ok(invmat.to_array())
 }
 
 /// Mutate a matrix inplace by adding the value of the ``ctrl`` row to the
@@ -10,8 +10,8 @@
 // copyright notice, and modified files need to carry a notice indicating
 // that they have been altered from the originals.
 
+use crate::linear::binary_matrix::BinaryMatrix;
 use crate::linear::lnn::synth_cnot_lnn_instructions;
-use crate::linear::utils::calc_inverse_matrix_inner;
 
 use hashbrown::HashSet;
 use ndarray::{Array2, ArrayView2, s};
@@ -255,9 +255,11 @@ pub fn py_synth_cx_cz_depth_line_my(
 ) -> PyResult<PyCircuitData> {
     // First, find circuits implementing mat_x by Proposition 7.3 and Proposition 7.4 of [1]
     let n = mat_x.as_array().nrows(); // is a quadratic matrix
-    let mat_x = calc_inverse_matrix_inner(mat_x.as_array(), false).unwrap();
+    let mat_x = BinaryMatrix::from_array(mat_x.as_array())
+        .inverse()
+        .unwrap();
     let (cx_instructions_rows_m2nw, cx_instructions_rows_nw2id) =
-        synth_cnot_lnn_instructions(mat_x.view());
+        synth_cnot_lnn_instructions(&mat_x);
 
     // Meanwhile, also build the -CZ- circuit via Phase gate insertions as per Algorithm 2 [2]
     let mut phase_schedule = _initialize_phase_schedule(mat_z.as_array());
@@ -11,4 +11,5 @@
 // that they have been altered from the originals.
 
 pub mod sim;
+pub mod statevector;
 pub mod two_qubit;
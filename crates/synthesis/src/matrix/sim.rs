@@ -15,64 +15,50 @@ use num_complex::Complex64;
 use numpy::IntoPyArray;
 use pyo3::prelude::*;
 use qiskit_circuit::circuit_data::{CircuitData, PyCircuitData};
-use qiskit_circuit::operations::{Operation, OperationRef, Param, StandardInstruction};
-use qiskit_quantum_info::unitary_compose;
+use rayon::prelude::*;
 
+use qiskit_util::getenv_use_multiple_threads;
+
+use super::statevector::CompiledCircuit;
 use crate::QiskitError;
 
-// The code is based on top of unitary_compose. For circuits with 13 or more qubits, einsum
-// throws an "index out of bounds" error.
-const MAX_NUM_QUBITS: usize = 12;
+// The unitary of an n-qubit circuit takes 16 * 4^n bytes, which is 4 GiB at this limit.  It is
+// written in place, so this is also the peak memory use.
+const MAX_NUM_QUBITS: usize = 14;
+
+/// Specifies the minimum number of qubits in order to simulate the columns of the unitary in
+/// parallel.
+const PARALLEL_THRESHOLD: usize = 6;
 
 /// Create a unitary matrix for a circuit.
+///
+/// Row `r` of the unitary is column `r` of its transpose, so the transposed gates are applied in
+/// reverse order and in place to each row of the unitary in turn, with each row starting out as a
+/// basis vector.  Every row is then an independent statevector simulation that stays in cache for
+/// the whole circuit, and is written straight into its place in the row-major output.
+/// Consecutive gates that together act on at most two qubits are first fused into a single gate.
 pub fn sim_unitary_circuit(circuit: &CircuitData) -> Result<Array2<Complex64>, String> {
-    if circuit.num_clbits() > 0 {
-        return Err("Cannot simulate circuit involving classical bits.".to_string());
-    }
-
-    let num_qubits = circuit.num_qubits();
-
-    if num_qubits > MAX_NUM_QUBITS {
-        return Err(format!(
-            "The number of circuit qubits ({num_qubits}) exceeds the maximum allowed number of qubits allowed for simulation ({MAX_NUM_QUBITS})."
-        ));
-    }
-
-    // e^{i * global_phase}
-    let global_phase_exp: Complex64 = if let Param::Float(p) = circuit.global_phase() {
-        Complex64::new(0., *p).exp()
-    } else {
-        return Err("Cannot simulate circuit involving non-float global phase.".to_string());
+    let compiled = CompiledCircuit::new(circuit, MAX_NUM_QUBITS)?.transpose();
+    let num_qubits = compiled.num_qubits();
+
+    let dim = 1usize << num_qubits;
+    let mut data = vec![Complex64::ZERO; dim * dim];
+    let simulate_row = |scratch: &mut Vec<Complex64>, (r, row): (usize, &mut [Complex64])| {
+        row[r] = compiled.phase();
+        compiled.apply_gates(row, scratch);
     };
-
-    // Product matrix holding the result
-    let mut product_mat: Array2<Complex64> =
-        Array2::<Complex64>::eye(2_usize.pow(num_qubits as u32)) * global_phase_exp;
-    let mut qubits = Vec::new();
-
-    for inst in circuit.data() {
-        if !circuit.get_cargs(inst.clbits).is_empty() {
-            return Err(
-                "Cannot simulate circuit with instructions involving classical bits".to_string(),
-            );
-        }
-
-        // Ignore barriers
-        if let OperationRef::StandardInstruction(StandardInstruction::Barrier(_)) = inst.op.view() {
-            continue;
-        }
-
-        qubits.clear();
-        qubits.extend(circuit.get_qargs(inst.qubits).iter().map(|q| q.index()));
-
-        let mat = inst
-            .try_matrix()
-            .ok_or_else(|| format!("Cannot extract matrix for operation {:?}.", inst.op.name()))?;
-
-        product_mat = unitary_compose::compose(&product_mat.view(), &mat.view(), &qubits, false)?;
+    if num_qubits >= PARALLEL_THRESHOLD && getenv_use_multiple_threads() {
+        data.par_chunks_exact_mut(dim)
+            .enumerate()
+            .for_each_init(Vec::new, simulate_row);
+    } else {
+        let mut scratch = Vec::new();
+        data.chunks_exact_mut(dim)
+            .enumerate()
+            .for_each(|row| simulate_row(&mut scratch, row));
     }
 
-    Ok(product_mat)
+    Ok(Array2::from_shape_vec((dim, dim), data).expect("the data has exactly dim * dim elements"))
 }
 
 /// Create a unitary matrix for a circuit.
@@ -92,7 +78,25 @@ pub fn unitary_sim(m: &Bound<PyModule>) -> PyResult<()> {
 mod test {
     use super::sim_unitary_circuit;
     use approx::abs_diff_eq;
-    use qiskit_circuit::operations::StandardGate;
+    use qiskit_circuit::Qubit;
+    use qiskit_circuit::circuit_data::CircuitData;
+    use qiskit_circuit::operations::{Param, StandardGate};
+    use smallvec::{SmallVec, smallvec};
+
+    fn circuit(num_qubits: u32, gates: &[(StandardGate, &[u32])]) -> CircuitData {
+        CircuitData::from_standard_gates(
+            num_qubits,
+            gates.iter().map(|(gate, qubits)| {
+                (
+                    *gate,
+                    smallvec![],
+                    qubits.iter().map(|q| Qubit(*q)).collect::<SmallVec<_>>(),
+                )
+            }),
+            Param::Float(0.0),
+        )
+        .unwrap()
+    }
 
     #[test]
     fn test_sim_ecr_definition() {
@@ -106,4 +110,77 @@ mod test {
         let close = abs_diff_eq!(simulated_matrix, expected_matrix, epsilon = 1e-12);
         assert!(close);
     }
+
+    #[test]
+    fn test_sim_multi_qubit_gate() {
+        // A three-qubit gate is applied without fusion, and matches its own definition.
+        let ccx_definition = StandardGate::CCX.definition(&[]).unwrap();
+        let simulated_matrix = sim_unitary_circuit(&ccx_definition).unwrap();
+        let direct_matrix =
+            sim_unitary_circuit(&circuit(3, &[(StandardGate::CCX, &[0, 1, 2])])).unwrap();
+        let expected_matrix = StandardGate::CCX.matrix(&[]).unwrap();
+
+        assert!(abs_diff_eq!(
+            simulated_matrix,
+            expected_matrix,
+            epsilon = 1e-12
+        ));
+        assert!(abs_diff_eq!(
+            direct_matrix,
+            expected_matrix,
+            epsilon = 1e-12
+        ));
+    }
+
+    #[test]
+    fn test_sim_not_symmetric() {
+        // The rows are simulated with the transposed gates, which must not be mistaken for the
+        // gates themselves.  Neither of these matrices is symmetric.
+        for (gate, qubits) in [
+            (StandardGate::RCCX, &[0, 1, 2][..]),
+            (StandardGate::ECR, &[0, 1][..]),
+        ] {
+            let simulated_matrix =
+                sim_unitary_circuit(&circuit(qubits.len() as u32, &[(gate, qubits)])).unwrap();
+            let expected_matrix = gate.matrix(&[]).unwrap();
+            assert!(abs_diff_eq!(
+                simulated_matrix,
+                expected_matrix,
+                epsilon = 1e-12
+            ));
+        }
+    }
+
+    #[test]
+    fn test_sim_fused_gates() {
+        // Gates on reversed and partially overlapping qubits, interleaved with gates on other
+        // qubits, are fused together.  Conjugating by swaps reverses the CX, and the H gates
+        // commute with everything on other qubits.
+        let fused = circuit(
+            3,
+            &[
+                (StandardGate::H, &[2]),
+                (StandardGate::Swap, &[0, 1]),
+                (StandardGate::X, &[2]),
+                (StandardGate::CX, &[1, 0]),
+                (StandardGate::Swap, &[1, 0]),
+                (StandardGate::S, &[0]),
+                (StandardGate::H, &[2]),
+            ],
+        );
+        let expected = circuit(
+            3,
+            &[
+                (StandardGate::CX, &[0, 1]),
+                (StandardGate::S, &[0]),
+                (StandardGate::H, &[2]),
+                (StandardGate::X, &[2]),
+                (StandardGate::H, &[2]),
+            ],
+        );
+        let fused_matrix = sim_unitary_circuit(&fused).unwrap();
+        let expected_matrix = sim_unitary_circuit(&expected).unwrap();
+
+        assert!(abs_diff_eq!(fused_matrix, expected_matrix, epsilon = 1e-12));
+    }
 }
@@ -0,0 +1,790 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+use ndarray::Array2;
+use ndarray::linalg::kron;
+use num_complex::Complex64;
+use qiskit_circuit::circuit_data::CircuitData;
+use qiskit_circuit::operations::{Operation, OperationRef, Param, StandardInstruction};
+use rand::prelude::*;
+use rand::rngs::SysRng;
+use rand_distr::StandardNormal;
+use rand_pcg::Pcg64Mcg;
+use rayon::prelude::*;
+use smallvec::{SmallVec, smallvec};
+
+use qiskit_util::getenv_use_multiple_threads;
+
+// A statevector of n qubits takes 16 * 2^n bytes, which is 16 GiB at this limit.
+pub const MAX_STATEVECTOR_QUBITS: usize = 30;
+
+/// Specifies the minimum number of qubits in order to apply the gates to a statevector with
+/// multiple threads.
+const PARALLEL_THRESHOLD: usize = 14;
+
+/// The number of amplitudes in each block of a statevector updated by a single parallel task.
+const PARALLEL_CHUNK: usize = 1 << 14;
+
+/// The tolerance on the distance between the output states of two circuits that are considered
+/// equivalent.
+const EQUIVALENCE_TOLERANCE: f64 = 1e-6;
+
+/// A gate to be applied to a statevector, together with its qubits.  Qubit `qubits[k]`
+/// corresponds to bit `k` of the indices of `matrix`.
+struct FusedGate {
+    matrix: Array2<Complex64>,
+    qubits: SmallVec<[usize; 2]>,
+}
+
+/// The matrix of a two-qubit gate with the order of its qubits exchanged.
+fn swap_qubit_order(matrix: &Array2<Complex64>) -> Array2<Complex64> {
+    const PERM: [usize; 4] = [0, 2, 1, 3];
+    Array2::from_shape_fn((4, 4), |(i, j)| matrix[[PERM[i], PERM[j]]])
+}
+
+/// Try to fuse the gate `matrix` on `qubits` into an earlier gate `first`, which is possible if
+/// the two together act on at most two qubits.
+fn fuse(first: &FusedGate, matrix: &Array2<Complex64>, qubits: &[usize]) -> Option<FusedGate> {
+    let eye = Array2::<Complex64>::eye(2);
+    let (matrix, qubits) = match (first.qubits.as_slice(), qubits) {
+        (a, b) if a == b => (matrix.dot(&first.matrix), first.qubits.clone()),
+        ([a0, a1], [b0, b1]) if a0 == b1 && a1 == b0 => (
+            swap_qubit_order(matrix).dot(&first.matrix),
+            first.qubits.clone(),
+        ),
+        // Qubit `k` of a gate is bit `k` of its matrix indices, so the lower qubit of a two-qubit
+        // matrix is the right-hand factor of a Kronecker product.
+        ([a0, _], [b]) if a0 == b => (kron(&eye, matrix).dot(&first.matrix), first.qubits.clone()),
+        ([_, a1], [b]) if a1 == b => (kron(matrix, &eye).dot(&first.matrix), first.qubits.clone()),
+        ([a], [b0, _]) if a == b0 => (matrix.dot(&kron(&eye, &first.matrix)), qubits.into()),
+        ([a], [_, b1]) if a == b1 => (matrix.dot(&kron(&first.matrix, &eye)), qubits.into()),
+        _ => return None,
+    };
+    Some(FusedGate { matrix, qubits })
+}
+
+/// An in-place update of a statevector.
+enum Kernel {
+    OneQubit([[Complex64; 2]; 2], usize),
+    TwoQubit([[Complex64; 4]; 4], [usize; 2]),
+    MultiQubit(Array2<Complex64>, SmallVec<[usize; 4]>),
+}
+
+impl From<FusedGate> for Kernel {
+    fn from(gate: FusedGate) -> Self {
+        let m = &gate.matrix;
+        match gate.qubits.as_slice() {
+            [q] => Kernel::OneQubit([[m[[0, 0]], m[[0, 1]]], [m[[1, 0]], m[[1, 1]]]], *q),
+            [q0, q1] => Kernel::TwoQubit(
+                std::array::from_fn(|i| std::array::from_fn(|j| m[[i, j]])),
+                [*q0, *q1],
+            ),
+            qubits => Kernel::MultiQubit(gate.matrix.clone(), qubits.iter().copied().collect()),
+        }
+    }
+}
+
+/// Insert a zero at bit `bit` of `index`, moving the higher bits up by one.
+#[inline(always)]
+fn insert_zero_bit(index: usize, bit: usize) -> usize {
+    let low = index & ((1 << bit) - 1);
+    ((index >> bit) << (bit + 1)) | low
+}
+
+/// The offsets from the base index of each group of amplitudes updated together by a gate on
+/// `qubits`, in the order of the gate's matrix indices.
+fn group_offsets(qubits: &[usize]) -> SmallVec<[usize; 8]> {
+    (0..1 << qubits.len())
+        .map(|j| {
+            qubits
+                .iter()
+                .enumerate()
+                .filter(|(bit, _)| (j >> bit) & 1 == 1)
+                .map(|(_, q)| 1 << q)
+                .sum::<usize>()
+        })
+        .collect()
+}
+
+/// A pointer to the amplitudes of a statevector that can be shared between threads, each of which
+/// must only touch amplitudes that no other thread does.
+#[derive(Clone, Copy)]
+struct SharedAmplitudes(*mut Complex64);
+
+// SAFETY: the threads sharing the pointer access disjoint sets of amplitudes.
+unsafe impl Send for SharedAmplitudes {}
+// SAFETY: as above.
+unsafe impl Sync for SharedAmplitudes {}
+
+impl SharedAmplitudes {
+    // This is a method rather than a field access so that closures capture the whole `Sync`
+    // struct rather than the raw pointer.
+    #[inline(always)]
+    fn ptr(&self) -> *mut Complex64 {
+        self.0
+    }
+}
+
+impl Kernel {
+    /// The kernel of the transpose of this kernel's gate.
+    fn transpose(&self) -> Self {
+        match self {
+            Kernel::OneQubit(m, q) => {
+                Kernel::OneQubit([[m[0][0], m[1][0]], [m[0][1], m[1][1]]], *q)
+            }
+            Kernel::TwoQubit(m, qubits) => Kernel::TwoQubit(
+                std::array::from_fn(|i| std::array::from_fn(|j| m[j][i])),
+                *qubits,
+            ),
+            Kernel::MultiQubit(m, qubits) => {
+                Kernel::MultiQubit(m.t().as_standard_layout().into_owned(), qubits.clone())
+            }
+        }
+    }
+
+    /// The qubits the kernel acts on, in the order of its matrix indices.
+    fn qubits(&self) -> SmallVec<[usize; 4]> {
+        match self {
+            Kernel::OneQubit(_, q) => smallvec![*q],
+            Kernel::TwoQubit(_, qubits) => qubits.iter().copied().collect(),
+            Kernel::MultiQubit(_, qubits) => qubits.clone(),
+        }
+    }
+
+    /// Multiply the vector `state` by this kernel's gate.
+    ///
+    /// The length of `state` must be a multiple of `2^(q + 1)` for every qubit `q` of the gate,
+    /// so this can also update any aligned block of a larger statevector.
+    fn apply(&self, state: &mut [Complex64], scratch: &mut Vec<Complex64>) {
+        match self {
+            Kernel::OneQubit(m, q) => {
+                // Amplitude pairs differing in bit `q` are `stride` apart, in contiguous runs of
+                // `stride`, so the inner loop is over two contiguous slices.
+                let stride = 1 << q;
+                for block in state.chunks_exact_mut(2 * stride) {
+                    let (lo, hi) = block.split_at_mut(stride);
+                    for (a, b) in lo.iter_mut().zip(hi) {
+                        let (x, y) = (*a, *b);
+                        *a = m[0][0] * x + m[0][1] * y;
+                        *b = m[1][0] * x + m[1][1] * y;
+                    }
+                }
+            }
+            Kernel::TwoQubit(m, [q0, q1]) => {
+                let (b0, b1) = (1 << q0, 1 << q1);
+                let (lo, hi) = (*q0.min(q1), *q0.max(q1));
+                for k in 0..state.len() / 4 {
+                    let base = insert_zero_bit(insert_zero_bit(k, lo), hi);
+                    let idx = [base, base | b0, base | b1, base | b0 | b1];
+                    let v = idx.map(|i| state[i]);
+                    for (row, i) in m.iter().zip(idx) {
+                        state[i] = row[0] * v[0] + row[1] * v[1] + row[2] * v[2] + row[3] * v[3];
+                    }
+                }
+            }
+            Kernel::MultiQubit(m, qubits) => {
+                let offsets = group_offsets(qubits);
+                let mut sorted = qubits.clone();
+                sorted.sort_unstable();
+                for k in 0..state.len() >> qubits.len() {
+                    let base = sorted.iter().fold(k, |idx, q| insert_zero_bit(idx, *q));
+                    scratch.clear();
+                    scratch.extend(offsets.iter().map(|o| state[base + o]));
+                    for (row, o) in m.rows().into_iter().zip(&offsets) {
+                        state[base + o] = row.iter().zip(scratch.iter()).map(|(a, b)| a * b).sum();
+                    }
+                }
+            }
+        }
+    }
+
+    /// Update the group of amplitudes at `base + offsets[j]`.
+    ///
+    /// # Safety
+    ///
+    /// Every index `base + offsets[j]` must be in bounds of `amplitudes`, and no other thread may
+    /// access those amplitudes during the call.
+    #[inline]
+    unsafe fn apply_group(
+        &self,
+        amplitudes: *mut Complex64,
+        base: usize,
+        offsets: &[usize],
+        scratch: &mut Vec<Complex64>,
+    ) {
+        scratch.clear();
+        // SAFETY: per the function's requirements.
+        scratch.extend(
+            offsets
+                .iter()
+                .map(|o| unsafe { amplitudes.add(base + o).read() }),
+        );
+        for (i, o) in offsets.iter().enumerate() {
+            let value = match self {
+                Kernel::OneQubit(m, _) => m[i][0] * scratch[0] + m[i][1] * scratch[1],
+                Kernel::TwoQubit(m, _) => m[i].iter().zip(scratch.iter()).map(|(a, b)| a * b).sum(),
+                Kernel::MultiQubit(m, _) => m
+                    .row(i)
+                    .iter()
+                    .zip(scratch.iter())
+                    .map(|(a, b)| a * b)
+                    .sum(),
+            };
+            // SAFETY: per the function's requirements.
+            unsafe { amplitudes.add(base + o).write(value) };
+        }
+    }
+
+    /// Multiply the vector `state`, which must have at least [PARALLEL_CHUNK] amplitudes, by this
+    /// kernel's gate with multiple threads.
+    fn apply_parallel(&self, state: &mut [Complex64]) {
+        let qubits = self.qubits();
+        let span = 2usize
+            << qubits
+                .iter()
+                .max()
+                .expect("kernels act on at least one qubit");
+        if span <= PARALLEL_CHUNK {
+            // The gate acts within each aligned block of `PARALLEL_CHUNK` amplitudes, which can
+            // then be updated independently with the serial kernel.
+            state
+                .par_chunks_exact_mut(PARALLEL_CHUNK)
+                .for_each_init(Vec::new, |scratch, block| self.apply(block, scratch));
+            return;
+        }
+        // The gate acts on a high qubit, so the amplitudes updated together are far apart, and
+        // the work is instead split between the groups of amplitudes.
+        let offsets = group_offsets(&qubits);
+        let mut sorted = qubits.clone();
+        sorted.sort_unstable();
+        let num_groups = state.len() >> qubits.len();
+        let amplitudes = SharedAmplitudes(state.as_mut_ptr());
+        (0..num_groups)
+            .into_par_iter()
+            .with_min_len(PARALLEL_CHUNK >> qubits.len())
+            .for_each_init(Vec::new, |scratch, k| {
+                let base = sorted.iter().fold(k, |idx, q| insert_zero_bit(idx, *q));
+                // SAFETY: the index sets `base + offsets` of distinct groups are disjoint, and
+                // all of them are within the statevector.
+                unsafe { self.apply_group(amplitudes.ptr(), base, &offsets, scratch) };
+            });
+    }
+}
+
+/// A circuit prepared for simulation, as a list of fused gates to be applied to a statevector.
+pub struct CompiledCircuit {
+    num_qubits: usize,
+    phase: Complex64,
+    kernels: Vec<Kernel>,
+}
+
+impl CompiledCircuit {
+    /// Prepare a unitary circuit of at most `max_qubits` qubits for simulation.
+    ///
+    /// Consecutive gates that together act on at most two qubits are fused into a single gate.
+    pub fn new(circuit: &CircuitData, max_qubits: usize) -> Result<Self, String> {
+        if circuit.num_clbits() > 0 {
+            return Err("Cannot simulate circuit involving classical bits.".to_string());
+        }
+
+        let num_qubits = circuit.num_qubits();
+
+        if num_qubits > max_qubits {
+            return Err(format!(
+                "The number of circuit qubits ({num_qubits}) exceeds the maximum allowed number of qubits allowed for simulation ({max_qubits})."
+            ));
+        }
+
+        // e^{i * global_phase}
+        let mut phase: Complex64 = if let Param::Float(p) = circuit.global_phase() {
+            Complex64::new(0., *p).exp()
+        } else {
+            return Err("Cannot simulate circuit involving non-float global phase.".to_string());
+        };
+
+        let mut gates: Vec<FusedGate> = Vec::new();
+        // The index in `gates` of the last gate acting on each qubit.
+        let mut last_gate: Vec<Option<usize>> = vec![None; num_qubits];
+
+        for inst in circuit.data() {
+            if !circuit.get_cargs(inst.clbits).is_empty() {
+                return Err(
+                    "Cannot simulate circuit with instructions involving classical bits"
+                        .to_string(),
+                );
+            }
+
+            // Ignore barriers
+            if let OperationRef::StandardInstruction(StandardInstruction::Barrier(_)) =
+                inst.op.view()
+            {
+                continue;
+            }
+
+            let qubits = circuit
+                .get_qargs(inst.qubits)
+                .iter()
+                .map(|q| q.index())
+                .collect::<SmallVec<[usize; 2]>>();
+
+            let mat = inst.try_matrix().ok_or_else(|| {
+                format!("Cannot extract matrix for operation {:?}.", inst.op.name())
+            })?;
+
+            if qubits.is_empty() {
+                phase *= mat[[0, 0]];
+                continue;
+            }
+
+            // Every gate after the last one on any of these qubits acts on other qubits, so
+            // commutes with this one, which can be fused into it if possible.
+            let previous = qubits.iter().filter_map(|q| last_gate[*q]).max();
+            let fused =
+                previous.and_then(|index| fuse(&gates[index], &mat, &qubits).map(|g| (index, g)));
+            let index = match fused {
+                Some((index, gate)) => {
+                    gates[index] = gate;
+                    index
+                }
+                None => {
+                    gates.push(FusedGate {
+                        matrix: mat,
+                        qubits: qubits.clone(),
+                    });
+                    gates.len() - 1
+                }
+            };
+            for q in gates[index].qubits.iter() {
+                last_gate[*q] = Some(index);
+            }
+        }
+        Ok(Self {
+            num_qubits,
+            phase,
+            kernels: gates.into_iter().map(Kernel::from).collect(),
+        })
+    }
+
+    /// The number of qubits of the circuit.
+    pub fn num_qubits(&self) -> usize {
+        self.num_qubits
+    }
+
+    /// The global phase of the circuit, as a unit complex number.
+    pub fn phase(&self) -> Complex64 {
+        self.phase
+    }
+
+    /// The circuit whose unitary is the transpose of this one's: the transposed gates in reverse
+    /// order.
+    pub(crate) fn transpose(&self) -> Self {
+        Self {
+            num_qubits: self.num_qubits,
+            phase: self.phase,
+            kernels: self.kernels.iter().rev().map(Kernel::transpose).collect(),
+        }
+    }
+
+    /// Apply the gates of the circuit, but not its global phase, to `state` on the current
+    /// thread.
+    pub(crate) fn apply_gates(&self, state: &mut [Complex64], scratch: &mut Vec<Complex64>) {
+        for kernel in self.kernels.iter() {
+            kernel.apply(state, scratch);
+        }
+    }
+
+    /// Apply the circuit, including its global phase, to `state` in place.
+    ///
+    /// The gates are applied with multiple threads for large enough circuits.
+    pub fn evolve(&self, state: &mut [Complex64]) {
+        assert_eq!(state.len(), 1 << self.num_qubits);
+        if use_multiple_threads(self.num_qubits) {
+            for kernel in self.kernels.iter() {
+                kernel.apply_parallel(state);
+            }
+            if self.phase != Complex64::ONE {
+                state
+                    .par_iter_mut()
+                    .with_min_len(PARALLEL_CHUNK)
+                    .for_each(|a| *a *= self.phase);
+            }
+        } else {
+            self.apply_gates(state, &mut Vec::new());
+            if self.phase != Complex64::ONE {
+                state.iter_mut().for_each(|a| *a *= self.phase);
+            }
+        }
+    }
+}
+
+/// Whether to work on a statevector of `num_qubits` qubits with multiple threads.
+fn use_multiple_threads(num_qubits: usize) -> bool {
+    num_qubits >= PARALLEL_THRESHOLD && getenv_use_multiple_threads()
+}
+
+/// The minimum length of the parallel iterators over a statevector of `num_qubits` qubits.  This
+/// is so large for small statevectors that Rayon runs the whole iteration on the current thread.
+fn min_parallel_len(num_qubits: usize) -> usize {
+    if use_multiple_threads(num_qubits) {
+        PARALLEL_CHUNK
+    } else {
+        usize::MAX
+    }
+}
+
+/// Simulate the statevector produced by a unitary circuit from the all-zeros state.
+///
+/// The amplitude of each basis state is at the index whose bit `k` is the state of qubit `k`.
+pub fn simulate_statevector(circuit: &CircuitData) -> Result<Vec<Complex64>, String> {
+    let compiled = CompiledCircuit::new(circuit, MAX_STATEVECTOR_QUBITS)?;
+    let mut state = vec![Complex64::ZERO; 1 << compiled.num_qubits()];
+    state[0] = Complex64::ONE;
+    compiled.evolve(&mut state);
+    Ok(state)
+}
+
+/// Sample `num_shots` measurements of every qubit of a statevector, which need not be normalized.
+///
+/// Returns the measured basis state of each shot, in the same bit order as the statevector.
+pub fn sample_statevector(state: &[Complex64], num_shots: usize, seed: Option<u64>) -> Vec<u64> {
+    let mut rng = match seed {
+        Some(seed) => Pcg64Mcg::seed_from_u64(seed),
+        None => Pcg64Mcg::try_from_rng(&mut SysRng).unwrap(),
+    };
+    let num_qubits = state.len().trailing_zeros() as usize;
+    let total: f64 = state
+        .par_iter()
+        .with_min_len(min_parallel_len(num_qubits))
+        .map(|a| a.norm_sqr())
+        .sum();
+    // Rounding could otherwise push a draw near the total past the last possible outcome.
+    let Some(last) = state.iter().rposition(|a| a.norm_sqr() > 0.0) else {
+        return vec![0; num_shots];
+    };
+
+    // Sorting the draws lets a single cumulative pass over the probabilities find every outcome,
+    // and keeping the shot index of each draw leaves the shots in random order.
+    let mut draws = (0..num_shots)
+        .map(|shot| (rng.random::<f64>() * total, shot))
+        .collect::<Vec<_>>();
+    draws.sort_unstable_by(|a, b| a.0.total_cmp(&b.0));
+    let mut out = vec![0; num_shots];
+    let mut index = 0;
+    let mut cumulative = 0.0;
+    for (draw, shot) in draws {
+        while index < last && cumulative + state[index].norm_sqr() <= draw {
+            cumulative += state[index].norm_sqr();
+            index += 1;
+        }
+        out[shot] = index as u64;
+    }
+    out
+}
+
+/// The positions of the qubits of one circuit in another that implements it on more qubits and
+/// with the qubits permuted, such as the output of the transpiler.
+///
+/// Both lists have an entry for every qubit of the larger circuit, with the qubits of the smaller
+/// circuit first and the ancillas after them.
+pub struct QubitMapping {
+    /// The qubit of the larger circuit that each qubit starts on.
+    pub initial_positions: Vec<usize>,
+    /// The qubit of the larger circuit that each qubit ends up on.
+    pub final_positions: Vec<usize>,
+}
+
+/// Gathers the bits of an index into the larger statevector that correspond to the qubits of the
+/// smaller circuit into an index into the smaller statevector, using one lookup table for the
+/// low bits of the index and another for the high bits.
+struct BitGather {
+    low: Vec<usize>,
+    high: Vec<usize>,
+    ancilla_mask: usize,
+}
+
+impl BitGather {
+    const LOW_BITS: usize = 15;
+
+    fn new(positions: &[usize], num_input_qubits: usize) -> Self {
+        let num_bits = positions.len();
+        let mut source = vec![None; num_bits];
+        for (qubit, position) in positions.iter().enumerate().take(num_input_qubits) {
+            source[*position] = Some(qubit);
+        }
+        let table = |first: usize, count: usize| {
+            (0..1usize << count)
+                .map(|j| {
+                    (0..count)
+                        .filter(|bit| (j >> bit) & 1 == 1)
+                        .filter_map(|bit| source[first + bit])
+                        .map(|qubit| 1usize << qubit)
+                        .sum::<usize>()
+                })
+                .collect::<Vec<_>>()
+        };
+        let num_low = num_bits.min(Self::LOW_BITS);
+        Self {
+            low: table(0, num_low),
+            high: table(num_low, num_bits - num_low),
+            ancilla_mask: positions[num_input_qubits..]
+                .iter()
+                .map(|position| 1usize << position)
+                .sum(),
+        }
+    }
+
+    /// The index into the smaller statevector, or `None` if any ancilla is set.
+    #[inline]
+    fn gather(&self, index: usize) -> Option<usize> {
+        (index & self.ancilla_mask == 0).then(|| {
+            self.low[index & ((1 << Self::LOW_BITS) - 1)] | self.high[index >> Self::LOW_BITS]
+        })
+    }
+}
+
+/// Check whether the circuit `b` implements the same unitary as `a` up to a global phase, by
+/// comparing their outputs on `num_trials` random product states.
+///
+/// If `mapping` is given, `b` may have more qubits than `a`, which start on `b`'s qubits at
+/// `initial_positions`, and must end on its qubits at `final_positions`, with its ancillas
+/// returned to the all-zeros state.  If not, both circuits must have the same qubits.
+///
+/// The product states span the whole space of inputs, so the check can only wrongly succeed if
+/// the random states happen to be eigenstates of the difference of the circuits, which does not
+/// happen in practice.
+pub fn check_equivalence(
+    a: &CircuitData,
+    b: &CircuitData,
+    mapping: Option<&QubitMapping>,
+    num_trials: usize,
+    seed: Option<u64>,
+) -> Result<bool, String> {
+    let a = CompiledCircuit::new(a, MAX_STATEVECTOR_QUBITS)?;
+    let b = CompiledCircuit::new(b, MAX_STATEVECTOR_QUBITS)?;
+    let (num_a, num_b) = (a.num_qubits(), b.num_qubits());
+    let (initial_gather, final_gather) = match mapping {
+        Some(mapping) => {
+            let is_permutation = |positions: &[usize]| {
+                let mut seen = vec![false; num_b];
+                positions.len() == num_b
+                    && positions
+                        .iter()
+                        .all(|p| *p < num_b && !std::mem::replace(&mut seen[*p], true))
+            };
+            if num_a > num_b
+                || !is_permutation(&mapping.initial_positions)
+                || !is_permutation(&mapping.final_positions)
+            {
+                return Err(format!(
+                    "The qubit mapping is not a valid layout of {num_a} qubits on {num_b} qubits."
+                ));
+            }
+            (
+                BitGather::new(&mapping.initial_positions, num_a),
+                BitGather::new(&mapping.final_positions, num_a),
+            )
+        }
+        None => {
+            if num_a != num_b {
+                return Err(format!(
+                    "Circuits with different numbers of qubits ({num_a} and {num_b}) need a qubit mapping to be compared."
+                ));
+            }
+            let trivial = (0..num_a).collect::<Vec<_>>();
+            (
+                BitGather::new(&trivial, num_a),
+                BitGather::new(&trivial, num_a),
+            )
+        }
+    };
+
+    let mut rng = match seed {
+        Some(seed) => Pcg64Mcg::seed_from_u64(seed),
+        None => Pcg64Mcg::try_from_rng(&mut SysRng).unwrap(),
+    };
+    let min_len = min_parallel_len(num_b);
+    // The global phase between the circuits, which is fixed by the first trial.
+    let mut relative_phase: Option<Complex64> = None;
+    for _ in 0..num_trials {
+        // Build a random product state one qubit at a time, doubling the filled part each time.
+        let mut state_a = vec![Complex64::ZERO; 1 << num_a];
+        state_a[0] = Complex64::ONE;
+        for qubit in 0..num_a {
+            let mut random =
+                || Complex64::new(rng.sample(StandardNormal), rng.sample(StandardNormal));
+            let (zero, one) = (random(), random());
+            let norm = (zero.norm_sqr() + one.norm_sqr()).sqrt();
+            let (zero, one) = (zero / norm, one / norm);
+            let (lo, hi) = state_a.split_at_mut(1 << qubit);
+            for (x, y) in lo.iter_mut().zip(hi.iter_mut()) {
+                *y = *x * one;
+                *x *= zero;
+            }
+        }
+        let mut state_b = vec![Complex64::ZERO; 1 << num_b];
+        state_b
+            .par_iter_mut()
+            .with_min_len(min_len)
+            .enumerate()
+            .for_each(|(y, amp)| {
+                if let Some(x) = initial_gather.gather(y) {
+                    *amp = state_a[x];
+                }
+            });
+        a.evolve(&mut state_a);
+        b.evolve(&mut state_b);
+
+        let phase = match relative_phase {
+            Some(phase) => phase,
+            None => {
+                let overlap: Complex64 = state_b
+                    .par_iter()
+                    .with_min_len(min_len)
+                    .enumerate()
+                    .filter_map(|(y, amp)| final_gather.gather(y).map(|x| state_a[x].conj() * amp))
+                    .sum();
+                if overlap.norm() < 0.5 {
+                    return Ok(false);
+                }
+                *relative_phase.insert(overlap / overlap.norm())
+            }
+        };
+        // The squared distance between the output of `b` and that of `a` in its final position,
+        // which includes any amplitude left on the ancillas.
+        let distance_sq: f64 = state_b
+            .par_iter()
+            .with_min_len(min_len)
+            .enumerate()
+            .map(|(y, amp)| match final_gather.gather(y) {
+                Some(x) => (amp - phase * state_a[x]).norm_sqr(),
+                None => amp.norm_sqr(),
+            })
+            .sum();
+        if distance_sq.sqrt() > EQUIVALENCE_TOLERANCE {
+            return Ok(false);
+        }
+    }
+    Ok(true)
+}
+
+#[cfg(all(test, not(miri)))]
+mod test {
+    use super::{QubitMapping, check_equivalence, sample_statevector, simulate_statevector};
+    use approx::abs_diff_eq;
+    use num_complex::Complex64;
+    use qiskit_circuit::Qubit;
+    use qiskit_circuit::circuit_data::CircuitData;
+    use qiskit_circuit::operations::{Param, StandardGate};
+    use smallvec::{SmallVec, smallvec};
+
+    fn circuit(num_qubits: u32, gates: &[(StandardGate, &[u32])]) -> CircuitData {
+        CircuitData::from_standard_gates(
+            num_qubits,
+            gates.iter().map(|(gate, qubits)| {
+                (
+                    *gate,
+                    smallvec![],
+                    qubits.iter().map(|q| Qubit(*q)).collect::<SmallVec<_>>(),
+                )
+            }),
+            Param::Float(0.0),
+        )
+        .unwrap()
+    }
+
+    fn ghz(num_qubits: u32) -> CircuitData {
+        let mut gates: Vec<(StandardGate, &[u32])> = vec![(StandardGate::H, &[0])];
+        let pairs = (1..num_qubits).map(|q| [q - 1, q]).collect::<Vec<_>>();
+        gates.extend(pairs.iter().map(|pair| (StandardGate::CX, pair.as_slice())));
+        circuit(num_qubits, &gates)
+    }
+
+    #[test]
+    fn test_statevector_ghz() {
+        // Large enough to apply the gates with multiple threads, including to the high qubits.
+        for num_qubits in [3, 16] {
+            let state = simulate_statevector(&ghz(num_qubits)).unwrap();
+            let amp = Complex64::new(std::f64::consts::FRAC_1_SQRT_2, 0.0);
+            let mut expected = vec![Complex64::ZERO; 1 << num_qubits];
+            expected[0] = amp;
+            expected[(1 << num_qubits) - 1] = amp;
+            assert!(abs_diff_eq!(
+                state.as_slice(),
+                expected.as_slice(),
+                epsilon = 1e-12
+            ));
+        }
+    }
+
+    #[test]
+    fn test_sample_ghz() {
+        let state = simulate_statevector(&ghz(4)).unwrap();
+        let shots = sample_statevector(&state, 1000, Some(2026));
+        assert!(shots.iter().all(|x| *x == 0 || *x == 15));
+        let ones = shots.iter().filter(|x| **x == 15).count();
+        assert!((400..600).contains(&ones));
+        assert_eq!(shots, sample_statevector(&state, 1000, Some(2026)));
+    }
+
+    #[test]
+    fn test_equivalence_up_to_phase() {
+        let a = circuit(2, &[(StandardGate::CZ, &[0, 1])]);
+        let b = circuit(
+            2,
+            &[
+                (StandardGate::H, &[1]),
+                (StandardGate::CX, &[0, 1]),
+                (StandardGate::H, &[1]),
+            ],
+        );
+        let c = circuit(2, &[(StandardGate::CX, &[0, 1])]);
+        assert!(check_equivalence(&a, &b, None, 2, Some(1)).unwrap());
+        assert!(!check_equivalence(&a, &c, None, 2, Some(1)).unwrap());
+    }
+
+    #[test]
+    fn test_equivalence_with_mapping() {
+        // `b` runs `a` on qubits 2 and 0 of three, and swaps them back to 0 and 2 at the end.
+        let a = circuit(2, &[(StandardGate::H, &[0]), (StandardGate::CX, &[0, 1])]);
+        let b = circuit(
+            3,
+            &[
+                (StandardGate::H, &[2]),
+                (StandardGate::CX, &[2, 0]),
+                (StandardGate::Swap, &[0, 2]),
+            ],
+        );
+        let mapping = QubitMapping {
+            initial_positions: vec![2, 0, 1],
+            final_positions: vec![0, 2, 1],
+        };
+        assert!(check_equivalence(&a, &b, Some(&mapping), 2, Some(3)).unwrap());
+        // Without the final swap, the qubits end in the wrong place.
+        let wrong = QubitMapping {
+            initial_positions: vec![2, 0, 1],
+            final_positions: vec![2, 0, 1],
+        };
+        assert!(!check_equivalence(&a, &b, Some(&wrong), 2, Some(3)).unwrap());
+        // An ancilla that is left excited breaks the equivalence.
+        let excited = circuit(
+            3,
+            &[
+                (StandardGate::H, &[2]),
+                (StandardGate::CX, &[2, 0]),
+                (StandardGate::Swap, &[0, 2]),
+                (StandardGate::X, &[1]),
+            ],
+        );
+        assert!(!check_equivalence(&a, &excited, Some(&mapping), 2, Some(3)).unwrap());
+        assert!(check_equivalence(&a, &b, None, 2, Some(3)).is_err());
+    }
+}
@@ -57,7 +57,7 @@ fn c3sx() -> CircuitData {
 ///
 /// This trait is **not** intended to be user-facing. It defines utility functions
 /// that make the code easier to read and that are used only for synthesis.
-trait CircuitDataForSynthesis {
+pub(super) trait CircuitDataForSynthesis {
     /// Appends H to the circuit.
     fn h(&mut self, q: u32) -> Result<(), CircuitDataError>;
 
@@ -16,6 +16,7 @@ use qiskit_circuit::circuit_data::PyCircuitData;
 
 mod mcmt;
 mod mcx;
+pub mod sparse_state;
 
 #[pyfunction]
 #[pyo3(name="synth_mcx_n_dirty_i15", signature = (num_controls, relative_phase=false, action_only=false))]
@@ -46,5 +47,6 @@ pub fn multi_controlled(m: &Bound<PyModule>) -> PyResult<()> {
     m.add_function(wrap_pyfunction!(py_synth_mcx_noaux_v24, m)?)?;
     m.add_function(wrap_pyfunction!(py_synth_mcx_noaux_hp24, m)?)?;
     m.add_function(wrap_pyfunction!(mcmt::mcmt_v_chain, m)?)?;
+    m.add_function(wrap_pyfunction!(sparse_state::py_synth_sparse_state, m)?)?;
     Ok(())
 }
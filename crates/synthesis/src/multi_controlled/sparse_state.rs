@@ -0,0 +1,390 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+use hashbrown::{HashMap, HashSet};
+use num_complex::Complex64;
+use pyo3::exceptions::PyValueError;
+use pyo3::prelude::*;
+use thiserror::Error;
+
+use qiskit_circuit::Qubit;
+use qiskit_circuit::circuit_data::{CircuitData, CircuitDataError, PyCircuitData};
+use qiskit_circuit::operations::{Param, StandardGate};
+
+use super::mcx::{CircuitDataForSynthesis, synth_mcx_noaux_hp24};
+
+/// Amplitudes with a smaller absolute value are treated as zero.
+const ZERO_TOL: f64 = 1e-14;
+/// The allowed deviation of the norm of the state from 1.
+const NORM_TOL: f64 = 1e-8;
+/// Rotations with a smaller angle are not added to the circuit.
+const ANGLE_TOL: f64 = 1e-12;
+
+/// Errors that might occur when preparing a sparse state.
+#[derive(Error, Debug)]
+pub enum SparseStateError {
+    #[error("the number of qubits must be between 1 and 64, but is {0}")]
+    InvalidNumQubits(u32),
+
+    #[error("got {0} basis states but {1} amplitudes")]
+    LengthMismatch(usize, usize),
+
+    #[error("the basis state {0} is out of range for {1} qubits")]
+    IndexOutOfRange(u64, u32),
+
+    #[error("the basis state {0} appears more than once")]
+    DuplicateIndex(u64),
+
+    #[error("the state must have norm 1, but has norm {0}")]
+    NotNormalized(f64),
+
+    // wraps CircuitDataError, produced when building the circuit
+    #[error(transparent)]
+    ErrorFromCircuitData(#[from] CircuitDataError),
+
+    // wraps PyErr, produced by the multi-controlled X synthesis
+    #[error(transparent)]
+    ErrorFromPython(#[from] PyErr),
+}
+
+impl From<SparseStateError> for PyErr {
+    fn from(error: SparseStateError) -> Self {
+        match error {
+            SparseStateError::ErrorFromCircuitData(err) => err.into(),
+            SparseStateError::ErrorFromPython(err) => err,
+            err => PyValueError::new_err(err.to_string()),
+        }
+    }
+}
+
+/// Appends multi-controlled single-qubit gates, caching the MCX circuits they are built from.
+struct McGateBuilder {
+    circuit: CircuitData,
+    mcx_cache: HashMap<usize, CircuitData>,
+}
+
+impl McGateBuilder {
+    fn rz(&mut self, theta: f64, q: u32) -> Result<(), CircuitDataError> {
+        if theta.abs() < ANGLE_TOL {
+            return Ok(());
+        }
+        self.circuit
+            .push_standard_gate(StandardGate::RZ, &[Param::Float(theta)], &[Qubit(q)])
+    }
+
+    fn ry(&mut self, theta: f64, q: u32) -> Result<(), CircuitDataError> {
+        if theta.abs() < ANGLE_TOL {
+            return Ok(());
+        }
+        self.circuit
+            .push_standard_gate(StandardGate::RY, &[Param::Float(theta)], &[Qubit(q)])
+    }
+
+    fn mcx(&mut self, controls: &[u32], target: u32) -> Result<(), SparseStateError> {
+        let mcx = match self.mcx_cache.entry(controls.len()) {
+            hashbrown::hash_map::Entry::Occupied(entry) => entry.into_mut(),
+            hashbrown::hash_map::Entry::Vacant(entry) => {
+                entry.insert(synth_mcx_noaux_hp24(controls.len())?)
+            }
+        };
+        let qargs: Vec<Qubit> = controls
+            .iter()
+            .chain(std::iter::once(&target))
+            .map(|q| Qubit(*q))
+            .collect();
+        self.circuit.compose(mcx, &qargs, &[])?;
+        Ok(())
+    }
+
+    /// Appends the special unitary ``Rz(phi) Ry(theta) Rz(lam)`` on ``target``, controlled on
+    /// ``controls`` being in the state ``|1...1>``.
+    ///
+    /// With controls, this uses the decomposition ``A X B X C`` with ``ABC = I`` from Lemma 4.3
+    /// of [1], so that the gate costs two multi-controlled X gates.
+    ///
+    /// [1]: A. Barenco et al., "Elementary gates for quantum computation" (1995).
+    fn mc_su2(
+        &mut self,
+        phi: f64,
+        theta: f64,
+        lam: f64,
+        controls: &[u32],
+        target: u32,
+    ) -> Result<(), SparseStateError> {
+        if controls.is_empty() {
+            self.rz(lam, target)?;
+            self.ry(theta, target)?;
+            self.rz(phi, target)?;
+            return Ok(());
+        }
+        self.rz(0.5 * (lam - phi), target)?;
+        self.mcx(controls, target)?;
+        self.rz(-0.5 * (phi + lam), target)?;
+        self.ry(-0.5 * theta, target)?;
+        self.mcx(controls, target)?;
+        self.ry(0.5 * theta, target)?;
+        self.rz(phi, target)?;
+        Ok(())
+    }
+}
+
+/// Validates the input and returns the nonzero terms of the state.
+fn nonzero_terms(
+    num_qubits: u32,
+    indices: &[u64],
+    amplitudes: &[Complex64],
+) -> Result<Vec<(u64, Complex64)>, SparseStateError> {
+    if num_qubits == 0 || num_qubits > 64 {
+        return Err(SparseStateError::InvalidNumQubits(num_qubits));
+    }
+    if indices.len() != amplitudes.len() {
+        return Err(SparseStateError::LengthMismatch(
+            indices.len(),
+            amplitudes.len(),
+        ));
+    }
+    let mut seen = HashSet::with_capacity(indices.len());
+    let mut norm_sqr = 0.0;
+    let mut terms = Vec::with_capacity(indices.len());
+    for (index, amplitude) in indices.iter().zip(amplitudes) {
+        if num_qubits < 64 && *index >> num_qubits != 0 {
+            return Err(SparseStateError::IndexOutOfRange(*index, num_qubits));
+        }
+        if !seen.insert(*index) {
+            return Err(SparseStateError::DuplicateIndex(*index));
+        }
+        norm_sqr += amplitude.norm_sqr();
+        if amplitude.norm() > ZERO_TOL {
+            terms.push((*index, *amplitude));
+        }
+    }
+    let norm = norm_sqr.sqrt();
+    if (norm - 1.0).abs() > NORM_TOL {
+        return Err(SparseStateError::NotNormalized(norm));
+    }
+    Ok(terms)
+}
+
+/// Synthesize a circuit preparing a state with few nonzero amplitudes.
+///
+/// The state is given by the basis states ``indices``, as bitstrings with qubit 0 as the least
+/// significant bit, and their ``amplitudes``. Basis states not listed have amplitude 0.
+///
+/// The circuit is built by disentangling the state, following the approach of Gleinig and
+/// Hoefler [1]: the two basis states closest in Hamming distance are repeatedly made to differ
+/// in a single qubit using CX gates, and then merged by a single-qubit rotation on that qubit,
+/// controlled on a set of qubits that distinguish the pair from all other basis states. Each
+/// merge removes a basis state, so the circuit contains ``m - 1`` multi-controlled rotations
+/// for a state with ``m`` nonzero amplitudes. The multi-controlled rotations are built from two
+/// multi-controlled X gates using no ancillas (see :func:`synth_mcx_noaux_hp24`), so the number
+/// of gates is ``O(m n)`` on ``n`` qubits, independently of ``2^n``.
+///
+/// # References
+///
+/// 1. N. Gleinig and T. Hoefler, *An Efficient Algorithm for Sparse Quantum State Preparation*,
+///    DAC (2021), https://ieeexplore.ieee.org/document/9586240.
+pub fn synth_sparse_state(
+    num_qubits: u32,
+    indices: &[u64],
+    amplitudes: &[Complex64],
+) -> Result<CircuitData, SparseStateError> {
+    let mut terms = nonzero_terms(num_qubits, indices, amplitudes)?;
+    if terms.is_empty() {
+        return Err(SparseStateError::NotNormalized(0.0));
+    }
+    let mut builder = McGateBuilder {
+        circuit: CircuitData::with_capacity(num_qubits, 0, 0, Param::Float(0.0))?,
+        mcx_cache: HashMap::new(),
+    };
+    // Indexed by qubit, the number of the remaining basis states that a control on that qubit
+    // distinguishes from the merged pair.
+    let mut counts = vec![0usize; num_qubits as usize];
+    let mut controls: Vec<u32> = Vec::with_capacity(num_qubits as usize);
+    let mut undistinguished: Vec<u64> = Vec::with_capacity(terms.len());
+
+    // The gates built here map the state to a basis state, so the circuit is inverted at the end.
+    while terms.len() > 1 {
+        let last = terms.len() - 1;
+        let x2 = terms[last].0;
+        let closest = (0..last)
+            .min_by_key(|i| (terms[*i].0 ^ x2).count_ones())
+            .unwrap();
+        let diff = terms[closest].0 ^ x2;
+        let pivot = diff.trailing_zeros();
+        let pivot_mask = 1u64 << pivot;
+
+        // Make the pair differ only on the pivot qubit.
+        let others = diff & !pivot_mask;
+        if others != 0 {
+            let mut bits = others;
+            while bits != 0 {
+                builder.circuit.cx(pivot, bits.trailing_zeros())?;
+                bits &= bits - 1;
+            }
+            for (state, _) in terms.iter_mut() {
+                if *state & pivot_mask != 0 {
+                    *state ^= others;
+                }
+            }
+        }
+        let (zero, one) = if terms[closest].0 & pivot_mask == 0 {
+            (closest, last)
+        } else {
+            (last, closest)
+        };
+        let target = terms[zero].0;
+
+        // Greedily pick controls until no other basis state agrees with the pair on all of them.
+        undistinguished.clear();
+        undistinguished.extend(
+            terms
+                .iter()
+                .enumerate()
+                .filter(|(i, _)| *i != closest && *i != last)
+                .map(|(_, (state, _))| *state),
+        );
+        controls.clear();
+        while !undistinguished.is_empty() {
+            counts.fill(0);
+            for state in undistinguished.iter() {
+                let mut bits = (state ^ target) & !pivot_mask;
+                while bits != 0 {
+                    counts[bits.trailing_zeros() as usize] += 1;
+                    bits &= bits - 1;
+                }
+            }
+            let qubit = (0..num_qubits).max_by_key(|q| counts[*q as usize]).unwrap();
+            controls.push(qubit);
+            undistinguished.retain(|state| (state ^ target) & (1u64 << qubit) == 0);
+        }
+
+        // Rotate ``alpha |0> + beta |1>`` on the pivot qubit to ``r |0>`` with the special
+        // unitary ``[[a*, b*], [-b, a]]`` = ``Rz(phi) Ry(theta) Rz(lam)``.
+        let alpha = terms[zero].1;
+        let beta = terms[one].1;
+        let r = (alpha.norm_sqr() + beta.norm_sqr()).sqrt();
+        let theta = 2.0 * beta.norm().atan2(alpha.norm());
+        let arg_a = alpha.arg();
+        let arg_minus_b = (-beta).arg();
+        let negated: Vec<u32> = controls
+            .iter()
+            .copied()
+            .filter(|q| target & (1u64 << q) == 0)
+            .collect();
+        for q in negated.iter() {
+            builder.circuit.x(*q)?;
+        }
+        builder.mc_su2(
+            arg_a + arg_minus_b,
+            theta,
+            arg_a - arg_minus_b,
+            &controls,
+            pivot,
+        )?;
+        for q in negated.iter() {
+            builder.circuit.x(*q)?;
+        }
+
+        terms[zero].1 = Complex64::new(r, 0.0);
+        terms.swap_remove(one);
+    }
+
+    let (state, amplitude) = terms[0];
+    let mut bits = state;
+    while bits != 0 {
+        builder.circuit.x(bits.trailing_zeros())?;
+        bits &= bits - 1;
+    }
+    let mut circuit = builder.circuit.inverse()?;
+    circuit.add_global_phase(&Param::Float(amplitude.arg()))?;
+    Ok(circuit)
+}
+
+/// Synthesize a circuit preparing a sparse state, given by its nonzero amplitudes.
+#[pyfunction]
+#[pyo3(name = "synth_sparse_state", signature = (num_qubits, indices, amplitudes))]
+pub fn py_synth_sparse_state(
+    num_qubits: u32,
+    indices: Vec<u64>,
+    amplitudes: Vec<Complex64>,
+) -> PyResult<PyCircuitData> {
+    Ok(synth_sparse_state(num_qubits, &indices, &amplitudes)?.into())
+}
+
+#[cfg(all(test, not(miri)))]
+mod test {
+    use super::*;
+    use crate::matrix::statevector::simulate_statevector;
+
+    fn check_state(num_qubits: u32, indices: &[u64], amplitudes: &[Complex64]) {
+        let circuit = synth_sparse_state(num_qubits, indices, amplitudes).unwrap();
+        let state = simulate_statevector(&circuit).unwrap();
+        let mut expected = vec![Complex64::new(0.0, 0.0); 1 << num_qubits];
+        for (index, amplitude) in indices.iter().zip(amplitudes) {
+            expected[*index as usize] = *amplitude;
+        }
+        for (actual, expected) in state.iter().zip(expected) {
+            assert!((actual - expected).norm() < 1e-10);
+        }
+    }
+
+    #[test]
+    fn test_basis_state() {
+        check_state(4, &[0b1011], &[Complex64::new(0.0, 1.0)]);
+    }
+
+    #[test]
+    fn test_ghz_state() {
+        let amplitude = Complex64::new(std::f64::consts::FRAC_1_SQRT_2, 0.0);
+        check_state(5, &[0, 0b11111], &[amplitude, amplitude]);
+    }
+
+    #[test]
+    fn test_complex_amplitudes() {
+        let indices = [0b000101, 0b110000, 0b011011, 0b100110, 0b111111, 0b000010];
+        let raw: Vec<Complex64> = (0..indices.len())
+            .map(|i| Complex64::from_polar(1.0 + i as f64, 0.7 * i as f64 - 1.3))
+            .collect();
+        let norm = raw.iter().map(|a| a.norm_sqr()).sum::<f64>().sqrt();
+        let amplitudes: Vec<Complex64> = raw.iter().map(|a| a / norm).collect();
+        check_state(6, &indices, &amplitudes);
+    }
+
+    #[test]
+    fn test_gate_count_scales_with_nonzeros() {
+        let num_qubits = 40;
+        let indices: Vec<u64> = (0..16u64)
+            .map(|i| i.wrapping_mul(0x9e37_79b9_7f4a_7c15) >> 24)
+            .collect();
+        let amplitudes = vec![Complex64::new(0.25, 0.0); indices.len()];
+        let circuit = synth_sparse_state(num_qubits, &indices, &amplitudes).unwrap();
+        assert_eq!(circuit.num_qubits(), num_qubits as usize);
+        assert!(circuit.len() < 16 * 60 * num_qubits as usize);
+    }
+
+    #[test]
+    fn test_invalid_input() {
+        let one = Complex64::new(1.0, 0.0);
+        assert!(matches!(
+            synth_sparse_state(2, &[4], &[one]),
+            Err(SparseStateError::IndexOutOfRange(4, 2))
+        ));
+        assert!(matches!(
+            synth_sparse_state(2, &[1, 1], &[one, one]),
+            Err(SparseStateError::DuplicateIndex(1))
+        ));
+        assert!(matches!(
+            synth_sparse_state(2, &[1, 2], &[one, one]),
+            Err(SparseStateError::NotNormalized(_))
+        ));
+    }
+}
@@ -10,12 +10,159 @@
 // copyright notice, and modified files need to carry a notice indicating
 // that they have been altered from the originals.
 
+mod qft_decompose_full;
 mod qft_decompose_lnn;
 
+use std::sync::{Arc, LazyLock, Mutex};
+
+use hashbrown::HashMap;
 use pyo3::prelude::*;
-use qft_decompose_lnn::synth_qft_line;
+use qiskit_circuit::Qubit;
+use qiskit_circuit::circuit_data::{CircuitData, CircuitDataError};
+use qiskit_circuit::operations::{Param, StandardGate, StandardInstruction, multiply_param};
+use qiskit_circuit::packed_instruction::PackedOperation;
+use smallvec::SmallVec;
+
+use qft_decompose_full::{qft_full_gates, synth_qft_full};
+use qft_decompose_lnn::{qft_line_gates, synth_qft_line};
+
+/// The connectivity of the qubits a QFT circuit is synthesized for.
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash)]
+pub enum QftConnectivity {
+    /// All-to-all connectivity, using controlled-phase gates between all pairs of qubits.
+    Full,
+    /// Linear nearest-neighbor connectivity.
+    Line,
+}
+
+/// A QFT gate sequence, where `None` stands for a barrier on all qubits.
+type QftGates = Vec<Option<(StandardGate, SmallVec<[Param; 3]>, SmallVec<[Qubit; 2]>)>>;
+
+#[derive(Clone, Copy, PartialEq, Eq, Hash)]
+struct QftKey {
+    num_qubits: usize,
+    approximation_degree: usize,
+    connectivity: QftConnectivity,
+    do_swaps: bool,
+    inverse: bool,
+    insert_barriers: bool,
+}
+
+/// The maximum number of circuits kept in the QFT cache before it is emptied.
+const QFT_CACHE_CAPACITY: usize = 64;
+/// The maximum width of the cached QFT circuits, which have a quadratic number of gates.
+const QFT_CACHE_MAX_QUBITS: usize = 256;
+
+static QFT_CACHE: LazyLock<Mutex<HashMap<QftKey, Arc<CircuitData>>>> =
+    LazyLock::new(|| Mutex::new(HashMap::new()));
+
+/// Synthesize a circuit for the Quantum Fourier Transform, or return the circuit synthesized by
+/// an earlier call with the same arguments.
+///
+/// Algorithms such as phase estimation and QFT-based arithmetic apply QFTs of the same width
+/// many times, and synthesizing each of them is quadratic in the width. The circuits are instead
+/// shared through a process-wide cache, and callers needing to modify a circuit clone it. QFTs
+/// on more than 256 qubits are not cached.
+///
+/// Args:
+///     num_qubits: The number of qubits on which the QFT acts.
+///     approximation_degree: The degree of approximation (0 for no approximation). The
+///         controlled-phase rotations with the smallest angles are dropped, as described in
+///         https://arxiv.org/abs/quant-ph/9601018. A degree of `num_qubits` or more drops all
+///         the rotations.
+///     connectivity: The connectivity of the qubits to synthesize for.
+///     do_swaps: Whether to synthesize the "QFT" or the "QFT-with-reversal" operation.
+///     inverse: Whether to synthesize the inverse QFT.
+///     insert_barriers: Whether to insert a barrier after each qubit is processed. This is only
+///         supported with all-to-all connectivity, and ignored otherwise.
+pub fn qft_circuit(
+    num_qubits: usize,
+    approximation_degree: usize,
+    connectivity: QftConnectivity,
+    do_swaps: bool,
+    inverse: bool,
+    insert_barriers: bool,
+) -> Result<Arc<CircuitData>, CircuitDataError> {
+    let key = QftKey {
+        num_qubits,
+        approximation_degree: approximation_degree.min(num_qubits),
+        connectivity,
+        do_swaps,
+        inverse,
+        insert_barriers: insert_barriers && connectivity == QftConnectivity::Full,
+    };
+    if num_qubits > QFT_CACHE_MAX_QUBITS {
+        return build_qft(&key).map(Arc::new);
+    }
+    if let Some(circuit) = QFT_CACHE.lock().unwrap().get(&key) {
+        return Ok(circuit.clone());
+    }
+    // The cache is not locked during the synthesis, so that QFTs of different widths can be
+    // synthesized in parallel. A circuit synthesized concurrently by two threads is the same.
+    let circuit = Arc::new(build_qft(&key)?);
+    let mut cache = QFT_CACHE.lock().unwrap();
+    if cache.len() >= QFT_CACHE_CAPACITY {
+        cache.clear();
+    }
+    cache.insert(key, circuit.clone());
+    Ok(circuit)
+}
+
+fn build_qft(key: &QftKey) -> Result<CircuitData, CircuitDataError> {
+    let gates: QftGates = match key.connectivity {
+        QftConnectivity::Full => qft_full_gates(
+            key.num_qubits,
+            key.do_swaps,
+            key.approximation_degree,
+            key.insert_barriers,
+        ),
+        QftConnectivity::Line => {
+            qft_line_gates(key.num_qubits, key.do_swaps, key.approximation_degree)
+                .into_iter()
+                .map(Some)
+                .collect()
+        }
+    };
+    let num_qubits = key.num_qubits as u32;
+    let mut circuit = CircuitData::with_capacity(num_qubits, 0, gates.len(), Param::Float(0.0))?;
+    let barrier_qubits: Vec<Qubit> = (0..num_qubits).map(Qubit).collect();
+    let mut push =
+        |gate: Option<(StandardGate, SmallVec<[Param; 3]>, SmallVec<[Qubit; 2]>)>| match gate {
+            Some((gate, params, qubits)) => circuit.push_standard_gate(gate, &params, &qubits),
+            None => circuit.push_packed_operation(
+                PackedOperation::from_standard_instruction(StandardInstruction::Barrier(
+                    num_qubits,
+                )),
+                None,
+                &barrier_qubits,
+                &[],
+            ),
+        };
+    if key.inverse {
+        // The gates are H, CX, Swap and (controlled) phase gates, which are their own inverses
+        // up to negating the phase.
+        for gate in gates.into_iter().rev() {
+            push(gate.map(|(gate, params, qubits)| {
+                let params = match gate {
+                    StandardGate::Phase | StandardGate::CPhase => params
+                        .iter()
+                        .map(|param| multiply_param(param, -1.0))
+                        .collect(),
+                    _ => params,
+                };
+                (gate, params, qubits)
+            }))?;
+        }
+    } else {
+        for gate in gates {
+            push(gate)?;
+        }
+    }
+    Ok(circuit)
+}
 
 pub fn qft(m: &Bound<PyModule>) -> PyResult<()> {
     m.add_function(wrap_pyfunction!(synth_qft_line, m)?)?;
+    m.add_function(wrap_pyfunction!(synth_qft_full, m)?)?;
     Ok(())
 }
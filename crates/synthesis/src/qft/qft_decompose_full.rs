@@ -0,0 +1,157 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+use super::{QftConnectivity, QftGates, qft_circuit};
+use pyo3::prelude::*;
+use qiskit_circuit::Qubit;
+use qiskit_circuit::circuit_data::{CircuitData, PyCircuitData};
+use qiskit_circuit::operations::{Param, StandardGate};
+use smallvec::smallvec;
+use std::f64::consts::PI;
+
+/// Construct a circuit for the Quantum Fourier Transform using all-to-all connectivity.
+///
+/// The circuits are cached, so that synthesizing a QFT of the same width again only copies
+/// the circuit.
+///
+/// Args:
+///     num_qubits: The number of qubits on which the Quantum Fourier Transform acts.
+///     do_swaps: Whether to synthesize the "QFT" or the "QFT-with-reversal" operation.
+///     approximation_degree: The degree of approximation (0 for no approximation).
+///         It is possible to implement the QFT approximately by ignoring
+///         controlled-phase rotations with the angle beneath a threshold. This is discussed
+///         in more detail in https://arxiv.org/abs/quant-ph/9601018 or
+///         https://arxiv.org/abs/quant-ph/0403071.
+///     insert_barriers: If ``True``, barriers are inserted for improved visualization.
+///     inverse: If ``True``, the inverse Quantum Fourier Transform is constructed.
+///
+/// Returns:
+///     A circuit implementing the QFT operation.
+#[pyfunction]
+#[pyo3(signature=(
+    num_qubits, do_swaps=true, approximation_degree=0, insert_barriers=false, inverse=false
+))]
+pub fn synth_qft_full(
+    num_qubits: usize,
+    do_swaps: bool,
+    approximation_degree: usize,
+    insert_barriers: bool,
+    inverse: bool,
+) -> PyResult<PyCircuitData> {
+    let circuit = qft_circuit(
+        num_qubits,
+        approximation_degree,
+        QftConnectivity::Full,
+        do_swaps,
+        inverse,
+        insert_barriers,
+    )?;
+    Ok(CircuitData::clone(&circuit).into())
+}
+
+/// The gates of the QFT circuit for all-to-all connectivity, see [synth_qft_full].
+///
+/// Rotations whose angle underflows to zero are dropped.
+pub(super) fn qft_full_gates(
+    num_qubits: usize,
+    do_swaps: bool,
+    approximation_degree: usize,
+    insert_barriers: bool,
+) -> QftGates {
+    let mut gates = QftGates::new();
+    for j in (0..num_qubits).rev() {
+        gates.push(Some((
+            StandardGate::H,
+            smallvec![],
+            smallvec![Qubit::new(j)],
+        )));
+        let num_entanglements =
+            j.saturating_sub(approximation_degree.saturating_sub(num_qubits - j - 1));
+        for k in (j - num_entanglements..j).rev() {
+            // Use negative exponents so that the angle safely underflows to zero.
+            let angle = PI * 2.0_f64.powi(k as i32 - j as i32);
+            if angle == 0.0 {
+                continue;
+            }
+            gates.push(Some((
+                StandardGate::CPhase,
+                smallvec![Param::Float(angle)],
+                smallvec![Qubit::new(j), Qubit::new(k)],
+            )));
+        }
+        if insert_barriers {
+            gates.push(None);
+        }
+    }
+    if do_swaps {
+        for i in 0..num_qubits / 2 {
+            gates.push(Some((
+                StandardGate::Swap,
+                smallvec![],
+                smallvec![Qubit::new(i), Qubit::new(num_qubits - i - 1)],
+            )));
+        }
+    }
+    gates
+}
+
+#[cfg(all(test, not(miri)))]
+mod test {
+    use super::super::{QftConnectivity, qft_circuit};
+    use qiskit_circuit::operations::{Operation, Param, StandardGate};
+    use std::sync::Arc;
+
+    #[test]
+    fn test_qft_full_gate_counts() {
+        let circuit = qft_circuit(5, 0, QftConnectivity::Full, true, false, false).unwrap();
+        let counts = circuit.count_ops();
+        assert_eq!(counts.get("h"), Some(&5));
+        assert_eq!(counts.get("cp"), Some(&10));
+        assert_eq!(counts.get("swap"), Some(&2));
+    }
+
+    #[test]
+    fn test_qft_full_approximation_drops_rotations() {
+        // An approximation degree of 2 drops the rotations by pi / 8 and pi / 16.
+        let circuit = qft_circuit(5, 2, QftConnectivity::Full, false, false, false).unwrap();
+        assert_eq!(circuit.count_ops().get("cp"), Some(&7));
+        let full = qft_circuit(5, 5, QftConnectivity::Full, false, false, false).unwrap();
+        assert_eq!(full.count_ops().get("cp"), None);
+    }
+
+    #[test]
+    fn test_qft_inverse() {
+        let circuit = qft_circuit(4, 0, QftConnectivity::Line, true, false, false).unwrap();
+        let inverse = qft_circuit(4, 0, QftConnectivity::Line, true, true, false).unwrap();
+        assert_eq!(circuit.len(), inverse.len());
+        for (gate, inverse_gate) in circuit.data().iter().zip(inverse.data().iter().rev()) {
+            assert_eq!(gate.op.name(), inverse_gate.op.name());
+            if gate.op.standard_gate() == StandardGate::Phase {
+                let (Param::Float(angle), Param::Float(inverse_angle)) =
+                    (&gate.params_view()[0], &inverse_gate.params_view()[0])
+                else {
+                    panic!("expected float angles");
+                };
+                assert_eq!(*angle, -inverse_angle);
+            }
+        }
+    }
+
+    #[test]
+    fn test_qft_cache_shares_circuits() {
+        let circuit = qft_circuit(7, 1, QftConnectivity::Line, true, false, false).unwrap();
+        let cached = qft_circuit(7, 1, QftConnectivity::Line, true, false, false).unwrap();
+        let other = qft_circuit(7, 1, QftConnectivity::Full, true, false, false).unwrap();
+        assert!(Arc::ptr_eq(&circuit, &cached));
+        assert!(!Arc::ptr_eq(&circuit, &other));
+    }
+}
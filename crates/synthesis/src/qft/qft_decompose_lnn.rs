@@ -10,6 +10,7 @@
 // copyright notice, and modified files need to carry a notice indicating
 // that they have been altered from the originals.
 
+use super::{QftConnectivity, qft_circuit};
 use crate::linear_phase::cz_depth_lnn::LnnGatesVec;
 use crate::permutation::_append_reverse_permutation_lnn_kms;
 use pyo3::prelude::*;
@@ -31,6 +32,9 @@ use std::f64::consts::PI;
 ///     this synthesis algorithm creates a circuit that corresponds to "QFT-with-reversal":
 ///     applying the QFT and reversing the order of its output qubits.
 ///
+/// The circuits are cached, so that synthesizing a QFT of the same width again only copies
+/// the circuit.
+///
 /// Args:
 ///     num_qubits: The number of qubits on which the Quantum Fourier Transform acts.
 ///     approximation_degree: The degree of approximation (0 for no approximation).
@@ -55,11 +59,33 @@ pub fn synth_qft_line(
     do_swaps: bool,
     approximation_degree: usize,
 ) -> PyResult<PyCircuitData> {
+    let circuit = qft_circuit(
+        num_qubits,
+        approximation_degree,
+        QftConnectivity::Line,
+        do_swaps,
+        false,
+        false,
+    )?;
+    Ok(CircuitData::clone(&circuit).into())
+}
+
+/// The gates of the QFT circuit for linear nearest-neighbor connectivity, see [synth_qft_line].
+///
+/// The approximation degree must be at most `num_qubits`.
+pub(super) fn qft_line_gates(
+    num_qubits: usize,
+    do_swaps: bool,
+    approximation_degree: usize,
+) -> LnnGatesVec {
+    if num_qubits == 0 {
+        return Vec::new();
+    }
     // Total number of compound gates required = L(L-1)/2
     // Compound gate: H + 3CX + 3P or 3CX + 3P
     // For approximation degree D, D(D+1)/2 * 3 gates will be reduced
-    let mut no_of_gates = num_qubits + (num_qubits * (num_qubits - 1) / 2) * 6
-        - (approximation_degree * (approximation_degree + 1) / 2) * 3;
+    let mut no_of_gates = (num_qubits + (num_qubits * (num_qubits - 1) / 2) * 6)
+        .saturating_sub((approximation_degree * (approximation_degree + 1) / 2) * 3);
 
     if !do_swaps {
         // `_append_reverse_permutation_lnn_kms` would add
@@ -97,10 +123,7 @@ pub fn synth_qft_line(
         _append_reverse_permutation_lnn_kms(&mut instructions, num_qubits);
     }
 
-    Ok(
-        CircuitData::from_standard_gates(num_qubits as u32, instructions, Param::Float(0.0))?
-            .into(),
-    )
+    instructions
 }
 
 #[inline]
@@ -0,0 +1,938 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+//! Checks that the output of the transpiler implements the same unitary as its input.
+//!
+//! Circuits made only of Clifford gates are compared exactly, through the stabilizers of their
+//! Choi states.  Any other circuits are compared on random "fingerprints": a single-qubit Pauli
+//! observable on the output is propagated backwards through both circuits in the Heisenberg
+//! picture, which only ever touches the gates in its light cone and so scales to circuits far
+//! too large to simulate.  Fingerprints whose propagation grows too large fall back to a
+//! statevector comparison, if the circuits are small enough.
+//!
+//! There are only `3n` single-qubit Pauli observables on `n` qubits, so the fingerprints are
+//! drawn without replacement, and every one of them is tried if there are at most as many as
+//! trials.  Two unitaries that conjugate every single-qubit Pauli the same way are equal up to a
+//! global phase, so trying all of them makes the check complete.
+
+use std::iter;
+
+use hashbrown::{HashMap, HashSet};
+use ndarray::Array2;
+use num_complex::Complex64;
+use rand::prelude::*;
+use rand::rngs::SysRng;
+use rand_pcg::Pcg64Mcg;
+use rayon_cond::CondIterator;
+use smallvec::SmallVec;
+
+use qiskit_circuit::circuit_data::CircuitData;
+use qiskit_circuit::operations::{
+    Operation, OperationRef, Param, StandardGate, StandardInstruction,
+};
+use qiskit_circuit::packed_instruction::PackedInstruction;
+use qiskit_quantum_info::clifford::{PauliLabelOrder, PauliList};
+use qiskit_synthesis::matrix::statevector::{
+    MAX_STATEVECTOR_QUBITS, QubitMapping, check_equivalence,
+};
+use qiskit_util::getenv_use_multiple_threads;
+
+use crate::passes::common::{MINIMUM_TOL, is_angle_close_to_multiple_of_pi_k};
+use crate::transpile_layout::TranspileLayout;
+
+/// The largest gate whose action on Pauli operators is computed from its matrix.
+const MAX_PROPAGATION_GATE_QUBITS: usize = 5;
+
+/// Pauli coefficients smaller than this are dropped during propagation.
+const PRUNE_TOLERANCE: f64 = 1e-12;
+
+/// The tolerance on the total difference between the coefficients of two propagated observables.
+const FINGERPRINT_TOLERANCE: f64 = 1e-8;
+
+/// The number of random input states of the statevector fallback.
+const STATEVECTOR_TRIALS: usize = 2;
+
+/// The outcome of an equivalence check.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum Equivalence {
+    /// The circuits are equivalent, exactly or on every fingerprint tried.
+    Equivalent,
+    /// The circuits are not equivalent.
+    NotEquivalent,
+    /// Some fingerprints could not be propagated within the term limit, and the circuits are too
+    /// large to simulate, while every other fingerprint matched, or no fingerprints were requested
+    /// for circuits that are not Clifford.
+    Inconclusive,
+}
+
+/// Options for [check_transpiled_equivalence].
+#[derive(Clone, Debug)]
+pub struct EquivalenceCheckOptions {
+    /// The number of random fingerprints to compare circuits that are not Clifford on.  The
+    /// fingerprints are distinct, so if `d` of the `3n` single-qubit Pauli observables on the `n`
+    /// output qubits catch a difference, it is missed with probability at most
+    /// `(1 - d / 3n)^num_trials`, and never if `num_trials >= 3n`.  With no trials, circuits
+    /// that are not Clifford are not compared and the outcome is [Equivalence::Inconclusive].
+    pub num_trials: usize,
+    /// The seed of the first fingerprint, from which the others are generated, or `None` to
+    /// draw it from system entropy.
+    pub seed: Option<u64>,
+    /// The largest number of Pauli terms a fingerprint may grow to during propagation before it
+    /// is abandoned.
+    pub max_terms: usize,
+}
+
+impl Default for EquivalenceCheckOptions {
+    fn default() -> Self {
+        Self {
+            num_trials: 128,
+            seed: None,
+            max_terms: 1 << 16,
+        }
+    }
+}
+
+/// The result of [check_transpiled_equivalence].
+#[derive(Clone, Debug, PartialEq, Eq)]
+pub struct EquivalenceReport {
+    pub outcome: Equivalence,
+    /// Whether the outcome is exact, which it is for Clifford circuits, rather than based on
+    /// random fingerprints.
+    pub exact: bool,
+    /// The seed of a fingerprint on which the circuits differ.  Running the check again with
+    /// this seed and a single trial reproduces the failure.
+    pub counterexample_seed: Option<u64>,
+}
+
+/// The positions of the virtual qubits of a transpiled circuit at its start and end, including
+/// its ancillas.
+pub fn layout_qubit_mapping(layout: &TranspileLayout) -> QubitMapping {
+    let num_output_qubits = layout.num_output_qubits() as usize;
+    QubitMapping {
+        initial_positions: match layout.initial_physical_layout(false) {
+            Some(initial) => initial.iter().map(|q| q.index()).collect(),
+            None => (0..num_output_qubits).collect(),
+        },
+        final_positions: layout
+            .final_index_layout(false)
+            .iter()
+            .map(|q| q.index())
+            .collect(),
+    }
+}
+
+/// A Pauli operator without a sign, as packed X and Z bits.  A qubit with both bits set has a Y.
+#[derive(Clone, Debug, PartialEq, Eq, Hash)]
+struct Pauli {
+    x: SmallVec<[u64; 2]>,
+    z: SmallVec<[u64; 2]>,
+}
+
+impl Pauli {
+    fn identity(num_qubits: usize) -> Self {
+        let num_words = num_qubits.div_ceil(64);
+        Self {
+            x: SmallVec::from_elem(0, num_words),
+            z: SmallVec::from_elem(0, num_words),
+        }
+    }
+
+    #[inline]
+    fn get(&self, qubit: usize) -> (bool, bool) {
+        let (word, bit) = (qubit / 64, qubit % 64);
+        (
+            (self.x[word] >> bit) & 1 == 1,
+            (self.z[word] >> bit) & 1 == 1,
+        )
+    }
+
+    #[inline]
+    fn set(&mut self, qubit: usize, x: bool, z: bool) {
+        let (word, mask) = (qubit / 64, 1u64 << (qubit % 64));
+        self.x[word] = (self.x[word] & !mask) | if x { mask } else { 0 };
+        self.z[word] = (self.z[word] & !mask) | if z { mask } else { 0 };
+    }
+
+    /// The operator on `qubits`, as an index whose low `qubits.len()` bits are the X bits and the
+    /// high bits the Z bits, with bit `j` of each for `qubits[j]`.
+    fn local(&self, qubits: &[usize]) -> usize {
+        qubits
+            .iter()
+            .enumerate()
+            .map(|(j, q)| {
+                let (x, z) = self.get(*q);
+                ((x as usize) << j) | ((z as usize) << (j + qubits.len()))
+            })
+            .sum()
+    }
+
+    /// Replace the operator on `qubits` with the one of index `local`, in the format of
+    /// [Pauli::local].
+    fn set_local(&mut self, qubits: &[usize], local: usize) {
+        for (j, q) in qubits.iter().enumerate() {
+            self.set(
+                *q,
+                (local >> j) & 1 == 1,
+                (local >> (j + qubits.len())) & 1 == 1,
+            );
+        }
+    }
+
+    /// Multiply `other` into this operator with sign `negative`, returning the sign of the
+    /// product.  The operators must commute, so that the product is Hermitian.
+    fn multiply(&mut self, negative: bool, other: &Pauli, other_negative: bool) -> bool {
+        // Count the factors of `i` from each qubit, as in the `rowsum` of Aaronson and Gottesman.
+        let mut phase = 2 * (negative as i64 + other_negative as i64);
+        for (((x1, z1), x2), z2) in other.x.iter().zip(&other.z).zip(&self.x).zip(&self.z) {
+            let (y1, xo1, zo1) = (x1 & z1, x1 & !z1, z1 & !x1);
+            let (y2, xo2, zo2) = (x2 & z2, x2 & !z2, z2 & !x2);
+            let plus = (y1 & zo2) | (xo1 & y2) | (zo1 & xo2);
+            let minus = (y1 & xo2) | (xo1 & zo2) | (zo1 & y2);
+            phase += plus.count_ones() as i64 - minus.count_ones() as i64;
+        }
+        for (a, b) in self.x.iter_mut().zip(&other.x) {
+            *a ^= b;
+        }
+        for (a, b) in self.z.iter_mut().zip(&other.z) {
+            *a ^= b;
+        }
+        phase.rem_euclid(4) == 2
+    }
+}
+
+/// The unitary instructions of a circuit and their qubits, skipping barriers and delays.
+fn unitary_instructions(
+    circuit: &CircuitData,
+) -> Result<Vec<(&PackedInstruction, SmallVec<[usize; 2]>)>, String> {
+    if circuit.num_clbits() > 0 {
+        return Err("Cannot check the equivalence of circuits involving classical bits.".into());
+    }
+    circuit
+        .data()
+        .iter()
+        .filter(|inst| {
+            !matches!(
+                inst.op.view(),
+                OperationRef::StandardInstruction(
+                    StandardInstruction::Barrier(_) | StandardInstruction::Delay(_)
+                )
+            )
+        })
+        .map(|inst| {
+            if let OperationRef::StandardInstruction(_) = inst.op.view() {
+                return Err(format!(
+                    "Cannot check the equivalence of circuits containing {:?}.",
+                    inst.op.name()
+                ));
+            }
+            let qubits = circuit
+                .get_qargs(inst.qubits)
+                .iter()
+                .map(|q| q.index())
+                .collect();
+            Ok((inst, qubits))
+        })
+        .collect()
+}
+
+/// Conjugate every Pauli in `paulis` by a gate, if it is a Clifford gate.  Returns `false`,
+/// leaving `paulis` unchanged, if not.
+fn append_clifford(paulis: &mut PauliList, inst: &PackedInstruction, qubits: &[usize]) -> bool {
+    let OperationRef::StandardGate(gate) = inst.op.view() else {
+        return false;
+    };
+    let quarter_turns = |rotation: StandardGate, index: usize| match inst.params_view().get(index) {
+        Some(Param::Float(angle)) => {
+            is_angle_close_to_multiple_of_pi_k(rotation, 2, *angle, MINIMUM_TOL)
+        }
+        _ => None,
+    };
+    match gate {
+        StandardGate::GlobalPhase | StandardGate::I => (),
+        StandardGate::X => paulis.append_x(qubits[0]),
+        StandardGate::Y => paulis.append_y(qubits[0]),
+        StandardGate::Z => paulis.append_z(qubits[0]),
+        StandardGate::H => paulis.append_h(qubits[0]),
+        StandardGate::S => paulis.append_s(qubits[0]),
+        StandardGate::Sdg => paulis.append_sdg(qubits[0]),
+        StandardGate::SX => paulis.append_sx(qubits[0]),
+        StandardGate::SXdg => paulis.append_sxdg(qubits[0]),
+        StandardGate::CX => paulis.append_cx(qubits[0], qubits[1]),
+        StandardGate::CY => paulis.append_cy(qubits[0], qubits[1]),
+        StandardGate::CZ => paulis.append_cz(qubits[0], qubits[1]),
+        StandardGate::Swap => paulis.append_swap(qubits[0], qubits[1]),
+        StandardGate::ISwap => paulis.append_iswap(qubits[0], qubits[1]),
+        StandardGate::ECR => paulis.append_ecr(qubits[0], qubits[1]),
+        StandardGate::DCX => paulis.append_dcx(qubits[0], qubits[1]),
+        // The phase gates are `RZ` gates up to a global phase.
+        StandardGate::RZ | StandardGate::Phase | StandardGate::U1 => {
+            let Some(multiple) = quarter_turns(StandardGate::RZ, 0) else {
+                return false;
+            };
+            paulis.append_rz(qubits[0], multiple)
+        }
+        StandardGate::RX => {
+            let Some(multiple) = quarter_turns(StandardGate::RX, 0) else {
+                return false;
+            };
+            paulis.append_rx(qubits[0], multiple)
+        }
+        StandardGate::RY => {
+            let Some(multiple) = quarter_turns(StandardGate::RY, 0) else {
+                return false;
+            };
+            paulis.append_ry(qubits[0], multiple)
+        }
+        // `U(theta, phi, lambda)` is `RZ(phi) RY(theta) RZ(lambda)` up to a global phase.
+        StandardGate::U | StandardGate::U3 => {
+            let (Some(theta), Some(phi), Some(lambda)) = (
+                quarter_turns(StandardGate::RY, 0),
+                quarter_turns(StandardGate::RZ, 1),
+                quarter_turns(StandardGate::RZ, 2),
+            ) else {
+                return false;
+            };
+            paulis.append_rz(qubits[0], lambda);
+            paulis.append_ry(qubits[0], theta);
+            paulis.append_rz(qubits[0], phi);
+        }
+        StandardGate::U2 => {
+            let (Some(phi), Some(lambda)) = (
+                quarter_turns(StandardGate::RZ, 0),
+                quarter_turns(StandardGate::RZ, 1),
+            ) else {
+                return false;
+            };
+            paulis.append_rz(qubits[0], lambda);
+            paulis.append_ry(qubits[0], 1);
+            paulis.append_rz(qubits[0], phi);
+        }
+        _ => return false,
+    }
+    true
+}
+
+/// The stabilizers of the Choi state of a Clifford circuit on the inputs with its ancillas in
+/// the zero state, in reduced row-echelon form, or `None` if the circuit is not Clifford.
+///
+/// The circuit has `num_qubits` qubits, and virtual qubit `v` starts on its qubit
+/// `positions[v]`, where the first `num_data` virtual qubits are maximally entangled with a
+/// reference qubit each, and the others are ancillas.  The output is given on the reference
+/// qubits followed by the circuit's qubits, with qubit `q` of the circuit relabelled to
+/// `relabel[q]`.
+fn choi_stabilizers(
+    instructions: &[(&PackedInstruction, SmallVec<[usize; 2]>)],
+    num_qubits: usize,
+    positions: &[usize],
+    num_data: usize,
+    relabel: &[usize],
+) -> Option<Vec<(Pauli, bool)>> {
+    // The circuit part of each generator: `X` and `Z` on each data qubit, then `Z` on each
+    // ancilla.
+    let generator = |position: usize, c: char| {
+        (0..num_qubits)
+            .map(|q| if q == position { c } else { 'I' })
+            .collect::<String>()
+    };
+    let labels = positions
+        .iter()
+        .enumerate()
+        .flat_map(|(v, position)| {
+            let ops: &[char] = if v < num_data { &['X', 'Z'] } else { &['Z'] };
+            ops.iter().map(move |c| generator(*position, *c))
+        })
+        .collect::<Vec<_>>();
+    let mut paulis =
+        PauliList::from_pauli_labels(num_qubits, &labels, PauliLabelOrder::LeftToRight)
+            .expect("the labels are valid");
+    for (inst, qubits) in instructions {
+        if !append_clifford(&mut paulis, inst, qubits) {
+            return None;
+        }
+    }
+
+    let total_qubits = num_data + num_qubits;
+    let rows = (0..labels.len())
+        .map(|i| {
+            let mut pauli = Pauli::identity(total_qubits);
+            if i < 2 * num_data {
+                pauli.set(i / 2, i % 2 == 0, i % 2 == 1);
+            }
+            for q in 0..num_qubits {
+                pauli.set(
+                    num_data + relabel[q],
+                    paulis.get_pauli_x(i, q),
+                    paulis.get_pauli_z(i, q),
+                );
+            }
+            (pauli, paulis.get_pauli_phase(i))
+        })
+        .collect::<Vec<_>>();
+    Some(reduce_stabilizers(rows, total_qubits))
+}
+
+/// Reduce the generators of a stabilizer group to the reduced row-echelon form of their bits,
+/// with the `X` bits of every qubit before the `Z` bits.  This form is the same for every set of
+/// generators of the group, including the signs, since a stabilizer group never contains both an
+/// operator and its negation.
+fn reduce_stabilizers(mut rows: Vec<(Pauli, bool)>, num_qubits: usize) -> Vec<(Pauli, bool)> {
+    let mut rank = 0;
+    for column in 0..2 * num_qubits {
+        let bit = |pauli: &Pauli| {
+            let (x, z) = pauli.get(column % num_qubits);
+            if column < num_qubits { x } else { z }
+        };
+        let Some(pivot) = (rank..rows.len()).find(|r| bit(&rows[*r].0)) else {
+            continue;
+        };
+        rows.swap(rank, pivot);
+        let (pivot_pauli, pivot_sign) = rows[rank].clone();
+        for (r, (pauli, sign)) in rows.iter_mut().enumerate() {
+            if r != rank && bit(pauli) {
+                *sign = pauli.multiply(*sign, &pivot_pauli, pivot_sign);
+            }
+        }
+        rank += 1;
+        if rank == rows.len() {
+            break;
+        }
+    }
+    rows
+}
+
+/// The action of a gate on the Pauli operators on its qubits in the Heisenberg picture, computed
+/// for each operator when it is first needed.
+struct PauliConjugation {
+    matrix: Array2<Complex64>,
+    num_qubits: usize,
+    images: Vec<Option<Vec<(usize, f64)>>>,
+}
+
+impl PauliConjugation {
+    fn new(matrix: Array2<Complex64>, num_qubits: usize) -> Self {
+        Self {
+            matrix,
+            num_qubits,
+            images: vec![None; 1 << (2 * num_qubits)],
+        }
+    }
+
+    /// The expansion of `U^dagger P U` in Pauli operators, where `P` is the operator of index
+    /// `local` in the format of [Pauli::local].
+    fn image(&mut self, local: usize) -> &[(usize, f64)] {
+        let (k, matrix) = (self.num_qubits, &self.matrix);
+        self.images[local].get_or_insert_with(|| {
+            let dim = 1 << k;
+            // Pauli `(a, b)` is `i^|a & b| X^a Z^b`, whose element `(a ^ j, j)` is
+            // `i^|a & b| (-1)^|b & j|`.
+            let i_pow = |n: u32| [1.0, Complex64::I, -1.0, -Complex64::I][(n % 4) as usize];
+            let sign = |n: u32| if n % 2 == 0 { 1.0 } else { -1.0 };
+            let (a, b) = (local & (dim - 1), local >> k);
+            let phase = i_pow((a & b).count_ones());
+            let pauli_u = Array2::from_shape_fn((dim, dim), |(i, c)| {
+                phase * sign((b & (i ^ a)).count_ones()) * matrix[[i ^ a, c]]
+            });
+            let conjugated = matrix.t().mapv(|v| v.conj()).dot(&pauli_u);
+            (0..dim * dim)
+                .filter_map(|image| {
+                    let (a, b) = (image & (dim - 1), image >> k);
+                    let trace: Complex64 = (0..dim)
+                        .map(|j| sign((b & j).count_ones()) * conjugated[[j, j ^ a]])
+                        .sum();
+                    let coefficient = (i_pow((a & b).count_ones()) * trace).re / dim as f64;
+                    (coefficient.abs() > PRUNE_TOLERANCE).then_some((image, coefficient))
+                })
+                .collect()
+        })
+    }
+}
+
+/// Propagate an observable backwards through a circuit, conjugating it by each gate in the
+/// Heisenberg picture.  Returns `None` if the observable grows to more than `max_terms` terms.
+fn propagate(
+    mut observable: HashMap<Pauli, f64>,
+    instructions: &[(&PackedInstruction, SmallVec<[usize; 2]>)],
+    max_terms: usize,
+) -> Result<Option<HashMap<Pauli, f64>>, String> {
+    for (inst, qubits) in instructions.iter().rev() {
+        if qubits.is_empty()
+            || observable
+                .keys()
+                .all(|pauli| qubits.iter().all(|q| pauli.get(*q) == (false, false)))
+        {
+            continue;
+        }
+        if qubits.len() > MAX_PROPAGATION_GATE_QUBITS {
+            return Err(format!(
+                "Cannot check the equivalence of circuits containing gates on more than {MAX_PROPAGATION_GATE_QUBITS} qubits."
+            ));
+        }
+        let matrix = inst
+            .try_matrix()
+            .ok_or_else(|| format!("Cannot extract matrix for operation {:?}.", inst.op.name()))?;
+        let mut conjugation = PauliConjugation::new(matrix, qubits.len());
+        let mut out = HashMap::with_capacity(observable.len());
+        for (pauli, coefficient) in observable {
+            let local = pauli.local(qubits);
+            if local == 0 {
+                *out.entry(pauli).or_insert(0.0) += coefficient;
+                continue;
+            }
+            for (image, factor) in conjugation.image(local) {
+                let mut term = pauli.clone();
+                term.set_local(qubits, *image);
+                *out.entry(term).or_insert(0.0) += coefficient * factor;
+            }
+        }
+        out.retain(|_, coefficient| coefficient.abs() > PRUNE_TOLERANCE);
+        if out.len() > max_terms {
+            return Ok(None);
+        }
+        observable = out;
+    }
+    Ok(Some(observable))
+}
+
+/// The fingerprint of a seed: the index of an output qubit, and the `(x, z)` bits of the Pauli
+/// observable on it.
+fn fingerprint(seed: u64, num_output_qubits: usize) -> (usize, (bool, bool)) {
+    let mut rng = Pcg64Mcg::seed_from_u64(seed);
+    let observable = rng.random_range(0..3 * num_output_qubits);
+    let paulis = [(true, false), (true, true), (false, true)];
+    (observable / 3, paulis[observable % 3])
+}
+
+/// The seeds of the fingerprints to try: `seed` itself, then those generated from it whose
+/// fingerprints haven't already been drawn, until there are `num_trials` of them or every
+/// fingerprint has been drawn.
+///
+/// Each new fingerprint is uniformly distributed over those not yet drawn, so this samples
+/// without replacement.  Drawing them all is the coupon collector's problem, which takes about
+/// `3n ln 3n` seeds and so only happens when there are about that many trials anyway.
+fn fingerprint_seeds(seed: u64, num_trials: usize, num_output_qubits: usize) -> Vec<u64> {
+    let num_fingerprints = num_trials.min(3 * num_output_qubits);
+    let mut drawn = HashSet::with_capacity(num_fingerprints);
+    iter::once(seed)
+        .chain(Pcg64Mcg::seed_from_u64(seed).sample_iter(&rand::distr::StandardUniform))
+        .filter(|seed| drawn.insert(fingerprint(*seed, num_output_qubits)))
+        .take(num_fingerprints)
+        .collect()
+}
+
+/// Compare two circuits on the fingerprint of one seed: a random single-qubit Pauli observable on
+/// the output, propagated backwards through both circuits and evaluated with the ancillas in the
+/// zero state.
+fn fingerprint_trial(
+    seed: u64,
+    input: &[(&PackedInstruction, SmallVec<[usize; 2]>)],
+    output: &[(&PackedInstruction, SmallVec<[usize; 2]>)],
+    mapping: &QubitMapping,
+    num_input_qubits: usize,
+    max_terms: usize,
+) -> Result<Equivalence, String> {
+    let num_output_qubits = mapping.final_positions.len();
+    let (position, (x, z)) = fingerprint(seed, num_output_qubits);
+
+    let mut output_observable = Pauli::identity(num_output_qubits);
+    output_observable.set(position, x, z);
+    let virtual_qubit = mapping
+        .final_positions
+        .iter()
+        .position(|p| *p == position)
+        .expect("the final positions are a permutation");
+    // The input circuit doesn't touch the ancillas, which stay in the zero state, so only `Z`
+    // has a nonzero expectation value on them.
+    let mut input_observable = HashMap::new();
+    if virtual_qubit < num_input_qubits {
+        let mut pauli = Pauli::identity(num_input_qubits);
+        pauli.set(virtual_qubit, x, z);
+        input_observable.insert(pauli, 1.0);
+    } else if !x {
+        input_observable.insert(Pauli::identity(num_input_qubits), 1.0);
+    }
+
+    let Some(input_image) = propagate(input_observable, input, max_terms)? else {
+        return Ok(Equivalence::Inconclusive);
+    };
+    let Some(output_image) =
+        propagate(HashMap::from([(output_observable, 1.0)]), output, max_terms)?
+    else {
+        return Ok(Equivalence::Inconclusive);
+    };
+
+    // Evaluate the ancillas of the output circuit in the zero state, where `X` and `Y` have zero
+    // expectation value, and move the data qubits to the qubits of the input circuit.
+    let ancillas = &mapping.initial_positions[num_input_qubits..];
+    let mut projected: HashMap<Pauli, f64> = HashMap::with_capacity(output_image.len());
+    for (pauli, coefficient) in output_image {
+        if ancillas.iter().any(|q| pauli.get(*q).0) {
+            continue;
+        }
+        let mut term = Pauli::identity(num_input_qubits);
+        for (v, q) in mapping.initial_positions[..num_input_qubits]
+            .iter()
+            .enumerate()
+        {
+            let (x, z) = pauli.get(*q);
+            term.set(v, x, z);
+        }
+        *projected.entry(term).or_insert(0.0) += coefficient;
+    }
+    let difference = input_image
+        .iter()
+        .map(|(pauli, c)| (c - projected.get(pauli).copied().unwrap_or(0.0)).abs())
+        .chain(
+            projected
+                .iter()
+                .filter(|(pauli, _)| !input_image.contains_key(*pauli))
+                .map(|(_, c)| c.abs()),
+        )
+        .sum::<f64>();
+    Ok(if difference <= FINGERPRINT_TOLERANCE {
+        Equivalence::Equivalent
+    } else {
+        Equivalence::NotEquivalent
+    })
+}
+
+/// Check whether `output` implements the same unitary as `input` up to a global phase, where
+/// `output` is the result of transpiling `input` with the given `layout`.  Without a layout,
+/// both circuits must have the same qubits.
+///
+/// The qubits of `input` start on the qubits of `output` given by the initial layout and must
+/// end on those given by the final layout, and the ancillas of `output` start in, and must be
+/// returned to, the zero state.
+pub fn check_transpiled_equivalence(
+    input: &CircuitData,
+    output: &CircuitData,
+    layout: Option<&TranspileLayout>,
+    options: &EquivalenceCheckOptions,
+) -> Result<EquivalenceReport, String> {
+    let (num_input_qubits, num_output_qubits) = (input.num_qubits(), output.num_qubits());
+    let mapping = match layout {
+        Some(layout) => {
+            if layout.num_input_qubits() as usize != num_input_qubits
+                || layout.num_output_qubits() as usize != num_output_qubits
+            {
+                return Err("The layout doesn't match the numbers of circuit qubits.".into());
+            }
+            layout_qubit_mapping(layout)
+        }
+        None => {
+            if num_input_qubits != num_output_qubits {
+                return Err(format!(
+                    "Circuits with different numbers of qubits ({num_input_qubits} and {num_output_qubits}) need a layout to be compared."
+                ));
+            }
+            QubitMapping {
+                initial_positions: (0..num_input_qubits).collect(),
+                final_positions: (0..num_input_qubits).collect(),
+            }
+        }
+    };
+    let input_instructions = unitary_instructions(input)?;
+    let output_instructions = unitary_instructions(output)?;
+    if num_output_qubits == 0 {
+        return Ok(EquivalenceReport {
+            outcome: Equivalence::Equivalent,
+            exact: true,
+            counterexample_seed: None,
+        });
+    }
+
+    // The input circuit acts on the first of the output's virtual qubits, which are then moved
+    // to their final positions.
+    let virtual_qubits = (0..num_output_qubits).collect::<Vec<_>>();
+    if let Some(input_stabilizers) = choi_stabilizers(
+        &input_instructions,
+        num_output_qubits,
+        &virtual_qubits,
+        num_input_qubits,
+        &mapping.final_positions,
+    ) && let Some(output_stabilizers) = choi_stabilizers(
+        &output_instructions,
+        num_output_qubits,
+        &mapping.initial_positions,
+        num_input_qubits,
+        &virtual_qubits,
+    ) {
+        return Ok(EquivalenceReport {
+            outcome: if input_stabilizers == output_stabilizers {
+                Equivalence::Equivalent
+            } else {
+                Equivalence::NotEquivalent
+            },
+            exact: true,
+            counterexample_seed: None,
+        });
+    }
+    if options.num_trials == 0 {
+        return Ok(EquivalenceReport {
+            outcome: Equivalence::Inconclusive,
+            exact: false,
+            counterexample_seed: None,
+        });
+    }
+
+    let seed = match options.seed {
+        Some(seed) => seed,
+        None => Pcg64Mcg::try_from_rng(&mut SysRng).unwrap().next_u64(),
+    };
+    let seeds = fingerprint_seeds(seed, options.num_trials, num_output_qubits);
+    let parallel = seeds.len() > 1 && getenv_use_multiple_threads();
+    let outcomes = CondIterator::new(seeds, parallel)
+        .map(|seed| {
+            fingerprint_trial(
+                seed,
+                &input_instructions,
+                &output_instructions,
+                &mapping,
+                num_input_qubits,
+                options.max_terms,
+            )
+            .map(|outcome| (seed, outcome))
+        })
+        .collect::<Result<Vec<_>, String>>()?;
+
+    let report = |outcome, counterexample_seed| EquivalenceReport {
+        outcome,
+        exact: false,
+        counterexample_seed,
+    };
+    if let Some((seed, _)) = outcomes
+        .iter()
+        .find(|(_, outcome)| *outcome == Equivalence::NotEquivalent)
+    {
+        return Ok(report(Equivalence::NotEquivalent, Some(*seed)));
+    }
+    if outcomes
+        .iter()
+        .any(|(_, outcome)| *outcome == Equivalence::Inconclusive)
+    {
+        if num_output_qubits > MAX_STATEVECTOR_QUBITS {
+            return Ok(report(Equivalence::Inconclusive, None));
+        }
+        let equivalent = check_equivalence(
+            input,
+            output,
+            Some(&mapping),
+            STATEVECTOR_TRIALS,
+            Some(seed),
+        )?;
+        return Ok(if equivalent {
+            report(Equivalence::Equivalent, None)
+        } else {
+            report(Equivalence::NotEquivalent, Some(seed))
+        });
+    }
+    Ok(report(Equivalence::Equivalent, None))
+}
+
+#[cfg(all(test, not(miri)))]
+mod test {
+    use super::{
+        Equivalence, EquivalenceCheckOptions, check_transpiled_equivalence, fingerprint,
+        fingerprint_seeds, layout_qubit_mapping,
+    };
+    use crate::transpile_layout::TranspileLayout;
+    use qiskit_circuit::circuit_data::CircuitData;
+    use qiskit_circuit::nlayout::NLayout;
+    use qiskit_circuit::operations::{Operation, Param, StandardGate};
+    use qiskit_circuit::{PhysicalQubit, Qubit};
+    use smallvec::SmallVec;
+
+    fn circuit(num_qubits: u32, gates: &[(StandardGate, &[f64], &[u32])]) -> CircuitData {
+        CircuitData::from_standard_gates(
+            num_qubits,
+            gates.iter().map(|(gate, params, qubits)| {
+                (
+                    *gate,
+                    params.iter().map(|p| Param::Float(*p)).collect(),
+                    qubits.iter().map(|q| Qubit(*q)).collect::<SmallVec<_>>(),
+                )
+            }),
+            Param::Float(0.0),
+        )
+        .unwrap()
+    }
+
+    fn options() -> EquivalenceCheckOptions {
+        EquivalenceCheckOptions {
+            num_trials: 128,
+            seed: Some(2026),
+            ..Default::default()
+        }
+    }
+
+    #[test]
+    fn test_clifford_exact() {
+        let a = circuit(2, &[(StandardGate::CZ, &[], &[0, 1])]);
+        let b = circuit(
+            2,
+            &[
+                (StandardGate::H, &[], &[1]),
+                (StandardGate::CX, &[], &[0, 1]),
+                (StandardGate::H, &[], &[1]),
+            ],
+        );
+        let c = circuit(2, &[(StandardGate::CX, &[], &[1, 0])]);
+        let report = check_transpiled_equivalence(&a, &b, None, &options()).unwrap();
+        assert_eq!(report.outcome, Equivalence::Equivalent);
+        assert!(report.exact);
+        let report = check_transpiled_equivalence(&a, &c, None, &options()).unwrap();
+        assert_eq!(report.outcome, Equivalence::NotEquivalent);
+        assert!(report.exact);
+    }
+
+    #[test]
+    fn test_clifford_sign() {
+        // `X` and `Z` have the same stabilizers up to sign.
+        let x = circuit(1, &[(StandardGate::X, &[], &[0])]);
+        let z = circuit(1, &[(StandardGate::Z, &[], &[0])]);
+        let y = circuit(
+            1,
+            &[(StandardGate::Z, &[], &[0]), (StandardGate::X, &[], &[0])],
+        );
+        let yy = circuit(1, &[(StandardGate::Y, &[], &[0])]);
+        let report = check_transpiled_equivalence(&x, &z, None, &options()).unwrap();
+        assert_eq!(report.outcome, Equivalence::NotEquivalent);
+        let report = check_transpiled_equivalence(&y, &yy, None, &options()).unwrap();
+        assert_eq!(report.outcome, Equivalence::Equivalent);
+    }
+
+    #[test]
+    fn test_fingerprints() {
+        // A Toffoli against its standard decomposition.
+        let a = circuit(3, &[(StandardGate::CCX, &[], &[0, 1, 2])]);
+        let b = StandardGate::CCX.definition(&[]).unwrap();
+        let report = check_transpiled_equivalence(&a, &b, None, &options()).unwrap();
+        assert_eq!(report.outcome, Equivalence::Equivalent);
+        assert!(!report.exact);
+
+        // The same with a rotation angle slightly off.
+        let c = circuit(
+            3,
+            &[
+                (StandardGate::CCX, &[], &[0, 1, 2]),
+                (StandardGate::RZ, &[1e-3], &[2]),
+            ],
+        );
+        let report = check_transpiled_equivalence(&c, &b, None, &options()).unwrap();
+        assert_eq!(report.outcome, Equivalence::NotEquivalent);
+        let seed = report.counterexample_seed.unwrap();
+        // The counterexample reproduces on its own.
+        let single = EquivalenceCheckOptions {
+            num_trials: 1,
+            seed: Some(seed),
+            ..Default::default()
+        };
+        let report = check_transpiled_equivalence(&c, &b, None, &single).unwrap();
+        assert_eq!(report.outcome, Equivalence::NotEquivalent);
+        assert_eq!(report.counterexample_seed, Some(seed));
+
+        // Without any trials nothing is compared.
+        let none = EquivalenceCheckOptions {
+            num_trials: 0,
+            ..options()
+        };
+        let report = check_transpiled_equivalence(&c, &b, None, &none).unwrap();
+        assert_eq!(report.outcome, Equivalence::Inconclusive);
+        assert_eq!(report.counterexample_seed, None);
+    }
+
+    #[test]
+    fn test_fingerprints_without_replacement() {
+        // With fewer trials than fingerprints they are distinct, and with more every one of them
+        // is tried exactly once.
+        for (num_trials, expected) in [(7, 7), (30, 30), (128, 30)] {
+            let seeds = fingerprint_seeds(2026, num_trials, 10);
+            assert_eq!(seeds.len(), expected);
+            assert_eq!(seeds[0], 2026);
+            let mut fingerprints = seeds
+                .iter()
+                .map(|seed| fingerprint(*seed, 10))
+                .collect::<Vec<_>>();
+            fingerprints.sort();
+            fingerprints.dedup();
+            assert_eq!(fingerprints.len(), expected);
+        }
+
+        // Only the `X` and `Y` fingerprints of one qubit out of ten catch a small rotation, which
+        // is then found from any seed once all 30 fingerprints are tried.
+        let a = circuit(10, &[(StandardGate::T, &[], &[4])]);
+        let b = circuit(
+            10,
+            &[
+                (StandardGate::T, &[], &[4]),
+                (StandardGate::RZ, &[1e-3], &[4]),
+            ],
+        );
+        for seed in 0..20 {
+            let options = EquivalenceCheckOptions {
+                num_trials: 30,
+                seed: Some(seed),
+                ..Default::default()
+            };
+            let report = check_transpiled_equivalence(&a, &b, None, &options).unwrap();
+            assert_eq!(report.outcome, Equivalence::NotEquivalent);
+            assert!(!report.exact);
+        }
+    }
+
+    #[test]
+    fn test_layout_and_ancillas() {
+        // Virtual qubits 0 and 1 start on physical qubits 2 and 0, with an ancilla on 1, and a
+        // final swap moves virtual qubit 0 to physical qubit 0 and 1 to 2.
+        let a = circuit(
+            2,
+            &[
+                (StandardGate::H, &[], &[0]),
+                (StandardGate::T, &[], &[0]),
+                (StandardGate::CX, &[], &[0, 1]),
+            ],
+        );
+        let b = circuit(
+            3,
+            &[
+                (StandardGate::H, &[], &[2]),
+                (StandardGate::T, &[], &[2]),
+                (StandardGate::CX, &[], &[2, 0]),
+                (StandardGate::Swap, &[], &[0, 2]),
+            ],
+        );
+        let initial_layout = NLayout::from_virtual_to_physical(vec![
+            PhysicalQubit(2),
+            PhysicalQubit(0),
+            PhysicalQubit(1),
+        ])
+        .unwrap();
+        let layout = TranspileLayout::new(
+            Some(initial_layout),
+            Some(vec![Qubit(2), Qubit(1), Qubit(0)]),
+            vec![],
+            2,
+            vec![],
+        );
+        let mapping = layout_qubit_mapping(&layout);
+        assert_eq!(mapping.final_positions, vec![0, 2, 1]);
+        let report = check_transpiled_equivalence(&a, &b, Some(&layout), &options()).unwrap();
+        assert_eq!(report.outcome, Equivalence::Equivalent);
+
+        // Flipping the ancilla is caught.
+        let mut flipped = b.clone();
+        flipped
+            .push_standard_gate(StandardGate::X, &[], &[Qubit(1)])
+            .unwrap();
+        let report = check_transpiled_equivalence(&a, &flipped, Some(&layout), &options()).unwrap();
+        assert_eq!(report.outcome, Equivalence::NotEquivalent);
+    }
+}
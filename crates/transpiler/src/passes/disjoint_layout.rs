@@ -523,8 +523,15 @@ fn separate_dag(dag: &mut DAGCircuit) -> PyResult<Vec<DAGCircuit>> {
     decomposed_dags
 }
 
+/// Merge the single-qubit barriers that `split_barriers` split a barrier into back into a single
+/// barrier.  If `retain_uuid` is false, the labels of the merged barriers are also restored to the
+/// labels of the original barriers.
 #[pyfunction]
 pub fn combine_barriers(dag: &mut DAGCircuit, retain_uuid: bool) -> PyResult<()> {
+    // The merged barriers act on the qubits of the pieces in the order of the DAG's qubits.
+    let qubit_pos_map: HashMap<Qubit, usize> = (0..dag.num_qubits())
+        .map(|index| (Qubit::new(index), index))
+        .collect();
     let mut uuid_map: HashMap<String, NodeIndex> = HashMap::new();
     let barrier_nodes: Vec<NodeIndex> = dag
         .op_nodes(true)
@@ -545,15 +552,6 @@ pub fn combine_barriers(dag: &mut DAGCircuit, retain_uuid: bool) -> PyResult<()>
         match uuid_map.get(label.as_str()) {
             Some(other_index) => {
                 let num_qubits = dag[*other_index].unwrap_operation().op.num_qubits() + num_qubits;
-                let new_label = if retain_uuid {
-                    Some(label.to_string())
-                } else if label.starts_with("_none_uuid=") {
-                    None
-                } else {
-                    let len = label.len();
-                    let components: Vec<&str> = label.split("_uuid=").collect();
-                    Some(components[..len - 1].join("_uuid="))
-                };
                 let new_op = PackedOperation::from_standard_instruction(
                     StandardInstruction::Barrier(num_qubits),
                 );
@@ -561,9 +559,9 @@ pub fn combine_barriers(dag: &mut DAGCircuit, retain_uuid: bool) -> PyResult<()>
                     &[*other_index, node_index],
                     new_op,
                     None,
-                    new_label.as_deref(),
+                    Some(label.as_str()),
                     true,
-                    &HashMap::new(),
+                    &qubit_pos_map,
                     &HashMap::new(),
                 )?;
                 uuid_map.insert(*label, new_node);
@@ -573,20 +571,45 @@ pub fn combine_barriers(dag: &mut DAGCircuit, retain_uuid: bool) -> PyResult<()>
             }
         }
     }
+    if !retain_uuid {
+        for (label, node_index) in uuid_map {
+            let original_label = match label.rsplit_once("_uuid=") {
+                Some(("_none", _)) => None,
+                Some((original_label, _)) => Some(original_label),
+                None => Some(label.as_str()),
+            };
+            let op = dag[node_index].unwrap_operation().op.clone();
+            dag.replace_block(
+                &[node_index],
+                op,
+                None,
+                original_label,
+                false,
+                &qubit_pos_map,
+                &HashMap::new(),
+            )?;
+        }
+    }
     Ok(())
 }
 
+/// Split every multi-qubit barrier in `dag` into single-qubit barriers that share a unique label,
+/// so that the barriers don't connect otherwise disconnected components of the circuit.
+/// `combine_barriers` merges them back together.
 fn split_barriers(dag: &mut DAGCircuit) -> PyResult<()> {
-    for (_index, inst) in dag.op_nodes(true) {
-        let OperationRef::StandardInstruction(StandardInstruction::Barrier(num_qubits)) =
-            inst.op.view()
-        else {
-            continue;
-        };
-        if num_qubits == 1 {
-            continue;
-        }
-        let barrier_uuid = match &inst.label {
+    let barriers: Vec<(NodeIndex, u32, Option<String>)> = dag
+        .op_nodes(true)
+        .filter_map(|(index, inst)| {
+            let OperationRef::StandardInstruction(StandardInstruction::Barrier(num_qubits)) =
+                inst.op.view()
+            else {
+                return None;
+            };
+            (num_qubits > 1).then(|| (index, num_qubits, inst.label.as_deref().cloned()))
+        })
+        .collect();
+    for (index, num_qubits, label) in barriers {
+        let barrier_uuid = match label {
             Some(label) => format!("{}_uuid={}", label, Uuid::new_v4()),
             None => format!("_none_uuid={}", Uuid::new_v4()),
         };
@@ -603,6 +626,8 @@ fn split_barriers(dag: &mut DAGCircuit) -> PyResult<()> {
                 None,
             )?;
         }
+        // Barriers touch no variables, so there is no variable mapping to infer.
+        dag.substitute_node_with_dag(index, &split_dag, None, None, Some(&HashMap::new()), None)?;
     }
     Ok(())
 }
@@ -24,7 +24,7 @@ use qiskit_circuit::circuit_instruction::OperationFromPython;
 use qiskit_circuit::converters::QuantumCircuitData;
 use qiskit_circuit::dag_circuit::DAGCircuit;
 use qiskit_circuit::gate_matrix::CX_GATE;
-use qiskit_circuit::imports::HLS_SYNTHESIZE_OP_USING_PLUGINS;
+use qiskit_circuit::imports::{HLS_SYNTHESIZE_OP_USING_PLUGINS, QFT_GATE};
 use qiskit_circuit::operations::{
     Operation, OperationRef, Param, StandardGate, StandardInstruction, radd_param,
 };
@@ -42,6 +42,7 @@ use crate::target::Target;
 use qiskit_circuit::PhysicalQubit;
 use qiskit_synthesis::euler_one_qubit_decomposer::EulerBasis;
 use qiskit_synthesis::euler_one_qubit_decomposer::angles_from_unitary;
+use qiskit_synthesis::qft::{QftConnectivity, qft_circuit};
 use qiskit_synthesis::qsd::quantum_shannon_decomposition;
 use qiskit_synthesis::two_qubit_decompose::TwoQubitBasisDecomposer;
 
@@ -859,8 +860,15 @@ fn synthesize_operation(
     // that the final result only consists of supported operations. If there is no
     // change, we return None.
 
+    // Synthesize QFT gates natively if they would use the default plugin anyway.
+    if let Some(circuit) = synthesize_default_qft(py, &borrowed_data, op)? {
+        output_circuit_and_qubits = Some((circuit, input_qubits.to_vec()));
+    }
+
     // Try to synthesize using plugins.
-    if borrowed_data.hls_op_names.iter().any(|s| s == op.name()) {
+    if output_circuit_and_qubits.is_none()
+        && borrowed_data.hls_op_names.iter().any(|s| s == op.name())
+    {
         output_circuit_and_qubits = synthesize_op_using_plugins(
             py,
             data,
@@ -921,6 +929,43 @@ fn synthesize_operation(
     Ok(output_circuit_and_qubits)
 }
 
+/// Synthesizes a ``QFTGate`` in Rust, using the cached QFT circuits of [qft_circuit].
+///
+/// This is only done when the HLS config does not list methods for ``"qft"`` and uses the default
+/// method, since the result is then the same as that of the default ``QFTSynthesisFull`` plugin
+/// with its default options.  Returns ``None`` for any other operation, which should go through
+/// the plugins as usual.
+fn synthesize_default_qft(
+    py: Python,
+    data: &HighLevelSynthesisData,
+    op: &PackedOperation,
+) -> PyResult<Option<CircuitData>> {
+    let OperationRef::PyCustom(gate) = op.view() else {
+        return Ok(None);
+    };
+    if gate.name() != "qft" || !gate.ob.bind(py).is_instance(QFT_GATE.get_bound(py))? {
+        return Ok(None);
+    }
+    let config = data.hls_config.bind(py);
+    if !config
+        .getattr("methods")?
+        .call_method1("get", ("qft",))?
+        .is_none()
+        || !config.getattr("use_default_on_unspecified")?.is_truthy()?
+    {
+        return Ok(None);
+    }
+    let circuit = qft_circuit(
+        gate.num_qubits() as usize,
+        0,
+        QftConnectivity::Full,
+        true,
+        false,
+        false,
+    )?;
+    Ok(Some(CircuitData::clone(&circuit)))
+}
+
 /// Attempts to synthesize an operation using available plugins.
 ///
 /// The input to this function is the operation to be synthesized and a list of global
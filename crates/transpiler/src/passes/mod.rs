@@ -44,6 +44,7 @@ mod inverse_cancellation;
 mod litinski_transformation;
 mod optimize_1q_gates_decomposition;
 mod optimize_clifford_t;
+mod pad_schedule;
 mod remove_diagonal_gates_before_measure;
 mod remove_identity_equiv;
 pub mod sabre;
@@ -51,6 +52,8 @@ mod schedule_analysis;
 mod split_2q_unitaries;
 mod substitute_pi4_rotations;
 mod synthesize_rz_rotations;
+mod template_matching;
+mod token_swapping;
 mod two_qubit_peephole;
 pub mod unitary_synthesis;
 mod unroll_3q_or_more;
@@ -93,6 +96,7 @@ pub use optimize_1q_gates_decomposition::{
     run_optimize_1q_gates_decomposition,
 };
 pub use optimize_clifford_t::{optimize_clifford_t_mod, run_optimize_clifford_t};
+pub use pad_schedule::{DynamicalDecoupling, align_start_times, run_pad_schedule};
 pub use remove_diagonal_gates_before_measure::{
     remove_diagonal_gates_before_measure_mod, run_remove_diagonal_before_measure,
 };
@@ -103,10 +107,20 @@ pub use schedule_analysis::alap_schedule_analysis::{
 pub use schedule_analysis::asap_schedule_analysis::{
     asap_schedule_analysis_mod, run_asap_schedule_analysis,
 };
+pub use schedule_analysis::dt_schedule::{
+    DtDurations, DtSchedule, TimingKind, run_alap_schedule_dt, run_asap_schedule_dt,
+};
 pub use schedule_analysis::scheduling_mod;
 pub use split_2q_unitaries::{run_split_2q_unitaries, split_2q_unitaries_mod};
 pub use substitute_pi4_rotations::{run_substitute_pi4_rotations, substitute_pi4_rotations_mod};
 pub use synthesize_rz_rotations::{py_run_synthesize_rz_rotations, synthesize_rz_rotations_mod};
+pub use template_matching::{
+    MAX_TEMPLATE_QUBITS, TemplateError, TemplateLibrary, run_template_optimization,
+    template_matching_mod,
+};
+pub use token_swapping::{
+    SwapPlan, TokenSwappingError, run_restore_final_layout, synth_permutation_token_swapper,
+};
 pub use two_qubit_peephole::{
     py_two_qubit_unitary_peephole_optimize, two_qubit_peephole_mod,
     two_qubit_unitary_peephole_optimize,
@@ -0,0 +1,291 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+use std::f64::consts::PI;
+
+use pyo3::prelude::*;
+use smallvec::smallvec;
+
+use qiskit_circuit::dag_circuit::{DAGCircuit, DAGCircuitBuilder};
+use qiskit_circuit::instruction::Parameters;
+use qiskit_circuit::operations::{DelayUnit, Operation, Param, StandardGate, StandardInstruction};
+use qiskit_circuit::packed_instruction::PackedOperation;
+use qiskit_circuit::{BlocksMode, PhysicalQubit, Qubit, VarsMode};
+
+use crate::TranspilerError;
+use crate::passes::schedule_analysis::dt_schedule::{DtDurations, DtSchedule, TimingKind, to_dt};
+use crate::target::Target;
+
+/// A dynamical-decoupling sequence that can be inserted into the idle windows of a schedule.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum DynamicalDecoupling {
+    /// Two `X` gates.
+    XX,
+    /// The four-pulse `X`-`Y`-`X`-`Y` sequence.
+    XY4,
+}
+impl DynamicalDecoupling {
+    /// The gates making up the sequence, in circuit order.
+    fn gates(&self) -> &'static [StandardGate] {
+        match self {
+            Self::XX => &[StandardGate::X, StandardGate::X],
+            Self::XY4 => &[
+                StandardGate::X,
+                StandardGate::Y,
+                StandardGate::X,
+                StandardGate::Y,
+            ],
+        }
+    }
+
+    /// The global phase of the product of the gates in the sequence, which is the identity up to
+    /// this phase.
+    fn global_phase(&self) -> f64 {
+        match self {
+            Self::XX => 0.0,
+            // YXYX = (-iZ)(-iZ) = -I.
+            Self::XY4 => PI,
+        }
+    }
+}
+
+/// Push the start times of a valid schedule later, where necessary, so that every gate starts on
+/// a multiple of `pulse_alignment` and every measurement and reset on a multiple of
+/// `acquire_alignment`, while keeping the instructions on each wire from overlapping.
+///
+/// This is the equivalent of the `ConstrainedReschedule` pass for schedules built natively, and
+/// makes a single pass over the circuit in topological order.  As in that pass, resets are
+/// aligned to `acquire_alignment` like measurements, and delays and directives are not aligned.
+pub fn align_start_times(
+    dag: &DAGCircuit,
+    schedule: &mut DtSchedule,
+    durations: &DtDurations,
+    clbit_write_latency: u64,
+    pulse_alignment: u32,
+    acquire_alignment: u32,
+) {
+    let mut qubit_idle_after = vec![0u64; dag.num_qubits()];
+    let mut clbit_idle_after = vec![0u64; dag.num_clbits()];
+    for node in dag.topological_op_nodes(false) {
+        let inst = dag[node].unwrap_operation();
+        let qargs = dag.get_qargs(inst.qubits);
+        let cargs = dag.get_cargs(inst.clbits);
+        let kind = durations.kind(node);
+        let mut t0 = qargs
+            .iter()
+            .map(|q| qubit_idle_after[q.index()])
+            .fold(schedule.start(node), u64::max);
+        // Measurements don't write their clbits until the write latency has passed, so they can
+        // begin that much before the clbits are free.
+        let clbit_lead = if kind == TimingKind::Measure {
+            clbit_write_latency
+        } else {
+            0
+        };
+        t0 = cargs
+            .iter()
+            .map(|c| clbit_idle_after[c.index()].saturating_sub(clbit_lead))
+            .fold(t0, u64::max);
+        let alignment = match kind {
+            TimingKind::Gate => pulse_alignment,
+            TimingKind::Measure | TimingKind::Reset => acquire_alignment,
+            TimingKind::Delay | TimingKind::Other => 1,
+        };
+        t0 = t0.next_multiple_of(alignment.max(1) as u64);
+        let t1 = t0 + durations.duration(node);
+        for q in qargs {
+            qubit_idle_after[q.index()] = t1;
+        }
+        if !kind.is_gate_or_delay() {
+            for c in cargs {
+                clbit_idle_after[c.index()] = t1;
+            }
+        }
+        schedule.set_start(node, t0);
+    }
+}
+
+/// Add a single delay of `duration` dt to a qubit.
+fn push_delay(builder: &mut DAGCircuitBuilder, qubit: Qubit, duration: u64) -> PyResult<()> {
+    builder.apply_operation_back(
+        PackedOperation::from_standard_instruction(StandardInstruction::Delay(DelayUnit::DT)),
+        &[qubit],
+        &[],
+        Some(Parameters::Params(smallvec![Param::Float(duration as f64)])),
+        None,
+        #[cfg(feature = "cache_pygates")]
+        None,
+    )?;
+    Ok(())
+}
+
+/// Fill the idle window `[begin, end)` of a qubit with a dynamical-decoupling sequence, if it
+/// fits with every gate starting on a multiple of `pulse_alignment`, or with a single delay if
+/// not.
+///
+/// Returns the global phase of the inserted instructions.
+fn pad_window(
+    builder: &mut DAGCircuitBuilder,
+    qubit: Qubit,
+    begin: u64,
+    end: u64,
+    sequence: Option<(DynamicalDecoupling, &[u64])>,
+    pulse_alignment: u64,
+) -> PyResult<f64> {
+    let window = end - begin;
+    if let Some((sequence, gate_durations)) = sequence {
+        let num_gates = gate_durations.len() as u64;
+        let busy: u64 = gate_durations.iter().sum();
+        if busy > 0 && busy <= window {
+            // The free time is split evenly between the gates, with half-size spacings at either
+            // end of the window, and each gate is then moved back to its nearest aligned time.
+            let free = window - busy;
+            let mut starts = Vec::with_capacity(gate_durations.len());
+            let mut elapsed = 0;
+            let mut earliest = begin;
+            for (k, duration) in (0..num_gates).zip(gate_durations) {
+                let ideal = begin + elapsed + free * (2 * k + 1) / (2 * num_gates);
+                let start = ideal - ideal % pulse_alignment;
+                if start < earliest {
+                    break;
+                }
+                starts.push(start);
+                elapsed += duration;
+                earliest = start + duration;
+            }
+            if starts.len() == gate_durations.len() && earliest <= end {
+                let mut now = begin;
+                for ((gate, start), duration) in
+                    sequence.gates().iter().zip(&starts).zip(gate_durations)
+                {
+                    if *start > now {
+                        push_delay(builder, qubit, start - now)?;
+                    }
+                    builder.apply_operation_back(
+                        PackedOperation::from_standard_gate(*gate),
+                        &[qubit],
+                        &[],
+                        None,
+                        None,
+                        #[cfg(feature = "cache_pygates")]
+                        None,
+                    )?;
+                    now = start + duration;
+                }
+                if end > now {
+                    push_delay(builder, qubit, end - now)?;
+                }
+                return Ok(sequence.global_phase());
+            }
+        }
+    }
+    push_delay(builder, qubit, window)?;
+    Ok(0.0)
+}
+
+/// Rebuild a scheduled circuit with every idle window on every qubit made explicit.
+///
+/// Each window is filled with a delay or, if `dynamical_decoupling` is set, with the given
+/// sequence wherever it is supported by the [Target] and fits.  Windows before the first
+/// non-delay operation on a qubit are always filled with delays, since the qubit is still in its
+/// initial state.  Every qubit is padded to the total duration of the circuit.
+///
+/// Returns the total duration of the circuit in `dt`.
+pub fn run_pad_schedule(
+    dag: &mut DAGCircuit,
+    schedule: &DtSchedule,
+    durations: &DtDurations,
+    target: &Target,
+    dynamical_decoupling: Option<DynamicalDecoupling>,
+) -> PyResult<u64> {
+    let num_qubits = dag.num_qubits();
+    let circuit_duration = schedule.circuit_duration(dag, durations);
+
+    // The durations of the decoupling gates on each qubit, or `None` if the target doesn't
+    // support the whole sequence on that qubit.
+    let dd_durations = match dynamical_decoupling {
+        Some(sequence) => {
+            let dt = target.dt.ok_or_else(|| {
+                TranspilerError::new_err("The target must define 'dt' to schedule a circuit.")
+            })?;
+            (0..num_qubits as u32)
+                .map(|q| {
+                    sequence
+                        .gates()
+                        .iter()
+                        .map(|gate| {
+                            target
+                                .get_duration(gate.name(), &[PhysicalQubit::new(q)])
+                                .map(|seconds| to_dt(seconds, DelayUnit::S, dt))
+                        })
+                        .collect::<Option<PyResult<Vec<u64>>>>()
+                        .transpose()
+                })
+                .collect::<PyResult<Vec<_>>>()?
+        }
+        None => vec![None; num_qubits],
+    };
+    let pulse_alignment = target.pulse_alignment.max(1) as u64;
+
+    let mut order = dag.topological_op_nodes(false).collect::<Vec<_>>();
+    // A stable sort keeps instructions that start together in topological order.
+    order.sort_by_key(|node| schedule.start(*node));
+
+    let mut builder = dag
+        .copy_empty_like_with_same_capacity(VarsMode::Alike, BlocksMode::Keep)
+        .into_builder();
+    let mut idle_after = vec![0u64; num_qubits];
+    let mut initialized = vec![false; num_qubits];
+    let mut global_phase = 0.0;
+    let sequence_for = |q: Qubit, initialized: &[bool]| {
+        let durations = dd_durations[q.index()].as_deref()?;
+        initialized[q.index()].then_some((dynamical_decoupling?, durations))
+    };
+    for node in order {
+        let inst = dag[node].unwrap_operation();
+        let start = schedule.start(node);
+        for &q in dag.get_qargs(inst.qubits) {
+            if start > idle_after[q.index()] {
+                global_phase += pad_window(
+                    &mut builder,
+                    q,
+                    idle_after[q.index()],
+                    start,
+                    sequence_for(q, &initialized),
+                    pulse_alignment,
+                )?;
+            }
+            idle_after[q.index()] = start + durations.duration(node);
+            initialized[q.index()] |=
+                !matches!(durations.kind(node), TimingKind::Delay | TimingKind::Other);
+        }
+        builder.push_back(inst.clone())?;
+    }
+    for q in (0..num_qubits).map(Qubit::new) {
+        if circuit_duration > idle_after[q.index()] {
+            global_phase += pad_window(
+                &mut builder,
+                q,
+                idle_after[q.index()],
+                circuit_duration,
+                sequence_for(q, &initialized),
+                pulse_alignment,
+            )?;
+        }
+    }
+    let mut out = builder.build();
+    if global_phase != 0.0 {
+        out.add_global_phase(&Param::Float(global_phase))?;
+    }
+    *dag = out;
+    Ok(circuit_duration)
+}
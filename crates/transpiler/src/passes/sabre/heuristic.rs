@@ -109,6 +109,38 @@ impl LookaheadHeuristic {
     pub fn weights(&self) -> &[f64] {
         &self.weights
     }
+
+    /// Construct a lookahead heuristic over a window of `depth` layers, where the first lookahead
+    /// layer has weight `weight`, and each subsequent layer's weight is multiplied by `decay`.
+    ///
+    /// Fails if `depth` is zero, or if `decay` is not in the range $(0, 1]$.
+    pub fn windowed(depth: u16, weight: f64, decay: f64, scale: SetScaling) -> Option<Self> {
+        if depth == 0 || !(decay > 0.0 && decay <= 1.0) {
+            return None;
+        }
+        let weights = std::iter::successors(Some(weight), |prev| Some(prev * decay))
+            .take(depth as usize)
+            .collect();
+        Some(Self { weights, scale })
+    }
+
+    /// A lookahead window depth suitable for a device with `num_qubits` physical qubits.
+    ///
+    /// A single extended-set layer is the historical Sabre behaviour and works well for small
+    /// devices.  On large devices, the front layer is typically a small fraction of the width of
+    /// the device, so a single layer gives the heuristic very little information about where the
+    /// remaining gates are going to be; we grow the window logarithmically with the device size.
+    pub fn window_depth_for(num_qubits: u32) -> u16 {
+        const MIN_DEPTH: u32 = 1;
+        const MAX_DEPTH: u32 = 16;
+        // `ilog2` of a device with fewer than 32 qubits would give us a depth of zero, and we
+        // always want at least one layer.
+        num_qubits
+            .max(1)
+            .ilog2()
+            .saturating_sub(4)
+            .clamp(MIN_DEPTH, MAX_DEPTH) as u16
+    }
 }
 #[pymethods]
 impl LookaheadHeuristic {
@@ -257,6 +289,34 @@ impl Heuristic {
         }
     }
 
+    /// Set the ``lookahead`` heuristic to a window of ``depth`` layers, with the first layer having
+    /// weight ``weight``, and each subsequent layer's weight being multiplied by ``decay``.  The
+    /// depth must be at least one and less than 65,536, and the decay must be in the range
+    /// ``(0, 1]``.
+    ///
+    /// This is equivalent to calling :meth:`with_lookahead` with a geometric sequence of weights.
+    pub fn with_windowed_lookahead(
+        &self,
+        depth: usize,
+        weight: f64,
+        decay: f64,
+        scale: SetScaling,
+    ) -> PyResult<Self> {
+        let lookahead = depth
+            .try_into()
+            .ok()
+            .and_then(|depth| LookaheadHeuristic::windowed(depth, weight, decay, scale))
+            .ok_or_else(|| {
+                PyValueError::new_err(
+                    "window depth must be in [1, 65,536) and decay must be in (0, 1]",
+                )
+            })?;
+        Ok(Self {
+            lookahead: Some(lookahead),
+            ..self.clone()
+        })
+    }
+
     /// Set the multiplier increment and reset interval of the decay heuristic.  The reset interval
     /// must be non-zero.
     pub fn with_decay(&self, increment: f64, reset: usize) -> PyResult<Self> {
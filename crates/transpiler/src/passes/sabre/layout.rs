@@ -13,16 +13,18 @@
 use pyo3::exceptions::PyValueError;
 use pyo3::prelude::*;
 
-use hashbrown::HashSet;
-use ndarray::aview2;
+use hashbrown::{HashMap, HashSet};
+use ndarray::{Array2, aview2};
 use rand::prelude::*;
 use rand::rngs::SysRng;
 use rand_pcg::Pcg64Mcg;
+use rayon::prelude::*;
 use rayon_cond::CondIterator;
 use rustworkx_core::petgraph::graph::NodeIndex;
 
 use qiskit_circuit::dag_circuit::DAGCircuit;
 use qiskit_circuit::nlayout::NLayout;
+use qiskit_circuit::operations::{OperationRef, StandardInstruction};
 use qiskit_circuit::{BlocksMode, PhysicalQubit, VirtualQubit};
 use qiskit_util::getenv_use_multiple_threads;
 
@@ -31,12 +33,29 @@ use crate::neighbors::Neighbors;
 use crate::passes::{
     dense_layout,
     disjoint_layout::{self, DisjointSplit},
+    vf2::neg_log_fidelity,
 };
 use crate::target::{Target, TargetCouplingError};
 
 use super::dag::SabreDAG;
 use super::heuristic::Heuristic;
-use super::route::{RoutingProblem, RoutingResult, RoutingTarget, swap_map, swap_map_trial};
+use super::route::{
+    RoutingProblem, RoutingResult, RoutingTarget, TrialRace, swap_map, swap_map_raced,
+    swap_map_trial,
+};
+
+/// How Sabre layout chooses between its trials, and whether it races them against each other.
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct TrialSelection {
+    /// Score each trial by the estimated error of the swaps it inserts, using the two-qubit gate
+    /// error rates in the [Target], rather than by the raw number of swaps.  This has no effect if
+    /// the [Target] has no error rates for its couplings.
+    pub score_by_error: bool,
+    /// If set, all trials share the best complete score as they run, and a trial is abandoned as
+    /// soon as its partial score exceeds the best by this relative margin.  Since scores only
+    /// increase, this never changes the selected result; it only skips work.
+    pub race_margin: Option<f64>,
+}
 
 #[allow(clippy::too_many_arguments)]
 #[pyfunction]
@@ -51,6 +70,35 @@ pub fn sabre_layout_and_routing(
     seed: Option<u64>,
     partial_layouts: Vec<Vec<Option<PhysicalQubit>>>,
     skip_routing: bool,
+) -> PyResult<(DAGCircuit, NLayout, NLayout)> {
+    sabre_layout_and_routing_with_selection(
+        dag,
+        target,
+        heuristic,
+        max_iterations,
+        num_swap_trials,
+        num_random_trials,
+        seed,
+        partial_layouts,
+        skip_routing,
+        TrialSelection::default(),
+    )
+}
+
+/// Run Sabre layout and routing, as [sabre_layout_and_routing], with control over how the layout
+/// trials are scored and whether they are raced.
+#[allow(clippy::too_many_arguments)]
+pub fn sabre_layout_and_routing_with_selection(
+    dag: &mut DAGCircuit,
+    target: &Target,
+    heuristic: &Heuristic,
+    max_iterations: usize,
+    num_swap_trials: usize,
+    num_random_trials: usize,
+    seed: Option<u64>,
+    partial_layouts: Vec<Vec<Option<PhysicalQubit>>>,
+    skip_routing: bool,
+    selection: TrialSelection,
 ) -> PyResult<(DAGCircuit, NLayout, NLayout)> {
     let Some(num_physical_qubits) = target.num_qubits else {
         return Err(TranspilerError::new_err(
@@ -139,7 +187,15 @@ pub fn sabre_layout_and_routing(
                 }
                 None => Neighbors::from_coupling(&coupling),
             };
-            let target = RoutingTarget::from_neighbors(neighbors);
+            let swap_costs = selection.score_by_error.then(|| {
+                swap_costs_from_target(target, &neighbors, |q| {
+                    subset.as_deref().map_or(q, |subset| subset[q.index()])
+                })
+            });
+            let target = match swap_costs.flatten() {
+                Some(costs) => RoutingTarget::from_neighbors(neighbors).with_swap_costs(costs),
+                None => RoutingTarget::from_neighbors(neighbors),
+            };
             let problem = RoutingProblem {
                 target: &target,
                 sabre: &sabre_full,
@@ -149,7 +205,8 @@ pub fn sabre_layout_and_routing(
             starting_layouts.extend(partial_layouts);
             add_heuristic_layouts(&mut starting_layouts, problem, allow_parallel);
             let num_layout_trials = starting_layouts.len();
-            let (_, result) = CondIterator::new(
+            let race = selection.race_margin.map(TrialRace::new);
+            let result = CondIterator::new(
                 seeds(num_layout_trials),
                 allow_parallel && num_layout_trials > 1,
             )
@@ -164,11 +221,13 @@ pub fn sabre_layout_and_routing(
                         num_swap_trials,
                         allow_parallel && num_swap_trials > 1,
                         &starting_layouts[index],
+                        race.as_ref(),
                     ),
                 )
             })
-            .min_by_key(|(index, result)| (result.swap_count(), *index))
-            .expect("should have at least one layout trial");
+            .min_by_key(|(index, result)| selection_key(result.as_ref(), *index))
+            .and_then(|(_, result)| result)
+            .expect("at least one layout trial should complete");
             let num_swaps = result.swap_count();
             let out = dag.physical_empty_like_with_capacity(
                 num_physical_qubits,
@@ -193,16 +252,21 @@ pub fn sabre_layout_and_routing(
             ))
         }
         TargetSplit::Multiple(components) => {
-            // The DAG needs splitting across multiple chips.  We can build an initial layout
-            // safely, but the final routing needs to be done altogether, with cross-chip
-            // synchronisation points (e.g. barriers, classical communication, etc) fully in place.
-            let mut full_layout = vec![PhysicalQubit::new(u32::MAX); dag.num_qubits()];
-            // Mapping of the "proper" (full-target) physical qubits to the "fake" restricted
-            // physical qubit index used in the disjoint handling.  At the end of the loop, there
-            // will be duplicates in the list, and there may still be un-set entries, but that
-            // doesn't matter, because we only access physical qubits that come up.
-            let mut sub_from_full = vec![PhysicalQubit::new(u32::MAX); num_physical_qubits];
-            for component in &components {
+            // The DAG needs splitting across multiple chips.  The layout problems of the separate
+            // chips are completely independent, so we solve them concurrently; each returns the
+            // assignment of its virtual qubits to (full-target) physical qubits.
+            //
+            // The winning layout trial of each chip is already routed, so if the components can be
+            // recombined exactly (see `components_are_separable`), we keep those routed circuits
+            // and join them back together, with the barriers that span several chips rejoined.
+            // Otherwise, the final routing is done altogether, with cross-chip synchronisation
+            // points (e.g. classical communication) fully in place.
+            let full_target = target;
+            let route_components = !skip_routing && components_are_separable(dag, &components);
+            let layout_component = |component: &disjoint_layout::DisjointComponent| -> PyResult<(
+                Vec<(VirtualQubit, PhysicalQubit)>,
+                Option<RoutedComponent>,
+            )> {
                 let sabre = SabreDAG::from_dag(&component.sub_dag)?;
                 let target =
                     RoutingTarget::from_neighbors(Neighbors::from_coupling_subset_with_map(
@@ -210,12 +274,25 @@ pub fn sabre_layout_and_routing(
                         &component.physical_qubits,
                         |q| NodeIndex::new(q.index()),
                     ));
+                let swap_costs = selection.score_by_error.then(|| {
+                    swap_costs_from_target(full_target, &target.neighbors, |q| {
+                        component.physical_qubits[q.index()]
+                    })
+                });
+                let target = match swap_costs.flatten() {
+                    Some(costs) => target.with_swap_costs(costs),
+                    None => target,
+                };
                 let sub_problem = RoutingProblem {
                     target: &target,
                     sabre: &sabre,
                     dag: &component.sub_dag,
                     heuristic,
                 };
+                // Mapping of the "proper" (full-target) physical qubits to the "fake" restricted
+                // physical qubit index used in the disjoint handling.  Entries for physical qubits
+                // outside this component are left un-set, but we never access them.
+                let mut sub_from_full = vec![PhysicalQubit::new(u32::MAX); num_physical_qubits];
                 for (sub, full) in component.physical_qubits.iter().enumerate() {
                     sub_from_full[full.index()] = PhysicalQubit::new(sub as u32);
                 }
@@ -228,7 +305,9 @@ pub fn sabre_layout_and_routing(
                             .flatten()
                             .map(|p| {
                                 let sub = sub_from_full[p.index()];
-                                if component.physical_qubits[sub.index()] == p {
+                                if sub.index() < component.physical_qubits.len()
+                                    && component.physical_qubits[sub.index()] == p
+                                {
                                     Ok(sub)
                                 } else {
                                     // TODO: this handling sucks, but it's better than panicking
@@ -255,7 +334,8 @@ pub fn sabre_layout_and_routing(
                 }
                 add_heuristic_layouts(&mut starting_layouts, sub_problem, allow_parallel);
                 let num_layout_trials = starting_layouts.len();
-                let (_, result) = CondIterator::new(
+                let race = selection.race_margin.map(TrialRace::new);
+                let result = CondIterator::new(
                     seeds(num_layout_trials),
                     allow_parallel && num_layout_trials > 1,
                 )
@@ -270,20 +350,67 @@ pub fn sabre_layout_and_routing(
                             num_swap_trials,
                             allow_parallel && num_layout_trials == 1,
                             &starting_layouts[index],
+                            race.as_ref(),
                         ),
                     )
                 })
-                .min_by_key(|(index, result)| (result.swap_count(), *index))
-                .expect("should have at least one layout trial");
-                for ((_, sub_phys), virt) in result
+                .min_by_key(|(index, result)| selection_key(result.as_ref(), *index))
+                .and_then(|(_, result)| result)
+                .expect("at least one layout trial should complete");
+                let full_physical = |q: PhysicalQubit| component.physical_qubits[q.index()];
+                let assignment = result
                     .initial_layout
                     .iter_virtual()
                     // This zip might be shorter than `initial_layout`, but we _want_ the
                     // side-effect of truncating to the non-ancillas.
                     .zip(&component.virtual_qubits)
-                {
-                    full_layout[virt.index()] = component.physical_qubits[sub_phys.index()];
+                    .map(|((_, sub_phys), virt)| (*virt, full_physical(sub_phys)))
+                    .collect();
+                if !route_components {
+                    return Ok((assignment, None));
                 }
+                let num_swaps = result.swap_count();
+                let out = component.sub_dag.physical_empty_like_with_capacity(
+                    num_physical_qubits,
+                    component.sub_dag.num_ops() + num_swaps,
+                    component.sub_dag.dag().edge_count() + 2 * num_swaps,
+                    BlocksMode::Drop,
+                )?;
+                // Every qubit of the component, ancillas included, is moved from its initial to
+                // its final physical qubit by the routing.
+                let moves = result
+                    .initial_layout
+                    .iter_virtual()
+                    .map(|(virt, initial)| {
+                        (
+                            full_physical(initial),
+                            full_physical(virt.to_phys(&result.final_layout)),
+                        )
+                    })
+                    .collect();
+                let routed = RoutedComponent {
+                    dag: result.rebuild_onto(out, full_physical)?,
+                    moves,
+                };
+                Ok((assignment, Some(routed)))
+            };
+            let (assignments, routed): (Vec<_>, Vec<_>) = if allow_parallel && components.len() > 1
+            {
+                components
+                    .par_iter()
+                    .map(layout_component)
+                    .collect::<PyResult<Vec<_>>>()?
+            } else {
+                components
+                    .iter()
+                    .map(layout_component)
+                    .collect::<PyResult<Vec<_>>>()?
+            }
+            .into_iter()
+            .unzip();
+            let mut full_layout = vec![PhysicalQubit::new(u32::MAX); dag.num_qubits()];
+            for (virt, phys) in assignments.into_iter().flatten() {
+                full_layout[virt.index()] = phys;
             }
             let max_virt = VirtualQubit::new(u32::MAX);
             let max_phys = PhysicalQubit::new(u32::MAX);
@@ -306,6 +433,51 @@ pub fn sabre_layout_and_routing(
                 // ...and assign them to the unassigned physical qubits in increasing order of both.
                 .zip(initial_physical.iter_mut().filter(|v| **v == max_virt))
                 .for_each(|(v, slot)| *slot = v);
+            if route_components {
+                let mut final_physical = initial_physical.clone();
+                let num_ops = routed
+                    .iter()
+                    .flatten()
+                    .map(|r| r.dag.num_ops())
+                    .sum::<usize>();
+                let num_edges = routed
+                    .iter()
+                    .flatten()
+                    .map(|r| r.dag.dag().edge_count())
+                    .sum::<usize>();
+                let mut out = dag.physical_empty_like_with_capacity(
+                    num_physical_qubits,
+                    num_ops,
+                    num_edges,
+                    BlocksMode::Drop,
+                )?;
+                for component in routed.into_iter().flatten() {
+                    for (initial, last) in component.moves {
+                        final_physical[last.index()] = initial_physical[initial.index()];
+                    }
+                    // The component only has the clbits it uses, all of which are in the full DAG.
+                    let clbits = component
+                        .dag
+                        .clbits()
+                        .objects()
+                        .iter()
+                        .map(|bit| {
+                            out.clbits()
+                                .find(bit)
+                                .expect("component clbits should be in the full DAG")
+                        })
+                        .collect::<Vec<_>>();
+                    out.compose(&component.dag, None, Some(&clbits), HashMap::new(), false)?;
+                }
+                disjoint_layout::combine_barriers(&mut out, false)?;
+                return Ok((
+                    out,
+                    NLayout::from_physical_to_virtual(initial_physical)
+                        .expect("all indices are valid"),
+                    NLayout::from_physical_to_virtual(final_physical)
+                        .expect("all indices are valid"),
+                ));
+            }
             let target = RoutingTarget::from_neighbors(Neighbors::from_coupling(&coupling));
             let problem = RoutingProblem {
                 target: &target,
@@ -344,6 +516,56 @@ pub fn sabre_layout_and_routing(
     }
 }
 
+/// A component of a disjoint circuit, routed on its own chip.
+struct RoutedComponent {
+    /// The routed circuit, on the physical qubits of the full target.  It only has the clbits that
+    /// the component uses.
+    dag: DAGCircuit,
+    /// The initial and final (full-target) physical qubits of each qubit of the component.
+    moves: Vec<(PhysicalQubit, PhysicalQubit)>,
+}
+
+/// Whether the components of a disjoint circuit can be routed separately and joined back together
+/// without changing the circuit.
+///
+/// Every operation must act within a single component, except for barriers, which are split
+/// between the components and rejoined, but which must not touch qubits outside all of them.  No
+/// classical bit may be shared between components, since the order of their operations on it would
+/// be lost.  Variables and control flow aren't handled by the recombination.
+fn components_are_separable(
+    dag: &DAGCircuit,
+    components: &[disjoint_layout::DisjointComponent],
+) -> bool {
+    if dag.vars_stretches_view().num_identifiers() > 0 || dag.num_blocks() > 0 {
+        return false;
+    }
+    let mut component_of = vec![None; dag.num_qubits()];
+    for (index, component) in components.iter().enumerate() {
+        for virt in &component.virtual_qubits {
+            component_of[virt.index()] = Some(index);
+        }
+    }
+    let mut clbits = HashSet::new();
+    if !components
+        .iter()
+        .flat_map(|component| component.sub_dag.clbits().objects())
+        .all(|clbit| clbits.insert(clbit))
+    {
+        return false;
+    }
+    dag.op_nodes(true).all(|(_, inst)| {
+        let qargs = dag.get_qargs(inst.qubits);
+        if let OperationRef::StandardInstruction(StandardInstruction::Barrier(_)) = inst.op.view() {
+            return qargs.iter().all(|q| component_of[q.index()].is_some());
+        }
+        let Some((first, rest)) = qargs.split_first() else {
+            return false;
+        };
+        let component = component_of[first.index()];
+        component.is_some() && rest.iter().all(|q| component_of[q.index()] == component)
+    })
+}
+
 fn layout_trial<'a>(
     problem: RoutingProblem<'a>,
     seed: u64,
@@ -351,7 +573,8 @@ fn layout_trial<'a>(
     num_swap_trials: usize,
     run_swap_in_parallel: bool,
     starting_layout: &'_ [Option<PhysicalQubit>],
-) -> RoutingResult<'a> {
+    race: Option<&TrialRace>,
+) -> Option<RoutingResult<'a>> {
     let num_physical_qubits: u32 = problem.target.neighbors.num_qubits().try_into().unwrap();
     let mut rng = Pcg64Mcg::seed_from_u64(seed);
 
@@ -407,15 +630,73 @@ fn layout_trial<'a>(
         }
         NLayout::from_vecs_unchecked(virt_to_phys, phys_to_virt)
     };
-    swap_map(
+    swap_map_raced(
         problem,
         &initial_layout,
         Some(seed),
         num_swap_trials,
         Some(run_swap_in_parallel),
+        race,
     )
 }
 
+/// Key to select the best layout trial, where abandoned trials sort after all complete ones.
+fn selection_key(result: Option<&RoutingResult>, index: usize) -> (bool, (u64, usize, usize)) {
+    match result {
+        Some(result) => (false, result.selection_key(index)),
+        None => (true, (u64::MAX, usize::MAX, index)),
+    }
+}
+
+/// Calculate the cost of a swap on each coupling of a routing target as the estimated
+/// `-ln(fidelity)` of the three applications of the best two-qubit gate on that coupling that
+/// make up the swap.
+///
+/// `physical_qubit` maps the qubits of the routing target onto the qubits of the full `target`.
+/// Couplings with no known error are given the mean cost of those with one.  Returns `None` if
+/// no coupling has a known error rate, in which case every swap should be treated equally.
+fn swap_costs_from_target(
+    target: &Target,
+    neighbors: &Neighbors,
+    physical_qubit: impl Fn(PhysicalQubit) -> PhysicalQubit,
+) -> Option<Array2<f64>> {
+    let num_qubits = neighbors.num_qubits();
+    let edge_error = |a: PhysicalQubit, b: PhysicalQubit| -> Option<f64> {
+        [[a, b], [b, a]]
+            .iter()
+            .filter_map(|qargs| {
+                let qargs: &[PhysicalQubit] = qargs;
+                let names = target.operation_names_for_qargs(qargs).ok()?;
+                names
+                    .into_iter()
+                    .filter_map(|name| target.get_error(name, qargs))
+                    .min_by(|a, b| a.total_cmp(b))
+            })
+            .min_by(|a, b| a.total_cmp(b))
+    };
+    let mut costs = Array2::from_elem((num_qubits, num_qubits), f64::NAN);
+    let mut total = 0.0;
+    let mut num_known = 0usize;
+    for a in (0..num_qubits as u32).map(PhysicalQubit::new) {
+        for &b in neighbors[a].iter().filter(|b| **b > a) {
+            if let Some(error) = edge_error(physical_qubit(a), physical_qubit(b)) {
+                let cost = 3.0 * neg_log_fidelity(error).min(f64::MAX / 3.0);
+                costs[[a.index(), b.index()]] = cost;
+                costs[[b.index(), a.index()]] = cost;
+                total += cost;
+                num_known += 1;
+            }
+        }
+    }
+    if num_known == 0 {
+        return None;
+    }
+    let mean = total / num_known as f64;
+    // Non-couplings are never used as swaps, but we fill them in so the whole matrix is finite.
+    costs.mapv_inplace(|cost| if cost.is_nan() { mean } else { cost });
+    Some(costs)
+}
+
 fn compute_dense_starting_layout(
     num_qubits: usize,
     target: &RoutingTarget,
@@ -512,3 +793,178 @@ fn add_heuristic_layouts(
         );
     }
 }
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use crate::target::InstructionProperties;
+    use qiskit_circuit::Qubit;
+    use qiskit_circuit::bit::QuantumRegister;
+    use qiskit_circuit::operations::{Operation, StandardGate};
+
+    use super::super::heuristic::SetScaling;
+
+    /// A line of qubits `0 - 1 - ... - n`, where the CX on each coupling has the given error.
+    fn line_target(errors: &[Option<f64>]) -> Target {
+        let mut target = Target::default();
+        let props = errors
+            .iter()
+            .enumerate()
+            .flat_map(|(i, error)| {
+                let (a, b) = (PhysicalQubit(i as u32), PhysicalQubit(i as u32 + 1));
+                [[a, b], [b, a]]
+                    .map(|qargs| (qargs.into(), Some(InstructionProperties::new(None, *error))))
+            })
+            .collect();
+        target
+            .add_instruction(StandardGate::CX.into(), None, None, Some(props))
+            .unwrap();
+        target
+    }
+
+    fn cx_dag(num_qubits: u32, pairs: &[[u32; 2]]) -> DAGCircuit {
+        let mut dag = DAGCircuit::new();
+        dag.add_qreg(QuantumRegister::new_owning("q", num_qubits))
+            .unwrap();
+        for [a, b] in pairs {
+            dag.apply_operation_back(
+                StandardGate::CX.into(),
+                &[Qubit(*a), Qubit(*b)],
+                &[],
+                None,
+                None,
+                #[cfg(feature = "cache_pygates")]
+                None,
+            )
+            .unwrap();
+        }
+        dag
+    }
+
+    fn heuristic() -> Heuristic {
+        Heuristic::new(None, None, None, Some(100), 1e-10)
+            .with_basic(1.0, SetScaling::Constant)
+            .with_lookahead(vec![0.5], SetScaling::Size)
+            .with_decay(0.001, 5)
+            .unwrap()
+    }
+
+    /// The name and physical qubits of every operation, in order of the nodes in the DAG.
+    fn operations(dag: &DAGCircuit) -> Vec<(String, Vec<Qubit>)> {
+        dag.op_nodes(true)
+            .map(|(_, inst)| {
+                (
+                    inst.op.name().to_owned(),
+                    dag.get_qargs(inst.qubits).to_vec(),
+                )
+            })
+            .collect()
+    }
+
+    fn swaps(dag: &DAGCircuit) -> Vec<Vec<Qubit>> {
+        operations(dag)
+            .into_iter()
+            .filter(|(name, _)| name == "swap")
+            .map(|(_, qubits)| qubits)
+            .collect()
+    }
+
+    fn run(
+        target: &Target,
+        dag: &DAGCircuit,
+        selection: TrialSelection,
+    ) -> (DAGCircuit, NLayout, NLayout) {
+        sabre_layout_and_routing_with_selection(
+            &mut dag.clone(),
+            target,
+            &heuristic(),
+            4,
+            8,
+            8,
+            Some(2025),
+            Vec::new(),
+            false,
+            selection,
+        )
+        .unwrap()
+    }
+
+    #[test]
+    fn test_race_selects_same_result() {
+        let target = line_target(&[Some(1e-2), Some(3e-3), Some(5e-2), Some(1e-3), Some(2e-2)]);
+        let dag = cx_dag(
+            6,
+            &[
+                [0, 5],
+                [1, 4],
+                [2, 3],
+                [0, 3],
+                [5, 1],
+                [4, 2],
+                [3, 0],
+                [1, 5],
+                [2, 4],
+            ],
+        );
+        for score_by_error in [false, true] {
+            let unraced = run(
+                &target,
+                &dag,
+                TrialSelection {
+                    score_by_error,
+                    race_margin: None,
+                },
+            );
+            let raced = run(
+                &target,
+                &dag,
+                TrialSelection {
+                    score_by_error,
+                    race_margin: Some(0.0),
+                },
+            );
+            assert_eq!(operations(&raced.0), operations(&unraced.0));
+            assert_eq!(raced.1, unraced.1);
+            assert_eq!(raced.2, unraced.2);
+        }
+    }
+
+    #[test]
+    fn test_swap_costs_prefer_low_error() {
+        let target = line_target(&[Some(0.2), Some(1e-4), None]);
+        let neighbors = Neighbors::from_coupling(&target.coupling_graph().unwrap());
+        let costs = swap_costs_from_target(&target, &neighbors, |q| q).unwrap();
+        assert_eq!(costs, costs.t());
+        assert!(costs[[0, 1]] > costs[[1, 2]]);
+        // The coupling with no known error costs the mean of the others.
+        assert_eq!(costs[[2, 3]], 0.5 * (costs[[0, 1]] + costs[[1, 2]]));
+
+        let target = line_target(&[None, None]);
+        let neighbors = Neighbors::from_coupling(&target.coupling_graph().unwrap());
+        assert!(swap_costs_from_target(&target, &neighbors, |q| q).is_none());
+    }
+
+    #[test]
+    fn test_score_by_error_avoids_bad_coupling() {
+        // Three qubits that all interact can't be laid out on a line without a swap.  Scored by
+        // error, the swap must go on the good coupling; counting swaps, either coupling will do.
+        let target = line_target(&[Some(0.2), Some(1e-4)]);
+        let dag = cx_dag(3, &[[0, 1], [1, 2], [2, 0]]);
+        let (routed, _, _) = run(
+            &target,
+            &dag,
+            TrialSelection {
+                score_by_error: true,
+                race_margin: Some(0.0),
+            },
+        );
+        let swaps = swaps(&routed);
+        assert!(!swaps.is_empty());
+        for qubits in swaps {
+            assert!(
+                qubits.contains(&Qubit(1)) && qubits.contains(&Qubit(2)),
+                "swap on {qubits:?}"
+            );
+        }
+    }
+}
@@ -22,7 +22,9 @@ use pyo3::wrap_pyfunction;
 
 pub(crate) use heuristic::Heuristic;
 pub(crate) use heuristic::SetScaling;
-pub use layout::sabre_layout_and_routing;
+pub use layout::{
+    TrialSelection, sabre_layout_and_routing, sabre_layout_and_routing_with_selection,
+};
 pub(crate) use route::sabre_routing;
 
 pub fn sabre(m: &Bound<PyModule>) -> PyResult<()> {
@@ -14,6 +14,7 @@ use std::cmp::Ordering;
 use std::collections::VecDeque;
 use std::convert::Infallible;
 use std::num::NonZero;
+use std::sync::atomic::{AtomicU64, Ordering as AtomicOrdering};
 
 use numpy::{PyArray2, ToPyArray};
 use pyo3::Python;
@@ -157,6 +158,9 @@ pub struct RoutingResult<'a> {
     /// The layout after the routing algorithm had finished.  This can be rederived from [order] and
     /// [initial_layout], but we get it for free anyway.
     pub final_layout: NLayout,
+    /// The total [RoutingTarget::swap_cost] of the swaps inserted at the top level.  If the target
+    /// has no swap costs, this is the same as the swap count.
+    score: f64,
 }
 impl RoutingResult<'_> {
     /// Count the number of swaps inserted at the top level (i.e. without recursing into
@@ -166,6 +170,23 @@ impl RoutingResult<'_> {
         self.order.swap_count()
     }
 
+    /// The total cost of the swaps inserted at the top level, as measured by
+    /// [RoutingTarget::swap_cost].
+    #[inline]
+    pub fn score(&self) -> f64 {
+        self.score
+    }
+
+    /// A totally ordered key to select the best of several results, breaking ties in favour of the
+    /// lowest trial index.
+    ///
+    /// Scores are always non-negative, and the IEEE 754 bit patterns of non-negative floats sort
+    /// in the same order as their values.
+    #[inline]
+    pub fn selection_key(&self, index: usize) -> (u64, usize, usize) {
+        (self.score.to_bits(), self.swap_count(), index)
+    }
+
     fn num_qubits(&self) -> usize {
         self.initial_layout.num_qubits()
     }
@@ -334,19 +355,80 @@ impl RoutingResult<'_> {
 pub struct RoutingTarget {
     pub neighbors: Neighbors,
     pub distance: Array2<f64>,
+    /// The cost of inserting a swap on each coupling, used to score complete routing trials
+    /// against each other.  If `None`, every swap has unit cost.
+    pub swap_costs: Option<Array2<f64>>,
 }
 impl RoutingTarget {
     pub fn from_neighbors(neighbors: Neighbors) -> Self {
         Self {
             distance: distance_matrix(&neighbors, usize::MAX, false, f64::NAN),
             neighbors,
+            swap_costs: None,
         }
     }
 
+    /// Set the costs used to score swaps on each coupling.  All costs must be non-negative and
+    /// finite.
+    pub fn with_swap_costs(mut self, swap_costs: Array2<f64>) -> Self {
+        debug_assert_eq!(swap_costs.dim(), self.distance.dim());
+        debug_assert!(swap_costs.iter().all(|x| x.is_finite() && *x >= 0.0));
+        self.swap_costs = Some(swap_costs);
+        self
+    }
+
     #[inline]
     pub fn num_qubits(&self) -> usize {
         self.neighbors.num_qubits()
     }
+
+    /// The cost of inserting the given swap.
+    #[inline]
+    pub fn swap_cost(&self, swap: [PhysicalQubit; 2]) -> f64 {
+        self.swap_costs
+            .as_ref()
+            .map_or(1.0, |costs| costs[[swap[0].index(), swap[1].index()]])
+    }
+}
+
+/// A bound shared between routing trials running concurrently, so each trial can give up as soon
+/// as it can no longer beat the best trial that has already completed.
+///
+/// Trial scores only ever increase as a trial progresses, so any trial whose partial score exceeds
+/// the best complete score is certain not to be selected.  Abandoning such trials early therefore
+/// never changes the selected result, it just saves the work.
+#[derive(Debug)]
+pub struct TrialRace {
+    /// Bit pattern of the best complete score seen so far.  Scores are non-negative, so their bit
+    /// patterns have the same order as their values.
+    best: AtomicU64,
+    /// The relative amount by which a partial score must exceed the best complete score before the
+    /// trial is abandoned.
+    margin: f64,
+}
+impl TrialRace {
+    /// Create a new race.  The `margin` must be non-negative.
+    pub fn new(margin: f64) -> Self {
+        assert!(margin >= 0.0, "race margin must be non-negative");
+        Self {
+            best: AtomicU64::new(f64::INFINITY.to_bits()),
+            margin,
+        }
+    }
+
+    /// Should a trial with the given partial score be abandoned?
+    #[inline]
+    pub fn should_abandon(&self, partial_score: f64) -> bool {
+        partial_score
+            > f64::from_bits(self.best.load(AtomicOrdering::Relaxed)) * (1.0 + self.margin)
+    }
+
+    /// Record the score of a trial that ran to completion.
+    #[inline]
+    pub fn complete(&self, score: f64) {
+        self.best
+            .fetch_min(score.to_bits(), AtomicOrdering::Relaxed);
+    }
 }
 
 /// Python wrapper for the Rust-space Sabre target object.
@@ -1000,7 +1082,8 @@ pub fn sabre_routing(
 }
 
 /// Run (potentially in parallel) several trials of the Sabre routing algorithm on the given
-/// problem and return the one with fewest swaps.
+/// problem and return the one with the lowest score (the fewest swaps, if the target has no swap
+/// costs).
 pub fn swap_map<'a>(
     problem: RoutingProblem<'a>,
     initial_layout: &'_ NLayout,
@@ -1008,6 +1091,30 @@ pub fn swap_map<'a>(
     num_trials: usize,
     run_in_parallel: Option<bool>,
 ) -> RoutingResult<'a> {
+    swap_map_raced(
+        problem,
+        initial_layout,
+        seed,
+        num_trials,
+        run_in_parallel,
+        None,
+    )
+    .expect("trials cannot be abandoned without a race")
+}
+
+/// Run several trials of the Sabre routing algorithm, as [swap_map], but abandoning any trial that
+/// falls behind the best complete trial in `race` (which may be shared with other calls).
+///
+/// Returns `None` if every trial was abandoned, which can only happen if the race is shared and
+/// some other trial has already completed with a better score.
+pub fn swap_map_raced<'a>(
+    problem: RoutingProblem<'a>,
+    initial_layout: &'_ NLayout,
+    seed: Option<u64>,
+    num_trials: usize,
+    run_in_parallel: Option<bool>,
+    race: Option<&TrialRace>,
+) -> Option<RoutingResult<'a>> {
     let seeds = match seed {
         Some(seed) => Pcg64Mcg::seed_from_u64(seed),
         None => Pcg64Mcg::try_from_rng(&mut SysRng).unwrap(),
@@ -1021,11 +1128,14 @@ pub fn swap_map<'a>(
         num_trials > 1
             && run_in_parallel.unwrap_or_else(|| getenv_use_multiple_threads() && num_trials > 1),
     )
-    .map(|seed| swap_map_trial(problem, initial_layout, seed))
+    .map(|seed| swap_map_trial_raced(problem, initial_layout, seed, race))
     .enumerate()
-    .min_by_key(|(index, result)| (result.order.swap_count(), *index))
-    .map(|(_, result)| result)
-    .expect("must have at least one trial")
+    // Abandoned trials sort after every complete trial.
+    .min_by_key(|(index, result)| match result {
+        Some(result) => (false, result.selection_key(*index)),
+        None => (true, (u64::MAX, usize::MAX, *index)),
+    })
+    .and_then(|(_, result)| result)
 }
 
 /// Run a single trial of the Sabre routing algorithm.
@@ -1034,7 +1144,20 @@ pub fn swap_map_trial<'a>(
     initial_layout: &NLayout,
     seed: u64,
 ) -> RoutingResult<'a> {
+    swap_map_trial_raced(problem, initial_layout, seed, None)
+        .expect("trials cannot be abandoned without a race")
+}
+
+/// Run a single trial of the Sabre routing algorithm, returning `None` if the trial was abandoned
+/// because it fell behind the best complete trial in the `race`.
+pub fn swap_map_trial_raced<'a>(
+    problem: RoutingProblem<'a>,
+    initial_layout: &NLayout,
+    seed: u64,
+    race: Option<&TrialRace>,
+) -> Option<RoutingResult<'a>> {
     let (mut state, mut order) = State::begin(problem, initial_layout.clone(), seed);
+    let mut score = 0.0;
 
     let mut routable_nodes = Vec::<NodeIndex>::with_capacity(2);
     let mut num_search_steps = 0;
@@ -1079,6 +1202,13 @@ pub fn swap_map_trial<'a>(
             let force_routed = state.force_enable_closest_node(problem, &mut current_swaps);
             routable_nodes.extend(force_routed);
         }
+        score += current_swaps
+            .iter()
+            .map(|swap| problem.target.swap_cost(*swap))
+            .sum::<f64>();
+        if race.is_some_and(|race| race.should_abandon(score)) {
+            return None;
+        }
         state.update_route(problem, &mut order, &routable_nodes, Some(current_swaps));
 
         if problem.heuristic.decay.is_some() {
@@ -1086,10 +1216,14 @@ pub fn swap_map_trial<'a>(
         }
         routable_nodes.clear();
     }
-    RoutingResult {
+    if let Some(race) = race {
+        race.complete(score);
+    }
+    Some(RoutingResult {
         problem,
         order,
         initial_layout: initial_layout.clone(),
         final_layout: state.layout,
-    }
+        score,
+    })
 }
@@ -12,6 +12,7 @@
 
 use super::TimeOps;
 use crate::TranspilerError;
+use crate::passes::schedule_analysis::dt_schedule::{DtDurations, run_alap_schedule_dt};
 use crate::passes::schedule_analysis::{NodeDurations, PyNodeDurations};
 use hashbrown::HashMap;
 use pyo3::prelude::*;
@@ -165,7 +166,10 @@ pub fn py_run_alap_schedule_analysis(
     // Get the first duration type
     let new_durations: NodeDurations = match &*node_durations {
         NodeDurations::Dt(node_durations) => {
-            run_alap_schedule_analysis(dag, clbit_write_latency, node_durations)?.into()
+            let durations = DtDurations::from_node_durations(dag, node_durations)?;
+            run_alap_schedule_dt(dag, clbit_write_latency, &durations)?
+                .to_node_start_times(dag)
+                .into()
         }
         NodeDurations::Seconds(node_durations) => {
             run_alap_schedule_analysis::<f64>(dag, clbit_write_latency as f64, node_durations)?
@@ -11,6 +11,7 @@
 // that they have been altered from the originals.
 
 use crate::TranspilerError;
+use crate::passes::schedule_analysis::dt_schedule::{DtDurations, run_asap_schedule_dt};
 use crate::passes::schedule_analysis::{NodeDurations, PyNodeDurations, TimeOps};
 use hashbrown::HashMap;
 use pyo3::prelude::*;
@@ -167,7 +168,10 @@ pub fn py_run_asap_schedule_analysis(
     // Get the first duration type
     let new_durations: NodeDurations = match &*node_durations {
         NodeDurations::Dt(node_durations) => {
-            run_asap_schedule_analysis(dag, clbit_write_latency, node_durations)?.into()
+            let durations = DtDurations::from_node_durations(dag, node_durations)?;
+            run_asap_schedule_dt(dag, clbit_write_latency, &durations)?
+                .to_node_start_times(dag)
+                .into()
         }
         NodeDurations::Seconds(node_durations) => {
             run_asap_schedule_analysis::<f64>(dag, clbit_write_latency as f64, node_durations)?
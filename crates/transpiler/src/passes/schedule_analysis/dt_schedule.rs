@@ -0,0 +1,760 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+//! Schedule analysis in integer units of `dt`.
+//!
+//! Durations are resolved once per distinct `(operation, qargs)` pair and stored densely by node
+//! index, along with how each node participates in scheduling, so the scheduling loops only do
+//! integer arithmetic over flat per-wire arrays.  Since every time is an exact integer, the start
+//! times are exact, and alignment to a `dt`-based grid never has to repair rounding error.
+
+use hashbrown::HashMap;
+use pyo3::prelude::*;
+use qiskit_circuit::dag_circuit::DAGCircuit;
+use qiskit_circuit::interner::Interned;
+use qiskit_circuit::operations::{
+    DelayUnit, Operation, OperationRef, Param, PyInstruction, PyOpKind, StandardInstruction,
+};
+use qiskit_circuit::packed_instruction::PackedInstruction;
+use qiskit_circuit::{PhysicalQubit, Qubit};
+use qiskit_util::IndexMap;
+use rustworkx_core::petgraph::prelude::NodeIndex;
+
+use crate::TranspilerError;
+use crate::target::Target;
+
+/// How an instruction takes part in scheduling.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum TimingKind {
+    /// A gate, which occupies only its qubits and is aligned to the pulse alignment.
+    Gate,
+    /// A delay, which occupies only its qubits.
+    Delay,
+    /// A measurement, which writes its clbits after the clbit write latency and is aligned to the
+    /// acquire alignment.
+    Measure,
+    /// A reset, which is aligned to the acquire alignment.
+    Reset,
+    /// Anything else, such as a barrier, which synchronizes all of its wires.
+    Other,
+}
+impl TimingKind {
+    fn of(inst: &PackedInstruction) -> Self {
+        match inst.op.view() {
+            OperationRef::StandardGate(_)
+            | OperationRef::PyCustom(PyInstruction {
+                kind: PyOpKind::Gate,
+                ..
+            }) => Self::Gate,
+            OperationRef::StandardInstruction(StandardInstruction::Delay(_)) => Self::Delay,
+            OperationRef::StandardInstruction(StandardInstruction::Measure) => Self::Measure,
+            OperationRef::StandardInstruction(StandardInstruction::Reset) => Self::Reset,
+            _ => Self::Other,
+        }
+    }
+
+    /// Whether the instruction is a gate or a delay, which occupy only their qubits.
+    #[inline]
+    pub fn is_gate_or_delay(&self) -> bool {
+        matches!(self, Self::Gate | Self::Delay)
+    }
+
+    /// Whether the instruction is aligned to the acquire alignment.
+    #[inline]
+    pub fn is_acquire(&self) -> bool {
+        matches!(self, Self::Measure | Self::Reset)
+    }
+}
+
+/// Convert a time in the given unit into an integer number of `dt`, rounding to the nearest.
+pub fn to_dt(value: f64, unit: DelayUnit, dt: f64) -> PyResult<u64> {
+    let seconds = match unit {
+        DelayUnit::DT => return Ok(value.round() as u64),
+        DelayUnit::S => value,
+        DelayUnit::MS => value * 1e-3,
+        DelayUnit::US => value * 1e-6,
+        DelayUnit::NS => value * 1e-9,
+        DelayUnit::PS => value * 1e-12,
+        DelayUnit::EXPR => {
+            return Err(TranspilerError::new_err(
+                "Cannot schedule a delay whose duration is an expression.",
+            ));
+        }
+    };
+    Ok((seconds / dt).round() as u64)
+}
+
+/// The duration in `dt` and [TimingKind] of every operation node in a DAG, indexed densely by
+/// node index.
+#[derive(Clone, Debug)]
+pub struct DtDurations {
+    durations: Vec<u64>,
+    kinds: Vec<TimingKind>,
+}
+impl DtDurations {
+    fn with_bound(dag: &DAGCircuit) -> Self {
+        let bound = dag.dag().node_bound();
+        Self {
+            durations: vec![0; bound],
+            kinds: vec![TimingKind::Other; bound],
+        }
+    }
+
+    /// Resolve the duration of every operation in a physical circuit from the instruction
+    /// properties of a [Target].
+    ///
+    /// Each distinct `(operation, qargs)` pair is only looked up in the [Target] once.  Delays are
+    /// converted from their own unit, and directives (such as barriers) take no time.  It is an
+    /// error for any other instruction not to have a duration in the [Target], or for the
+    /// [Target] not to define `dt`.
+    pub fn from_target(dag: &DAGCircuit, target: &Target) -> PyResult<Self> {
+        let dt = target.dt.ok_or_else(|| {
+            TranspilerError::new_err("The target must define 'dt' to schedule a circuit.")
+        })?;
+        let mut out = Self::with_bound(dag);
+        let mut resolved = HashMap::<(&str, Interned<[Qubit]>), u64>::new();
+        let mut qargs = Vec::<PhysicalQubit>::new();
+        for (node, inst) in dag.op_nodes(false) {
+            let op_view = inst.op.view();
+            let duration = match op_view {
+                OperationRef::StandardInstruction(StandardInstruction::Delay(unit)) => {
+                    let value = match inst.params_view().first() {
+                        Some(Param::Float(value)) => *value,
+                        Some(Param::Obj(value)) => Python::attach(|py| value.extract::<f64>(py))?,
+                        _ => {
+                            return Err(TranspilerError::new_err(
+                                "Cannot schedule a delay without a fixed duration.",
+                            ));
+                        }
+                    };
+                    to_dt(value, unit, dt)?
+                }
+                OperationRef::ControlFlow(_) => {
+                    return Err(TranspilerError::new_err(
+                        "Scheduling circuits containing control flow is not supported.",
+                    ));
+                }
+                _ if op_view.directive() => 0,
+                _ => match resolved.entry((op_view.name(), inst.qubits)) {
+                    hashbrown::hash_map::Entry::Occupied(entry) => *entry.get(),
+                    hashbrown::hash_map::Entry::Vacant(entry) => {
+                        qargs.clear();
+                        qargs.extend(
+                            dag.get_qargs(inst.qubits)
+                                .iter()
+                                .map(|q| PhysicalQubit::new(q.0)),
+                        );
+                        let seconds =
+                            target.get_duration(op_view.name(), &qargs).ok_or_else(|| {
+                                TranspilerError::new_err(format!(
+                                    "Duration of '{}' on qubits {:?} is not found in the target.",
+                                    op_view.name(),
+                                    qargs,
+                                ))
+                            })?;
+                        *entry.insert(to_dt(seconds, DelayUnit::S, dt)?)
+                    }
+                },
+            };
+            out.durations[node.index()] = duration;
+            out.kinds[node.index()] = TimingKind::of(inst);
+        }
+        Ok(out)
+    }
+
+    /// Take the durations from a mapping of node indices to durations in `dt`, which must contain
+    /// every operation node in the DAG.
+    pub fn from_node_durations(
+        dag: &DAGCircuit,
+        node_durations: &IndexMap<NodeIndex, u64>,
+    ) -> PyResult<Self> {
+        let mut out = Self::with_bound(dag);
+        for (node, inst) in dag.op_nodes(false) {
+            out.durations[node.index()] = *node_durations.get(&node).ok_or_else(|| {
+                TranspilerError::new_err(format!(
+                    "No duration found for node at index {}",
+                    node.index()
+                ))
+            })?;
+            out.kinds[node.index()] = TimingKind::of(inst);
+        }
+        Ok(out)
+    }
+
+    /// The duration of an operation node, in `dt`.
+    #[inline]
+    pub fn duration(&self, node: NodeIndex) -> u64 {
+        self.durations[node.index()]
+    }
+
+    /// How an operation node takes part in scheduling.
+    #[inline]
+    pub fn kind(&self, node: NodeIndex) -> TimingKind {
+        self.kinds[node.index()]
+    }
+}
+
+/// The start time of every operation node in a DAG, in `dt`, indexed densely by node index.
+#[derive(Clone, Debug)]
+pub struct DtSchedule {
+    start_times: Vec<u64>,
+}
+impl DtSchedule {
+    /// The start time of an operation node.
+    #[inline]
+    pub fn start(&self, node: NodeIndex) -> u64 {
+        self.start_times[node.index()]
+    }
+
+    /// Set the start time of an operation node.
+    #[inline]
+    pub fn set_start(&mut self, node: NodeIndex, start: u64) {
+        self.start_times[node.index()] = start;
+    }
+
+    /// The time at which the last operation in the DAG ends.
+    pub fn circuit_duration(&self, dag: &DAGCircuit, durations: &DtDurations) -> u64 {
+        dag.op_nodes(false)
+            .map(|(node, _)| self.start(node) + durations.duration(node))
+            .max()
+            .unwrap_or(0)
+    }
+
+    /// Convert into a mapping of node index to start time, in topological order.
+    pub fn to_node_start_times(&self, dag: &DAGCircuit) -> IndexMap<NodeIndex, u64> {
+        dag.topological_op_nodes(false)
+            .map(|node| (node, self.start(node)))
+            .collect()
+    }
+}
+
+fn check_physical(dag: &DAGCircuit, pass: &str) -> PyResult<()> {
+    if dag.qregs().len() != 1 || !dag.qregs_data().contains_key("q") {
+        return Err(TranspilerError::new_err(format!(
+            "{pass} schedule runs on physical circuits only"
+        )));
+    }
+    Ok(())
+}
+
+/// Schedule every instruction in a physical circuit as soon as possible.
+///
+/// This has the same semantics as [run_asap_schedule_analysis](super::asap_schedule_analysis::run_asap_schedule_analysis),
+/// but works with exact integer times.
+pub fn run_asap_schedule_dt(
+    dag: &DAGCircuit,
+    clbit_write_latency: u64,
+    durations: &DtDurations,
+) -> PyResult<DtSchedule> {
+    check_physical(dag, "ASAP")?;
+    let mut schedule = DtSchedule {
+        start_times: vec![0; dag.dag().node_bound()],
+    };
+    let mut qubit_idle_after = vec![0u64; dag.num_qubits()];
+    let mut clbit_idle_after = vec![0u64; dag.num_clbits()];
+    for node in dag.topological_op_nodes(false) {
+        let inst = dag[node].unwrap_operation();
+        let qargs = dag.get_qargs(inst.qubits);
+        let cargs = dag.get_cargs(inst.clbits);
+        let kind = durations.kind(node);
+        let t0q = qargs
+            .iter()
+            .map(|q| qubit_idle_after[q.index()])
+            .fold(0, u64::max);
+        let t0c = cargs
+            .iter()
+            .map(|c| clbit_idle_after[c.index()])
+            .fold(0, u64::max);
+        let t0 = match kind {
+            _ if kind.is_gate_or_delay() => t0q,
+            // There is no actual clbit access until `clbit_write_latency` after the start of a
+            // measurement, so it can start that much before its clbits are free.
+            TimingKind::Measure => t0q.max(t0c.saturating_sub(clbit_write_latency)),
+            _ => t0q.max(t0c),
+        };
+        let t1 = t0 + durations.duration(node);
+        if kind == TimingKind::Measure {
+            for c in cargs {
+                clbit_idle_after[c.index()] = t1;
+            }
+        }
+        for q in qargs {
+            qubit_idle_after[q.index()] = t1;
+        }
+        schedule.set_start(node, t0);
+    }
+    Ok(schedule)
+}
+
+/// Schedule every instruction in a physical circuit as late as possible.
+///
+/// This has the same semantics as [run_alap_schedule_analysis](super::alap_schedule_analysis::run_alap_schedule_analysis),
+/// but works with exact integer times.
+pub fn run_alap_schedule_dt(
+    dag: &DAGCircuit,
+    clbit_write_latency: u64,
+    durations: &DtDurations,
+) -> PyResult<DtSchedule> {
+    check_physical(dag, "ALAP")?;
+    // Nodes are packed from the end of the circuit in reverse topological order, so we first
+    // calculate the time from each node's _end_ to the end of the circuit, then flip it.
+    let mut schedule = DtSchedule {
+        start_times: vec![0; dag.dag().node_bound()],
+    };
+    let mut qubit_idle_before = vec![0u64; dag.num_qubits()];
+    let mut clbit_idle_before = vec![0u64; dag.num_clbits()];
+    for node in dag.topological_op_nodes(true) {
+        let inst = dag[node].unwrap_operation();
+        let qargs = dag.get_qargs(inst.qubits);
+        let cargs = dag.get_cargs(inst.clbits);
+        let kind = durations.kind(node);
+        let mut t0 = qargs
+            .iter()
+            .map(|q| qubit_idle_before[q.index()])
+            .fold(0, u64::max);
+        if !kind.is_gate_or_delay() {
+            t0 = cargs
+                .iter()
+                .map(|c| clbit_idle_before[c.index()])
+                .fold(t0, u64::max);
+        }
+        let t1 = t0 + durations.duration(node);
+        if kind == TimingKind::Measure {
+            // Clbit time is always right (ALAP) justified.
+            for c in cargs {
+                clbit_idle_before[c.index()] = t1.saturating_sub(clbit_write_latency);
+            }
+        }
+        for q in qargs {
+            qubit_idle_before[q.index()] = t1;
+        }
+        schedule.set_start(node, t1);
+    }
+    let circuit_duration = qubit_idle_before
+        .iter()
+        .chain(clbit_idle_before.iter())
+        .copied()
+        .fold(0, u64::max);
+    for (node, _) in dag.op_nodes(false) {
+        let t1 = schedule.start(node);
+        schedule.set_start(node, circuit_duration - t1);
+    }
+    Ok(schedule)
+}
+
+#[cfg(all(test, not(miri)))]
+mod test {
+    use super::*;
+    use crate::passes::pad_schedule::align_start_times;
+    use crate::passes::schedule_analysis::alap_schedule_analysis::run_alap_schedule_analysis;
+    use crate::passes::schedule_analysis::asap_schedule_analysis::run_asap_schedule_analysis;
+    use crate::target::InstructionProperties;
+    use qiskit_circuit::Clbit;
+    use qiskit_circuit::bit::{ClassicalRegister, QuantumRegister};
+    use qiskit_circuit::instruction::Parameters;
+    use qiskit_circuit::operations::StandardGate;
+    use qiskit_circuit::packed_instruction::PackedOperation;
+
+    // An awkward `dt`, so that no duration in seconds is a whole number of `dt`.
+    const DT: f64 = 2.0e-9 / 9.0;
+    const MEASURE: StandardInstruction = StandardInstruction::Measure;
+
+    fn physical_dag(num_qubits: u32, num_clbits: u32) -> DAGCircuit {
+        let mut dag = DAGCircuit::new();
+        dag.add_qreg(QuantumRegister::new_owning("q", num_qubits))
+            .unwrap();
+        dag.add_creg(ClassicalRegister::new_owning("c", num_clbits))
+            .unwrap();
+        dag
+    }
+
+    fn apply(
+        dag: &mut DAGCircuit,
+        op: PackedOperation,
+        params: &[f64],
+        qubits: &[u32],
+        clbits: &[u32],
+    ) -> NodeIndex {
+        let qubits = qubits.iter().map(|q| Qubit(*q)).collect::<Vec<_>>();
+        let clbits = clbits.iter().map(|c| Clbit(*c)).collect::<Vec<_>>();
+        let params = (!params.is_empty())
+            .then(|| Parameters::Params(params.iter().map(|p| Param::Float(*p)).collect()));
+        dag.apply_operation_back(
+            op,
+            &qubits,
+            &clbits,
+            params,
+            None,
+            #[cfg(feature = "cache_pygates")]
+            None,
+        )
+        .unwrap()
+    }
+
+    /// A three-qubit target whose durations, in seconds, are not whole numbers of `dt`.
+    fn target() -> Target {
+        let mut target = Target::default();
+        target.dt = Some(DT);
+        let single = |duration: f64| {
+            Some(
+                (0..3)
+                    .map(|q| {
+                        (
+                            [PhysicalQubit(q)].into(),
+                            Some(InstructionProperties::new(Some(duration), None)),
+                        )
+                    })
+                    .collect(),
+            )
+        };
+        target
+            .add_instruction(StandardGate::SX.into(), None, None, single(35.6e-9))
+            .unwrap();
+        target
+            .add_instruction(
+                StandardInstruction::Measure.into(),
+                None,
+                None,
+                single(1.5e-6),
+            )
+            .unwrap();
+        target
+            .add_instruction(
+                StandardInstruction::Reset.into(),
+                None,
+                None,
+                single(1.1e-6),
+            )
+            .unwrap();
+        let cx = [((0, 1), 300.3e-9), ((1, 2), 410.1e-9)]
+            .into_iter()
+            .map(|((a, b), duration)| {
+                (
+                    [PhysicalQubit(a), PhysicalQubit(b)].into(),
+                    Some(InstructionProperties::new(Some(duration), None)),
+                )
+            })
+            .collect();
+        target
+            .add_instruction(StandardGate::CX.into(), None, None, Some(cx))
+            .unwrap();
+        target
+    }
+
+    /// A circuit for [target] with gates, a delay in nanoseconds, a barrier, a reset and
+    /// measurements sharing a clbit.
+    fn target_dag() -> DAGCircuit {
+        let mut dag = physical_dag(3, 2);
+        apply(&mut dag, StandardGate::SX.into(), &[], &[0], &[]);
+        apply(&mut dag, StandardGate::SX.into(), &[], &[1], &[]);
+        apply(&mut dag, StandardGate::CX.into(), &[], &[0, 1], &[]);
+        apply(&mut dag, StandardGate::CX.into(), &[], &[1, 2], &[]);
+        apply(&mut dag, StandardGate::CX.into(), &[], &[0, 1], &[]);
+        let delay = StandardInstruction::Delay(DelayUnit::NS);
+        apply(&mut dag, delay.into(), &[100.0], &[2], &[]);
+        apply(&mut dag, MEASURE.into(), &[], &[0], &[0]);
+        apply(
+            &mut dag,
+            StandardInstruction::Barrier(3).into(),
+            &[],
+            &[0, 1, 2],
+            &[],
+        );
+        apply(&mut dag, MEASURE.into(), &[], &[1], &[0]);
+        apply(&mut dag, StandardInstruction::Reset.into(), &[], &[2], &[]);
+        apply(&mut dag, MEASURE.into(), &[], &[2], &[1]);
+        apply(&mut dag, StandardGate::SX.into(), &[], &[0], &[]);
+        dag
+    }
+
+    /// The durations of every operation node in [target_dag], in seconds, as the float scheduling
+    /// path expects them.
+    fn target_durations_seconds(dag: &DAGCircuit, target: &Target) -> IndexMap<NodeIndex, f64> {
+        dag.topological_op_nodes(false)
+            .map(|node| {
+                let inst = dag[node].unwrap_operation();
+                let op = inst.op.view();
+                let qargs = dag
+                    .get_qargs(inst.qubits)
+                    .iter()
+                    .map(|q| PhysicalQubit(q.0))
+                    .collect::<Vec<_>>();
+                let duration = match op {
+                    OperationRef::StandardInstruction(StandardInstruction::Delay(_)) => 100e-9,
+                    _ if op.directive() => 0.0,
+                    _ => target.get_duration(op.name(), &qargs).unwrap(),
+                };
+                (node, duration)
+            })
+            .collect()
+    }
+
+    /// The start times of a schedule as floats, in the order of `expected`.
+    fn start_times(schedule: &DtSchedule, expected: &IndexMap<NodeIndex, f64>) -> Vec<f64> {
+        expected
+            .keys()
+            .map(|node| schedule.start(*node) as f64)
+            .collect()
+    }
+
+    #[test]
+    fn test_to_dt_rounding() {
+        assert_eq!(to_dt(12.4, DelayUnit::DT, DT).unwrap(), 12);
+        assert_eq!(to_dt(12.5, DelayUnit::DT, DT).unwrap(), 13);
+        // 100ns is 450.0000...01 dt and 35.6ns is 160.2 dt.
+        assert_eq!(to_dt(100.0, DelayUnit::NS, DT).unwrap(), 450);
+        assert_eq!(to_dt(0.1, DelayUnit::US, DT).unwrap(), 450);
+        assert_eq!(to_dt(35.6e-9, DelayUnit::S, DT).unwrap(), 160);
+        assert_eq!(to_dt(35.7e-9, DelayUnit::S, DT).unwrap(), 161);
+        assert!(to_dt(1.0, DelayUnit::EXPR, DT).is_err());
+    }
+
+    #[test]
+    fn test_durations_from_target() {
+        let target = target();
+        let dag = target_dag();
+        let durations = DtDurations::from_target(&dag, &target).unwrap();
+        let nodes = dag.topological_op_nodes(false).collect::<Vec<_>>();
+        // Each `(operation, qargs)` pair is only looked up once, but the cache must not mix up
+        // the same gate on different qubits.
+        let expected = [
+            (160, TimingKind::Gate),
+            (160, TimingKind::Gate),
+            (1351, TimingKind::Gate),
+            (1845, TimingKind::Gate),
+            (1351, TimingKind::Gate),
+            (450, TimingKind::Delay),
+            (6750, TimingKind::Measure),
+            (0, TimingKind::Other),
+            (6750, TimingKind::Measure),
+            (4950, TimingKind::Reset),
+            (6750, TimingKind::Measure),
+            (160, TimingKind::Gate),
+        ];
+        assert_eq!(nodes.len(), expected.len());
+        for (node, (duration, kind)) in nodes.iter().zip(expected) {
+            assert_eq!(durations.duration(*node), duration);
+            assert_eq!(durations.kind(*node), kind);
+        }
+
+        // The durations agree with the seconds used by the float path, to within rounding.
+        let seconds = target_durations_seconds(&dag, &target);
+        for (node, duration) in &seconds {
+            assert!((durations.duration(*node) as f64 * DT - duration).abs() <= DT / 2.0);
+        }
+    }
+
+    #[test]
+    fn test_durations_from_target_errors() {
+        let dag = target_dag();
+        let mut no_dt = target();
+        no_dt.dt = None;
+        assert!(DtDurations::from_target(&dag, &no_dt).is_err());
+
+        // There is no `cx` on qubits (0, 2).
+        let mut dag = physical_dag(3, 0);
+        apply(&mut dag, StandardGate::CX.into(), &[], &[0, 2], &[]);
+        assert!(DtDurations::from_target(&dag, &target()).is_err());
+    }
+
+    #[test]
+    fn test_target_schedule_matches_float() {
+        let target = target();
+        let dag = target_dag();
+        let durations = DtDurations::from_target(&dag, &target).unwrap();
+        let seconds = target_durations_seconds(&dag, &target);
+        // The same durations, rounded to `dt` but as floats, which the float path schedules
+        // exactly.
+        let rounded = seconds
+            .keys()
+            .map(|node| (*node, durations.duration(*node) as f64))
+            .collect::<IndexMap<_, _>>();
+        for latency in [0, 800] {
+            let asap = run_asap_schedule_dt(&dag, latency, &durations).unwrap();
+            let alap = run_alap_schedule_dt(&dag, latency, &durations).unwrap();
+            let float_asap = run_asap_schedule_analysis(&dag, latency as f64, &rounded).unwrap();
+            let float_alap = run_alap_schedule_analysis(&dag, latency as f64, &rounded).unwrap();
+            assert_eq!(
+                start_times(&asap, &float_asap),
+                float_asap.values().copied().collect::<Vec<_>>()
+            );
+            assert_eq!(
+                start_times(&alap, &float_alap),
+                float_alap.values().copied().collect::<Vec<_>>()
+            );
+
+            // Scheduling in seconds instead only differs by the rounding of each duration.
+            let float_asap =
+                run_asap_schedule_analysis(&dag, latency as f64 * DT, &seconds).unwrap();
+            let float_alap =
+                run_alap_schedule_analysis(&dag, latency as f64 * DT, &seconds).unwrap();
+            let tolerance = seconds.len() as f64 * DT / 2.0;
+            for (schedule, float) in [(&asap, &float_asap), (&alap, &float_alap)] {
+                for (node, start) in float {
+                    assert!((schedule.start(*node) as f64 * DT - start).abs() <= tolerance);
+                }
+            }
+        }
+    }
+
+    #[test]
+    fn test_node_durations_schedule_matches_float() {
+        let mut dag = physical_dag(2, 1);
+        let nodes = [
+            apply(&mut dag, StandardGate::H.into(), &[], &[0], &[]),
+            apply(&mut dag, StandardGate::CX.into(), &[], &[0, 1], &[]),
+            apply(&mut dag, MEASURE.into(), &[], &[0], &[0]),
+            apply(&mut dag, StandardGate::X.into(), &[], &[1], &[]),
+            apply(&mut dag, StandardGate::X.into(), &[], &[1], &[]),
+            apply(&mut dag, MEASURE.into(), &[], &[1], &[0]),
+            apply(
+                &mut dag,
+                StandardInstruction::Barrier(2).into(),
+                &[],
+                &[0, 1],
+                &[],
+            ),
+            apply(&mut dag, StandardGate::H.into(), &[], &[0], &[]),
+        ];
+        let node_durations = nodes
+            .iter()
+            .zip([7, 0, 1000, 3, 5, 1000, 0, 7])
+            .map(|(node, duration)| (*node, duration))
+            .collect::<IndexMap<_, u64>>();
+        let durations = DtDurations::from_node_durations(&dag, &node_durations).unwrap();
+        let float_durations = node_durations
+            .iter()
+            .map(|(node, duration)| (*node, *duration as f64))
+            .collect::<IndexMap<_, _>>();
+        for latency in [0, 10, 2000] {
+            let asap = run_asap_schedule_dt(&dag, latency, &durations).unwrap();
+            let float_asap =
+                run_asap_schedule_analysis(&dag, latency as f64, &float_durations).unwrap();
+            assert_eq!(
+                start_times(&asap, &float_asap),
+                float_asap.values().copied().collect::<Vec<_>>()
+            );
+            let alap = run_alap_schedule_dt(&dag, latency, &durations).unwrap();
+            let float_alap =
+                run_alap_schedule_analysis(&dag, latency as f64, &float_durations).unwrap();
+            assert_eq!(
+                start_times(&alap, &float_alap),
+                float_alap.values().copied().collect::<Vec<_>>()
+            );
+            // The mapping back to node start times is in topological order, like the float ASAP
+            // schedule.
+            assert_eq!(
+                asap.to_node_start_times(&dag)
+                    .into_iter()
+                    .collect::<Vec<_>>(),
+                float_asap
+                    .iter()
+                    .map(|(node, start)| (*node, *start as u64))
+                    .collect::<Vec<_>>()
+            );
+        }
+
+        // Directives don't need a duration, but every other node does.
+        let mut missing = node_durations.clone();
+        missing.swap_remove(&nodes[6]);
+        assert!(DtDurations::from_node_durations(&dag, &missing).is_ok());
+        missing.swap_remove(&nodes[3]);
+        assert!(DtDurations::from_node_durations(&dag, &missing).is_err());
+    }
+
+    #[test]
+    fn test_alignment() {
+        let target = target();
+        let dag = target_dag();
+        let durations = DtDurations::from_target(&dag, &target).unwrap();
+        let latency = 800;
+        for (pulse_alignment, acquire_alignment) in [(1, 1), (16, 16), (16, 64), (7, 3)] {
+            let unaligned = run_alap_schedule_dt(&dag, latency, &durations).unwrap();
+            let mut aligned = unaligned.clone();
+            align_start_times(
+                &dag,
+                &mut aligned,
+                &durations,
+                latency,
+                pulse_alignment,
+                acquire_alignment,
+            );
+            let mut qubit_idle_after = [0; 3];
+            for node in dag.topological_op_nodes(false) {
+                let start = aligned.start(node);
+                // Instructions are only ever pushed later, onto their grid.
+                assert!(start >= unaligned.start(node));
+                match durations.kind(node) {
+                    TimingKind::Gate => assert_eq!(start % pulse_alignment as u64, 0),
+                    TimingKind::Measure | TimingKind::Reset => {
+                        assert_eq!(start % acquire_alignment as u64, 0)
+                    }
+                    TimingKind::Delay | TimingKind::Other => (),
+                }
+                // No two instructions overlap on a qubit.
+                for q in dag.get_qargs(dag[node].unwrap_operation().qubits) {
+                    assert!(start >= qubit_idle_after[q.index()]);
+                    qubit_idle_after[q.index()] = start + durations.duration(node);
+                }
+            }
+            // Without constraints, a valid schedule is left as it is.
+            if pulse_alignment == 1 && acquire_alignment == 1 {
+                for node in dag.topological_op_nodes(false) {
+                    assert_eq!(aligned.start(node), unaligned.start(node));
+                }
+            }
+        }
+
+        // When every duration is already a multiple of the alignments, an ASAP schedule is already
+        // aligned.
+        let mut dag = physical_dag(2, 1);
+        let nodes = [
+            apply(&mut dag, StandardGate::SX.into(), &[], &[0], &[]),
+            apply(&mut dag, StandardGate::CX.into(), &[], &[0, 1], &[]),
+            apply(&mut dag, MEASURE.into(), &[], &[1], &[0]),
+        ];
+        let node_durations = nodes
+            .iter()
+            .zip([64, 320, 1024])
+            .map(|(node, duration)| (*node, duration))
+            .collect::<IndexMap<_, u64>>();
+        let durations = DtDurations::from_node_durations(&dag, &node_durations).unwrap();
+        let asap = run_asap_schedule_dt(&dag, 0, &durations).unwrap();
+        let mut aligned = asap.clone();
+        align_start_times(&dag, &mut aligned, &durations, 0, 16, 64);
+        for node in nodes {
+            assert_eq!(aligned.start(node), asap.start(node));
+        }
+        assert_eq!(nodes.map(|node| aligned.start(node)), [0, 64, 384]);
+    }
+
+    #[test]
+    fn test_reset_alignment() {
+        // Like `ConstrainedReschedule`, resets are aligned to the acquire alignment, the same as
+        // measurements, rather than to the pulse alignment.
+        let mut dag = physical_dag(1, 1);
+        let nodes = [
+            apply(&mut dag, StandardGate::SX.into(), &[], &[0], &[]),
+            apply(&mut dag, StandardInstruction::Reset.into(), &[], &[0], &[]),
+            apply(&mut dag, MEASURE.into(), &[], &[0], &[0]),
+        ];
+        let node_durations = nodes
+            .iter()
+            .zip([100, 500, 1000])
+            .map(|(node, duration)| (*node, duration))
+            .collect::<IndexMap<_, u64>>();
+        let durations = DtDurations::from_node_durations(&dag, &node_durations).unwrap();
+        let mut aligned = run_asap_schedule_dt(&dag, 0, &durations).unwrap();
+        align_start_times(&dag, &mut aligned, &durations, 0, 16, 64);
+        assert_eq!(nodes.map(|node| aligned.start(node)), [0, 128, 640]);
+    }
+}
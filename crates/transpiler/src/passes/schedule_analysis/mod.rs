@@ -12,6 +12,7 @@
 
 pub mod alap_schedule_analysis;
 pub mod asap_schedule_analysis;
+pub mod dt_schedule;
 
 use std::ops::{
     Add, AddAssign, Deref, DerefMut, Div, DivAssign, Mul, MulAssign, Rem, RemAssign, Sub, SubAssign,
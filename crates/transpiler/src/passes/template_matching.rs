@@ -0,0 +1,751 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+use std::cmp::Reverse;
+use std::collections::VecDeque;
+
+use hashbrown::{HashMap, HashSet};
+use num_complex::Complex64;
+use pyo3::prelude::*;
+use pyo3::wrap_pyfunction;
+use rayon::prelude::*;
+use rustworkx_core::petgraph::Direction;
+use rustworkx_core::petgraph::stable_graph::NodeIndex;
+use rustworkx_core::petgraph::visit::{EdgeRef, IntoEdgeReferences};
+use smallvec::{SmallVec, smallvec};
+use thiserror::Error;
+
+use crate::TranspilerError;
+use qiskit_circuit::circuit_data::{CircuitData, PyCircuitData};
+use qiskit_circuit::dag_circuit::{DAGCircuit, DAGError, NodeType, Wire};
+use qiskit_circuit::instruction::Parameters;
+use qiskit_circuit::operations::{Operation, Param, StandardGate};
+use qiskit_circuit::packed_instruction::PackedOperation;
+use qiskit_circuit::{BlocksMode, Qubit, VarsMode};
+use qiskit_synthesis::matrix::sim::sim_unitary_circuit;
+use qiskit_util::getenv_use_multiple_threads;
+
+/// The maximum number of qubits of a template.  Templates are simulated to check that they are
+/// equivalent to the identity.
+pub const MAX_TEMPLATE_QUBITS: usize = 10;
+/// The number of operation nodes of a DAG above which it is matched in parallel.
+const PARALLEL_THRESHOLD: usize = 1000;
+/// The tolerance when comparing gate parameters.
+const PARAM_TOLERANCE: f64 = 1e-10;
+/// The tolerance when checking that a template is equivalent to the identity.
+const IDENTITY_TOLERANCE: f64 = 1e-8;
+
+#[derive(Error, Debug)]
+pub enum TemplateError {
+    #[error("templates can only contain standard gates with numeric parameters")]
+    UnsupportedInstruction,
+    #[error("the template has {0} qubits, more than the maximum of {MAX_TEMPLATE_QUBITS}")]
+    TooManyQubits(usize),
+    #[error("the template is not equivalent to the identity")]
+    NotIdentity,
+}
+
+/// A gate of a template, on the qubits of the template.
+#[derive(Clone, Debug)]
+struct TemplateGate {
+    gate: StandardGate,
+    params: SmallVec<[f64; 3]>,
+    qubits: SmallVec<[u32; 2]>,
+}
+
+impl TemplateGate {
+    fn inverse(&self) -> Option<TemplateGate> {
+        let params: SmallVec<[Param; 3]> = self.params.iter().map(|p| Param::Float(*p)).collect();
+        let (gate, params) = self.gate.inverse(&params)?;
+        Some(TemplateGate {
+            gate,
+            params: params
+                .iter()
+                .map(|p| match p {
+                    Param::Float(p) => Some(*p),
+                    _ => None,
+                })
+                .collect::<Option<_>>()?,
+            qubits: self.qubits.clone(),
+        })
+    }
+
+    /// The key of the gate when deduplicating patterns.
+    fn key(&self) -> (StandardGate, SmallVec<[u64; 3]>, SmallVec<[u32; 2]>) {
+        (
+            self.gate,
+            self.params.iter().map(|p| p.to_bits()).collect(),
+            self.qubits.clone(),
+        )
+    }
+}
+
+/// The cost of a sequence of gates, compared lexicographically: the number of multi-qubit gates,
+/// then the number of gates.
+fn cost(gates: &[TemplateGate]) -> (isize, isize) {
+    let multi_qubit = gates.iter().filter(|gate| gate.qubits.len() > 1).count();
+    (multi_qubit as isize, gates.len() as isize)
+}
+
+/// A part of a template that is replaced by the inverse of the rest of the template.
+struct Pattern {
+    /// The gates to match, on the qubits `0..num_qubits`, in an order where every gate after the
+    /// first shares a qubit with an earlier gate.
+    gates: Vec<TemplateGate>,
+    num_qubits: usize,
+    /// The gates replacing a match of the pattern, on the same qubits.
+    replacement: Vec<TemplateGate>,
+    /// The global phase of the replacement.
+    phase: f64,
+    /// How much cheaper the replacement is than the pattern, see [cost].
+    gain: (isize, isize),
+    /// The number of each gate in `gates`, to skip the patterns that cannot match a DAG.
+    gate_counts: Vec<(StandardGate, usize)>,
+}
+
+/// A set of templates, indexed for [run_template_optimization].
+///
+/// A template is a circuit equivalent to the identity.  Any contiguous part of a template, in
+/// cyclic order, is equivalent to the inverse of the rest of the template, so each part that is
+/// more expensive than the rest is stored as a pattern to replace.  Patterns are indexed by their
+/// first gate, and store the number of each gate they contain and their number of qubits, so
+/// that only the patterns that can fit in a DAG are tried.  Identical patterns coming from
+/// different templates are only stored once.
+#[pyclass(module = "qiskit._accelerate.template_matching")]
+#[derive(Default)]
+pub struct TemplateLibrary {
+    num_templates: usize,
+    patterns: Vec<Pattern>,
+    by_first_gate: HashMap<StandardGate, Vec<usize>>,
+    seen: HashSet<Vec<(StandardGate, SmallVec<[u64; 3]>, SmallVec<[u32; 2]>)>>,
+}
+
+#[pymethods]
+impl TemplateLibrary {
+    #[new]
+    fn py_new(templates: Vec<PyRef<PyCircuitData>>) -> PyResult<Self> {
+        let mut library = TemplateLibrary::default();
+        for template in &templates {
+            library
+                .add_template(template)
+                .map_err(|e| TranspilerError::new_err(e.to_string()))?;
+        }
+        Ok(library)
+    }
+
+    fn __len__(&self) -> usize {
+        self.num_templates
+    }
+}
+
+impl TemplateLibrary {
+    /// The number of templates added to the library.
+    pub fn num_templates(&self) -> usize {
+        self.num_templates
+    }
+
+    /// The number of patterns indexed from the templates.
+    pub fn num_patterns(&self) -> usize {
+        self.patterns.len()
+    }
+
+    /// Add a template to the library.
+    ///
+    /// The template must only contain standard gates with numeric parameters, and be equivalent
+    /// to the identity up to a global phase.
+    pub fn add_template(&mut self, template: &CircuitData) -> Result<(), TemplateError> {
+        let num_qubits = template.num_qubits();
+        if num_qubits > MAX_TEMPLATE_QUBITS {
+            return Err(TemplateError::TooManyQubits(num_qubits));
+        }
+        let gates = template
+            .data()
+            .iter()
+            .map(|inst| {
+                let gate = inst
+                    .op
+                    .try_standard_gate()
+                    .ok_or(TemplateError::UnsupportedInstruction)?;
+                let params = inst
+                    .params_view()
+                    .iter()
+                    .map(|param| match param {
+                        Param::Float(param) => Ok(*param),
+                        _ => Err(TemplateError::UnsupportedInstruction),
+                    })
+                    .collect::<Result<_, _>>()?;
+                let qubits = template
+                    .get_qargs(inst.qubits)
+                    .iter()
+                    .map(|q| q.0)
+                    .collect();
+                Ok(TemplateGate {
+                    gate,
+                    params,
+                    qubits,
+                })
+            })
+            .collect::<Result<Vec<_>, TemplateError>>()?;
+
+        let Param::Float(template_phase) = template.global_phase() else {
+            return Err(TemplateError::UnsupportedInstruction);
+        };
+        let unitary = sim_unitary_circuit(template).map_err(|_| TemplateError::NotIdentity)?;
+        let phase = unitary[[0, 0]];
+        if (phase.norm() - 1.0).abs() > IDENTITY_TOLERANCE
+            || unitary.indexed_iter().any(|((i, j), value)| {
+                let expected = if i == j { phase } else { Complex64::ZERO };
+                (value - expected).norm() > IDENTITY_TOLERANCE
+            })
+        {
+            return Err(TemplateError::NotIdentity);
+        }
+        self.num_templates += 1;
+
+        // The gates of the template, without its global phase, multiply to the identity up to
+        // `phase.arg() - template_phase`.
+        let num_gates = gates.len();
+        for length in 1..=num_gates {
+            for start in 0..num_gates {
+                let part: Vec<TemplateGate> = (0..length)
+                    .map(|i| gates[(start + i) % num_gates].clone())
+                    .collect();
+                let rest: Vec<TemplateGate> = (length..num_gates)
+                    .map(|i| gates[(start + i) % num_gates].clone())
+                    .collect();
+                self.add_pattern(part, &rest, phase.arg() - template_phase);
+            }
+        }
+        Ok(())
+    }
+
+    /// Add the pattern replacing `part` by the inverse of `rest`, if it is cheaper.
+    ///
+    /// `rest` followed by `part` is equivalent to the identity up to a global phase `phase`.
+    fn add_pattern(&mut self, mut part: Vec<TemplateGate>, rest: &[TemplateGate], phase: f64) {
+        let Some(mut replacement) = rest
+            .iter()
+            .rev()
+            .map(TemplateGate::inverse)
+            .collect::<Option<Vec<_>>>()
+        else {
+            return;
+        };
+        let (part_cost, replacement_cost) = (cost(&part), cost(&replacement));
+        let gain = (
+            part_cost.0 - replacement_cost.0,
+            part_cost.1 - replacement_cost.1,
+        );
+        if gain <= (0, 0) {
+            return;
+        }
+
+        // Relabel the qubits in order of first use, so that a pattern found in several templates
+        // or several positions of a template is only stored once.
+        let mut relabel = [u32::MAX; MAX_TEMPLATE_QUBITS];
+        let mut num_qubits = 0;
+        for gate in part.iter_mut() {
+            for qubit in gate.qubits.iter_mut() {
+                if relabel[*qubit as usize] == u32::MAX {
+                    relabel[*qubit as usize] = num_qubits;
+                    num_qubits += 1;
+                }
+                *qubit = relabel[*qubit as usize];
+            }
+        }
+        for gate in replacement.iter_mut() {
+            for qubit in gate.qubits.iter_mut() {
+                // The replacement must not act on qubits the match doesn't determine.
+                if relabel[*qubit as usize] == u32::MAX {
+                    return;
+                }
+                *qubit = relabel[*qubit as usize];
+            }
+        }
+        let Some(gates) = connected_order(part) else {
+            return;
+        };
+        if !self
+            .seen
+            .insert(gates.iter().map(TemplateGate::key).collect())
+        {
+            return;
+        }
+
+        let mut gate_counts: Vec<(StandardGate, usize)> = Vec::new();
+        for gate in &gates {
+            match gate_counts
+                .iter_mut()
+                .find(|(other, _)| *other == gate.gate)
+            {
+                Some((_, count)) => *count += 1,
+                None => gate_counts.push((gate.gate, 1)),
+            }
+        }
+        self.by_first_gate
+            .entry(gates[0].gate)
+            .or_default()
+            .push(self.patterns.len());
+        self.patterns.push(Pattern {
+            gates,
+            num_qubits: num_qubits as usize,
+            replacement,
+            phase,
+            gain,
+            gate_counts,
+        });
+    }
+}
+
+/// Reorder `gates`, keeping the order of the gates on each qubit, so that every gate after the
+/// first shares a qubit with an earlier gate.  Returns `None` if the gates are not connected.
+fn connected_order(gates: Vec<TemplateGate>) -> Option<Vec<TemplateGate>> {
+    let mut remaining: Vec<Option<TemplateGate>> = gates.into_iter().map(Some).collect();
+    let mut out: Vec<TemplateGate> = Vec::with_capacity(remaining.len());
+    let mut touched = [false; MAX_TEMPLATE_QUBITS];
+    while out.len() < remaining.len() {
+        let mut blocked = [false; MAX_TEMPLATE_QUBITS];
+        let mut next = None;
+        for (i, gate) in remaining.iter().enumerate() {
+            let Some(gate) = gate else {
+                continue;
+            };
+            let ready = gate.qubits.iter().all(|q| !blocked[*q as usize]);
+            let connected = out.is_empty() || gate.qubits.iter().any(|q| touched[*q as usize]);
+            if ready && connected {
+                next = Some(i);
+                break;
+            }
+            // Later gates on these qubits have to wait for this one.
+            for q in &gate.qubits {
+                blocked[*q as usize] = true;
+            }
+        }
+        let gate = remaining[next?].take().unwrap();
+        for q in &gate.qubits {
+            touched[*q as usize] = true;
+        }
+        out.push(gate);
+    }
+    Some(out)
+}
+
+/// A match of a pattern in a DAG.
+struct Match {
+    pattern: usize,
+    /// The matched nodes, in the order of the gates of the pattern.
+    nodes: Vec<NodeIndex>,
+    /// The DAG qubit of each qubit of the pattern.
+    qubits: SmallVec<[Qubit; 4]>,
+}
+
+/// The qubits of `node` if it is an application of `gate`.
+fn gate_qubits<'a>(
+    dag: &'a DAGCircuit,
+    node: NodeIndex,
+    gate: &TemplateGate,
+) -> Option<&'a [Qubit]> {
+    let NodeType::Operation(inst) = &dag[node] else {
+        return None;
+    };
+    if inst.op.try_standard_gate()? != gate.gate {
+        return None;
+    }
+    let params_match = inst
+        .params_view()
+        .iter()
+        .zip(&gate.params)
+        .all(|(param, expected)| {
+            matches!(param, Param::Float(param) if (param - expected).abs() <= PARAM_TOLERANCE)
+        });
+    params_match.then(|| dag.get_qargs(inst.qubits))
+}
+
+/// The next node after `node` on the wire of `qubit`.
+fn wire_successor(dag: &DAGCircuit, node: NodeIndex, qubit: Qubit) -> Option<NodeIndex> {
+    dag.dag()
+        .edges_directed(node, Direction::Outgoing)
+        .find(|edge| *edge.weight() == Wire::Qubit(qubit))
+        .map(|edge| edge.target())
+}
+
+/// Match `pattern` in `dag`, with its first gate on `start`.
+///
+/// The gates of the pattern on each qubit must be consecutive on the matched wire of the DAG, so
+/// the match is found by following the wires from `start`, without any search.
+fn match_pattern(
+    dag: &DAGCircuit,
+    start: NodeIndex,
+    pattern: &Pattern,
+    pattern_index: usize,
+) -> Option<Match> {
+    let mut qubits: SmallVec<[Option<Qubit>; 4]> = smallvec![None; pattern.num_qubits];
+    let mut last: SmallVec<[NodeIndex; 4]> = smallvec![start; pattern.num_qubits];
+    let mut nodes = Vec::with_capacity(pattern.gates.len());
+    for (i, gate) in pattern.gates.iter().enumerate() {
+        let node = if i == 0 {
+            start
+        } else {
+            let anchor = *gate
+                .qubits
+                .iter()
+                .find(|q| qubits[**q as usize].is_some())
+                .expect("every gate after the first shares a qubit with an earlier gate");
+            wire_successor(dag, last[anchor as usize], qubits[anchor as usize]?)?
+        };
+        let node_qubits = gate_qubits(dag, node, gate)?;
+        for (qubit, node_qubit) in gate.qubits.iter().zip(node_qubits) {
+            let qubit = *qubit as usize;
+            match qubits[qubit] {
+                Some(mapped) => {
+                    if mapped != *node_qubit
+                        || wire_successor(dag, last[qubit], mapped) != Some(node)
+                    {
+                        return None;
+                    }
+                }
+                None => {
+                    if qubits.contains(&Some(*node_qubit)) {
+                        return None;
+                    }
+                    qubits[qubit] = Some(*node_qubit);
+                }
+            }
+            last[qubit] = node;
+        }
+        nodes.push(node);
+    }
+    Some(Match {
+        pattern: pattern_index,
+        nodes,
+        qubits: qubits.into_iter().map(|q| q.unwrap()).collect(),
+    })
+}
+
+/// Run the native template optimization pass on `dag`.
+///
+/// Every part of a template of `library` that appears in the DAG is replaced by the inverse of the
+/// rest of the template, when that is cheaper, counting first the multi-qubit gates and then all
+/// gates.  The gates of a part on each qubit must be consecutive on the wires of the DAG; unlike
+/// the Python ``TemplateOptimization`` pass, gates are not moved through commuting gates to find
+/// more matches.
+///
+/// The best match starting at each node is searched independently, in parallel for large DAGs,
+/// trying only the patterns whose first gate is the gate of the node and whose gates all appear
+/// in the DAG.  Overlapping matches are resolved greedily by gain, and all the matches are
+/// replaced in a single rebuild of the DAG.  A match that would introduce a cycle, because a path
+/// of the DAG leaves and re-enters it, is left unchanged.
+///
+/// Returns the number of replaced matches.
+pub fn run_template_optimization(
+    dag: &mut DAGCircuit,
+    library: &TemplateLibrary,
+) -> Result<usize, DAGError> {
+    let op_counts = dag.get_op_counts();
+    let active: Vec<bool> = library
+        .patterns
+        .iter()
+        .map(|pattern| {
+            pattern.num_qubits <= dag.num_qubits()
+                && pattern
+                    .gate_counts
+                    .iter()
+                    .all(|(gate, count)| op_counts.get(gate.name()).is_some_and(|n| n >= count))
+        })
+        .collect();
+    if !active.iter().any(|active| *active) {
+        return Ok(0);
+    }
+
+    let nodes: Vec<NodeIndex> = dag.topological_op_nodes(false).collect();
+    let dag_ref: &DAGCircuit = dag;
+    let best_match = |node: &NodeIndex| -> Option<Match> {
+        let NodeType::Operation(inst) = &dag_ref[*node] else {
+            return None;
+        };
+        library
+            .by_first_gate
+            .get(&inst.op.try_standard_gate()?)?
+            .iter()
+            .filter(|pattern| active[**pattern])
+            .filter_map(|pattern| {
+                match_pattern(dag_ref, *node, &library.patterns[*pattern], *pattern)
+            })
+            .max_by_key(|found| library.patterns[found.pattern].gain)
+    };
+    let matches: Vec<Match> = if nodes.len() >= PARALLEL_THRESHOLD && getenv_use_multiple_threads()
+    {
+        nodes.par_iter().filter_map(best_match).collect()
+    } else {
+        nodes.iter().filter_map(best_match).collect()
+    };
+
+    // The sort is stable, so matches with the same gain are taken in topological order.
+    let mut order: Vec<usize> = (0..matches.len()).collect();
+    order.sort_by_key(|i| Reverse(library.patterns[matches[*i].pattern].gain));
+    let mut taken = vec![false; dag.dag().node_bound()];
+    let mut accepted: Vec<&Match> = Vec::new();
+    for i in order {
+        let found = &matches[i];
+        if found.nodes.iter().any(|node| taken[node.index()]) {
+            continue;
+        }
+        for node in &found.nodes {
+            taken[node.index()] = true;
+        }
+        accepted.push(found);
+    }
+    if accepted.is_empty() {
+        return Ok(0);
+    }
+
+    let (out, num_replaced) = replace_matches(dag, library, &nodes, &accepted)?;
+    *dag = out;
+    Ok(num_replaced)
+}
+
+/// Rebuild `dag` with `matches` replaced, returning the new DAG and the number of replacements.
+///
+/// The nodes are emitted in a topological order of the DAG with each match contracted to a single
+/// unit.  If that order gets stuck, the remaining units form a cycle through a match that is not
+/// convex, so the match with the lowest priority that is left is emitted node by node instead.
+fn replace_matches(
+    dag: &DAGCircuit,
+    library: &TemplateLibrary,
+    topological_order: &[NodeIndex],
+    matches: &[&Match],
+) -> Result<(DAGCircuit, usize), DAGError> {
+    let graph = dag.dag();
+    let bound = graph.node_bound();
+    let is_op = |node: NodeIndex| matches!(graph[node], NodeType::Operation(_));
+    // The unit each node is emitted in: the node itself, or its match.  Matches are numbered
+    // after the nodes.
+    let mut unit_of: Vec<usize> = (0..bound).collect();
+    for (i, found) in matches.iter().enumerate() {
+        for node in &found.nodes {
+            unit_of[node.index()] = bound + i;
+        }
+    }
+    // There is one entry per edge, so multiple wires between two units are all counted.
+    let mut in_degree = vec![0usize; bound + matches.len()];
+    for edge in graph.edge_references() {
+        if is_op(edge.source()) && is_op(edge.target()) {
+            let (source, target) = (
+                unit_of[edge.source().index()],
+                unit_of[edge.target().index()],
+            );
+            if source != target {
+                in_degree[target] += 1;
+            }
+        }
+    }
+    let mut ready = VecDeque::new();
+    let mut seen = vec![false; bound + matches.len()];
+    let mut num_left = 0;
+    for node in topological_order {
+        let unit = unit_of[node.index()];
+        if !seen[unit] {
+            seen[unit] = true;
+            num_left += 1;
+            if in_degree[unit] == 0 {
+                ready.push_back(unit);
+            }
+        }
+    }
+
+    let mut out = dag
+        .copy_empty_like_with_same_capacity(VarsMode::Alike, BlocksMode::Keep)
+        .into_builder();
+    let mut emitted = vec![false; bound + matches.len()];
+    let mut num_replaced = matches.len();
+    loop {
+        while let Some(unit) = ready.pop_front() {
+            emitted[unit] = true;
+            num_left -= 1;
+            let single = [NodeIndex::new(unit)];
+            let members: &[NodeIndex] = if unit < bound {
+                out.push_back(graph[single[0]].unwrap_operation().clone())?;
+                &single
+            } else {
+                let found = matches[unit - bound];
+                let pattern = &library.patterns[found.pattern];
+                for gate in &pattern.replacement {
+                    let qubits: SmallVec<[Qubit; 2]> = gate
+                        .qubits
+                        .iter()
+                        .map(|q| found.qubits[*q as usize])
+                        .collect();
+                    out.apply_operation_back(
+                        PackedOperation::from_standard_gate(gate.gate),
+                        &qubits,
+                        &[],
+                        (!gate.params.is_empty()).then(|| {
+                            Parameters::Params(
+                                gate.params.iter().map(|p| Param::Float(*p)).collect(),
+                            )
+                        }),
+                        None,
+                        #[cfg(feature = "cache_pygates")]
+                        None,
+                    )?;
+                }
+                out.add_global_phase(&Param::Float(pattern.phase))?;
+                &found.nodes
+            };
+            for node in members {
+                for successor in graph.neighbors_directed(*node, Direction::Outgoing) {
+                    if !is_op(successor) {
+                        continue;
+                    }
+                    let next = unit_of[successor.index()];
+                    if next != unit {
+                        in_degree[next] -= 1;
+                        if in_degree[next] == 0 {
+                            ready.push_back(next);
+                        }
+                    }
+                }
+            }
+        }
+        if num_left == 0 {
+            break;
+        }
+        let stuck = (0..matches.len())
+            .rev()
+            .find(|i| unit_of[matches[*i].nodes[0].index()] == bound + i && !emitted[bound + i])
+            .expect("the DAG without contracted matches is acyclic");
+        num_replaced -= 1;
+        num_left += matches[stuck].nodes.len() - 1;
+        for node in &matches[stuck].nodes {
+            unit_of[node.index()] = node.index();
+        }
+        for node in &matches[stuck].nodes {
+            let unit = node.index();
+            in_degree[unit] = graph
+                .edges_directed(*node, Direction::Incoming)
+                .filter(|edge| is_op(edge.source()) && !emitted[unit_of[edge.source().index()]])
+                .count();
+            if in_degree[unit] == 0 {
+                ready.push_back(unit);
+            }
+        }
+    }
+    Ok((out.build(), num_replaced))
+}
+
+#[pyfunction]
+#[pyo3(name = "template_optimization")]
+pub fn py_run_template_optimization(
+    dag: &mut DAGCircuit,
+    library: &TemplateLibrary,
+) -> PyResult<usize> {
+    Ok(run_template_optimization(dag, library)?)
+}
+
+pub fn template_matching_mod(m: &Bound<PyModule>) -> PyResult<()> {
+    m.add_wrapped(wrap_pyfunction!(py_run_template_optimization))?;
+    m.add_class::<TemplateLibrary>()?;
+    Ok(())
+}
+
+#[cfg(all(test, not(miri)))]
+mod test {
+    use super::*;
+
+    fn circuit(num_qubits: u32, gates: &[(StandardGate, &[u32])]) -> CircuitData {
+        CircuitData::from_standard_gates(
+            num_qubits,
+            gates.iter().map(|(gate, qubits)| {
+                (
+                    *gate,
+                    smallvec![],
+                    qubits.iter().map(|q| Qubit(*q)).collect(),
+                )
+            }),
+            Param::Float(0.0),
+        )
+        .unwrap()
+    }
+
+    #[test]
+    fn test_rejects_non_identity() {
+        let mut library = TemplateLibrary::default();
+        let template = circuit(2, &[(StandardGate::CX, &[0, 1]), (StandardGate::H, &[0])]);
+        assert!(matches!(
+            library.add_template(&template),
+            Err(TemplateError::NotIdentity)
+        ));
+        assert_eq!(library.num_templates(), 0);
+    }
+
+    #[test]
+    fn test_replaces_cheaper_part() {
+        // H S S H X = I up to a phase, so H S S H can be replaced by X.
+        let mut library = TemplateLibrary::default();
+        let template = circuit(
+            1,
+            &[
+                (StandardGate::H, &[0]),
+                (StandardGate::S, &[0]),
+                (StandardGate::S, &[0]),
+                (StandardGate::H, &[0]),
+                (StandardGate::X, &[0]),
+            ],
+        );
+        library.add_template(&template).unwrap();
+        let qc = circuit(
+            2,
+            &[
+                (StandardGate::CX, &[0, 1]),
+                (StandardGate::H, &[1]),
+                (StandardGate::S, &[1]),
+                (StandardGate::S, &[1]),
+                (StandardGate::H, &[1]),
+                (StandardGate::CX, &[0, 1]),
+            ],
+        );
+        let mut dag = DAGCircuit::from_circuit_data(&qc, false, None, None, None, None).unwrap();
+        assert_eq!(run_template_optimization(&mut dag, &library).unwrap(), 1);
+        let counts = dag.get_op_counts();
+        assert_eq!(counts.get("x"), Some(&1));
+        assert_eq!(counts.get("cx"), Some(&2));
+        assert_eq!(dag.num_ops(), 3);
+        let expected = sim_unitary_circuit(&qc).unwrap();
+        let result = sim_unitary_circuit(&CircuitData::from_dag_ref(&dag).unwrap()).unwrap();
+        for (a, b) in expected.iter().zip(result.iter()) {
+            assert!((a - b).norm() < 1e-10);
+        }
+    }
+
+    #[test]
+    fn test_match_must_be_consecutive_on_wires() {
+        let mut library = TemplateLibrary::default();
+        let template = circuit(
+            2,
+            &[(StandardGate::CX, &[0, 1]), (StandardGate::CX, &[0, 1])],
+        );
+        library.add_template(&template).unwrap();
+        let qc = circuit(
+            2,
+            &[
+                (StandardGate::CX, &[0, 1]),
+                (StandardGate::H, &[1]),
+                (StandardGate::CX, &[0, 1]),
+                (StandardGate::CX, &[1, 0]),
+                (StandardGate::CX, &[1, 0]),
+            ],
+        );
+        let mut dag = DAGCircuit::from_circuit_data(&qc, false, None, None, None, None).unwrap();
+        assert_eq!(run_template_optimization(&mut dag, &library).unwrap(), 1);
+        assert_eq!(dag.num_ops(), 3);
+    }
+}
@@ -0,0 +1,304 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+use std::sync::{Arc, LazyLock, Mutex};
+
+use hashbrown::HashMap;
+use rustworkx_core::petgraph::visit::EdgeRef;
+use rustworkx_core::token_swapper::token_swapper;
+use thiserror::Error;
+
+use crate::neighbors::Neighbors;
+use crate::target::{Target, TargetCouplingError};
+use crate::transpile_layout::TranspileLayout;
+use qiskit_circuit::dag_circuit::{DAGCircuit, DAGError};
+use qiskit_circuit::operations::StandardGate;
+use qiskit_circuit::packed_instruction::PackedOperation;
+use qiskit_circuit::{PhysicalQubit, Qubit};
+use qiskit_util::getenv_use_multiple_threads;
+
+/// The maximum number of swap plans kept in the cache.  The cache is cleared when full.
+const PLAN_CACHE_CAPACITY: usize = 128;
+
+/// A sequence of swaps between physical qubits, applied in order.
+pub type SwapPlan = Arc<[[PhysicalQubit; 2]]>;
+
+#[derive(Error, Debug)]
+pub enum TokenSwappingError {
+    #[error("target contains multi-qubit operations")]
+    MultiQ,
+    #[error("the permutation acts on {0} qubits, but the target has {1}")]
+    MismatchedQubits(usize, usize),
+    #[error("the permutation cannot be implemented on the coupling graph of the target")]
+    MapNotPossible,
+    #[error(transparent)]
+    Dag(#[from] DAGError),
+}
+
+/// The key of the swap plan cache.
+///
+/// Permutations with the same moved qubits and destinations have the same plan, whatever the
+/// number of fixed qubits, so only the moved qubits are stored.  The coupling graph is stored
+/// as its sorted list of undirected edges, or `None` for all-to-all connectivity.
+#[derive(Clone, Debug, PartialEq, Eq, Hash)]
+struct PlanKey {
+    edges: Option<Vec<[u32; 2]>>,
+    moves: Vec<[u32; 2]>,
+    trials: usize,
+    seed: Option<u64>,
+}
+
+static PLAN_CACHE: LazyLock<Mutex<HashMap<PlanKey, SwapPlan>>> =
+    LazyLock::new(|| Mutex::new(HashMap::new()));
+
+/// Synthesize a sequence of swaps implementing a permutation on the coupling graph of a target.
+///
+/// `mapping[i]` is the physical qubit that the state on physical qubit `i` must be moved to.
+/// Each swap in the returned plan acts on two qubits that are coupled in the target.
+///
+/// The plan is found with the approximate token swapping algorithm of [1], running `trials`
+/// randomized trials and keeping the shortest plan.  The trials run in parallel for large
+/// coupling graphs, unless multithreading is disabled.  Plans are cached by coupling graph, the
+/// qubits moved by `mapping`, `trials` and `seed`, so restoring the same layout again (for
+/// example, across a batch of circuits routed with the same seed) does not search again.  For
+/// targets with all-to-all connectivity, the permutation is decomposed into cycles directly.
+///
+/// # References
+///
+/// [1]: Miltzow et al., "Approximation and hardness of token swapping", ESA (2016).
+///      [arXiv:1602.05150](https://arxiv.org/abs/1602.05150)
+pub fn synth_permutation_token_swapper(
+    target: &Target,
+    mapping: &[PhysicalQubit],
+    trials: usize,
+    seed: Option<u64>,
+) -> Result<SwapPlan, TokenSwappingError> {
+    let coupling = match target.coupling_graph() {
+        Ok(coupling) => Some(coupling),
+        Err(TargetCouplingError::AllToAll) => None,
+        Err(TargetCouplingError::MultiQ(_)) => return Err(TokenSwappingError::MultiQ),
+    };
+    if let Some(coupling) = coupling.as_ref()
+        && coupling.node_count() != mapping.len()
+    {
+        return Err(TokenSwappingError::MismatchedQubits(
+            mapping.len(),
+            coupling.node_count(),
+        ));
+    }
+    let moves: Vec<[u32; 2]> = mapping
+        .iter()
+        .enumerate()
+        .filter(|(source, destination)| destination.index() != *source)
+        .map(|(source, destination)| [source as u32, destination.0])
+        .collect();
+    if moves.is_empty() {
+        return Ok(Arc::new([]));
+    }
+    let key = PlanKey {
+        edges: coupling.as_ref().map(|coupling| {
+            let mut edges: Vec<[u32; 2]> = coupling
+                .edge_references()
+                .map(|edge| {
+                    let (a, b) = (edge.source().index() as u32, edge.target().index() as u32);
+                    [a.min(b), a.max(b)]
+                })
+                .collect();
+            edges.sort_unstable();
+            edges
+        }),
+        moves,
+        trials,
+        seed,
+    };
+    if let Some(plan) = PLAN_CACHE.lock().unwrap().get(&key) {
+        return Ok(plan.clone());
+    }
+
+    let plan: SwapPlan = match coupling {
+        Some(coupling) => {
+            let neighbors = Neighbors::from_coupling(&coupling);
+            // Disable the parallel trials by setting the threshold beyond any graph size.
+            let parallel_threshold = (!getenv_use_multiple_threads()).then_some(usize::MAX);
+            token_swapper(
+                &neighbors,
+                key.moves
+                    .iter()
+                    .map(|[source, destination]| {
+                        (PhysicalQubit(*source), PhysicalQubit(*destination))
+                    })
+                    .collect(),
+                Some(trials.max(1)),
+                seed,
+                parallel_threshold,
+            )
+            .map_err(|_| TokenSwappingError::MapNotPossible)?
+            .into_iter()
+            .map(|(l, r)| {
+                [
+                    PhysicalQubit::new(l.index() as u32),
+                    PhysicalQubit::new(r.index() as u32),
+                ]
+            })
+            .collect()
+        }
+        None => cycle_swaps(mapping).into(),
+    };
+
+    let mut cache = PLAN_CACHE.lock().unwrap();
+    if cache.len() >= PLAN_CACHE_CAPACITY {
+        cache.clear();
+    }
+    cache.insert(key, plan.clone());
+    Ok(plan)
+}
+
+/// Decompose a permutation into swaps along its cycles, for all-to-all connectivity.
+fn cycle_swaps(mapping: &[PhysicalQubit]) -> Vec<[PhysicalQubit; 2]> {
+    let mut swaps = Vec::new();
+    let mut visited = vec![false; mapping.len()];
+    for start in 0..mapping.len() {
+        if visited[start] {
+            continue;
+        }
+        // Walking backwards along the cycle, each swap moves one state to its destination.
+        let mut current = start;
+        visited[start] = true;
+        while mapping[current].index() != start {
+            let next = mapping[current].index();
+            visited[next] = true;
+            swaps.push([
+                PhysicalQubit::new(start as u32),
+                PhysicalQubit::new(next as u32),
+            ]);
+            current = next;
+        }
+    }
+    swaps
+}
+
+/// Run the RestoreFinalLayout pass on a physical `dag`.
+///
+/// This appends swaps along the coupling graph of `target` that undo the output permutation of
+/// `transpile_layout`, typically introduced by routing, so that every qubit ends the circuit on
+/// the physical qubit it started on.  The swaps are found by
+/// [synth_permutation_token_swapper], and the output permutation of `transpile_layout` is
+/// updated to account for them.
+///
+/// Returns the number of swaps added.
+pub fn run_restore_final_layout(
+    dag: &mut DAGCircuit,
+    target: &Target,
+    transpile_layout: &mut TranspileLayout,
+    trials: usize,
+    seed: Option<u64>,
+) -> Result<usize, TokenSwappingError> {
+    let Some(permutation) = transpile_layout.output_permutation() else {
+        return Ok(0);
+    };
+    if permutation.len() != dag.num_qubits() {
+        return Err(TokenSwappingError::MismatchedQubits(
+            permutation.len(),
+            dag.num_qubits(),
+        ));
+    }
+    // The state that started on qubit `i` is now on `permutation[i]`, and has to go back to `i`.
+    let mut mapping = vec![PhysicalQubit(0); permutation.len()];
+    for (start, current) in permutation.iter().enumerate() {
+        mapping[current.index()] = PhysicalQubit::new(start as u32);
+    }
+    let plan = synth_permutation_token_swapper(target, &mapping, trials, seed)?;
+
+    let mut position: Vec<Qubit> = (0..dag.num_qubits() as u32).map(Qubit).collect();
+    for [a, b] in plan.iter() {
+        dag.apply_operation_back(
+            PackedOperation::from_standard_gate(StandardGate::Swap),
+            &[Qubit(a.0), Qubit(b.0)],
+            &[],
+            None,
+            None,
+            #[cfg(feature = "cache_pygates")]
+            None,
+        )?;
+        position.swap(a.index(), b.index());
+    }
+    // `position[p]` holds the qubit whose state ends on `p`, so invert it to get where each
+    // qubit's state goes.
+    let mut destination = vec![Qubit(0); position.len()];
+    for (p, q) in position.iter().enumerate() {
+        destination[q.index()] = Qubit::new(p);
+    }
+    transpile_layout.add_permutation_inside(|q| destination[q.index()]);
+    Ok(plan.len())
+}
+
+#[cfg(all(test, not(miri)))]
+mod test {
+    use super::*;
+
+    fn line_target(num_qubits: u32) -> Target {
+        let mut target = Target::default();
+        let props = (0..num_qubits - 1)
+            .flat_map(|i| [[i, i + 1], [i + 1, i]])
+            .map(|[a, b]| ([PhysicalQubit(a), PhysicalQubit(b)].into(), None))
+            .collect();
+        target
+            .add_instruction(StandardGate::CX.into(), None, None, Some(props))
+            .unwrap();
+        target
+    }
+
+    fn apply(plan: &[[PhysicalQubit; 2]], num_qubits: usize) -> Vec<usize> {
+        let mut position: Vec<usize> = (0..num_qubits).collect();
+        for [a, b] in plan {
+            position.swap(a.index(), b.index());
+        }
+        position
+    }
+
+    #[test]
+    fn test_line_reversal() {
+        let target = line_target(6);
+        let mapping: Vec<PhysicalQubit> = (0..6).rev().map(PhysicalQubit).collect();
+        let plan = synth_permutation_token_swapper(&target, &mapping, 4, Some(7)).unwrap();
+        for [a, b] in plan.iter() {
+            assert_eq!(a.index().abs_diff(b.index()), 1);
+        }
+        // `position[p]` is the state ending on `p`.
+        let position = apply(&plan, 6);
+        for (p, start) in position.iter().enumerate() {
+            assert_eq!(mapping[*start].index(), p);
+        }
+        let again = synth_permutation_token_swapper(&target, &mapping, 4, Some(7)).unwrap();
+        assert!(Arc::ptr_eq(&plan, &again));
+    }
+
+    #[test]
+    fn test_cycle_swaps() {
+        let mapping: Vec<PhysicalQubit> =
+            [2, 0, 1, 3, 5, 4].into_iter().map(PhysicalQubit).collect();
+        let plan = cycle_swaps(&mapping);
+        assert_eq!(plan.len(), 3);
+        let position = apply(&plan, 6);
+        for (p, start) in position.iter().enumerate() {
+            assert_eq!(mapping[*start].index(), p);
+        }
+    }
+
+    #[test]
+    fn test_identity_has_empty_plan() {
+        let target = line_target(4);
+        let mapping: Vec<PhysicalQubit> = (0..4).map(PhysicalQubit).collect();
+        let plan = synth_permutation_token_swapper(&target, &mapping, 4, None).unwrap();
+        assert!(plan.is_empty());
+    }
+}
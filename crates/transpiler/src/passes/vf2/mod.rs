@@ -14,6 +14,7 @@ mod error_map;
 mod vf2_layout;
 
 pub use error_map::{ErrorMap, error_map_mod};
+pub(crate) use vf2_layout::neg_log_fidelity;
 pub use vf2_layout::{
     Vf2PassConfiguration, Vf2PassReturn, vf2_layout_mod, vf2_layout_pass_average,
     vf2_layout_pass_exact,
@@ -451,7 +451,7 @@ impl<T> VirtualInteractions<T> {
 /// This treats `nan` as `0.0`, and clamps errors to the `[0.0, 1.0]` interval.  An error of `1.0`
 /// should arguably have an infinite cost, but we use `f64::MAX` instead so the score is guaranteed
 /// to be finite, and safe to multiply by any other floating-point value.
-fn neg_log_fidelity(error: f64) -> f64 {
+pub(crate) fn neg_log_fidelity(error: f64) -> f64 {
     if error.is_nan() || error <= 0. {
         0.0
     } else if error >= 1. {
@@ -44,6 +44,27 @@ pub enum LayoutSource {
     Sabre,
 }
 
+/// A point in the pipeline run by [`transpile_with_passes`] at which extra passes can run on the
+/// in-flight [DAGCircuit].
+#[derive(Copy, Clone, Debug, Eq, PartialEq, Hash)]
+pub enum PassInsertionPoint {
+    /// Before the [`init_stage`], on the virtual circuit.
+    BeforeInit,
+    /// After the [`init_stage`], on the virtual circuit.
+    AfterInit,
+    /// After the [`layout_stage`], once the circuit is defined over physical qubits.
+    AfterLayout,
+    /// After the [`routing_stage`].
+    AfterRouting,
+    /// After the [`translation_stage`].
+    AfterTranslation,
+    /// In every iteration of the optimization loop of the [`optimization_stage`].  See
+    /// [`optimization_stage_with_loop_passes`].
+    OptimizationLoop,
+    /// After the [`optimization_stage`], at the end of the pipeline.
+    AfterOptimization,
+}
+
 impl From<u8> for OptimizationLevel {
     fn from(value: u8) -> Self {
         match value {
@@ -219,17 +240,24 @@ pub fn layout_stage(
             layout[&x]
         });
     } else {
-        let (result, initial_layout, final_layout) = sabre::sabre_layout_and_routing(
-            dag,
-            target,
-            sabre_heuristic,
-            4,
-            20,
-            20,
-            seed,
-            Vec::new(),
-            false,
-        )?;
+        // At the highest optimization level, score the trials by the estimated error of their
+        // swaps rather than their count, and abandon trials as soon as they can no longer win.
+        let (result, initial_layout, final_layout) =
+            sabre::sabre_layout_and_routing_with_selection(
+                dag,
+                target,
+                sabre_heuristic,
+                4,
+                20,
+                20,
+                seed,
+                Vec::new(),
+                false,
+                sabre::TrialSelection {
+                    score_by_error: true,
+                    race_margin: Some(0.0),
+                },
+            )?;
         *dag = result;
         *transpile_layout =
             layout_from_sabre_result(dag, initial_layout, &final_layout, transpile_layout);
@@ -347,6 +375,38 @@ pub fn optimization_stage(
     commutation_checker: &mut CommutationChecker,
     equivalence_library: &mut EquivalenceLibrary,
     transpile_layout: &mut TranspileLayout,
+) -> Result<()> {
+    optimization_stage_with_loop_passes(
+        dag,
+        target,
+        optimization_level,
+        approximation_degree,
+        synthesis_state,
+        commutation_checker,
+        equivalence_library,
+        transpile_layout,
+        &mut |_, _| Ok(()),
+    )
+}
+
+/// Run the [optimization_stage], calling `loop_passes` in every iteration of its optimization
+/// loop.
+///
+/// `loop_passes` runs after the preset optimizations of the iteration and before the circuit is
+/// translated again if needed, so it may introduce gates outside the target.  Its effect on the
+/// depth and size of the circuit counts towards the fixed point that ends the loop.  There is no
+/// optimization loop at [OptimizationLevel::Level0], so `loop_passes` is never called there.
+#[allow(clippy::too_many_arguments)]
+pub fn optimization_stage_with_loop_passes(
+    dag: &mut DAGCircuit,
+    target: &Target,
+    optimization_level: OptimizationLevel,
+    approximation_degree: Option<f64>,
+    synthesis_state: &mut UnitarySynthesisState,
+    commutation_checker: &mut CommutationChecker,
+    equivalence_library: &mut EquivalenceLibrary,
+    transpile_layout: &mut TranspileLayout,
+    loop_passes: &mut dyn FnMut(&mut DAGCircuit, &mut TranspileLayout) -> Result<()>,
 ) -> Result<()> {
     let mut depth: Option<usize> = None;
     let mut size: Option<usize> = None;
@@ -365,6 +425,7 @@ pub fn optimization_stage(
             size = new_size;
             run_optimize_1q_gates_decomposition(dag, &optimize_1q_state, Some(target), None, None)?;
             run_inverse_cancellation_standard_gates(dag);
+            loop_passes(dag, transpile_layout)?;
             if gates_missing_from_target(dag, target)? {
                 translation_stage(dag, target, synthesis_state, equivalence_library)?;
             }
@@ -394,6 +455,7 @@ pub fn optimization_stage(
             run_remove_identity_equiv(dag, approximation_degree, Some(target))?;
             run_optimize_1q_gates_decomposition(dag, &optimize_1q_state, Some(target), None, None)?;
             cancel_commutations(dag, commutation_checker, None, 1.0)?;
+            loop_passes(dag, transpile_layout)?;
             if gates_missing_from_target(dag, target)? {
                 translation_stage(dag, target, synthesis_state, equivalence_library)?;
             }
@@ -421,6 +483,7 @@ pub fn optimization_stage(
             run_remove_identity_equiv(dag, approximation_degree, Some(target))?;
             run_optimize_1q_gates_decomposition(dag, &optimize_1q_state, Some(target), None, None)?;
             cancel_commutations(dag, commutation_checker, None, 1.0)?;
+            loop_passes(dag, transpile_layout)?;
             if gates_missing_from_target(dag, target)? {
                 translation_stage(dag, target, synthesis_state, equivalence_library)?;
             }
@@ -456,8 +519,80 @@ pub fn optimization_stage(
     Ok(())
 }
 
+/// The method used by the [scheduling_stage] to choose the start time of each instruction.
+#[derive(Copy, Clone, Debug, Eq, PartialEq)]
+pub enum SchedulingMethod {
+    /// Start every instruction as soon as possible.
+    Asap,
+    /// Start every instruction as late as possible.
+    Alap,
+}
+
+/// The configuration of the [scheduling_stage].
+#[derive(Copy, Clone, Debug, PartialEq)]
+pub struct SchedulingConfig {
+    pub method: SchedulingMethod,
+    /// The sequence to fill idle windows with, or `None` to fill them with delays only.
+    pub dynamical_decoupling: Option<DynamicalDecoupling>,
+    /// The latency, in `dt`, between the start of a measurement and its write to its clbit.
+    pub clbit_write_latency: u64,
+}
+
+/// Schedule a physical circuit, which must already be in the target's basis, and make all of its
+/// idle time explicit.
+///
+/// Instruction durations are taken from the [Target], and start times are aligned to its pulse and
+/// acquire alignment constraints.  Returns the total duration of the circuit in `dt`.
+#[inline]
+pub fn scheduling_stage(
+    dag: &mut DAGCircuit,
+    target: &Target,
+    config: &SchedulingConfig,
+) -> Result<u64> {
+    let durations = DtDurations::from_target(dag, target)?;
+    let mut schedule = match config.method {
+        SchedulingMethod::Asap => {
+            run_asap_schedule_dt(dag, config.clbit_write_latency, &durations)?
+        }
+        SchedulingMethod::Alap => {
+            run_alap_schedule_dt(dag, config.clbit_write_latency, &durations)?
+        }
+    };
+    align_start_times(
+        dag,
+        &mut schedule,
+        &durations,
+        config.clbit_write_latency,
+        target.pulse_alignment,
+        target.acquire_alignment,
+    );
+    Ok(run_pad_schedule(
+        dag,
+        &schedule,
+        &durations,
+        target,
+        config.dynamical_decoupling,
+    )?)
+}
+
 #[inline]
 pub fn get_sabre_heuristic(target: &Target) -> Result<sabre::Heuristic> {
+    get_windowed_sabre_heuristic(target, Some(1), 1.0)
+}
+
+/// Get the Sabre heuristic with a lookahead window of `depth` layers, where the weight of each
+/// successive layer is multiplied by `decay`.
+///
+/// If `depth` is `None`, the depth of the window is chosen to scale with the number of qubits in
+/// the target.  A depth of one with any decay is the same as [`get_sabre_heuristic`].
+pub fn get_windowed_sabre_heuristic(
+    target: &Target,
+    depth: Option<u16>,
+    decay: f64,
+) -> Result<sabre::Heuristic> {
+    let num_qubits = target.num_qubits.unwrap_or(20);
+    let depth =
+        depth.unwrap_or_else(|| sabre::heuristic::LookaheadHeuristic::window_depth_for(num_qubits));
     Ok(sabre::Heuristic::new(
         None,
         None,
@@ -466,10 +601,12 @@ pub fn get_sabre_heuristic(target: &Target) -> Result<sabre::Heuristic> {
         1e-10,
     )
     .with_basic(1.0, sabre::SetScaling::Constant)
-    .with_lookahead(
-        vec![0.5 / target.num_qubits.unwrap_or(20) as f64],
+    .with_windowed_lookahead(
+        depth as usize,
+        0.5 / num_qubits as f64,
+        decay,
         sabre::SetScaling::Constant,
-    )
+    )?
     .with_decay(0.001, 5)?)
 }
 
@@ -483,6 +620,31 @@ pub fn transpile(
     optimization_level: OptimizationLevel,
     approximation_degree: Option<f64>,
     seed: Option<u64>,
+) -> Result<(CircuitData, TranspileLayout)> {
+    transpile_with_passes(
+        circuit,
+        target,
+        optimization_level,
+        approximation_degree,
+        seed,
+        &mut |_, _, _| Ok(()),
+    )
+}
+
+/// Run the same pipeline as [`transpile`], calling `passes` at every [`PassInsertionPoint`].
+///
+/// `passes` receives the insertion point, the DAG being transpiled and the layout found so far,
+/// and can modify both in place, so extra passes run without converting the circuit between
+/// stages.  Passes that run before the layout stage see a virtual circuit, and passes after
+/// [`PassInsertionPoint::AfterTranslation`] are responsible for leaving the circuit supported by
+/// the target, except in the optimization loop which translates the circuit again if needed.
+pub fn transpile_with_passes(
+    circuit: &CircuitData,
+    target: &Target,
+    optimization_level: OptimizationLevel,
+    approximation_degree: Option<f64>,
+    seed: Option<u64>,
+    passes: &mut dyn FnMut(PassInsertionPoint, &mut DAGCircuit, &mut TranspileLayout) -> Result<()>,
 ) -> Result<(CircuitData, TranspileLayout)> {
     let mut dag = DAGCircuit::from_circuit_data(circuit, false, None, None, None, None)?;
     let mut commutation_checker = get_standard_commutation_checker();
@@ -504,6 +666,11 @@ pub fn transpile(
         dag.qregs().to_vec(),
     );
 
+    passes(
+        PassInsertionPoint::BeforeInit,
+        &mut dag,
+        &mut transpile_layout,
+    )?;
     // Init stage
     init_stage(
         &mut dag,
@@ -514,6 +681,11 @@ pub fn transpile(
         &mut transpile_layout,
         &mut commutation_checker,
     )?;
+    passes(
+        PassInsertionPoint::AfterInit,
+        &mut dag,
+        &mut transpile_layout,
+    )?;
     // layout stage
     let layout_source = layout_stage(
         &mut dag,
@@ -523,6 +695,11 @@ pub fn transpile(
         &sabre_heuristic,
         &mut transpile_layout,
     )?;
+    passes(
+        PassInsertionPoint::AfterLayout,
+        &mut dag,
+        &mut transpile_layout,
+    )?;
     // Routing stage
     routing_stage(
         &mut dag,
@@ -533,6 +710,11 @@ pub fn transpile(
         &mut transpile_layout,
         layout_source,
     )?;
+    passes(
+        PassInsertionPoint::AfterRouting,
+        &mut dag,
+        &mut transpile_layout,
+    )?;
     // Translation Stage
     translation_stage(
         &mut dag,
@@ -540,8 +722,13 @@ pub fn transpile(
         &mut synthesis_state,
         &mut equivalence_library,
     )?;
+    passes(
+        PassInsertionPoint::AfterTranslation,
+        &mut dag,
+        &mut transpile_layout,
+    )?;
     // optimization stage
-    optimization_stage(
+    optimization_stage_with_loop_passes(
         &mut dag,
         target,
         optimization_level,
@@ -550,6 +737,12 @@ pub fn transpile(
         &mut commutation_checker,
         &mut equivalence_library,
         &mut transpile_layout,
+        &mut |dag, layout| passes(PassInsertionPoint::OptimizationLoop, dag, layout),
+    )?;
+    passes(
+        PassInsertionPoint::AfterOptimization,
+        &mut dag,
+        &mut transpile_layout,
     )?;
     Ok((CircuitData::from_dag_ref(&dag)?, transpile_layout))
 }
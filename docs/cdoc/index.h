@@ -13,10 +13,13 @@
  * @defgroup QkObs QkObs
  * @defgroup QkObsTerm QkObsTerm
  * @defgroup QkParam QkParam
+ * @defgroup QkPassManager QkPassManager
  * @defgroup QkQuantumRegister QkQuantumRegister
  * @defgroup QkSabreLayoutOptions QkSabreLayoutOptions
+ * @defgroup QkSharedCircuit QkSharedCircuit
  * @defgroup QkTarget QkTarget
  * @defgroup QkTargetEntry QkTargetEntry
+ * @defgroup QkTemplateLibrary QkTemplateLibrary
  * @defgroup QkTranspileLayout QkTranspileLayout
  * @defgroup QkTranspiler QkTranspiler
  * @defgroup QkTranspilerPasses QkTranspilerPasses
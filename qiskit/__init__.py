@@ -127,6 +127,7 @@ sys.modules["qiskit._accelerate.inverse_cancellation"] = _accelerate.inverse_can
 sys.modules["qiskit._accelerate.check_map"] = _accelerate.check_map
 sys.modules["qiskit._accelerate.filter_op_nodes"] = _accelerate.filter_op_nodes
 sys.modules["qiskit._accelerate.two_qubit_peephole"] = _accelerate.two_qubit_peephole
+sys.modules["qiskit._accelerate.template_matching"] = _accelerate.template_matching
 sys.modules["qiskit._accelerate.twirling"] = _accelerate.twirling
 sys.modules["qiskit._accelerate.high_level_synthesis"] = _accelerate.high_level_synthesis
 sys.modules["qiskit._accelerate.remove_identity_equiv"] = _accelerate.remove_identity_equiv
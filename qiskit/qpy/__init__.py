@@ -431,8 +431,11 @@ encoding scheme used for symbolic expressions:
     }
 
 From V16 on, the file header struct is immediately followed by a circuit start table
-containing the byte offsets of each circuit payload in the file. There are ``num_circuits``
-entries in the circuit start table, each of which is of type ``uint64_t``. In all previous
+containing the byte offsets of each circuit payload from the start of the QPY payload, which need
+not be the start of the file. There are ``num_circuits`` entries in the circuit start table, each
+of which is of type ``uint64_t``. Some older versions of Qiskit wrote offsets from the start of
+the file instead, so readers should locate circuits relative to the first entry, whose circuit
+immediately follows the table. In all previous
 versions, the file header is immediately followed by the circuit payloads in sequence
 without any padding in-between.
 
@@ -462,6 +465,46 @@ There is a circuit payload for each circuit (where the total number is dictated
 by ``num_circuits`` in the file header). There is no padding between the
 circuits in the data.
 
+.. _qpy_compressed:
+
+Compressed payloads
+-------------------
+
+When :func:`.qpy.dump` is called with ``compression`` set, the QPY payload is wrapped in a
+container in which every circuit payload is compressed on its own.  The container starts with
+the 4 byte string ``QPYZ``, followed by the header:
+
+.. code-block:: c
+
+    struct {
+        uint8_t format_version;
+        char codec;
+        char qpy_header[20];
+        uint64_t dictionary_size;
+    }
+
+``format_version`` is currently ``1``, and ``codec`` is ``z`` for zstd or ``l`` for LZ4.
+``qpy_header`` holds the ``QISKIT`` string and the file header of the uncompressed payload,
+including its number of circuits and QPY version (which is at least 17).  It is followed by
+``dictionary_size`` bytes of compression dictionary shared by all circuits, which may be empty,
+and then by one frame table entry per circuit:
+
+.. code-block:: c
+
+    struct {
+        uint64_t offset;
+        uint64_t compressed_size;
+        uint64_t size;
+    }
+
+``offset`` is the byte offset of the compressed circuit from the start of the container, and
+``compressed_size`` and ``size`` are the sizes of the circuit payload after and before
+compression.  The compressed circuits follow the table, and each one decompresses to a circuit
+payload in the format described above.  With zstd, each compressed circuit is a zstd frame and
+the dictionary is a zstd dictionary.  With LZ4, each compressed circuit is a single LZ4 block
+(without the LZ4 frame format), and the dictionary is raw data which precedes every block, so
+that matches in the block may refer back into it.
+
 .. _qpy_version_17:
 
 Version 17
@@ -27,6 +27,11 @@ QPY_VERSION = 17
 QPY_COMPATIBILITY_VERSION = 13
 QPY_RUST_READ_MIN_VERSION = 13
 QPY_RUST_WRITE_MIN_VERSION = 17
+COMPRESSED_QPY_MAGIC = b"QPYZ"
+# The regular QPY file header of a compressed payload follows the magic bytes, the container
+# format version and the compression codec.
+COMPRESSED_QPY_HEADER_OFFSET = 6
+COMPRESSION_CODECS = ("zstd", "lz4")
 ENCODE = "utf8"
 
 
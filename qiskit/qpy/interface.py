@@ -20,7 +20,7 @@ import shutil
 from json import JSONEncoder, JSONDecoder
 from typing import BinaryIO, TYPE_CHECKING
 from collections.abc import Callable
-from collections.abc import Iterable, Mapping
+from collections.abc import Iterable, Mapping, Sequence
 import struct
 import warnings
 import re
@@ -94,6 +94,9 @@ def dump(
     use_symengine: bool = False,
     version: int = common.QPY_VERSION,
     annotation_factories: Mapping[str, Callable[[], annotation.QPYSerializer]] | None = None,
+    compression: str | None = None,
+    compression_level: int = 3,
+    train_dictionary: bool = False,
 ):
     """Write QPY binary data to a file
 
@@ -134,6 +137,18 @@ def dump(
 
     Which will save the qpy serialized circuit to the provided file.
 
+    Alternatively, the programs can be compressed individually by setting ``compression``:
+
+    .. code-block:: python
+
+        with open('bell.qpyz', 'wb') as fd:
+            qpy.dump(qc, fd, compression="zstd")
+
+    Unlike compressing the whole file, this keeps each program separately addressable, so
+    :func:`load` can still decode only the programs it is asked for, and can decompress
+    programs in parallel.  Compressed payloads can only be loaded by Qiskit versions which
+    support them.
+
     Args:
         programs: QPY supported object(s) to store in the specified file like object.
             QPY supports :class:`.QuantumCircuit`.
@@ -173,11 +188,22 @@ def dump(
             :class:`.Annotation` objects.  The subsequent call to :func:`load` will need to use
             similar serializer objects, that understand the custom output format of those
             serializers.
+        compression: The codec with which to compress each program, if any.  The supported
+            codecs are ``"zstd"``, which compresses best, and ``"lz4"``, which compresses less
+            but decompresses faster.  Compression requires ``version`` to be at least 17.
+        compression_level: The compression level passed to the codec.  For ``"zstd"``, higher
+            levels compress better but more slowly, and negative levels trade compression for speed.
+            It is ignored by ``"lz4"``.
+        train_dictionary: If ``True``, train a compression dictionary on the encoded instructions
+            of the programs being written and store it alongside them.  This helps most when
+            there are many small programs made of the same instructions.  If there is too little
+            data to train a dictionary on, the programs are compressed without one.
 
 
     Raises:
         TypeError: When invalid data type is input.
-        ValueError: When an unsupported version number is passed in for the ``version`` argument.
+        ValueError: When an unsupported version number is passed in for the ``version`` argument,
+            or an unsupported ``compression`` is requested.
     """
     if not isinstance(programs, Iterable):
         programs = [programs]
@@ -197,6 +223,17 @@ def dump(
         )
 
     use_rust = version >= common.QPY_RUST_WRITE_MIN_VERSION
+    if compression is not None:
+        if compression not in common.COMPRESSION_CODECS:
+            raise ValueError(
+                f"Unsupported compression codec '{compression}'. Supported codecs are "
+                f"{', '.join(common.COMPRESSION_CODECS)}."
+            )
+        if not use_rust:
+            raise ValueError(
+                f"Compressed QPY payloads require QPY version {common.QPY_RUST_WRITE_MIN_VERSION} "
+                f"or above, but version {version} was selected."
+            )
     if use_rust:
         _qpy.dump(
             programs,
@@ -205,6 +242,9 @@ def dump(
             bool(use_symengine),
             version,
             annotation_factories,
+            compression,
+            compression_level,
+            train_dictionary,
         )
         return
 
@@ -242,11 +282,15 @@ def dump(
             # Fast path for properly seekable streams
             file_offsets = []
             table_start = file_obj.tell()
+            # The offsets are relative to the start of the payload, which need not be the start of
+            # the stream.
+            payload_start = table_start - header_bytes_written
             # Skip past the circuit table to write circuit contents first.
             file_obj.seek(len(programs) * formats.CIRCUIT_TABLE_ENTRY_SIZE, 1)
             for program in programs:
-                file_offsets.append(file_obj.tell())
+                file_offsets.append(file_obj.tell() - payload_start)
                 _write_circuit(file_obj, program)
+            payload_end = file_obj.tell()
             # Seek back to the table start and write it out.
             file_obj.seek(table_start)
             for offset in file_offsets:
@@ -255,8 +299,8 @@ def dump(
                         formats.CIRCUIT_TABLE_ENTRY_PACK, *formats.CIRCUIT_TABLE_ENTRY(offset)
                     )
                 )
-            # Seek to the end of the stream.
-            file_obj.seek(0, 2)
+            # Seek to the end of the payload.
+            file_obj.seek(payload_end)
         else:
             # We need to create a temporary BytesIO buffer since the input
             # stream isn't seekable.
@@ -289,6 +333,7 @@ def load(
     file_obj: BinaryIO,
     metadata_deserializer: type[JSONDecoder] | None = None,
     annotation_factories: Mapping[str, Callable[[], annotation.QPYSerializer]] | None = None,
+    programs: Sequence[int] | None = None,
 ) -> list[QPY_SUPPORTED_TYPES]:
     """Load a QPY binary file
 
@@ -314,7 +359,19 @@ def load(
             circuits = qpy.load(fd)
 
     which will read the contents of the qpy and return a list of
-    :class:`~qiskit.circuit.QuantumCircuit` objects from the file.
+    :class:`~qiskit.circuit.QuantumCircuit` objects from the file.  Payloads written by
+    :func:`dump` with ``compression`` set are recognized and decompressed automatically.
+
+    To load only some of the programs in a file, pass their indices as ``programs``.  Only
+    the requested programs are deserialized; for QPY version 16 and above, which store the
+    byte offset of every program, the programs which were not requested are not even read:
+
+    .. code-block:: python
+
+        from qiskit import qpy
+
+        with open('archive.qpy', 'rb') as fd:
+            first, last = qpy.load(fd, programs=[0, 9999])
 
     Args:
         file_obj: A file like object that contains the QPY binary
@@ -329,9 +386,11 @@ def load(
         annotation_factories: Mapping of namespaces to functions that create new instances of
             :class:`.annotation.QPUSerializer`, for handling the loading of custom
             :class:`.Annotation` objects.
+        programs: The indices of the programs to load, in the order they should be returned.
+            If this is not specified, every program in the file is loaded.
 
     Returns:
-        The list of Qiskit programs contained in the QPY data.
+        The list of Qiskit programs contained in the QPY data, or the requested subset of them.
         A list is always returned, even if there is only 1 program in the QPY data.
 
     Raises:
@@ -344,18 +403,34 @@ def load(
         QpyError: if known but unsupported data type is loaded.
     """
 
-    # identify file header version
+    # identify whether the payload is compressed, and the version of its file header
+    payload_start = file_obj.tell()
+    compressed = file_obj.read(len(common.COMPRESSED_QPY_MAGIC)) == common.COMPRESSED_QPY_MAGIC
+    file_obj.seek(payload_start + (common.COMPRESSED_QPY_HEADER_OFFSET if compressed else 0))
     version = struct.unpack("!6sB", file_obj.read(7))[1]
-    file_obj.seek(0)
+    file_obj.seek(payload_start)
 
     if version > common.QPY_VERSION:
         raise QiskitError(
             f"The QPY format version being read, {version}, isn't supported by "
             "this Qiskit version. Please upgrade your version of Qiskit to load this QPY payload"
         )
+    if compressed:
+        return _qpy.load_compressed(
+            file_obj,
+            metadata_deserializer,
+            annotation_factories,
+            None if programs is None else list(programs),
+        )
     use_rust = version >= common.QPY_RUST_READ_MIN_VERSION
     if use_rust:
-        return _qpy.load(file_obj, metadata_deserializer, version, annotation_factories)
+        return _qpy.load(
+            file_obj,
+            metadata_deserializer,
+            version,
+            annotation_factories,
+            None if programs is None else list(programs),
+        )
 
     if version < 10:
         data = formats.FILE_HEADER._make(
@@ -438,22 +513,37 @@ def load(
                 ).offset
             )
 
-    programs = []
-    for i in range(data.num_programs):
-        if data.qpy_version >= 16:
-            # Deserialize each program using their byte offsets
-            file_obj.seek(program_offsets[i])
-        programs.append(
-            binary_io.read_circuit(
-                file_obj,
-                data.qpy_version,
-                metadata_deserializer=metadata_deserializer,
-                use_symengine=bool(use_symengine),
-                annotation_factories=annotation_factories,
-                use_rust=use_rust,
-            )
+    def read_program():
+        return binary_io.read_circuit(
+            file_obj,
+            data.qpy_version,
+            metadata_deserializer=metadata_deserializer,
+            use_symengine=bool(use_symengine),
+            annotation_factories=annotation_factories,
+            use_rust=use_rust,
         )
-    return programs
+
+    if data.qpy_version < 16:
+        # Without byte offsets, the programs can only be read in sequence.
+        loaded = [read_program() for _ in range(data.num_programs)]
+        return loaded if programs is None else [loaded[i] for i in programs]
+
+    # The first program directly follows the offset table.  The offsets are taken relative to the
+    # first one, because older versions of Qiskit wrote them relative to the start of the stream
+    # rather than to the start of the payload.
+    programs_start = file_obj.tell()
+    loaded = []
+    for i in range(data.num_programs) if programs is None else programs:
+        # Deserialize each program using their byte offsets
+        file_obj.seek(programs_start + program_offsets[i] - program_offsets[0])
+        loaded.append(read_program())
+    last = data.num_programs - 1
+    if programs is not None and last >= 0 and (not programs or programs[-1] != last):
+        # Leave the stream at the end of the payload, which is only known once the last program
+        # has been read.
+        file_obj.seek(programs_start + program_offsets[last] - program_offsets[0])
+        read_program()
+    return loaded
 
 
 def get_qpy_version(
@@ -481,6 +571,12 @@ def get_qpy_version(
         The QPY version of the specified file.
     """
 
-    version = struct.unpack("!6sB", file_obj.read(7))[1]
-    file_obj.seek(-7, 1)
+    preface = file_obj.read(len(common.COMPRESSED_QPY_MAGIC))
+    if preface == common.COMPRESSED_QPY_MAGIC:
+        file_obj.read(common.COMPRESSED_QPY_HEADER_OFFSET - len(preface))
+        version = struct.unpack("!6sB", file_obj.read(7))[1]
+        file_obj.seek(-(common.COMPRESSED_QPY_HEADER_OFFSET + 7), 1)
+    else:
+        version = struct.unpack("!6sB", preface + file_obj.read(7 - len(preface)))[1]
+        file_obj.seek(-7, 1)
     return version
@@ -587,7 +587,7 @@ from qiskit.synthesis.multi_controlled import (
     synth_mcmt_vchain,
     synth_mcmt_xgate,
 )
-from qiskit.synthesis.evolution import ProductFormula, synth_pauli_network_rustiq
+from qiskit.synthesis.evolution import ProductFormula, SuzukiTrotter, synth_pauli_network_rustiq
 from qiskit.synthesis.arithmetic import (
     adder_ripple_c04,
     adder_qft_d00,
@@ -604,6 +604,7 @@ from qiskit.circuit._add_control import EFFICIENTLY_CONTROLLED_GATES
 from qiskit.transpiler.optimization_metric import OptimizationMetric
 
 from qiskit._accelerate.high_level_synthesis import synthesize_operation, HighLevelSynthesisData
+from qiskit._accelerate.synthesis.evolution import pauli_network_synthesis_sparse_observable
 from .plugin import HighLevelSynthesisPlugin
 
 if TYPE_CHECKING:
@@ -2132,6 +2133,40 @@ class PauliEvolutionSynthesisRustiq(HighLevelSynthesisPlugin):
 
         from qiskit.quantum_info import SparsePauliOp, SparseObservable
 
+        optimize_count = options.get("optimize_count", True)
+        preserve_order = options.get("preserve_order", True)
+        upto_clifford = options.get("upto_clifford", False)
+        upto_phase = options.get("upto_phase", False)
+        resynth_clifford_method = options.get("resynth_clifford_method", 1)
+
+        operator = high_level_object.operator
+        time = high_level_object.time
+        algo = high_level_object.synthesis
+        bit_term = SparseObservable.BitTerm
+        paulis = (bit_term.X, bit_term.Y, bit_term.Z)
+        if (
+            isinstance(operator, SparseObservable)
+            and isinstance(time, (int, float))
+            and isinstance(algo, SuzukiTrotter)
+            and algo.order == 1
+            and algo.reps == 1
+            and options.get("preserve_order", algo.preserve_order)
+            and np.isin(operator.bit_terms, paulis).all()
+            and (np.abs(operator.coeffs.imag) <= 1e-12).all()
+        ):
+            # A single Lie-Trotter step expands into one rotation per term, in order. In this
+            # case the terms can be packed straight from the observable.
+            data = pauli_network_synthesis_sparse_observable(
+                operator,
+                time,
+                optimize_count=optimize_count,
+                preserve_order=preserve_order,
+                upto_clifford=upto_clifford,
+                upto_phase=upto_phase,
+                resynth_clifford_method=resynth_clifford_method,
+            )
+            return QuantumCircuit._from_circuit_data(data, legacy_qubits=True)
+
         # The synthesis function synth_pauli_network_rustiq does not support SparseObservables,
         # so we need to convert them to SparsePauliOps.
         if isinstance(high_level_object.operator, SparsePauliOp):
@@ -2173,11 +2208,6 @@ class PauliEvolutionSynthesisRustiq(HighLevelSynthesisPlugin):
 
         num_qubits = evo.num_qubits
         pauli_network = algo.expand(evo)
-        optimize_count = options.get("optimize_count", True)
-        preserve_order = options.get("preserve_order", True)
-        upto_clifford = options.get("upto_clifford", False)
-        upto_phase = options.get("upto_phase", False)
-        resynth_clifford_method = options.get("resynth_clifford_method", 1)
 
         synth_object = synth_pauli_network_rustiq(
             num_qubits=num_qubits,
@@ -0,0 +1,44 @@
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2026
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+
+# pylint: disable=missing-docstring
+# pylint: disable=attribute-defined-outside-init
+
+from qiskit.synthesis.linear import (
+    binary_matmul,
+    calc_inverse_matrix,
+    random_invertible_binary_matrix,
+    synth_cnot_count_full_pmh,
+    synth_cnot_depth_line_kms,
+)
+
+
+class LinearSynthesisBench:
+    timeout = 600.0  # seconds
+
+    params = [256, 512, 1024]
+    param_names = ["n_qubits"]
+
+    def setup(self, n_qubits):
+        self.mat = random_invertible_binary_matrix(n_qubits, seed=2026)
+
+    def time_calc_inverse_matrix(self, _):
+        calc_inverse_matrix(self.mat)
+
+    def time_binary_matmul(self, _):
+        binary_matmul(self.mat, self.mat)
+
+    def time_synth_cnot_count_full_pmh(self, _):
+        synth_cnot_count_full_pmh(self.mat)
+
+    def time_synth_cnot_depth_line_kms(self, _):
+        synth_cnot_depth_line_kms(self.mat)
@@ -13,6 +13,10 @@
 
 from copy import deepcopy
 
+import numpy as np
+
+from qiskit import QuantumCircuit
+from qiskit._accelerate.sabre import Heuristic, SetScaling
 from qiskit.transpiler import CouplingMap
 from qiskit.transpiler.passes import (
     FullAncillaAllocation,
@@ -246,3 +250,38 @@ class RoutedPassBenchmarks:
 
     def time_check_map(self, _, __):
         CheckMap(self.coupling_map).run(self.routed_dag)
+
+
+class SabreLookaheadWindowBenchmarks:
+    """Swap count versus routing time of Sabre for increasing lookahead-window depths on a
+    heavy-hex device with over 1,000 qubits."""
+
+    params = ([1, 2, 4, 6, 8, 16], [1.0, 0.5])
+    param_names = ["window", "decay"]
+    timeout = 600
+
+    def setup(self, window, decay):
+        self.coupling_map = CouplingMap.from_heavy_hex(21)
+        num_qubits = self.coupling_map.size()
+        rng = np.random.default_rng(2025)
+        circuit = QuantumCircuit(num_qubits)
+        for _ in range(10):
+            perm = rng.permutation(num_qubits)
+            for k in range(num_qubits // 2):
+                circuit.cx(int(perm[2 * k]), int(perm[2 * k + 1]))
+        self.dag = circuit_to_dag(circuit)
+        self.heuristic = (
+            Heuristic(attempt_limit=10 * num_qubits)
+            .with_basic(1.0, SetScaling.Constant)
+            .with_windowed_lookahead(window, 0.5 / num_qubits, decay, SetScaling.Constant)
+            .with_decay(0.001, 5)
+        )
+        self.routed_dag = SabreSwap(self.coupling_map, heuristic=self.heuristic, seed=42).run(
+            self.dag
+        )
+
+    def time_sabre_swap(self, _, __):
+        SabreSwap(self.coupling_map, heuristic=self.heuristic, seed=42).run(self.dag)
+
+    def track_sabre_swap_count(self, _, __):
+        return self.routed_dag.count_ops().get("swap", 0)
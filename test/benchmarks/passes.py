@@ -10,7 +10,12 @@
 # copyright notice, and modified files need to carry a notice indicating
 # that they have been altered from the originals.
 
+import numpy as np
+
+from qiskit import QuantumCircuit
+from qiskit._accelerate.template_matching import TemplateLibrary, template_optimization
 from qiskit.circuit.equivalence_library import SessionEquivalenceLibrary as SEL
+from qiskit.circuit.library.templates import clifford
 from qiskit.transpiler.passes import (
     CollectMultiQBlocks,
     Collect2qBlocks,
@@ -43,6 +48,8 @@ from qiskit.transpiler.passes import (
     RemoveResetInZeroState,
 )
 from qiskit.converters import circuit_to_dag
+from qiskit.dagcircuit import DAGOpNode
+from qiskit.dagcircuit.collect_blocks import BlockCollector
 from qiskit.circuit.library import CXGate
 from qiskit.transpiler import Target
 from qiskit.compiler import transpile
@@ -72,6 +79,46 @@ class Collect2QPassBenchmarks:
         _pass.run(self.dag)
 
 
+class CollectRunsBenchmarks:
+    params = ([5, 14, 20], [1024])
+
+    param_names = ["n_qubits", "depth"]
+    timeout = 300
+
+    def setup(self, n_qubits, depth):
+        seed = 42
+        self.circuit = random_circuit(n_qubits, depth, max_operands=2, seed=seed)
+        self.dag = circuit_to_dag(self.circuit)
+
+    def time_collect_1q_runs(self, _, __):
+        self.dag.collect_1q_runs()
+
+    def time_collect_1q_runs_by_traversal(self, _, __):
+        # The same runs, collected one node at a time through the successors of each node.
+        def in_run(node):
+            return isinstance(node, DAGOpNode) and len(node.qargs) == 1 and not node.cargs
+
+        seen = set()
+        runs = []
+        for node in self.dag.topological_op_nodes():
+            if node in seen or not in_run(node):
+                continue
+            run = [node]
+            seen.add(node)
+            while in_run(successor := next(self.dag.successors(run[-1]))):
+                run.append(successor)
+                seen.add(successor)
+            runs.append(run)
+
+    def time_collect_2q_runs(self, _, __):
+        self.dag.collect_2q_runs()
+
+    def time_collect_2q_blocks_by_traversal(self, _, __):
+        BlockCollector(self.dag).collect_all_matching_blocks(
+            lambda node: len(node.qargs) <= 2, min_block_size=1, max_block_width=2
+        )
+
+
 class CommutativeAnalysisPassBenchmarks:
     params = ([5, 14, 20], [1024])
 
@@ -252,3 +299,33 @@ class LitinskiTransformationPassBenchmarks:
     def time_litinski_transformation(self, _, __):
         _pass = LitinskiTransformation(use_ppr=True)
         _pass.run(self.dag)
+
+
+class TemplateOptimizationBenchmarks:
+    params = ([20, 100], [10_000, 100_000])
+
+    param_names = ["n_qubits", "n_gates"]
+    timeout = 300
+    # The pass modifies the DAG built in setup in place, so it may only run once per setup.
+    number = 1
+    warmup_time = 0
+
+    def setup(self, n_qubits, n_gates):
+        rng = np.random.default_rng(42)
+        circuit = QuantumCircuit(n_qubits)
+        one_qubit = [circuit.h, circuit.s, circuit.sdg, circuit.t, circuit.tdg]
+        for _ in range(n_gates):
+            if rng.random() < 0.3:
+                control, target = rng.choice(n_qubits, size=2, replace=False)
+                circuit.cx(control, target)
+            else:
+                one_qubit[rng.integers(len(one_qubit))](rng.integers(n_qubits))
+        self.dag = circuit_to_dag(circuit, copy_operations=False)
+        t_tdg = QuantumCircuit(1)
+        t_tdg.t(0)
+        t_tdg.tdg(0)
+        templates = [getattr(clifford, name)() for name in clifford.__all__] + [t_tdg]
+        self.library = TemplateLibrary([template._data for template in templates])
+
+    def time_template_optimization(self, _, __):
+        template_optimization(self.dag, self.library)
@@ -0,0 +1,51 @@
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2026
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+
+# pylint: disable=missing-docstring
+# pylint: disable=attribute-defined-outside-init
+
+import numpy as np
+
+from qiskit.synthesis.evolution import synth_pauli_network_rustiq
+
+
+def random_local_network(num_qubits, num_terms, locality, seed):
+    rng = np.random.default_rng(seed)
+    network = []
+    for _ in range(num_terms):
+        start = rng.integers(num_qubits - locality + 1)
+        qubits = [int(q) for q in range(start, start + locality)]
+        label = "".join(rng.choice(["X", "Y", "Z"], size=locality))
+        network.append((label, qubits, float(rng.uniform(-np.pi, np.pi))))
+    return network
+
+
+class PauliNetworkSynthesisBench:
+    timeout = 600.0  # seconds
+
+    params = ([(50, 1000), (100, 5000), (200, 20000)], [True, False])
+    param_names = ["(n_qubits, n_terms)", "preserve_order"]
+
+    def setup(self, size, _):
+        num_qubits, num_terms = size
+        self.num_qubits = num_qubits
+        self.network = random_local_network(num_qubits, num_terms, locality=3, seed=2026)
+
+    def time_synth_pauli_network_rustiq(self, _, preserve_order):
+        synth_pauli_network_rustiq(
+            self.num_qubits, self.network, preserve_order=preserve_order, upto_clifford=True
+        )
+
+    def peakmem_synth_pauli_network_rustiq(self, _, preserve_order):
+        synth_pauli_network_rustiq(
+            self.num_qubits, self.network, preserve_order=preserve_order, upto_clifford=True
+        )
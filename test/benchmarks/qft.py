@@ -15,9 +15,11 @@ import itertools
 import math
 
 from qiskit import QuantumRegister, QuantumCircuit, transpile
+from qiskit.circuit.library import QFTGate
 from qiskit.converters import circuit_to_dag
+from qiskit.synthesis.qft import synth_qft_full, synth_qft_line
 from qiskit.transpiler import CouplingMap
-from qiskit.transpiler.passes import SabreSwap
+from qiskit.transpiler.passes import HighLevelSynthesis, SabreSwap
 
 
 def build_model_circuit(qreg, circuit=None):
@@ -74,6 +76,28 @@ class QftTranspileBench:
         )
 
 
+class QftSynthesisBench:
+    params = ([10, 50, 100], [0, 5])
+    param_names = ["n_qubits", "approximation_degree"]
+
+    def setup(self, n, _):
+        # A phase-estimation-like circuit, which applies the same QFT many times.
+        self.circuit = QuantumCircuit(n)
+        for _ in range(20):
+            self.circuit.append(QFTGate(n), self.circuit.qubits)
+            self.circuit.append(QFTGate(n).inverse(), self.circuit.qubits)
+        self.pass_ = HighLevelSynthesis(basis_gates=["cp", "h", "swap"])
+
+    def time_synth_qft_full(self, n, approximation_degree):
+        synth_qft_full(n, approximation_degree=approximation_degree)
+
+    def time_synth_qft_line(self, n, approximation_degree):
+        synth_qft_line(n, approximation_degree=approximation_degree)
+
+    def time_high_level_synthesis(self, *_):
+        self.pass_(self.circuit)
+
+
 class LargeQFTMappingTimeBench:
     timeout = 600.0  # seconds
 
@@ -101,3 +101,47 @@ class ParameterizedBenchmarks:
         qpy.dump(self.circuit, qpy_file)
         qpy_file.seek(0)
         qpy.load(qpy_file)
+
+
+class CompressedBenchmarks:
+
+    params = ([None, "zstd", "lz4"], [False, True])
+
+    param_names = ["compression", "train_dictionary"]
+    timeout = 300
+
+    def setup(self, compression, train_dictionary):
+        if compression is None and train_dictionary:
+            raise NotImplementedError
+        self.circuits = [
+            random_circuit(20, 256, measure=True, seed=seed, max_operands=2) for seed in range(20)
+        ]
+        self.qpy_file = io.BytesIO()
+        qpy.dump(
+            self.circuits,
+            self.qpy_file,
+            compression=compression,
+            train_dictionary=train_dictionary,
+        )
+
+    def time_dump(self, compression, train_dictionary):
+        qpy_file = io.BytesIO()
+        qpy.dump(
+            self.circuits,
+            qpy_file,
+            compression=compression,
+            train_dictionary=train_dictionary,
+        )
+
+    def time_load(self, _, __):
+        self.qpy_file.seek(0)
+        qpy.load(self.qpy_file)
+
+    def time_load_single(self, _, __):
+        self.qpy_file.seek(0)
+        qpy.load(self.qpy_file, programs=[10])
+
+    def track_size(self, _, __):
+        return len(self.qpy_file.getvalue())
+
+    track_size.unit = "bytes"
@@ -14,7 +14,10 @@
 import numpy as np
 from qiskit import QuantumRegister, QuantumCircuit
 from qiskit.compiler import transpile
+from qiskit.circuit.library import Isometry
 from qiskit.circuit.library.data_preparation import StatePreparation
+from qiskit.quantum_info import random_unitary
+from qiskit._accelerate.synthesis.multi_controlled import synth_sparse_state
 
 
 class StatePreparationTranspileBench:
@@ -61,3 +64,52 @@ class StatePreparationTranspileBench:
         counts = circuit.count_ops()
         cnot_count = counts.get("cx", 0)
         return cnot_count
+
+
+class StatePreparationSynthesisBench:
+    params = [8, 10, 12, 14]
+    param_names = ["number of qubits in state"]
+    timeout = 600.0
+
+    def setup(self, n):
+        rng = np.random.default_rng(2026)
+        state = rng.standard_normal(2**n) + 1j * rng.standard_normal(2**n)
+        self.state = state / np.linalg.norm(state)
+
+    def time_state_preparation_definition(self, _):
+        StatePreparation(self.state).definition  # pylint: disable=expression-not-assigned
+
+
+class IsometrySynthesisBench:
+    params = ([4, 6, 8, 10], [0, 1, 2])
+    param_names = ["number of output qubits", "number of input qubits"]
+    timeout = 600.0
+
+    def setup(self, n, m):
+        unitary = random_unitary(2**n, seed=2026).data
+        self.isometry = unitary[:, : 2**m]
+
+    def time_isometry_definition(self, *_):
+        Isometry(self.isometry, 0, 0).definition  # pylint: disable=expression-not-assigned
+
+
+class SparseStatePreparationSynthesisBench:
+    params = ([16, 64, 256, 1024], [20, 40, 64])
+    param_names = ["number of nonzero amplitudes", "number of qubits in state"]
+    timeout = 600.0
+
+    def setup(self, m, n):
+        rng = np.random.default_rng(2026)
+        indices = set()
+        while len(indices) < m:
+            indices.add(int(rng.integers(0, 2**n, dtype=np.uint64)))
+        amplitudes = rng.standard_normal(m) + 1j * rng.standard_normal(m)
+        self.num_qubits = n
+        self.indices = list(indices)
+        self.amplitudes = list(amplitudes / np.linalg.norm(amplitudes))
+
+    def time_sparse_state_synthesis(self, *_):
+        synth_sparse_state(self.num_qubits, self.indices, self.amplitudes)
+
+    def track_sparse_state_gate_count(self, *_):
+        return len(synth_sparse_state(self.num_qubits, self.indices, self.amplitudes))
@@ -0,0 +1,30 @@
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2026
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+
+# pylint: disable=missing-docstring
+# pylint: disable=attribute-defined-outside-init
+
+from qiskit._accelerate.unitary_sim import sim_unitary_circuit
+from qiskit.circuit.random import random_circuit
+
+
+class UnitarySimulationBench:
+    timeout = 600.0  # seconds
+
+    params = [8, 10, 12, 14]
+    param_names = ["n_qubits"]
+
+    def setup(self, n_qubits):
+        self.circuit = random_circuit(n_qubits, depth=20, max_operands=2, seed=2026)
+
+    def time_sim_unitary_circuit(self, _):
+        sim_unitary_circuit(self.circuit._data)
@@ -0,0 +1,115 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "common.h"
+#include <qiskit.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Test that a circuit with registers and symbolic parameters survives a round trip.
+ */
+static int test_circuit_serialize_roundtrip(void) {
+    int result = Ok;
+    QkCircuit *qc = qk_circuit_new(0, 0);
+    QkQuantumRegister *qr = qk_quantum_register_new(2, "q");
+    QkClassicalRegister *cr = qk_classical_register_new(2, "c");
+    qk_circuit_add_quantum_register(qc, qr);
+    qk_circuit_add_classical_register(qc, cr);
+    QkParam *theta = qk_param_new_symbol("theta");
+    qk_circuit_gate(qc, QkGate_H, (uint32_t[]){0}, NULL);
+    qk_circuit_parameterized_gate(qc, QkGate_RZ, (uint32_t[]){1}, (const QkParam *[]){theta});
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+    qk_circuit_measure(qc, 1, 1);
+
+    uint8_t *buffer = NULL;
+    size_t len = 0;
+    QkCircuit *copy = NULL;
+    if (qk_circuit_serialize(qc, &buffer, &len) != QkExitCode_Success) {
+        printf("Serializing the circuit failed\n");
+        result = RuntimeError;
+        goto cleanup;
+    }
+    copy = qk_circuit_deserialize(buffer, len);
+    if (copy == NULL) {
+        printf("Deserializing the circuit failed\n");
+        result = RuntimeError;
+        goto cleanup;
+    }
+    if (qk_circuit_num_qubits(copy) != 2 || qk_circuit_num_clbits(copy) != 2 ||
+        qk_circuit_num_instructions(copy) != 4 || qk_circuit_num_param_symbols(copy) != 1 ||
+        qk_circuit_num_quantum_registers(copy) != 1 ||
+        qk_circuit_num_classical_registers(copy) != 1) {
+        printf("The deserialized circuit does not match the original\n");
+        result = EqualityError;
+        goto cleanup;
+    }
+    QkCircuitInstruction inst;
+    qk_circuit_get_instruction(copy, 3, &inst);
+    if (strcmp(inst.name, "measure") != 0 || inst.qubits[0] != 1 || inst.clbits[0] != 1) {
+        printf("The deserialized measurement does not match the original\n");
+        result = EqualityError;
+    }
+    qk_circuit_instruction_clear(&inst);
+
+cleanup:
+    qk_circuit_serialized_free(buffer, len);
+    qk_circuit_free(copy);
+    qk_param_free(theta);
+    qk_classical_register_free(cr);
+    qk_quantum_register_free(qr);
+    qk_circuit_free(qc);
+    return result;
+}
+
+/**
+ * Test that invalid bytes are rejected rather than read.
+ */
+static int test_circuit_deserialize_invalid(void) {
+    int result = Ok;
+    QkCircuit *qc = qk_circuit_new(2, 0);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+    uint8_t *buffer = NULL;
+    size_t len = 0;
+    qk_circuit_serialize(qc, &buffer, &len);
+
+    QkCircuit *truncated = qk_circuit_deserialize(buffer, len / 2);
+    if (truncated != NULL) {
+        printf("A truncated buffer was deserialized\n");
+        result = EqualityError;
+        qk_circuit_free(truncated);
+        goto cleanup;
+    }
+    uint8_t garbage[64] = {0};
+    if (qk_circuit_deserialize(garbage, sizeof(garbage)) != NULL) {
+        printf("A buffer without a header was deserialized\n");
+        result = EqualityError;
+    }
+
+cleanup:
+    qk_circuit_serialized_free(buffer, len);
+    qk_circuit_free(qc);
+    return result;
+}
+
+int test_circuit_serialize(void) {
+    int num_failed = 0;
+    num_failed += RUN_TEST(test_circuit_serialize_roundtrip);
+    num_failed += RUN_TEST(test_circuit_deserialize_invalid);
+
+    fflush(stderr);
+    fprintf(stderr, "=== Number of failed subtests: %i\n", num_failed);
+
+    return num_failed;
+}
@@ -785,6 +785,165 @@ cleanup:
     return result;
 }
 
+static int test_dag_adjacency_snapshot(void) {
+    int result = Ok;
+    QkDag *dag = qk_dag_new();
+    QkQuantumRegister *qr = qk_quantum_register_new(3, "qr");
+    qk_dag_add_quantum_register(dag, qr);
+    qk_quantum_register_free(qr);
+
+    uint32_t node_h = qk_dag_apply_gate(dag, QkGate_H, (uint32_t[]){0}, NULL, false);
+    uint32_t node_ccx = qk_dag_apply_gate(dag, QkGate_CCX, (uint32_t[]){0, 1, 2}, NULL, false);
+    uint32_t node_cx = qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){1, 2}, NULL, false);
+
+    QkDagAdjacency *adjacency = qk_dag_adjacency_snapshot(dag);
+    if (adjacency->num_edges != 9 || adjacency->num_op_nodes != 3 ||
+        adjacency->topological_op_nodes[0] != node_h ||
+        adjacency->topological_op_nodes[1] != node_ccx ||
+        adjacency->topological_op_nodes[2] != node_cx) {
+        printf("Incorrect number of edges or topological order in the snapshot!\n");
+        result = EqualityError;
+        goto cleanup;
+    }
+    if (adjacency->successor_offsets[adjacency->num_nodes] != adjacency->num_edges ||
+        adjacency->predecessor_offsets[adjacency->num_nodes] != adjacency->num_edges) {
+        printf("Incorrect offsets in the snapshot!\n");
+        result = EqualityError;
+        goto cleanup;
+    }
+    for (uint32_t node = 0; node < adjacency->num_nodes; node++) {
+        if (adjacency->node_types[node] != qk_dag_node_type(dag, node)) {
+            printf("Incorrect type of node %u in the snapshot!\n", node);
+            result = EqualityError;
+            goto cleanup;
+        }
+    }
+
+    // CCX node, with one edge per wire sorted by wire.
+    size_t start = adjacency->successor_offsets[node_ccx];
+    const QkDagEdge *successors = adjacency->successors + start;
+    if (adjacency->successor_offsets[node_ccx + 1] - start != 3 ||
+        successors[0].wire != 0 || successors[0].wire_type != QkDagWireType_Qubit ||
+        adjacency->node_types[successors[0].node] != QkDagNodeType_QubitOut ||
+        successors[1].wire != 1 || successors[1].node != node_cx || successors[2].wire != 2 ||
+        successors[2].node != node_cx) {
+        printf("Incorrect successors of the CCX node in the snapshot!\n");
+        result = EqualityError;
+        goto cleanup;
+    }
+    start = adjacency->predecessor_offsets[node_ccx];
+    const QkDagEdge *predecessors = adjacency->predecessors + start;
+    if (adjacency->predecessor_offsets[node_ccx + 1] - start != 3 ||
+        predecessors[0].wire != 0 || predecessors[0].node != node_h ||
+        predecessors[1].wire != 1 ||
+        predecessors[1].node != qk_dag_qubit_in_node(dag, 1) || predecessors[2].wire != 2 ||
+        predecessors[2].node != qk_dag_qubit_in_node(dag, 2)) {
+        printf("Incorrect predecessors of the CCX node in the snapshot!\n");
+        result = EqualityError;
+    }
+
+cleanup:
+    qk_dag_adjacency_free(adjacency);
+    qk_dag_free(dag);
+    return result;
+}
+
+static bool is_two_qubit(const QkDag *dag, uint32_t node, void *data) {
+    *(size_t *)data += 1;
+    return qk_dag_op_node_num_qubits(dag, node) == 2;
+}
+
+static int test_dag_collect_blocks(void) {
+    int result = Ok;
+    QkDag *dag = qk_dag_new();
+    QkQuantumRegister *qr = qk_quantum_register_new(3, "qr");
+    qk_dag_add_quantum_register(dag, qr);
+    qk_quantum_register_free(qr);
+
+    uint32_t node_h0 = qk_dag_apply_gate(dag, QkGate_H, (uint32_t[]){0}, NULL, false);
+    uint32_t node_s0 = qk_dag_apply_gate(dag, QkGate_S, (uint32_t[]){0}, NULL, false);
+    uint32_t node_cx01 = qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){0, 1}, NULL, false);
+    uint32_t node_h1 = qk_dag_apply_gate(dag, QkGate_H, (uint32_t[]){1}, NULL, false);
+    uint32_t node_cx10 = qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){1, 0}, NULL, false);
+    qk_dag_apply_gate(dag, QkGate_T, (uint32_t[]){2}, NULL, false);
+    uint32_t node_cx12 = qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){1, 2}, NULL, false);
+
+    // The runs are [H, S] on qubit 0, [H] on qubit 1 and [T] on qubit 2.
+    QkDagNodeBlocks runs = qk_dag_collect_1q_runs(dag);
+    QkDagNodeBlocks blocks_2q = qk_dag_collect_2q_blocks(dag);
+    size_t num_calls = 0;
+    QkDagNodeBlocks blocks = qk_dag_collect_blocks(dag, is_two_qubit, &num_calls, 2);
+    // A NULL filter matches every node, and all the gates are connected through their qubits.
+    QkDagNodeBlocks all = qk_dag_collect_blocks(dag, NULL, NULL, 1);
+    if (runs.num_blocks != 3 || runs.num_nodes != 4 || runs.block_offsets[3] != 4) {
+        printf("Unexpected number of 1q runs %zu with %zu nodes\n", runs.num_blocks,
+               runs.num_nodes);
+        result = EqualityError;
+        goto cleanup;
+    }
+    bool found_run = false;
+    for (size_t i = 0; i < runs.num_blocks; i++) {
+        size_t start = runs.block_offsets[i];
+        if (runs.nodes[start] == node_h0) {
+            found_run = runs.block_offsets[i + 1] - start == 2 && runs.nodes[start + 1] == node_s0;
+        }
+    }
+    if (!found_run) {
+        printf("The run on qubit 0 was not collected\n");
+        result = EqualityError;
+        goto cleanup;
+    }
+
+    // The gates on qubits 0 and 1 form a single 2q block.
+    bool found_block = false;
+    for (size_t i = 0; i < blocks_2q.num_blocks; i++) {
+        size_t start = blocks_2q.block_offsets[i];
+        size_t end = blocks_2q.block_offsets[i + 1];
+        bool has_cx01 = false, has_h1 = false, has_cx10 = false;
+        for (size_t j = start; j < end; j++) {
+            has_cx01 |= blocks_2q.nodes[j] == node_cx01;
+            has_h1 |= blocks_2q.nodes[j] == node_h1;
+            has_cx10 |= blocks_2q.nodes[j] == node_cx10;
+        }
+        found_block |= has_cx01 && has_h1 && has_cx10;
+    }
+    if (!found_block) {
+        printf("The 2q block on qubits 0 and 1 was not collected\n");
+        result = EqualityError;
+        goto cleanup;
+    }
+
+    // The H on qubit 1 separates the first CX from the other two, and the block with the first
+    // CX alone is below the minimum size.
+    if (num_calls != 7 || blocks.num_blocks != 1 || blocks.num_nodes != 2 ||
+        blocks.nodes[0] != node_cx10 || blocks.nodes[1] != node_cx12) {
+        printf("Unexpected blocks collected by the filter (%zu calls, %zu blocks)\n", num_calls,
+               blocks.num_blocks);
+        result = EqualityError;
+        goto cleanup;
+    }
+    if (all.num_blocks != 1 || all.num_nodes != 7) {
+        printf("Unexpected blocks collected without a filter (%zu blocks, %zu nodes)\n",
+               all.num_blocks, all.num_nodes);
+        result = EqualityError;
+        goto cleanup;
+    }
+
+    qk_dag_node_blocks_clear(&blocks);
+    if (blocks.nodes != NULL || blocks.block_offsets != NULL || blocks.num_blocks != 0) {
+        printf("qk_dag_node_blocks_clear didn't work!\n");
+        result = RuntimeError;
+    }
+
+cleanup:
+    qk_dag_node_blocks_clear(&runs);
+    qk_dag_node_blocks_clear(&blocks_2q);
+    qk_dag_node_blocks_clear(&blocks);
+    qk_dag_node_blocks_clear(&all);
+    qk_dag_free(dag);
+    return result;
+}
+
 static int test_dag_copy_empty_like(void) {
     int result = Ok;
 
@@ -1375,6 +1534,140 @@ cleanup:
     return result;
 }
 
+static int test_dag_rewrite(void) {
+    int result = Ok;
+
+    // Create a DAG with H, T, S, CX, X gates
+    QkDag *dag = qk_dag_new();
+    QkQuantumRegister *qr = qk_quantum_register_new(2, "qr");
+    qk_dag_add_quantum_register(dag, qr);
+    uint32_t idx_h = qk_dag_apply_gate(dag, QkGate_H, (uint32_t[]){0}, NULL, false);
+    uint32_t idx_t = qk_dag_apply_gate(dag, QkGate_T, (uint32_t[]){1}, NULL, false);
+    uint32_t idx_s = qk_dag_apply_gate(dag, QkGate_S, (uint32_t[]){1}, NULL, false);
+    uint32_t idx_cx = qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){0, 1}, NULL, false);
+    qk_dag_apply_gate(dag, QkGate_X, (uint32_t[]){0}, NULL, false);
+
+    // Build a replacement for the CX, with a CZ conjugated by H on the target.
+    QkDag *replacement = qk_dag_new();
+    QkQuantumRegister *replacement_qr = qk_quantum_register_new(2, "other");
+    qk_dag_add_quantum_register(replacement, replacement_qr);
+    qk_dag_apply_gate(replacement, QkGate_H, (uint32_t[]){1}, NULL, false);
+    qk_dag_apply_gate(replacement, QkGate_CZ, (uint32_t[]){0, 1}, NULL, false);
+    qk_dag_apply_gate(replacement, QkGate_H, (uint32_t[]){1}, NULL, false);
+    QkParam *phase = qk_param_from_double(0.5);
+    qk_dag_set_global_phase(replacement, phase);
+    qk_param_free(phase);
+    QkDag *small = qk_dag_new();
+
+    static const QkComplex64 mat_ts[4] = {{1, 0}, {0, 0}, {0, 0}, {-M_SQRT1_2, M_SQRT1_2}};
+    QkDagRewrite *rewrite = qk_dag_rewrite_begin(dag);
+    QkExitCode codes[7] = {
+        qk_dag_rewrite_remove_node(rewrite, idx_h),
+        qk_dag_rewrite_replace_block_with_unitary(rewrite, 2, (uint32_t[]){idx_t, idx_s}, mat_ts,
+                                                  1, (uint32_t[]){1}),
+        qk_dag_rewrite_substitute_node_with_dag(rewrite, idx_cx, small),
+        qk_dag_rewrite_substitute_node_with_dag(rewrite, idx_cx, replacement),
+        qk_dag_rewrite_remove_node(rewrite, idx_s),
+        qk_dag_rewrite_remove_node(rewrite, qk_dag_qubit_in_node(dag, 0)),
+        qk_dag_rewrite_replace_block_with_unitary(rewrite, 1, (uint32_t[]){idx_cx}, mat_ts, 1,
+                                                  (uint32_t[]){1}),
+    };
+    QkExitCode expected[7] = {
+        QkExitCode_Success,
+        QkExitCode_Success,
+        QkExitCode_MismatchedQubits, // wrong number of qubits
+        QkExitCode_Success,
+        QkExitCode_DagRewriteConflict, // already in the block
+        QkExitCode_IndexError,         // not an operation node
+        QkExitCode_MismatchedQubits,   // acts on qubit 0 too
+    };
+    for (int i = 0; i < 7; i++) {
+        if (codes[i] != expected[i]) {
+            printf("Queueing edit %d returned %d, expected %d\n", i, codes[i], expected[i]);
+            result = EqualityError;
+        }
+    }
+    QkExitCode exit_code = qk_dag_rewrite_commit(rewrite);
+    if (result != Ok) {
+        goto cleanup;
+    }
+    if (exit_code != QkExitCode_Success) {
+        printf("Commit failed with exit code %d\n", exit_code);
+        result = RuntimeError;
+        goto cleanup;
+    }
+
+    // The DAG is now U(1) H(1) CZ(0, 1) H(1) X(0), where the first three are in this order.
+    size_t num_ops = qk_dag_num_op_nodes(dag);
+    QkParam *out_phase = qk_dag_global_phase(dag);
+    double out_phase_val = qk_param_as_real(out_phase);
+    qk_param_free(out_phase);
+    if (num_ops != 5 || out_phase_val != 0.5) {
+        printf("Unexpected DAG after the rewrite: %zu operations, global phase %f\n", num_ops,
+               out_phase_val);
+        result = EqualityError;
+        goto cleanup;
+    }
+    uint32_t order[5];
+    qk_dag_topological_op_nodes(dag, order);
+    if (qk_dag_op_node_kind(dag, order[0]) != QkOperationKind_Unitary ||
+        qk_dag_op_node_gate_op(dag, order[1], NULL) != QkGate_H ||
+        qk_dag_op_node_gate_op(dag, order[2], NULL) != QkGate_CZ) {
+        printf("Unexpected order of operations after the rewrite\n");
+        result = EqualityError;
+    }
+
+cleanup:
+    qk_dag_free(small);
+    qk_quantum_register_free(replacement_qr);
+    qk_dag_free(replacement);
+    qk_quantum_register_free(qr);
+    qk_dag_free(dag);
+
+    return result;
+}
+
+static int test_dag_rewrite_cycle(void) {
+    int result = Ok;
+
+    // Create a DAG with CX, H, CX
+    QkDag *dag = qk_dag_new();
+    QkQuantumRegister *qr = qk_quantum_register_new(2, "qr");
+    qk_dag_add_quantum_register(dag, qr);
+    uint32_t idx1 = qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){0, 1}, NULL, false);
+    uint32_t idx_h = qk_dag_apply_gate(dag, QkGate_H, (uint32_t[]){1}, NULL, false);
+    uint32_t idx2 = qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){0, 1}, NULL, false);
+
+    // Contracting the two CX gates would introduce a cycle through the H gate.
+    static const QkComplex64 identity_mat_2[16] = {
+        {1, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {1, 0}, {0, 0}, {0, 0},
+        {0, 0}, {0, 0}, {1, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {1, 0},
+    };
+    QkDagRewrite *rewrite = qk_dag_rewrite_begin(dag);
+    qk_dag_rewrite_remove_node(rewrite, idx_h);
+    qk_dag_rewrite_replace_block_with_unitary(rewrite, 2, (uint32_t[]){idx1, idx2},
+                                              identity_mat_2, 2, (uint32_t[]){0, 1});
+    QkExitCode exit_code = qk_dag_rewrite_commit(rewrite);
+    if (exit_code != QkExitCode_DagRewriteCycle) {
+        printf("Commit returned %d, expected %d\n", exit_code, QkExitCode_DagRewriteCycle);
+        result = EqualityError;
+        goto cleanup;
+    }
+
+    // The original DAG should be left unchanged.
+    size_t num_ops = qk_dag_num_op_nodes(dag);
+    if (num_ops != 3 || qk_dag_op_node_gate_op(dag, idx_h, NULL) != QkGate_H) {
+        printf("The DAG was modified by a failed rewrite\n");
+        result = EqualityError;
+    }
+
+cleanup:
+    qk_quantum_register_free(qr);
+    qk_dag_free(dag);
+
+    return result;
+}
+
 int test_dag(void) {
     int num_failed = 0;
     num_failed += RUN_TEST(test_empty);
@@ -1391,6 +1684,8 @@ int test_dag(void) {
     num_failed += RUN_TEST(test_unitary_gates);
     num_failed += RUN_TEST(test_substitute_node_with_dag);
     num_failed += RUN_TEST(test_dag_node_neighbors);
+    num_failed += RUN_TEST(test_dag_adjacency_snapshot);
+    num_failed += RUN_TEST(test_dag_collect_blocks);
     num_failed += RUN_TEST(test_dag_copy_empty_like);
     num_failed += RUN_TEST(test_dag_compose);
     num_failed += RUN_TEST(test_dag_compose_permuted);
@@ -1398,6 +1693,8 @@ int test_dag(void) {
     num_failed += RUN_TEST(test_dag_replace_qubitless_block_with_unitary);
     num_failed += RUN_TEST(test_dag_replace_illegal_block_with_unitary);
     num_failed += RUN_TEST(test_dag_substitute_node_with_unitary);
+    num_failed += RUN_TEST(test_dag_rewrite);
+    num_failed += RUN_TEST(test_dag_rewrite_cycle);
 
     fflush(stderr);
     fprintf(stderr, "=== Number of failed subtests: %i\n", num_failed);
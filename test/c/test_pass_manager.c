@@ -0,0 +1,304 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "common.h"
+#include <qiskit.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Build a target with X, SX, RZ and CX on a line of qubits.
+ */
+static QkTarget *line_target(uint32_t num_qubits) {
+    QkTarget *target = qk_target_new(num_qubits);
+    QkGate gates_1q[3] = {QkGate_X, QkGate_SX, QkGate_RZ};
+    for (int g = 0; g < 3; g++) {
+        QkTargetEntry *entry = qk_target_entry_new(gates_1q[g]);
+        for (uint32_t i = 0; i < num_qubits; i++) {
+            uint32_t qargs[1] = {i};
+            qk_target_entry_add_property(entry, qargs, 1, 0.0, 1e-6);
+        }
+        qk_target_add_instruction(target, entry);
+    }
+    QkTargetEntry *cx_entry = qk_target_entry_new(QkGate_CX);
+    for (uint32_t i = 0; i < num_qubits - 1; i++) {
+        uint32_t forward[2] = {i, i + 1};
+        uint32_t backward[2] = {i + 1, i};
+        qk_target_entry_add_property(cx_entry, forward, 2, 0.0, 1e-3);
+        qk_target_entry_add_property(cx_entry, backward, 2, 0.0, 1e-3);
+    }
+    qk_target_add_instruction(target, cx_entry);
+    return target;
+}
+
+typedef struct {
+    int after_layout;
+    int optimization_loop;
+    int after_optimization;
+    uint32_t num_qubits;
+} PassCalls;
+
+static QkExitCode count_after_layout(QkDag *dag, const QkTarget *target, QkTranspileLayout *layout,
+                                     void *data) {
+    (void)layout;
+    PassCalls *calls = data;
+    calls->after_layout += 1;
+    // The circuit is defined over the physical qubits of the target after the layout stage.
+    calls->num_qubits = qk_dag_num_qubits(dag);
+    if (calls->num_qubits != qk_target_num_qubits(target)) {
+        return QkExitCode_TranspilerError;
+    }
+    return QkExitCode_Success;
+}
+
+static QkExitCode add_h_in_loop(QkDag *dag, const QkTarget *target, QkTranspileLayout *layout,
+                                void *data) {
+    (void)target;
+    (void)layout;
+    PassCalls *calls = data;
+    // Only add a gate in the first iteration, so that the loop reaches a fixed point.
+    if (calls->optimization_loop == 0) {
+        qk_dag_apply_gate(dag, QkGate_H, (uint32_t[]){0}, NULL, false);
+    }
+    calls->optimization_loop += 1;
+    return QkExitCode_Success;
+}
+
+static QkExitCode count_after_optimization(QkDag *dag, const QkTarget *target,
+                                           QkTranspileLayout *layout, void *data) {
+    (void)dag;
+    (void)target;
+    (void)layout;
+    PassCalls *calls = data;
+    calls->after_optimization += 1;
+    return QkExitCode_Success;
+}
+
+static QkExitCode fail(QkDag *dag, const QkTarget *target, QkTranspileLayout *layout,
+                       void *data) {
+    (void)dag;
+    (void)target;
+    (void)layout;
+    (void)data;
+    return QkExitCode_DagError;
+}
+
+/**
+ * Test that callback passes run at their insertion points, and that gates added in the
+ * optimization loop are translated to the target.
+ */
+static int test_pass_manager_callbacks(void) {
+    int result = Ok;
+    QkTarget *target = line_target(3);
+    QkCircuit *qc = qk_circuit_new(3, 0);
+    qk_circuit_gate(qc, QkGate_H, (uint32_t[]){0}, NULL);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){1, 2}, NULL);
+
+    QkTranspileOptions options = qk_transpiler_default_options();
+    options.optimization_level = 1;
+    options.seed = 42;
+    QkPassManager *pm = qk_pass_manager_new(&options);
+    PassCalls calls = {0, 0, 0, 0};
+    qk_pass_manager_add_pass(pm, QkPassInsertionPoint_AfterLayout, count_after_layout, &calls);
+    qk_pass_manager_add_pass(pm, QkPassInsertionPoint_OptimizationLoop, add_h_in_loop, &calls);
+    qk_pass_manager_add_native_pass(pm, QkPassInsertionPoint_AfterOptimization,
+                                    QkNativePass_InverseCancellation);
+    qk_pass_manager_add_pass(pm, QkPassInsertionPoint_AfterOptimization, count_after_optimization,
+                             &calls);
+    if (qk_pass_manager_add_pass(pm, QkPassInsertionPoint_AfterInit, NULL, NULL) !=
+        QkExitCode_NullPointerError) {
+        printf("A null pass was accepted\n");
+        result = EqualityError;
+        goto cleanup;
+    }
+
+    QkTranspileResult transpile_result = {NULL, NULL};
+    char *error = NULL;
+    QkExitCode exit_code = qk_pass_manager_run(pm, qc, target, &transpile_result, &error);
+    if (exit_code != QkExitCode_Success) {
+        printf("Transpilation failed with: %s\n", error);
+        qk_str_free(error);
+        result = RuntimeError;
+        goto cleanup;
+    }
+    if (calls.after_layout != 1 || calls.num_qubits != 3 || calls.optimization_loop < 2 ||
+        calls.after_optimization != 1) {
+        printf("Unexpected pass calls: %d after layout, %d in the loop, %d after optimization\n",
+               calls.after_layout, calls.optimization_loop, calls.after_optimization);
+        result = EqualityError;
+        goto transpile_cleanup;
+    }
+    QkOpCounts op_counts = qk_circuit_count_ops(transpile_result.circuit);
+    for (size_t i = 0; i < op_counts.len; i++) {
+        const char *name = op_counts.data[i].name;
+        if (strcmp(name, "x") != 0 && strcmp(name, "sx") != 0 && strcmp(name, "rz") != 0 &&
+            strcmp(name, "cx") != 0) {
+            printf("Gate %s outside the target found in the circuit\n", name);
+            result = EqualityError;
+            break;
+        }
+    }
+    qk_opcounts_clear(&op_counts);
+
+transpile_cleanup:
+    qk_circuit_free(transpile_result.circuit);
+    qk_transpile_layout_free(transpile_result.layout);
+cleanup:
+    qk_pass_manager_free(pm);
+    qk_circuit_free(qc);
+    qk_target_free(target);
+    return result;
+}
+
+/**
+ * Test that the exit code of a failing callback pass is returned.
+ */
+static int test_pass_manager_failing_pass(void) {
+    int result = Ok;
+    QkTarget *target = line_target(2);
+    QkCircuit *qc = qk_circuit_new(2, 0);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+
+    QkPassManager *pm = qk_pass_manager_new(NULL);
+    qk_pass_manager_add_pass(pm, QkPassInsertionPoint_AfterRouting, fail, NULL);
+    QkTranspileResult transpile_result = {NULL, NULL};
+    char *error = NULL;
+    QkExitCode exit_code = qk_pass_manager_run(pm, qc, target, &transpile_result, &error);
+    if (exit_code != QkExitCode_DagError) {
+        printf("Unexpected exit code %d\n", exit_code);
+        result = EqualityError;
+    }
+    if (error == NULL) {
+        printf("No error message was written\n");
+        result = EqualityError;
+    }
+    qk_str_free(error);
+    qk_pass_manager_free(pm);
+    qk_circuit_free(qc);
+    qk_target_free(target);
+    return result;
+}
+
+/**
+ * Test that the native RestoreFinalLayout pass undoes the routing permutation, and that its swaps
+ * are translated to the target.
+ */
+static int test_pass_manager_restore_final_layout(void) {
+    const uint32_t num_qubits = 5;
+    int result = Ok;
+    QkTarget *target = line_target(num_qubits);
+    QkCircuit *qc = qk_circuit_new(num_qubits, 0);
+    qk_circuit_gate(qc, QkGate_H, (uint32_t[]){0}, NULL);
+    for (uint32_t i = 1; i < num_qubits; i++) {
+        qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, i}, NULL);
+    }
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){4, 1}, NULL);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){3, 0}, NULL);
+
+    QkTranspileOptions options = qk_transpiler_default_options();
+    options.optimization_level = 1;
+    options.seed = 1234;
+    QkPassManager *pm = qk_pass_manager_new(&options);
+    qk_pass_manager_add_native_pass(pm, QkPassInsertionPoint_AfterRouting,
+                                    QkNativePass_RestoreFinalLayout);
+    QkTranspileResult transpile_result = {NULL, NULL};
+    char *error = NULL;
+    QkExitCode exit_code = qk_pass_manager_run(pm, qc, target, &transpile_result, &error);
+    if (exit_code != QkExitCode_Success) {
+        printf("Transpilation failed with: %s\n", error);
+        qk_str_free(error);
+        result = RuntimeError;
+        goto cleanup;
+    }
+    uint32_t permutation[5];
+    if (qk_transpile_layout_output_permutation(transpile_result.layout, permutation)) {
+        for (uint32_t i = 0; i < num_qubits; i++) {
+            if (permutation[i] != i) {
+                printf("Qubit %u ends on qubit %u\n", i, permutation[i]);
+                result = EqualityError;
+                goto transpile_cleanup;
+            }
+        }
+    }
+    QkOpCounts op_counts = qk_circuit_count_ops(transpile_result.circuit);
+    for (size_t i = 0; i < op_counts.len; i++) {
+        const char *name = op_counts.data[i].name;
+        if (strcmp(name, "x") != 0 && strcmp(name, "sx") != 0 && strcmp(name, "rz") != 0 &&
+            strcmp(name, "cx") != 0) {
+            printf("Gate %s outside the target found in the circuit\n", name);
+            result = EqualityError;
+            break;
+        }
+    }
+    qk_opcounts_clear(&op_counts);
+
+transpile_cleanup:
+    qk_circuit_free(transpile_result.circuit);
+    qk_transpile_layout_free(transpile_result.layout);
+cleanup:
+    qk_pass_manager_free(pm);
+    qk_circuit_free(qc);
+    qk_target_free(target);
+    return result;
+}
+
+/**
+ * Test that the native RestoreFinalLayout pass fails before the layout stage, and after the
+ * translation stage when the target does not support swaps.
+ */
+static int test_pass_manager_restore_final_layout_invalid_point(void) {
+    int result = Ok;
+    QkTarget *target = line_target(3);
+    QkCircuit *qc = qk_circuit_new(3, 0);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, 2}, NULL);
+
+    QkPassInsertionPoint points[2] = {QkPassInsertionPoint_AfterInit,
+                                      QkPassInsertionPoint_AfterTranslation};
+    for (int i = 0; i < 2; i++) {
+        QkPassManager *pm = qk_pass_manager_new(NULL);
+        qk_pass_manager_add_native_pass(pm, points[i], QkNativePass_RestoreFinalLayout);
+        QkTranspileResult transpile_result = {NULL, NULL};
+        char *error = NULL;
+        QkExitCode exit_code = qk_pass_manager_run(pm, qc, target, &transpile_result, &error);
+        qk_pass_manager_free(pm);
+        qk_str_free(error);
+        if (exit_code != QkExitCode_TranspilerError) {
+            printf("Unexpected exit code %d at point %d\n", exit_code, points[i]);
+            if (exit_code == QkExitCode_Success) {
+                qk_circuit_free(transpile_result.circuit);
+                qk_transpile_layout_free(transpile_result.layout);
+            }
+            result = EqualityError;
+            break;
+        }
+    }
+    qk_circuit_free(qc);
+    qk_target_free(target);
+    return result;
+}
+
+int test_pass_manager(void) {
+    int num_failed = 0;
+    num_failed += RUN_TEST(test_pass_manager_callbacks);
+    num_failed += RUN_TEST(test_pass_manager_failing_pass);
+    num_failed += RUN_TEST(test_pass_manager_restore_final_layout);
+    num_failed += RUN_TEST(test_pass_manager_restore_final_layout_invalid_point);
+
+    fflush(stderr);
+    fprintf(stderr, "=== Number of failed subtests: %i\n", num_failed);
+
+    return num_failed;
+}
@@ -0,0 +1,127 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "common.h"
+#include <math.h>
+#include <qiskit.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Test that the QFT maps the all-zeros state to the uniform superposition.
+ */
+static int test_qft_uniform_superposition(void) {
+    const uint32_t num_qubits = 4;
+    int result = Ok;
+    QkCircuit *qft = qk_circuit_library_qft(num_qubits, 0, true, false);
+    QkComplex64 state[16];
+    QkExitCode exit_code = qk_circuit_statevector(qft, state);
+    if (exit_code != QkExitCode_Success) {
+        printf("Simulation failed with exit code %d\n", exit_code);
+        result = RuntimeError;
+        goto cleanup;
+    }
+    for (size_t i = 0; i < 16; i++) {
+        if (fabs(state[i].re - 0.25) > 1e-12 || fabs(state[i].im) > 1e-12) {
+            printf("Unexpected amplitude %zu: %f + %fi\n", i, state[i].re, state[i].im);
+            result = EqualityError;
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    qk_circuit_free(qft);
+    return result;
+}
+
+/**
+ * Test that the QFTs for full and linear connectivity, and their inverses, are equivalent.
+ */
+static int test_qft_full_and_line_equivalent(void) {
+    const uint32_t num_qubits = 5;
+    int result = Ok;
+    for (int inverse = 0; inverse < 2; inverse++) {
+        QkCircuit *full = qk_circuit_library_qft(num_qubits, 0, true, inverse);
+        QkCircuit *line = qk_circuit_library_qft_line(num_qubits, 0, true, inverse);
+        QkCircuit *reversed = qk_circuit_library_qft_line(num_qubits, 0, false, inverse);
+        bool equivalent = false;
+        bool reversed_equivalent = true;
+        QkExitCode exit_code = qk_circuit_equiv_check(full, line, NULL, &equivalent);
+        QkExitCode reversed_exit_code =
+            qk_circuit_equiv_check(full, reversed, NULL, &reversed_equivalent);
+        qk_circuit_free(full);
+        qk_circuit_free(line);
+        qk_circuit_free(reversed);
+        if (exit_code != QkExitCode_Success || !equivalent) {
+            printf("The QFTs are not equivalent (inverse: %d, exit code %d)\n", inverse,
+                   exit_code);
+            result = EqualityError;
+            break;
+        }
+        if (reversed_exit_code != QkExitCode_Success || reversed_equivalent) {
+            printf("The QFT-with-reversal is equivalent to the QFT (inverse: %d, exit code %d)\n",
+                   inverse, reversed_exit_code);
+            result = EqualityError;
+            break;
+        }
+    }
+    return result;
+}
+
+/**
+ * Test that approximating the QFT drops the smallest rotations, and that the cached circuits
+ * returned for repeated calls are independent copies.
+ */
+static int test_qft_approximation(void) {
+    int result = Ok;
+    QkCircuit *approximate = qk_circuit_library_qft(5, 2, false, false);
+    QkCircuit *again = qk_circuit_library_qft(5, 2, false, false);
+    // Only the rotations by pi / 2 and pi / 4 are left.
+    QkOpCounts counts = qk_circuit_count_ops(approximate);
+    size_t num_cp = 0;
+    for (size_t i = 0; i < counts.len; i++) {
+        if (strcmp(counts.data[i].name, "cp") == 0) {
+            num_cp = counts.data[i].count;
+        }
+    }
+    qk_opcounts_clear(&counts);
+    if (num_cp != 7) {
+        printf("Expected 7 cp gates, but found %zu\n", num_cp);
+        result = EqualityError;
+        goto cleanup;
+    }
+    qk_circuit_gate(approximate, QkGate_X, (uint32_t[]){0}, NULL);
+    if (qk_circuit_num_instructions(again) != qk_circuit_num_instructions(approximate) - 1) {
+        printf("Modifying a QFT circuit changed another one\n");
+        result = EqualityError;
+    }
+
+cleanup:
+    qk_circuit_free(approximate);
+    qk_circuit_free(again);
+    return result;
+}
+
+int test_qft(void) {
+    int num_failed = 0;
+    num_failed += RUN_TEST(test_qft_uniform_superposition);
+    num_failed += RUN_TEST(test_qft_full_and_line_equivalent);
+    num_failed += RUN_TEST(test_qft_approximation);
+
+    fflush(stderr);
+    fprintf(stderr, "=== Number of failed subtests: %i\n", num_failed);
+
+    return num_failed;
+}
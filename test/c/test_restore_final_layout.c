@@ -0,0 +1,148 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "common.h"
+#include <qiskit.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static QkTarget *line_target(uint32_t num_qubits) {
+    QkTarget *target = qk_target_new(num_qubits);
+    QkTargetEntry *cx_entry = qk_target_entry_new(QkGate_CX);
+    for (uint32_t i = 0; i < num_qubits - 1; i++) {
+        qk_target_entry_add_property(cx_entry, (uint32_t[]){i, i + 1}, 2, 0.0, 0.001 * (i + 1));
+        qk_target_entry_add_property(cx_entry, (uint32_t[]){i + 1, i}, 2, 0.0, 0.001 * (i + 1));
+    }
+    qk_target_add_instruction(target, cx_entry);
+    qk_target_add_instruction(target, qk_target_entry_new(QkGate_U));
+    qk_target_add_instruction(target, qk_target_entry_new(QkGate_Swap));
+    return target;
+}
+
+/**
+ * Test that restoring the final layout of a routed circuit undoes the routing permutation,
+ * using only swaps between coupled qubits.
+ */
+static int test_restore_final_layout_routed(void) {
+    const uint32_t num_qubits = 5;
+    int result = Ok;
+    QkCircuit *qc = qk_circuit_new(num_qubits, 0);
+    qk_circuit_gate(qc, QkGate_H, (uint32_t[]){0}, NULL);
+    for (uint32_t i = 1; i < num_qubits; i++) {
+        qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, i}, NULL);
+    }
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){4, 1}, NULL);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){3, 0}, NULL);
+    QkTarget *target = line_target(num_qubits);
+    QkTranspileOptions options = {0, 1234, 1.0};
+    QkTranspileResult transpile_result = {NULL, NULL};
+    uint32_t *permutation = malloc(sizeof(uint32_t) * num_qubits);
+    if (qk_transpile(qc, target, &options, &transpile_result, NULL) != QkExitCode_Success) {
+        printf("Transpilation failed\n");
+        result = RuntimeError;
+        goto cleanup;
+    }
+    size_t num_before = qk_circuit_num_instructions(transpile_result.circuit);
+
+    QkExitCode exit_code = qk_transpiler_pass_standalone_restore_final_layout(
+        transpile_result.circuit, target, transpile_result.layout, 8, 42);
+    if (exit_code != QkExitCode_Success) {
+        printf("RestoreFinalLayout failed with exit code %d\n", exit_code);
+        result = RuntimeError;
+        goto cleanup;
+    }
+    if (qk_transpile_layout_output_permutation(transpile_result.layout, permutation)) {
+        for (uint32_t i = 0; i < num_qubits; i++) {
+            if (permutation[i] != i) {
+                printf("Qubit %u ends on qubit %u\n", i, permutation[i]);
+                result = EqualityError;
+                goto cleanup;
+            }
+        }
+    }
+    size_t num_after = qk_circuit_num_instructions(transpile_result.circuit);
+    for (size_t i = num_before; i < num_after; i++) {
+        QkCircuitInstruction inst;
+        qk_circuit_get_instruction(transpile_result.circuit, i, &inst);
+        bool coupled = inst.num_qubits == 2 && (inst.qubits[0] + 1 == inst.qubits[1] ||
+                                                inst.qubits[1] + 1 == inst.qubits[0]);
+        qk_circuit_instruction_clear(&inst);
+        if (!coupled) {
+            printf("Instruction %zu is not a swap between coupled qubits\n", i);
+            result = EqualityError;
+            goto cleanup;
+        }
+    }
+
+    bool equivalent = false;
+    exit_code =
+        qk_circuit_equiv_check(qc, transpile_result.circuit, transpile_result.layout, &equivalent);
+    if (exit_code != QkExitCode_Success || !equivalent) {
+        printf("The restored circuit is not equivalent (exit code %d)\n", exit_code);
+        result = EqualityError;
+    }
+
+cleanup:
+    free(permutation);
+    qk_circuit_free(transpile_result.circuit);
+    qk_transpile_layout_free(transpile_result.layout);
+    qk_target_free(target);
+    qk_circuit_free(qc);
+    return result;
+}
+
+/**
+ * Test that a disconnected target is reported as a transpiler error.
+ */
+static int test_restore_final_layout_disconnected(void) {
+    int result = Ok;
+    QkTarget *target = qk_target_new(4);
+    QkTargetEntry *cx_entry = qk_target_entry_new(QkGate_CX);
+    qk_target_entry_add_property(cx_entry, (uint32_t[]){0, 1}, 2, 0.0, 0.0);
+    qk_target_entry_add_property(cx_entry, (uint32_t[]){2, 3}, 2, 0.0, 0.0);
+    qk_target_add_instruction(target, cx_entry);
+    // Eliding the swap leaves a circuit whose output permutation exchanges qubits 0 and 2.
+    QkCircuit *qc = qk_circuit_new(4, 0);
+    qk_circuit_gate(qc, QkGate_Swap, (uint32_t[]){0, 2}, NULL);
+    QkTranspileLayout *layout = qk_transpiler_pass_standalone_elide_permutations(qc);
+    if (layout == NULL) {
+        printf("Failed to elide the swap\n");
+        result = RuntimeError;
+        goto cleanup;
+    }
+    QkExitCode exit_code =
+        qk_transpiler_pass_standalone_restore_final_layout(qc, target, layout, 4, 0);
+    if (exit_code != QkExitCode_TranspilerError) {
+        printf("Expected a transpiler error, but got exit code %d\n", exit_code);
+        result = EqualityError;
+    }
+    qk_transpile_layout_free(layout);
+
+cleanup:
+    qk_circuit_free(qc);
+    qk_target_free(target);
+    return result;
+}
+
+int test_restore_final_layout(void) {
+    int num_failed = 0;
+    num_failed += RUN_TEST(test_restore_final_layout_routed);
+    num_failed += RUN_TEST(test_restore_final_layout_disconnected);
+
+    fflush(stderr);
+    fprintf(stderr, "=== Number of failed subtests: %i\n", num_failed);
+
+    return num_failed;
+}
@@ -202,10 +202,193 @@ cleanup:
     return result;
 }
 
+/**
+ * Test running sabre layout with a lookahead window that scales with the target.
+ */
+static int test_sabre_layout_lookahead_window(void) {
+    int result = Ok;
+
+    const uint32_t num_qubits = 64;
+    QkTarget *target = qk_target_new(num_qubits);
+    qk_target_add_instruction(target, qk_target_entry_new(QkGate_U));
+    QkTargetEntry *cx_entry = qk_target_entry_new(QkGate_CX);
+    for (uint32_t i = 0; i < num_qubits - 1; i++) {
+        uint32_t qargs[2] = {i, i + 1};
+        qk_target_entry_add_property(cx_entry, qargs, 2, 0.020039, 0.0090393);
+    }
+    qk_target_add_instruction(target, cx_entry);
+
+    QkCircuit *qc = qk_circuit_new(num_qubits, 0);
+    for (uint32_t layer = 0; layer < 8; layer++) {
+        for (uint32_t i = 0; i < num_qubits / 2; i++) {
+            uint32_t qargs[2] = {i, (i + 7 * layer + 5) % num_qubits};
+            if (qargs[0] == qargs[1]) {
+                continue;
+            }
+            qk_circuit_gate(qc, QkGate_CX, qargs, NULL);
+        }
+    }
+    QkSabreLayoutOptions options = qk_sabre_layout_options_default();
+    options.seed = 2025;
+    options.lookahead_layers = 0;
+    options.lookahead_decay = 0.5;
+    QkTranspileLayout *layout_result =
+        qk_transpiler_pass_standalone_sabre_layout(qc, target, &options);
+
+    size_t num_instructions = qk_circuit_num_instructions(qc);
+    QkCircuitInstruction inst;
+    for (size_t i = 0; i < num_instructions; i++) {
+        qk_circuit_get_instruction(qc, i, &inst);
+        if (inst.num_qubits == 2) {
+            uint32_t distance = inst.qubits[0] > inst.qubits[1] ? inst.qubits[0] - inst.qubits[1]
+                                                                : inst.qubits[1] - inst.qubits[0];
+            if (distance != 1) {
+                printf("Instruction %s on qubits (%u, %u) is not on a coupling edge\n", inst.name,
+                       inst.qubits[0], inst.qubits[1]);
+                result = EqualityError;
+            }
+        }
+        qk_circuit_instruction_clear(&inst);
+        if (result != Ok) {
+            break;
+        }
+    }
+
+    qk_transpile_layout_free(layout_result);
+    qk_circuit_free(qc);
+    qk_target_free(target);
+    return result;
+}
+
+/**
+ * Test that invalid lookahead options return NULL and leave the circuit unchanged.
+ */
+static int test_sabre_layout_invalid_lookahead(void) {
+    int result = Ok;
+
+    QkTarget *target = qk_target_new(3);
+    QkTargetEntry *cx_entry = qk_target_entry_new(QkGate_CX);
+    for (uint32_t i = 0; i < 2; i++) {
+        uint32_t qargs[2] = {i, i + 1};
+        qk_target_entry_add_property(cx_entry, qargs, 2, 0.0, 0.0);
+    }
+    qk_target_add_instruction(target, cx_entry);
+    QkCircuit *qc = qk_circuit_new(3, 0);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, 2}, NULL);
+
+    uint32_t layers[3] = {65536, 1, 1};
+    double decays[3] = {1.0, 0.0, 1.5};
+    for (int i = 0; i < 3; i++) {
+        QkSabreLayoutOptions options = qk_sabre_layout_options_default();
+        options.lookahead_layers = layers[i];
+        options.lookahead_decay = decays[i];
+        QkTranspileLayout *layout_result =
+            qk_transpiler_pass_standalone_sabre_layout(qc, target, &options);
+        if (layout_result != NULL) {
+            printf("Invalid options (%u layers, decay %f) were accepted\n", layers[i], decays[i]);
+            qk_transpile_layout_free(layout_result);
+            result = EqualityError;
+            break;
+        }
+        if (qk_circuit_num_qubits(qc) != 3 || qk_circuit_num_instructions(qc) != 1) {
+            printf("The circuit was modified by a failed run\n");
+            result = EqualityError;
+            break;
+        }
+    }
+
+    qk_circuit_free(qc);
+    qk_target_free(target);
+    return result;
+}
+
+/**
+ * Test running sabre layout on a target made of several disconnected chiplets, with a circuit
+ * that has to be split across them and a barrier spanning every chiplet.
+ */
+static int test_sabre_layout_disjoint_chiplets(void) {
+    int result = Ok;
+
+    const uint32_t num_chiplets = 4;
+    const uint32_t chiplet_size = 5;
+    const uint32_t num_qubits = num_chiplets * chiplet_size;
+    QkTarget *target = qk_target_new(num_qubits);
+    qk_target_add_instruction(target, qk_target_entry_new(QkGate_U));
+    QkTargetEntry *cx_entry = qk_target_entry_new(QkGate_CX);
+    for (uint32_t chiplet = 0; chiplet < num_chiplets; chiplet++) {
+        for (uint32_t i = 0; i < chiplet_size - 1; i++) {
+            uint32_t qargs[2] = {chiplet * chiplet_size + i, chiplet * chiplet_size + i + 1};
+            qk_target_entry_add_property(cx_entry, qargs, 2, 0.020039, 0.0090393);
+        }
+    }
+    qk_target_add_instruction(target, cx_entry);
+
+    // Each group of four virtual qubits forms a star that needs routing within a single chiplet.
+    const uint32_t group_size = 4;
+    QkCircuit *qc = qk_circuit_new(num_chiplets * group_size, 0);
+    for (uint32_t group = 0; group < num_chiplets; group++) {
+        for (uint32_t i = 1; i < group_size; i++) {
+            uint32_t qargs[2] = {group * group_size, group * group_size + i};
+            qk_circuit_gate(qc, QkGate_CX, qargs, NULL);
+        }
+    }
+    uint32_t barrier_qubits[16];
+    for (uint32_t i = 0; i < num_chiplets * group_size; i++) {
+        barrier_qubits[i] = i;
+    }
+    qk_circuit_barrier(qc, barrier_qubits, num_chiplets * group_size);
+    for (uint32_t group = 0; group < num_chiplets; group++) {
+        for (uint32_t i = 1; i < group_size; i++) {
+            uint32_t qargs[2] = {group * group_size + i, group * group_size};
+            qk_circuit_gate(qc, QkGate_CX, qargs, NULL);
+        }
+    }
+
+    QkSabreLayoutOptions options = qk_sabre_layout_options_default();
+    options.seed = 2025;
+    QkTranspileLayout *layout_result =
+        qk_transpiler_pass_standalone_sabre_layout(qc, target, &options);
+
+    size_t num_barriers = 0;
+    size_t num_instructions = qk_circuit_num_instructions(qc);
+    QkCircuitInstruction inst;
+    for (size_t i = 0; i < num_instructions; i++) {
+        qk_circuit_get_instruction(qc, i, &inst);
+        if (strcmp(inst.name, "barrier") == 0) {
+            num_barriers++;
+        } else if (inst.num_qubits == 2) {
+            uint32_t low = inst.qubits[0] < inst.qubits[1] ? inst.qubits[0] : inst.qubits[1];
+            uint32_t high = inst.qubits[0] < inst.qubits[1] ? inst.qubits[1] : inst.qubits[0];
+            if (high - low != 1 || low / chiplet_size != high / chiplet_size) {
+                printf("Instruction %s on qubits (%u, %u) is not on a coupling edge\n", inst.name,
+                       inst.qubits[0], inst.qubits[1]);
+                result = EqualityError;
+            }
+        }
+        qk_circuit_instruction_clear(&inst);
+        if (result != Ok) {
+            goto cleanup;
+        }
+    }
+    if (num_barriers != 1) {
+        printf("Expected the barrier to be preserved, but found %zu barriers\n", num_barriers);
+        result = EqualityError;
+    }
+
+cleanup:
+    qk_transpile_layout_free(layout_result);
+    qk_circuit_free(qc);
+    qk_target_free(target);
+    return result;
+}
+
 int test_sabre_layout(void) {
     int num_failed = 0;
     num_failed += RUN_TEST(test_sabre_layout_no_swap);
     num_failed += RUN_TEST(test_sabre_layout_applies_layout);
+    num_failed += RUN_TEST(test_sabre_layout_lookahead_window);
+    num_failed += RUN_TEST(test_sabre_layout_invalid_lookahead);
+    num_failed += RUN_TEST(test_sabre_layout_disjoint_chiplets);
 
     fflush(stderr);
     fprintf(stderr, "=== Number of failed subtests: %i\n", num_failed);
@@ -0,0 +1,96 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "common.h"
+#include <qiskit.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Test that clones of a handle share the circuit without copying it.
+ */
+static int test_shared_circuit_clone(void) {
+    int result = Ok;
+    QkCircuit *qc = qk_circuit_new(2, 0);
+    qk_circuit_gate(qc, QkGate_H, (uint32_t[]){0}, NULL);
+    QkSharedCircuit *shared = qk_shared_circuit_new(qc);
+    if (!qk_shared_circuit_is_unique(shared)) {
+        printf("A new handle is not unique\n");
+        result = EqualityError;
+        qk_shared_circuit_free(shared);
+        return result;
+    }
+    QkSharedCircuit *other = qk_shared_circuit_clone(shared);
+
+    if (qk_shared_circuit_get(shared) != qk_shared_circuit_get(other)) {
+        printf("Cloning a handle copied the circuit\n");
+        result = EqualityError;
+        goto cleanup;
+    }
+    if (qk_shared_circuit_is_unique(shared) || qk_shared_circuit_is_unique(other)) {
+        printf("A shared circuit is reported as unique\n");
+        result = EqualityError;
+    }
+
+cleanup:
+    qk_shared_circuit_free(other);
+    qk_shared_circuit_free(shared);
+    return result;
+}
+
+/**
+ * Test that mutating a shared circuit copies it, and mutating a unique one does not.
+ */
+static int test_shared_circuit_copy_on_write(void) {
+    int result = Ok;
+    QkCircuit *qc = qk_circuit_new(2, 0);
+    qk_circuit_gate(qc, QkGate_H, (uint32_t[]){0}, NULL);
+    QkSharedCircuit *shared = qk_shared_circuit_new(qc);
+    QkSharedCircuit *other = qk_shared_circuit_clone(shared);
+
+    const QkCircuit *original = qk_shared_circuit_get(shared);
+    QkCircuit *copy = qk_shared_circuit_get_mut(other);
+    if (copy == original) {
+        printf("Mutating a shared circuit did not copy it\n");
+        result = EqualityError;
+        goto cleanup;
+    }
+    qk_circuit_gate(copy, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+    if (qk_circuit_num_instructions(original) != 1 || qk_circuit_num_instructions(copy) != 2) {
+        printf("The original circuit was modified through a copy\n");
+        result = EqualityError;
+        goto cleanup;
+    }
+    // Both handles are now the only references to their circuits.
+    if (!qk_shared_circuit_is_unique(shared) ||
+        qk_shared_circuit_get_mut(shared) != qk_shared_circuit_get(shared)) {
+        printf("Mutating a unique circuit copied it\n");
+        result = EqualityError;
+    }
+
+cleanup:
+    qk_shared_circuit_free(other);
+    qk_shared_circuit_free(shared);
+    return result;
+}
+
+int test_shared_circuit(void) {
+    int num_failed = 0;
+    num_failed += RUN_TEST(test_shared_circuit_clone);
+    num_failed += RUN_TEST(test_shared_circuit_copy_on_write);
+
+    fflush(stderr);
+    fprintf(stderr, "=== Number of failed subtests: %i\n", num_failed);
+
+    return num_failed;
+}
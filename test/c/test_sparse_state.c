@@ -0,0 +1,138 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "common.h"
+#include <math.h>
+#include <qiskit.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Test that the circuit prepares the given state.
+ */
+static int test_sparse_state_prep_statevector(void) {
+    const uint32_t num_qubits = 5;
+    const size_t num_terms = 5;
+    int result = Ok;
+    uint64_t indices[5] = {3, 28, 17, 9, 30};
+    QkComplex64 amplitudes[5] = {{0.5, 0.0}, {0.0, -0.5}, {0.3, 0.4}, {-0.1, 0.1}, {0.0, 0.0}};
+    // Normalize the state, leaving one basis state with amplitude zero.
+    double norm = 0.0;
+    for (size_t i = 0; i < num_terms; i++) {
+        norm += amplitudes[i].re * amplitudes[i].re + amplitudes[i].im * amplitudes[i].im;
+    }
+    norm = sqrt(norm);
+    for (size_t i = 0; i < num_terms; i++) {
+        amplitudes[i].re /= norm;
+        amplitudes[i].im /= norm;
+    }
+
+    QkCircuit *qc =
+        qk_circuit_library_sparse_state_prep(num_qubits, num_terms, indices, amplitudes);
+    if (qc == NULL) {
+        printf("Failed to synthesize the state\n");
+        return RuntimeError;
+    }
+    QkComplex64 state[32];
+    QkExitCode exit_code = qk_circuit_statevector(qc, state);
+    if (exit_code != QkExitCode_Success) {
+        printf("Simulation failed with exit code %d\n", exit_code);
+        result = RuntimeError;
+        goto cleanup;
+    }
+    for (uint64_t i = 0; i < 32; i++) {
+        QkComplex64 expected = {0.0, 0.0};
+        for (size_t j = 0; j < num_terms; j++) {
+            if (indices[j] == i) {
+                expected = amplitudes[j];
+            }
+        }
+        if (fabs(state[i].re - expected.re) > 1e-10 || fabs(state[i].im - expected.im) > 1e-10) {
+            printf("Unexpected amplitude %llu: %f + %fi, expected %f + %fi\n",
+                   (unsigned long long)i, state[i].re, state[i].im, expected.re, expected.im);
+            result = EqualityError;
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    qk_circuit_free(qc);
+    return result;
+}
+
+/**
+ * Test that the circuit size does not depend on the dimension of the state.
+ */
+static int test_sparse_state_prep_many_qubits(void) {
+    const uint32_t num_qubits = 60;
+    int result = Ok;
+    uint64_t indices[4] = {0, (uint64_t)1 << 59, 0x0f0f0f0f0f0f0f0full, 0x0123456789abcdefull};
+    QkComplex64 amplitudes[4] = {{0.5, 0.0}, {0.5, 0.0}, {0.0, 0.5}, {-0.5, 0.0}};
+    QkCircuit *qc = qk_circuit_library_sparse_state_prep(num_qubits, 4, indices, amplitudes);
+    if (qc == NULL) {
+        printf("Failed to synthesize the state\n");
+        return RuntimeError;
+    }
+    if (qk_circuit_num_qubits(qc) != num_qubits) {
+        printf("Unexpected number of qubits %u\n", qk_circuit_num_qubits(qc));
+        result = EqualityError;
+    }
+    size_t num_instructions = qk_circuit_num_instructions(qc);
+    if (num_instructions == 0 || num_instructions > 4 * 60 * num_qubits) {
+        printf("Unexpected number of instructions %zu\n", num_instructions);
+        result = EqualityError;
+    }
+    qk_circuit_free(qc);
+    return result;
+}
+
+/**
+ * Test that invalid states are rejected.
+ */
+static int test_sparse_state_prep_invalid(void) {
+    QkComplex64 half[2] = {{M_SQRT1_2, 0.0}, {M_SQRT1_2, 0.0}};
+    QkComplex64 one[2] = {{1.0, 0.0}, {1.0, 0.0}};
+    uint64_t duplicate[2] = {1, 1};
+    uint64_t out_of_range[2] = {1, 8};
+    uint64_t valid[2] = {1, 2};
+
+    if (qk_circuit_library_sparse_state_prep(3, 2, duplicate, half) != NULL) {
+        printf("Duplicate basis states were accepted\n");
+        return EqualityError;
+    }
+    if (qk_circuit_library_sparse_state_prep(3, 2, out_of_range, half) != NULL) {
+        printf("A basis state out of range was accepted\n");
+        return EqualityError;
+    }
+    if (qk_circuit_library_sparse_state_prep(3, 2, valid, one) != NULL) {
+        printf("An unnormalized state was accepted\n");
+        return EqualityError;
+    }
+    if (qk_circuit_library_sparse_state_prep(3, 0, NULL, NULL) != NULL) {
+        printf("An empty state was accepted\n");
+        return EqualityError;
+    }
+    return Ok;
+}
+
+int test_sparse_state(void) {
+    int num_failed = 0;
+    num_failed += RUN_TEST(test_sparse_state_prep_statevector);
+    num_failed += RUN_TEST(test_sparse_state_prep_many_qubits);
+    num_failed += RUN_TEST(test_sparse_state_prep_invalid);
+
+    fflush(stderr);
+    fprintf(stderr, "=== Number of failed subtests: %i\n", num_failed);
+
+    return num_failed;
+}
@@ -0,0 +1,253 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "common.h"
+#include <complex.h>
+#include <math.h>
+#include <qiskit.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static QkCircuit *ghz(uint32_t num_qubits) {
+    QkCircuit *qc = qk_circuit_new(num_qubits, 0);
+    qk_circuit_gate(qc, QkGate_H, (uint32_t[]){0}, NULL);
+    for (uint32_t i = 1; i < num_qubits; i++) {
+        qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){i - 1, i}, NULL);
+    }
+    return qc;
+}
+
+/**
+ * Test the statevector of a GHZ state.
+ */
+static int test_statevector_ghz(void) {
+    const uint32_t num_qubits = 3;
+    int result = Ok;
+    QkCircuit *qc = ghz(num_qubits);
+    QkComplex64 state[8];
+    QkExitCode exit_code = qk_circuit_statevector(qc, state);
+    if (exit_code != QkExitCode_Success) {
+        printf("Simulation failed with exit code %d\n", exit_code);
+        result = RuntimeError;
+        goto cleanup;
+    }
+    for (size_t i = 0; i < 8; i++) {
+        double expected = (i == 0 || i == 7) ? M_SQRT1_2 : 0.0;
+        if (fabs(state[i].re - expected) > 1e-12 || fabs(state[i].im) > 1e-12) {
+            printf("Unexpected amplitude %zu: %f + %fi\n", i, state[i].re, state[i].im);
+            result = EqualityError;
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    qk_circuit_free(qc);
+    return result;
+}
+
+/**
+ * Test that a circuit with non-unitary operations can't be simulated.
+ */
+static int test_statevector_non_unitary(void) {
+    int result = Ok;
+    QkCircuit *qc = qk_circuit_new(1, 0);
+    qk_circuit_gate(qc, QkGate_H, (uint32_t[]){0}, NULL);
+    qk_circuit_reset(qc, 0);
+    QkComplex64 state[2];
+    QkExitCode exit_code = qk_circuit_statevector(qc, state);
+    if (exit_code != QkExitCode_SimulationError) {
+        printf("Expected a simulation error, but got exit code %d\n", exit_code);
+        result = EqualityError;
+    }
+    qk_circuit_free(qc);
+    return result;
+}
+
+/**
+ * Test sampling a GHZ state.
+ */
+static int test_sample_ghz(void) {
+    const uint32_t num_qubits = 4;
+    const size_t num_shots = 1000;
+    int result = Ok;
+    QkCircuit *qc = ghz(num_qubits);
+    uint64_t *shots = malloc(sizeof(uint64_t) * num_shots);
+    uint64_t *repeat = malloc(sizeof(uint64_t) * num_shots);
+    QkExitCode exit_code = qk_circuit_sample(qc, num_shots, 42, shots);
+    if (exit_code != QkExitCode_Success) {
+        printf("Sampling failed with exit code %d\n", exit_code);
+        result = RuntimeError;
+        goto cleanup;
+    }
+    qk_circuit_sample(qc, num_shots, 42, repeat);
+    size_t num_ones = 0;
+    for (size_t i = 0; i < num_shots; i++) {
+        if (shots[i] != 0 && shots[i] != 15) {
+            printf("Unexpected outcome %llu\n", (unsigned long long)shots[i]);
+            result = EqualityError;
+            goto cleanup;
+        }
+        if (shots[i] != repeat[i]) {
+            printf("Sampling with the same seed gave different outcomes\n");
+            result = EqualityError;
+            goto cleanup;
+        }
+        num_ones += shots[i] == 15;
+    }
+    if (num_ones < 400 || num_ones > 600) {
+        printf("Unexpected number of all-ones outcomes: %zu\n", num_ones);
+        result = EqualityError;
+    }
+
+cleanup:
+    free(shots);
+    free(repeat);
+    qk_circuit_free(qc);
+    return result;
+}
+
+/**
+ * Test that sampling no shots does not write to the output.
+ */
+static int test_sample_no_shots(void) {
+    int result = Ok;
+    QkCircuit *qc = ghz(2);
+    QkExitCode exit_code = qk_circuit_sample(qc, 0, 42, NULL);
+    if (exit_code != QkExitCode_Success) {
+        printf("Sampling no shots failed with exit code %d\n", exit_code);
+        result = EqualityError;
+    }
+    qk_circuit_free(qc);
+    return result;
+}
+
+/**
+ * Test the equivalence check on circuits with the same qubits.
+ */
+static int test_equiv_check(void) {
+    int result = Ok;
+    QkCircuit *cz = qk_circuit_new(2, 0);
+    qk_circuit_gate(cz, QkGate_CZ, (uint32_t[]){0, 1}, NULL);
+    QkCircuit *hcxh = qk_circuit_new(2, 0);
+    qk_circuit_gate(hcxh, QkGate_H, (uint32_t[]){1}, NULL);
+    qk_circuit_gate(hcxh, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+    qk_circuit_gate(hcxh, QkGate_H, (uint32_t[]){1}, NULL);
+    QkCircuit *cx = qk_circuit_new(2, 0);
+    qk_circuit_gate(cx, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+    QkCircuit *three = qk_circuit_new(3, 0);
+
+    bool equivalent = false;
+    QkExitCode exit_code = qk_circuit_equiv_check(cz, hcxh, NULL, &equivalent);
+    if (exit_code != QkExitCode_Success || !equivalent) {
+        printf("CZ is not equivalent to H-CX-H (exit code %d)\n", exit_code);
+        result = EqualityError;
+        goto cleanup;
+    }
+    exit_code = qk_circuit_equiv_check(cz, cx, NULL, &equivalent);
+    if (exit_code != QkExitCode_Success || equivalent) {
+        printf("CZ is equivalent to CX (exit code %d)\n", exit_code);
+        result = EqualityError;
+        goto cleanup;
+    }
+    exit_code = qk_circuit_equiv_check(cz, three, NULL, &equivalent);
+    if (exit_code != QkExitCode_MismatchedQubits) {
+        printf("Expected mismatched qubits, but got exit code %d\n", exit_code);
+        result = EqualityError;
+    }
+
+cleanup:
+    qk_circuit_free(cz);
+    qk_circuit_free(hcxh);
+    qk_circuit_free(cx);
+    qk_circuit_free(three);
+    return result;
+}
+
+/**
+ * Test the equivalence check on a routed circuit and its transpile layout.
+ */
+static int test_equiv_check_transpiled(void) {
+    const uint32_t num_qubits = 5;
+    int result = Ok;
+    QkCircuit *qc = qk_circuit_new(3, 0);
+    qk_circuit_gate(qc, QkGate_H, (uint32_t[]){0}, NULL);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, 2}, NULL);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){1, 2}, NULL);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+    qk_circuit_gate(qc, QkGate_T, (uint32_t[]){2}, NULL);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){2, 0}, NULL);
+    QkCircuit *other = qk_circuit_copy(qc);
+    qk_circuit_gate(other, QkGate_S, (uint32_t[]){1}, NULL);
+
+    QkTarget *target = qk_target_new(num_qubits);
+    QkTargetEntry *cx_entry = qk_target_entry_new(QkGate_CX);
+    for (uint32_t i = 0; i < num_qubits - 1; i++) {
+        qk_target_entry_add_property(cx_entry, (uint32_t[]){i, i + 1}, 2, 0.0, 0.001 * (i + 1));
+        qk_target_entry_add_property(cx_entry, (uint32_t[]){i + 1, i}, 2, 0.0, 0.001 * (i + 1));
+    }
+    qk_target_add_instruction(target, cx_entry);
+    qk_target_add_instruction(target, qk_target_entry_new(QkGate_U));
+
+    for (uint8_t opt_level = 0; opt_level < 4; opt_level++) {
+        QkTranspileOptions options = {opt_level, 1234, 1.0};
+        QkTranspileResult transpile_result = {NULL, NULL};
+        if (qk_transpile(qc, target, &options, &transpile_result, NULL) != QkExitCode_Success) {
+            printf("Transpilation failed at optimization level %d\n", opt_level);
+            result = RuntimeError;
+            goto cleanup;
+        }
+        bool equivalent = false;
+        bool other_equivalent = true;
+        QkExitCode exit_code = qk_circuit_equiv_check(qc, transpile_result.circuit,
+                                                      transpile_result.layout, &equivalent);
+        QkExitCode other_exit_code = qk_circuit_equiv_check(
+            other, transpile_result.circuit, transpile_result.layout, &other_equivalent);
+        qk_circuit_free(transpile_result.circuit);
+        qk_transpile_layout_free(transpile_result.layout);
+        if (exit_code != QkExitCode_Success || !equivalent) {
+            printf("Transpiled circuit at optimization level %d is not equivalent (exit code %d)\n",
+                   opt_level, exit_code);
+            result = EqualityError;
+            goto cleanup;
+        }
+        if (other_exit_code != QkExitCode_Success || other_equivalent) {
+            printf("A different circuit is equivalent at optimization level %d (exit code %d)\n",
+                   opt_level, other_exit_code);
+            result = EqualityError;
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    qk_circuit_free(qc);
+    qk_circuit_free(other);
+    qk_target_free(target);
+    return result;
+}
+
+int test_statevector(void) {
+    int num_failed = 0;
+    num_failed += RUN_TEST(test_statevector_ghz);
+    num_failed += RUN_TEST(test_statevector_non_unitary);
+    num_failed += RUN_TEST(test_sample_ghz);
+    num_failed += RUN_TEST(test_sample_no_shots);
+    num_failed += RUN_TEST(test_equiv_check);
+    num_failed += RUN_TEST(test_equiv_check_transpiled);
+
+    fflush(stderr);
+    fprintf(stderr, "=== Number of failed subtests: %i\n", num_failed);
+
+    return num_failed;
+}
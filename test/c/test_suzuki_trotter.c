@@ -13,6 +13,7 @@
 #include "common.h"
 #include <math.h>
 #include <qiskit.h>
+#include <stdbool.h>
 #include <string.h>
 
 /**
@@ -247,6 +248,83 @@ cleanup_obs:
     return result;
 }
 
+static size_t count_cx(QkCircuit *qc) {
+    QkOpCounts counts = qk_circuit_count_ops(qc);
+    size_t num_cx = 0;
+    for (size_t i = 0; i < counts.len; i++) {
+        if (strcmp(counts.data[i].name, "cx") == 0) {
+            num_cx = counts.data[i].count;
+        }
+    }
+    qk_opcounts_clear(&counts);
+    return num_cx;
+}
+
+/**
+ * Test that ordering the terms for cancellation shares the CX chains of terms with common qubits,
+ * and gives the same evolution if all terms commute.
+ */
+static int test_suzuki_trotter_cancellation_ordering(void) {
+    QkObs *obs = qk_obs_zero(5);
+    QkBitTerm zzzz[4] = {QkBitTerm_Z, QkBitTerm_Z, QkBitTerm_Z, QkBitTerm_Z};
+    QkBitTerm xxx[3] = {QkBitTerm_X, QkBitTerm_X, QkBitTerm_X};
+    QkObsTerm terms[3] = {
+        {(QkComplex64){1.0, 0.0}, 4, zzzz, (uint32_t[4]){0, 2, 3, 4}, 5},
+        {(QkComplex64){0.5, 0.0}, 3, xxx, (uint32_t[3]){0, 1, 2}, 5},
+        {(QkComplex64){0.7, 0.0}, 4, zzzz, (uint32_t[4]){1, 2, 3, 4}, 5},
+    };
+    for (size_t i = 0; i < 3; i++) {
+        qk_obs_add_term(obs, &terms[i]);
+    }
+
+    int result = Ok;
+    QkCircuit *preserve =
+        qk_circuit_library_suzuki_trotter_ordered(obs, 1, 1, 0.1, QkTermOrdering_Preserve, false);
+    QkCircuit *cancellation = qk_circuit_library_suzuki_trotter_ordered(
+        obs, 1, 1, 0.1, QkTermOrdering_Cancellation, false);
+    QkCircuit *preserve_2 =
+        qk_circuit_library_suzuki_trotter_ordered(obs, 2, 3, 0.1, QkTermOrdering_Preserve, false);
+    QkCircuit *cancellation_2 = qk_circuit_library_suzuki_trotter_ordered(
+        obs, 2, 3, 0.1, QkTermOrdering_Cancellation, false);
+
+    // Each 4-qubit term uses 6 CX gates and the 3-qubit term 4, and evolving the 4-qubit terms
+    // one after the other cancels the two CX gates they share on each side.
+    size_t num_cx = count_cx(preserve);
+    size_t num_cx_cancellation = count_cx(cancellation);
+    if (num_cx != 16 || num_cx_cancellation != 12) {
+        printf("Expected 16 and 12 cx gates, but found %zu and %zu\n", num_cx,
+               num_cx_cancellation);
+        result = EqualityError;
+        goto cleanup;
+    }
+    num_cx = count_cx(preserve_2);
+    num_cx_cancellation = count_cx(cancellation_2);
+    if (num_cx_cancellation >= num_cx) {
+        printf("Expected fewer than %zu cx gates, but found %zu\n", num_cx, num_cx_cancellation);
+        result = EqualityError;
+        goto cleanup;
+    }
+
+    bool equivalent = false;
+    bool equivalent_2 = false;
+    QkExitCode exit_code = qk_circuit_equiv_check(preserve, cancellation, NULL, &equivalent);
+    QkExitCode exit_code_2 =
+        qk_circuit_equiv_check(preserve_2, cancellation_2, NULL, &equivalent_2);
+    if (exit_code != QkExitCode_Success || exit_code_2 != QkExitCode_Success || !equivalent ||
+        !equivalent_2) {
+        printf("Ordering the terms for cancellation changed the evolution\n");
+        result = EqualityError;
+    }
+
+cleanup:
+    qk_circuit_free(preserve);
+    qk_circuit_free(cancellation);
+    qk_circuit_free(preserve_2);
+    qk_circuit_free(cancellation_2);
+    qk_obs_free(obs);
+    return result;
+}
+
 int test_suzuki_trotter(void) {
     int num_failed = 0;
 
@@ -254,6 +332,7 @@ int test_suzuki_trotter(void) {
     num_failed += RUN_TEST(test_suzuki_trotter_2_order_reorder);
     num_failed += RUN_TEST(test_suzuki_trotter_with_barriers);
     num_failed += RUN_TEST(test_tri_ising_hamiltonian);
+    num_failed += RUN_TEST(test_suzuki_trotter_cancellation_ordering);
 
     fflush(stderr);
     fprintf(stderr, "=== Number of failed subtests (Suzuki-Trotter): %i\n", num_failed);
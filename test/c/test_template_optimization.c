@@ -0,0 +1,139 @@
+// This code is part of Qiskit.
+//
+// (C) Copyright IBM 2026.
+//
+// This code is licensed under the Apache License, Version 2.0. You may
+// obtain a copy of this license in the LICENSE.txt file in the root directory
+// of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// Any modifications or derivative works of this code must retain this
+// copyright notice, and modified files need to carry a notice indicating
+// that they have been altered from the originals.
+
+#include "common.h"
+#include <qiskit.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Build a library with the CX-CX template and the H-S-S-H-X template.
+ */
+static QkTemplateLibrary *build_library(void) {
+    QkTemplateLibrary *library = qk_template_library_new();
+    QkCircuit *cx_cx = qk_circuit_new(2, 0);
+    qk_circuit_gate(cx_cx, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+    qk_circuit_gate(cx_cx, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+    qk_template_library_add(library, cx_cx);
+    qk_circuit_free(cx_cx);
+
+    QkCircuit *hsshx = qk_circuit_new(1, 0);
+    QkGate gates[5] = {QkGate_H, QkGate_S, QkGate_S, QkGate_H, QkGate_X};
+    for (int i = 0; i < 5; i++) {
+        qk_circuit_gate(hsshx, gates[i], (uint32_t[]){0}, NULL);
+    }
+    qk_template_library_add(library, hsshx);
+    qk_circuit_free(hsshx);
+    return library;
+}
+
+/**
+ * Test that only templates equivalent to the identity are accepted.
+ */
+static int test_template_library_add(void) {
+    int result = Ok;
+    QkTemplateLibrary *library = build_library();
+    QkCircuit *not_identity = qk_circuit_new(2, 0);
+    qk_circuit_gate(not_identity, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+    qk_circuit_gate(not_identity, QkGate_H, (uint32_t[]){0}, NULL);
+
+    if (qk_template_library_add(library, not_identity) != QkExitCode_CInputError) {
+        printf("A template that is not the identity was accepted\n");
+        result = EqualityError;
+        goto cleanup;
+    }
+    size_t num_templates = qk_template_library_num_templates(library);
+    if (num_templates != 2) {
+        printf("Expected 2 templates, got %zu\n", num_templates);
+        result = EqualityError;
+    }
+
+cleanup:
+    qk_circuit_free(not_identity);
+    qk_template_library_free(library);
+    return result;
+}
+
+/**
+ * Test that matches of the templates are replaced in a circuit.
+ */
+static int test_template_optimization_standalone(void) {
+    int result = Ok;
+    QkTemplateLibrary *library = build_library();
+    QkCircuit *qc = qk_circuit_new(3, 0);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, 1}, NULL);
+    QkGate gates[4] = {QkGate_H, QkGate_S, QkGate_S, QkGate_H};
+    for (int i = 0; i < 4; i++) {
+        qk_circuit_gate(qc, gates[i], (uint32_t[]){2}, NULL);
+    }
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){1, 2}, NULL);
+
+    size_t num_replaced = 0;
+    QkExitCode code =
+        qk_transpiler_pass_standalone_template_optimization(qc, library, &num_replaced);
+    if (code != QkExitCode_Success || num_replaced != 2) {
+        printf("Expected 2 replacements, got %zu\n", num_replaced);
+        result = EqualityError;
+        goto cleanup;
+    }
+    // The CX pair is removed and H-S-S-H is replaced by X.
+    size_t num_instructions = qk_circuit_num_instructions(qc);
+    if (num_instructions != 2) {
+        printf("Expected 2 instructions, got %zu\n", num_instructions);
+        result = EqualityError;
+    }
+
+cleanup:
+    qk_circuit_free(qc);
+    qk_template_library_free(library);
+    return result;
+}
+
+/**
+ * Test that gates separated by another gate on one of their wires are not matched.
+ */
+static int test_template_optimization_dag(void) {
+    int result = Ok;
+    QkTemplateLibrary *library = build_library();
+    QkDag *dag = qk_dag_new();
+    QkQuantumRegister *qr = qk_quantum_register_new(2, "q");
+    qk_dag_add_quantum_register(dag, qr);
+    qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){0, 1}, NULL, false);
+    qk_dag_apply_gate(dag, QkGate_Z, (uint32_t[]){1}, NULL, false);
+    qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){0, 1}, NULL, false);
+
+    size_t num_replaced = 1;
+    QkExitCode code = qk_transpiler_pass_template_optimization(dag, library, &num_replaced);
+    if (code != QkExitCode_Success || num_replaced != 0 || qk_dag_num_op_nodes(dag) != 3) {
+        printf("Unexpected replacement of gates that are not consecutive\n");
+        result = EqualityError;
+    }
+
+    qk_quantum_register_free(qr);
+    qk_dag_free(dag);
+    qk_template_library_free(library);
+    return result;
+}
+
+int test_template_optimization(void) {
+    int num_failed = 0;
+    num_failed += RUN_TEST(test_template_library_add);
+    num_failed += RUN_TEST(test_template_optimization_standalone);
+    num_failed += RUN_TEST(test_template_optimization_dag);
+
+    fflush(stderr);
+    fprintf(stderr, "=== Number of failed subtests: %i\n", num_failed);
+
+    return num_failed;
+}
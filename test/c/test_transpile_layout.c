@@ -70,9 +70,175 @@ cleanup:
     return result;
 }
 
+static QkTarget *line_target(uint32_t num_qubits) {
+    QkTarget *target = qk_target_new(num_qubits);
+    QkTargetEntry *cx_entry = qk_target_entry_new(QkGate_CX);
+    for (uint32_t i = 0; i < num_qubits - 1; i++) {
+        qk_target_entry_add_property(cx_entry, (uint32_t[]){i, i + 1}, 2, 0.0, 0.001 * (i % 5 + 1));
+        qk_target_entry_add_property(cx_entry, (uint32_t[]){i + 1, i}, 2, 0.0, 0.001 * (i % 5 + 1));
+    }
+    qk_target_add_instruction(target, cx_entry);
+    qk_target_add_instruction(target, qk_target_entry_new(QkGate_U));
+    return target;
+}
+
+/**
+ * Test the exact equivalence check of a transpiled Clifford circuit.
+ */
+static int test_transpile_layout_equiv_check_clifford(void) {
+    int result = Ok;
+    QkCircuit *qc = qk_circuit_new(3, 0);
+    qk_circuit_gate(qc, QkGate_H, (uint32_t[]){0}, NULL);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){0, 2}, NULL);
+    qk_circuit_gate(qc, QkGate_S, (uint32_t[]){2}, NULL);
+    qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){2, 1}, NULL);
+    qk_circuit_gate(qc, QkGate_SX, (uint32_t[]){1}, NULL);
+    qk_circuit_gate(qc, QkGate_CZ, (uint32_t[]){1, 0}, NULL);
+    QkCircuit *other = qk_circuit_copy(qc);
+    qk_circuit_gate(other, QkGate_Z, (uint32_t[]){0}, NULL);
+    QkTarget *target = line_target(5);
+
+    QkTranspileOptions options = {1, 1234, 1.0};
+    QkTranspileResult transpiled = {NULL, NULL};
+    if (qk_transpile(qc, target, &options, &transpiled, NULL) != QkExitCode_Success) {
+        printf("Transpilation failed\n");
+        result = RuntimeError;
+        goto cleanup;
+    }
+    QkEquivCheckResult check;
+    QkExitCode exit_code =
+        qk_transpile_layout_equiv_check(qc, transpiled.circuit, transpiled.layout, NULL, &check);
+    if (exit_code != QkExitCode_Success || check.outcome != QkEquivalence_Equivalent ||
+        !check.exact) {
+        printf("Transpiled circuit is not exactly equivalent (exit code %d, outcome %d)\n",
+               exit_code, check.outcome);
+        result = EqualityError;
+        goto transpiled_cleanup;
+    }
+    exit_code = qk_transpile_layout_equiv_check(other, transpiled.circuit, transpiled.layout,
+                                                NULL, &check);
+    if (exit_code != QkExitCode_Success || check.outcome != QkEquivalence_NotEquivalent ||
+        !check.exact || check.has_counterexample) {
+        printf("Different circuit is not exactly inequivalent (exit code %d, outcome %d)\n",
+               exit_code, check.outcome);
+        result = EqualityError;
+        goto transpiled_cleanup;
+    }
+    exit_code = qk_transpile_layout_equiv_check(qc, other, NULL, NULL, &check);
+    if (exit_code != QkExitCode_Success || check.outcome != QkEquivalence_NotEquivalent) {
+        printf("Circuits without a layout are not inequivalent (exit code %d)\n", exit_code);
+        result = EqualityError;
+        goto transpiled_cleanup;
+    }
+    exit_code = qk_transpile_layout_equiv_check(qc, transpiled.circuit, NULL, NULL, &check);
+    if (exit_code != QkExitCode_MismatchedQubits) {
+        printf("Expected mismatched qubits, but got exit code %d\n", exit_code);
+        result = EqualityError;
+    }
+
+transpiled_cleanup:
+    qk_circuit_free(transpiled.circuit);
+    qk_transpile_layout_free(transpiled.layout);
+cleanup:
+    qk_circuit_free(qc);
+    qk_circuit_free(other);
+    qk_target_free(target);
+    return result;
+}
+
+/**
+ * Test the fingerprint equivalence check of a transpiled circuit too large to simulate.
+ */
+static int test_transpile_layout_equiv_check_fingerprints(void) {
+    const uint32_t num_qubits = 40;
+    int result = Ok;
+    QkCircuit *qc = qk_circuit_new(num_qubits, 0);
+    for (uint32_t i = 0; i < num_qubits; i++) {
+        qk_circuit_gate(qc, QkGate_H, (uint32_t[]){i}, NULL);
+        qk_circuit_gate(qc, QkGate_T, (uint32_t[]){i}, NULL);
+    }
+    for (uint32_t i = 0; i + 1 < num_qubits; i += 2) {
+        qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){i, i + 1}, NULL);
+    }
+    for (uint32_t i = 0; i < num_qubits; i++) {
+        qk_circuit_gate(qc, QkGate_RZ, (uint32_t[]){i}, (double[]){0.3 + 0.01 * i});
+    }
+    for (uint32_t i = 1; i + 1 < num_qubits; i += 2) {
+        qk_circuit_gate(qc, QkGate_CX, (uint32_t[]){i + 1, i}, NULL);
+    }
+    // A small rotation on every qubit is caught by most fingerprints.
+    QkCircuit *other = qk_circuit_copy(qc);
+    for (uint32_t i = 0; i < num_qubits; i++) {
+        qk_circuit_gate(other, QkGate_RZ, (uint32_t[]){i}, (double[]){0.01});
+    }
+    QkTarget *target = line_target(num_qubits + 2);
+
+    QkTranspileOptions transpile_options = {2, 1234, 1.0};
+    QkTranspileResult transpiled = {NULL, NULL};
+    if (qk_transpile(qc, target, &transpile_options, &transpiled, NULL) != QkExitCode_Success) {
+        printf("Transpilation failed\n");
+        result = RuntimeError;
+        goto cleanup;
+    }
+    QkEquivCheckOptions options = qk_equiv_check_options_default();
+    options.seed = 42;
+    QkEquivCheckResult check;
+    QkExitCode exit_code = qk_transpile_layout_equiv_check(qc, transpiled.circuit,
+                                                           transpiled.layout, &options, &check);
+    if (exit_code != QkExitCode_Success || check.outcome != QkEquivalence_Equivalent ||
+        check.exact) {
+        printf("Transpiled circuit is not equivalent (exit code %d, outcome %d)\n", exit_code,
+               check.outcome);
+        result = EqualityError;
+        goto transpiled_cleanup;
+    }
+    exit_code = qk_transpile_layout_equiv_check(other, transpiled.circuit, transpiled.layout,
+                                                &options, &check);
+    if (exit_code != QkExitCode_Success || check.outcome != QkEquivalence_NotEquivalent ||
+        !check.has_counterexample) {
+        printf("Different circuit is not inequivalent (exit code %d, outcome %d)\n", exit_code,
+               check.outcome);
+        result = EqualityError;
+        goto transpiled_cleanup;
+    }
+    // The counterexample reproduces on its own.
+    uint64_t counterexample = check.counterexample_seed;
+    options.num_trials = 1;
+    options.seed = (int64_t)counterexample;
+    exit_code = qk_transpile_layout_equiv_check(other, transpiled.circuit, transpiled.layout,
+                                                &options, &check);
+    if (exit_code != QkExitCode_Success || check.outcome != QkEquivalence_NotEquivalent ||
+        check.counterexample_seed != counterexample) {
+        printf("Counterexample %llu does not reproduce (exit code %d, outcome %d)\n",
+               (unsigned long long)counterexample, exit_code, check.outcome);
+        result = EqualityError;
+        goto transpiled_cleanup;
+    }
+    // Without any trials nothing is compared.
+    options.num_trials = 0;
+    exit_code = qk_transpile_layout_equiv_check(other, transpiled.circuit, transpiled.layout,
+                                                &options, &check);
+    if (exit_code != QkExitCode_Success || check.outcome != QkEquivalence_Inconclusive) {
+        printf("Check without trials is not inconclusive (exit code %d, outcome %d)\n",
+               exit_code, check.outcome);
+        result = EqualityError;
+    }
+
+transpiled_cleanup:
+    qk_circuit_free(transpiled.circuit);
+    qk_transpile_layout_free(transpiled.layout);
+cleanup:
+    qk_circuit_free(qc);
+    qk_circuit_free(other);
+    qk_target_free(target);
+    return result;
+}
+
 int test_transpile_layout(void) {
     int num_failed = 0;
     num_failed += RUN_TEST(test_transpile_layout_generate);
+    num_failed += RUN_TEST(test_transpile_layout_equiv_check_clifford);
+    num_failed += RUN_TEST(test_transpile_layout_equiv_check_fingerprints);
 
     fflush(stderr);
     fprintf(stderr, "=== Number of failed subtests: %i\n", num_failed);
@@ -450,6 +450,147 @@ cleanup:
     return result;
 }
 
+static uint32_t count_dag_ops_named(QkDag *dag, const char *name) {
+    uint32_t num_ops = qk_dag_num_op_nodes(dag);
+    uint32_t *ops = malloc(num_ops * sizeof(*ops));
+    qk_dag_topological_op_nodes(dag, ops);
+    uint32_t count = 0;
+    QkCircuitInstruction inst;
+    for (uint32_t i = 0; i < num_ops; i++) {
+        qk_dag_get_instruction(dag, ops[i], &inst);
+        if (!strcmp(inst.name, name))
+            count++;
+        qk_circuit_instruction_clear(&inst);
+    }
+    free(ops);
+    return count;
+}
+
+static QkTarget *scheduling_target(void) {
+    QkTarget *target = qk_target_new(3);
+    qk_target_set_dt(target, 1e-9);
+    QkTargetEntry *x_entry = qk_target_entry_new(QkGate_X);
+    for (uint32_t i = 0; i < 3; i++) {
+        qk_target_entry_add_property(x_entry, (uint32_t[]){i}, 1, 10e-9, 1e-4);
+    }
+    qk_target_add_instruction(target, x_entry);
+    QkTargetEntry *cx_entry = qk_target_entry_new(QkGate_CX);
+    for (uint32_t i = 0; i < 2; i++) {
+        qk_target_entry_add_property(cx_entry, (uint32_t[]){i, i + 1}, 2, 100e-9, 1e-3);
+    }
+    qk_target_add_instruction(target, cx_entry);
+    return target;
+}
+
+static QkDag *scheduling_dag(void) {
+    QkDag *dag = qk_dag_new();
+    QkQuantumRegister *qr = qk_quantum_register_new(3, "q");
+    qk_dag_add_quantum_register(dag, qr);
+    qk_quantum_register_free(qr);
+    // Qubit 0 is idle from the end of the first CX until its X is scheduled as late as possible,
+    // and qubit 2 is idle before its first instruction.
+    qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){0, 1}, NULL, false);
+    qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){1, 2}, NULL, false);
+    qk_dag_apply_gate(dag, QkGate_CX, (uint32_t[]){1, 2}, NULL, false);
+    qk_dag_apply_gate(dag, QkGate_X, (uint32_t[]){0}, NULL, false);
+    return dag;
+}
+
+static int test_scheduling_stage_delays(void) {
+    int result = Ok;
+    QkTarget *target = scheduling_target();
+    QkDag *dag = scheduling_dag();
+    uint64_t duration = 0;
+    int compile_result = qk_transpile_stage_scheduling(dag, target, NULL, &duration, NULL);
+    if (compile_result != 0) {
+        result = RuntimeError;
+        printf("Running the scheduling stage failed\n");
+        goto cleanup;
+    }
+    if (duration != 300) {
+        result = EqualityError;
+        printf("Scheduled duration %lu does not match expected 300\n", (unsigned long)duration);
+        goto cleanup;
+    }
+    uint32_t num_delays = count_dag_ops_named(dag, "delay");
+    uint32_t num_x = count_dag_ops_named(dag, "x");
+    if (num_delays != 2 || num_x != 1) {
+        result = EqualityError;
+        printf("Expected 2 delays and 1 x, got %u delays and %u x\n", num_delays, num_x);
+    }
+cleanup:
+    qk_target_free(target);
+    qk_dag_free(dag);
+    return result;
+}
+
+static int test_scheduling_stage_dynamical_decoupling(void) {
+    int result = Ok;
+    QkTarget *target = scheduling_target();
+    QkDag *dag = scheduling_dag();
+    QkSchedulingOptions options = qk_transpiler_default_scheduling_options();
+    options.dynamical_decoupling = QkDynamicalDecoupling_XX;
+    uint64_t duration = 0;
+    int compile_result = qk_transpile_stage_scheduling(dag, target, &options, &duration, NULL);
+    if (compile_result != 0) {
+        result = RuntimeError;
+        printf("Running the scheduling stage failed\n");
+        goto cleanup;
+    }
+    if (duration != 300) {
+        result = EqualityError;
+        printf("Scheduled duration %lu does not match expected 300\n", (unsigned long)duration);
+        goto cleanup;
+    }
+    // The window on qubit 0 gets an XX sequence surrounded by three delays, but qubit 2 is still
+    // in its initial state during its idle window, so only gets a delay.
+    uint32_t num_delays = count_dag_ops_named(dag, "delay");
+    uint32_t num_x = count_dag_ops_named(dag, "x");
+    if (num_delays != 4 || num_x != 3) {
+        result = EqualityError;
+        printf("Expected 4 delays and 3 x, got %u delays and %u x\n", num_delays, num_x);
+    }
+cleanup:
+    qk_target_free(target);
+    qk_dag_free(dag);
+    return result;
+}
+
+static int test_scheduling_stage_missing_duration(void) {
+    int result = Ok;
+    QkTarget *target = scheduling_target();
+    QkDag *dag = scheduling_dag();
+    qk_dag_apply_gate(dag, QkGate_H, (uint32_t[]){0}, NULL, false);
+    char *error = NULL;
+    int compile_result = qk_transpile_stage_scheduling(dag, target, NULL, NULL, &error);
+    if (compile_result != QkExitCode_TranspilerError || error == NULL) {
+        result = EqualityError;
+        printf("Scheduling a gate with no duration did not fail\n");
+    }
+    qk_str_free(error);
+    qk_target_free(target);
+    qk_dag_free(dag);
+    return result;
+}
+
+static int test_scheduling_stage_invalid_options(void) {
+    int result = Ok;
+    QkTarget *target = scheduling_target();
+    QkDag *dag = scheduling_dag();
+    QkSchedulingOptions options = qk_transpiler_default_scheduling_options();
+    options.dynamical_decoupling = 3;
+    char *error = NULL;
+    int compile_result = qk_transpile_stage_scheduling(dag, target, &options, NULL, &error);
+    if (compile_result != QkExitCode_CInputError || error == NULL) {
+        result = EqualityError;
+        printf("Scheduling with an invalid dynamical-decoupling sequence did not fail\n");
+    }
+    qk_str_free(error);
+    qk_target_free(target);
+    qk_dag_free(dag);
+    return result;
+}
+
 int test_transpiler(void) {
     int num_failed = 0;
     num_failed += RUN_TEST(test_transpile_bv);
@@ -460,6 +601,10 @@ int test_transpiler(void) {
     num_failed += RUN_TEST(test_routing_stage_empty);
     num_failed += RUN_TEST(test_translation_stage_empty);
     num_failed += RUN_TEST(test_optimization_stage_empty);
+    num_failed += RUN_TEST(test_scheduling_stage_delays);
+    num_failed += RUN_TEST(test_scheduling_stage_dynamical_decoupling);
+    num_failed += RUN_TEST(test_scheduling_stage_missing_duration);
+    num_failed += RUN_TEST(test_scheduling_stage_invalid_options);
 
     fflush(stderr);
     fprintf(stderr, "=== Number of failed subtests: %i\n", num_failed);
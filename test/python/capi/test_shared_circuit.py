@@ -0,0 +1,115 @@
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2026.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at https://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+
+"""Tests for passing shared circuit handles between Python and C."""
+
+import ctypes
+
+from qiskit import capi
+from qiskit.circuit import QuantumCircuit
+from qiskit.circuit.library import HGate
+from test import QiskitTestCase
+
+
+class TestSharedCircuit(QiskitTestCase):
+    """Copy-on-write of QkSharedCircuit handles that refer to Python objects."""
+
+    def add_h(self, shared):
+        """Append an H gate on qubit 0 through the handle."""
+        capi.qk_circuit_gate(
+            capi.qk_shared_circuit_get_mut(shared),
+            int(HGate()._standard_gate),
+            (ctypes.c_uint32 * 1)(0),
+            None,
+        )
+
+    def num_instructions(self, shared):
+        """The number of instructions in the circuit of the handle."""
+        return capi.qk_circuit_num_instructions(capi.qk_shared_circuit_get(shared))
+
+    def new_shared(self, num_qubits):
+        """A new native handle, freed at the end of the test."""
+        shared = capi.qk_shared_circuit_new(capi.qk_circuit_new(num_qubits, 0))
+        self.addCleanup(capi.qk_shared_circuit_free, shared)
+        return shared
+
+    def test_get_mut_copies_referenced_python_circuit(self):
+        """Mutating a handle copies a circuit that Python still references."""
+        qc = QuantumCircuit(2)
+        shared = capi.qk_shared_circuit_from_python(qc._data)
+        self.addCleanup(capi.qk_shared_circuit_free, shared)
+        self.assertFalse(capi.qk_shared_circuit_is_unique(shared))
+
+        self.add_h(shared)
+        self.assertEqual(len(qc.data), 0)
+        self.assertEqual(self.num_instructions(shared), 1)
+        # The handle moved to its own copy.
+        self.assertTrue(capi.qk_shared_circuit_is_unique(shared))
+
+    def test_get_mut_copies_for_cloned_python_handle(self):
+        """Mutating one of two handles to a Python object leaves the other one alone."""
+        shared = self.new_shared(2)
+        data = capi.qk_shared_circuit_to_python(shared)
+        del data
+        other = capi.qk_shared_circuit_clone(shared)
+        self.addCleanup(capi.qk_shared_circuit_free, other)
+        self.assertFalse(capi.qk_shared_circuit_is_unique(shared))
+
+        self.add_h(other)
+        self.assertEqual(self.num_instructions(shared), 0)
+        self.assertEqual(self.num_instructions(other), 1)
+
+    def test_get_mut_in_place_when_unique(self):
+        """A Python object referenced only by the handle is mutated in place."""
+        shared = self.new_shared(2)
+        data = capi.qk_shared_circuit_to_python(shared)
+        del data
+        self.assertTrue(capi.qk_shared_circuit_is_unique(shared))
+
+        self.add_h(shared)
+        data = capi.qk_shared_circuit_to_python(shared)
+        self.assertEqual(len(data), 1)
+        self.assertIs(capi.qk_shared_circuit_to_python(shared), data)
+
+    def test_to_python_copies_shared_native_circuit(self):
+        """Passing a circuit that another handle refers to into Python copies it once."""
+        shared = self.new_shared(2)
+        other = capi.qk_shared_circuit_clone(shared)
+        self.addCleanup(capi.qk_shared_circuit_free, other)
+
+        data = capi.qk_shared_circuit_to_python(shared)
+        self.assertIs(capi.qk_shared_circuit_to_python(shared), data)
+        self.assertTrue(capi.qk_shared_circuit_is_unique(other))
+        self.add_h(other)
+        self.assertEqual(len(data), 0)
+        self.assertEqual(self.num_instructions(shared), 0)
+
+    def test_to_python_moves_unique_native_circuit(self):
+        """Passing a circuit only this handle refers to into Python does not copy it."""
+        shared = self.new_shared(2)
+        self.add_h(shared)
+        data = capi.qk_shared_circuit_to_python(shared)
+        self.assertEqual(len(data), 1)
+        self.assertFalse(capi.qk_shared_circuit_is_unique(shared))
+
+    def test_from_python_wrong_type(self):
+        """A Python object that is not a CircuitData is rejected."""
+        with self.assertRaises(TypeError):
+            capi.qk_shared_circuit_from_python(QuantumCircuit(1))
+
+    def test_python_mutation_is_seen_by_handles(self):
+        """Copy-on-write does not cover mutation from Python, which handles see."""
+        qc = QuantumCircuit(1)
+        shared = capi.qk_shared_circuit_from_python(qc._data)
+        self.addCleanup(capi.qk_shared_circuit_free, shared)
+        qc.h(0)
+        self.assertEqual(self.num_instructions(shared), 1)
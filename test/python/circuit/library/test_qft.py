@@ -184,8 +184,7 @@ class TestQFT(QiskitTestCase):
         """Test that a warning is issued if the user tries to make a circuit that would need to
         represent angles smaller than the smallest normal double-precision floating-point number.
         It's too slow to actually let QFT construct a 1050+ qubit circuit for such a simple test, so
-        we temporarily prevent QuantumCircuits from being created in order to short-circuit the QFT
-        builder."""
+        we temporarily replace the Rust synthesis in order to short-circuit the QFT builder."""
 
         class SentinelException(Exception):
             """Dummy exception that raises itself as soon as it is created."""
@@ -214,7 +213,9 @@ class TestQFT(QiskitTestCase):
 
         # Short-circuit the build method so it exits after input validation, but without actually
         # spinning the CPU to build a huge, useless object.
-        with unittest.mock.patch("qiskit.circuit.QuantumCircuit.__init__", SentinelException):
+        with unittest.mock.patch(
+            "qiskit.synthesis.qft.qft_decompose_full._synth_qft_full", SentinelException
+        ):
             with self.assertWarnsRegex(RuntimeWarning, "precision loss in QFT"):
                 with self.assertRaises(SentinelException):
                     qft._build()
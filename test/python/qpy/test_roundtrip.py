@@ -13,6 +13,9 @@
 """Tests for python write/rust read flow and vice versa"""
 
 import io
+import itertools
+import os
+import struct
 import uuid
 
 from ddt import ddt, idata, unpack
@@ -27,7 +30,8 @@ from qiskit.circuit.classical import expr
 from qiskit.synthesis import LieTrotter
 from qiskit.qpy.common import QPY_RUST_READ_MIN_VERSION, QPY_RUST_WRITE_MIN_VERSION, QPY_VERSION
 from qiskit.qpy.binary_io import write_circuit
-from qiskit.qpy import dump, load
+from qiskit.qpy import formats
+from qiskit.qpy import dump, load, get_qpy_version
 from qiskit.qpy import UnsupportedFeatureForVersion
 from test import QiskitTestCase
 from unittest.mock import patch
@@ -250,6 +254,132 @@ class TestQPYRoundtrip(QiskitTestCase):
                 qc, version=version, read_with=read_with, write_with=write_with
             )
 
+    @all_qpy_combinations(QPY_RUST_READ_MIN_VERSION)
+    def test_load_selected_programs(self, version, write_with, read_with):
+        """Test loading a subset of the programs in a file, out of order"""
+        circuits = [
+            random_circuit(5, 10, measure=True, conditional=True, reset=True, seed=42 + i)
+            for i in range(5)
+        ]
+        body = QuantumCircuit(2)
+        body.cx(0, 1)
+        qc = QuantumCircuit(2, 1)
+        qc.h(0)
+        qc.measure(0, 0)
+        qc.if_test((qc.clbits[0], True), body, [0, 1], [])
+        circuits.append(qc)
+        qpy_file = io.BytesIO()
+        with patch(
+            "qiskit.qpy.common.QPY_RUST_WRITE_MIN_VERSION",
+            QPY_RUST_WRITE_MIN_VERSION if write_with == "Rust" else QPY_VERSION + 1,
+        ):
+            dump(circuits, qpy_file, version=version)
+        qpy_file.seek(0)
+        with patch(
+            "qiskit.qpy.common.QPY_RUST_READ_MIN_VERSION",
+            QPY_RUST_READ_MIN_VERSION if read_with == "Rust" else QPY_VERSION + 1,
+        ):
+            loaded = load(qpy_file, programs=[5, 3, 0, 3])
+        self.assertEqual(loaded, [circuits[5], circuits[3], circuits[0], circuits[3]])
+
+    @all_qpy_combinations(16)
+    def test_load_selected_programs_inside_stream(self, version, write_with, read_with):
+        """Test loading programs from a payload which neither starts nor ends its stream"""
+        circuits = [random_circuit(3, 5, measure=True, seed=7 + i) for i in range(4)]
+        prefix, suffix = b"prefix", b"suffix"
+        qpy_file = io.BytesIO()
+        qpy_file.write(prefix)
+        with patch(
+            "qiskit.qpy.common.QPY_RUST_WRITE_MIN_VERSION",
+            QPY_RUST_WRITE_MIN_VERSION if write_with == "Rust" else QPY_VERSION + 1,
+        ):
+            dump(circuits, qpy_file, version=version)
+        qpy_file.write(suffix)
+        relative = qpy_file.getvalue()
+        # Older versions of Qiskit wrote offsets relative to the start of the stream rather than
+        # to the start of the payload.
+        absolute = bytearray(relative)
+        table_start = len(prefix) + formats.FILE_HEADER_V10_SIZE + formats.TYPE_KEY_SIZE
+        for i in range(len(circuits)):
+            entry = slice(
+                table_start + i * formats.CIRCUIT_TABLE_ENTRY_SIZE,
+                table_start + (i + 1) * formats.CIRCUIT_TABLE_ENTRY_SIZE,
+            )
+            (offset,) = struct.unpack(formats.CIRCUIT_TABLE_ENTRY_PACK, absolute[entry])
+            absolute[entry] = struct.pack(formats.CIRCUIT_TABLE_ENTRY_PACK, offset + len(prefix))
+        for data, programs in itertools.product((relative, bytes(absolute)), (None, [3, 1], [2])):
+            with self.subTest(absolute=data != relative, programs=programs):
+                qpy_file = io.BytesIO(data)
+                qpy_file.seek(len(prefix))
+                with patch(
+                    "qiskit.qpy.common.QPY_RUST_READ_MIN_VERSION",
+                    QPY_RUST_READ_MIN_VERSION if read_with == "Rust" else QPY_VERSION + 1,
+                ):
+                    loaded = load(qpy_file, programs=programs)
+                expected = circuits if programs is None else [circuits[i] for i in programs]
+                self.assertEqual(loaded, expected)
+                self.assertEqual(qpy_file.read(), suffix)
+
+    def test_parallel_matches_serial(self):
+        """Test that files with many programs are written and read the same in parallel"""
+        circuits = [
+            random_circuit(5, 10, measure=True, conditional=True, seed=42 + i) for i in range(20)
+        ]
+        serial_env = {"QISKIT_IN_PARALLEL": "TRUE", "QISKIT_FORCE_THREADS": "FALSE"}
+        parallel_env = {"QISKIT_IN_PARALLEL": "FALSE"}
+        serial_file = io.BytesIO()
+        with patch.dict(os.environ, serial_env):
+            dump(circuits, serial_file)
+        parallel_file = io.BytesIO()
+        with patch.dict(os.environ, parallel_env):
+            dump(circuits, parallel_file)
+        self.assertEqual(parallel_file.getvalue(), serial_file.getvalue())
+        parallel_file.seek(0)
+        with patch.dict(os.environ, parallel_env):
+            self.assertEqual(load(parallel_file), circuits)
+
+    def test_compressed_roundtrip(self):
+        """Test that compressed files load the same programs, including a subset of them"""
+        circuits = [
+            random_circuit(5, 20, measure=True, conditional=True, seed=42 + i) for i in range(20)
+        ]
+        plain_file = io.BytesIO()
+        dump(circuits, plain_file)
+        for compression, train_dictionary in itertools.product(("zstd", "lz4"), (False, True)):
+            with self.subTest(compression=compression, train_dictionary=train_dictionary):
+                qpy_file = io.BytesIO()
+                dump(circuits, qpy_file, compression=compression, train_dictionary=train_dictionary)
+                self.assertLess(len(qpy_file.getvalue()), len(plain_file.getvalue()))
+                qpy_file.seek(0)
+                self.assertEqual(get_qpy_version(qpy_file), QPY_VERSION)
+                self.assertEqual(load(qpy_file), circuits)
+                qpy_file.seek(0)
+                self.assertEqual(load(qpy_file, programs=[7, 2]), [circuits[7], circuits[2]])
+
+    def test_compressed_inside_stream(self):
+        """Test loading a compressed payload which neither starts nor ends its stream"""
+        circuits = [random_circuit(3, 5, measure=True, seed=7 + i) for i in range(4)]
+        prefix, suffix = b"prefix", b"suffix"
+        for compression, programs in itertools.product(("zstd", "lz4"), (None, [3, 1], [2])):
+            with self.subTest(compression=compression, programs=programs):
+                qpy_file = io.BytesIO()
+                qpy_file.write(prefix)
+                dump(circuits, qpy_file, compression=compression)
+                qpy_file.write(suffix)
+                qpy_file.seek(len(prefix))
+                loaded = load(qpy_file, programs=programs)
+                expected = circuits if programs is None else [circuits[i] for i in programs]
+                self.assertEqual(loaded, expected)
+                self.assertEqual(qpy_file.read(), suffix)
+
+    def test_compression_errors(self):
+        """Test that invalid compression settings are rejected"""
+        qc = QuantumCircuit(1)
+        with self.assertRaisesRegex(ValueError, "Unsupported compression"):
+            dump(qc, io.BytesIO(), compression="gzip")
+        with self.assertRaisesRegex(ValueError, "Compressed QPY payloads require"):
+            dump(qc, io.BytesIO(), compression="zstd", version=QPY_RUST_WRITE_MIN_VERSION - 1)
+
     @all_qpy_combinations(QPY_RUST_READ_MIN_VERSION)
     def test_delay_roundtrip(self, version, write_with, read_with):
         qc = QuantumCircuit(1)
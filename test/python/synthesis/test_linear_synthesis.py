@@ -103,7 +103,7 @@ class TestLinearSynth(QiskitTestCase):
         self.assertEqual(optimized_qc.depth(), 15)
         self.assertEqual(optimized_qc.count_ops()["cx"], 23)
 
-    @data(5, 6)
+    @data(5, 6, 70, 130)
     def test_invertible_matrix(self, n):
         """Test the functions for generating a random invertible matrix and inverting it."""
         mat = random_invertible_binary_matrix(n, seed=1234)
@@ -114,7 +114,7 @@ class TestLinearSynth(QiskitTestCase):
         self.assertTrue(np.array_equal(mat_out, np.eye(n)))
         self.assertTrue(out)
 
-    @data(5, 6)
+    @data(5, 6, 70)
     def test_synth_lnn_kms(self, num_qubits):
         """Test that synth_cnot_depth_line_kms produces the correct synthesis."""
         rng = np.random.default_rng(1234)
@@ -153,6 +153,14 @@ class TestLinearSynth(QiskitTestCase):
             qc = synth_cnot_count_full_pmh(mat, section_size)
             self.assertEqual(LinearFunction(qc), LinearFunction(mat))
 
+    @data(65, 130)
+    def test_synth_full_pmh_multiword(self, num_qubits):
+        """Test the PMH synthesis on matrices whose rows span several machine words."""
+        for seed in range(3):
+            mat = random_invertible_binary_matrix(num_qubits, seed=seed)
+            qc = synth_cnot_count_full_pmh(mat)
+            self.assertTrue(np.array_equal(LinearFunction(qc).linear, mat))
+
     @data(5, 11)
     def test_pmh_section_sizes(self, num_qubits):
         """Test the PMH algorithm for different section sizes.
@@ -17,10 +17,13 @@ import unittest
 from test import combine
 from ddt import ddt, data
 
-from qiskit.circuit.library import QFT
+from qiskit.circuit import QuantumCircuit
+from qiskit.circuit.exceptions import CircuitError
+from qiskit.circuit.library import QFT, QFTGate
 from qiskit.synthesis.qft import synth_qft_line, synth_qft_full
 from qiskit.quantum_info import Operator
 from qiskit.synthesis.linear.linear_circuits_utils import check_lnn_connectivity
+from qiskit.transpiler.passes import HLSConfig, HighLevelSynthesis
 from test import QiskitTestCase
 
 
@@ -123,6 +126,42 @@ class TestQFTFull(QiskitTestCase):
         qft = synth_qft_full(num_qubits)
         self.assertEqual(set(qft.count_ops()), {"cp", "h", "swap"})
 
+    def test_repeated_synthesis_independent(self):
+        """Test that repeatedly synthesizing the same QFT gives independent circuits."""
+        qft = synth_qft_full(6, approximation_degree=2)
+        expected = qft.copy()
+        qft.x(0)
+        self.assertEqual(synth_qft_full(6, approximation_degree=2), expected)
+        self.assertNotEqual(synth_qft_full(6, approximation_degree=2, inverse=True), expected)
+
+    def test_negative_approximation_degree(self):
+        """Test that a negative approximation degree means no approximation."""
+        self.assertEqual(synth_qft_full(5, approximation_degree=-2), synth_qft_full(5))
+
+    def test_negative_num_qubits(self):
+        """Test that a negative number of qubits raises a CircuitError."""
+        with self.assertRaises(CircuitError):
+            synth_qft_full(-1)
+
+    def test_high_level_synthesis(self):
+        """Test that HighLevelSynthesis synthesizes a QFTGate as the default plugin does."""
+        circuit = QuantumCircuit(5)
+        circuit.append(QFTGate(5), circuit.qubits)
+        circuit.append(QFTGate(5), [4, 2, 0, 1, 3])
+        expected = QuantumCircuit(5)
+        expected.compose(synth_qft_full(5), inplace=True)
+        expected.compose(synth_qft_full(5), [4, 2, 0, 1, 3], inplace=True)
+        synthesized = HighLevelSynthesis(basis_gates=["cp", "h", "swap"])(circuit)
+        self.assertEqual(synthesized, expected)
+
+        with self.subTest("configured method"):
+            config = HLSConfig(qft=["line"])
+            synthesized = HighLevelSynthesis(hls_config=config, basis_gates=["cp", "h", "swap"])(
+                circuit
+            )
+            self.assertEqual(Operator(synthesized), Operator(expected))
+            self.assertNotEqual(synthesized, expected)
+
 
 if __name__ == "__main__":
     unittest.main()
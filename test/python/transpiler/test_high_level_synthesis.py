@@ -3210,6 +3210,27 @@ class TestPauliEvolutionSynthesisPlugins(QiskitTestCase):
         self.assertEqual(Operator(qct_default), Operator(qc))
         self.assertEqual(Operator(qct_rustiq), Operator(qc))
 
+    def test_rustiq_on_pauli_sparse_observable(self):
+        """Test that Rustiq synthesizes a SparseObservable of Paulis directly, and gives the
+        same circuit as for the equivalent SparsePauliOp."""
+        obs = SparseObservable.from_sparse_list(
+            [("XX", (0, 1), 1.5), ("ZY", (1, 3), -0.5), ("YZX", (0, 2, 3), 0.25), ("", (), 1.0)],
+            num_qubits=4,
+        )
+        rustiq_config = HLSConfig(PauliEvolution=["rustiq"])
+        qc = QuantumCircuit(4)
+        qc.append(PauliEvolutionGate(obs, time=0.7), [0, 1, 2, 3])
+        qct = HighLevelSynthesis(hls_config=rustiq_config)(qc)
+        self.assertEqual(Operator(qct), Operator(qc))
+        self.assertEqual(count_rotation_gates(qct), 3)
+
+        expected = QuantumCircuit(4)
+        expected.append(
+            PauliEvolutionGate(SparsePauliOp.from_sparse_observable(obs), time=0.7), [0, 1, 2, 3]
+        )
+        expected = HighLevelSynthesis(hls_config=rustiq_config)(expected)
+        self.assertEqual(qct, expected)
+
     def test_on_list_with_sparse_observable(self):
         """Test that plugins handle operators with SparseObservables."""
         pauli = Pauli("-XYZI")
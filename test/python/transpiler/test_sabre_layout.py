@@ -471,6 +471,34 @@ class TestDisjointDeviceSabreLayout(QiskitTestCase):
         layout = layout_routing_pass.property_set["layout"]
         self.assertEqual([layout[q] for q in qc.qubits], [3, 2, 1, 5, 4, 7, 6, 8])
 
+    def test_spanning_barrier_routed_per_component(self):
+        """Test that a barrier across components is rejoined after the components are routed."""
+        qc = QuantumCircuit(8, name="double dhz")
+        qc.h(0)
+        qc.cz(0, 1)
+        qc.cz(0, 2)
+        qc.barrier(0, 1, 2, 4, 5, label="sync")
+        qc.h(3)
+        qc.cx(3, 4)
+        qc.cx(3, 5)
+        qc.cx(3, 6)
+        qc.cx(3, 7)
+        qc.measure_all()
+        layout_routing_pass = SabreLayout(
+            self.dual_grid_cmap, seed=123456, swap_trials=1, layout_trials=1
+        )
+        out = layout_routing_pass(qc)
+        barriers = [inst.operation for inst in out.data if inst.operation.name == "barrier"]
+        self.assertEqual([(b.num_qubits, b.label) for b in barriers], [(5, "sync"), (8, None)])
+        counts = out.count_ops()
+        for name, count in qc.count_ops().items():
+            self.assertEqual(counts[name], count)
+        edges = set(self.dual_grid_cmap.get_edges())
+        edges |= {(b, a) for a, b in edges}
+        for inst in out.data:
+            if inst.operation.num_qubits == 2:
+                self.assertIn(tuple(out.find_bit(q).index for q in inst.qubits), edges)
+
     def test_too_large_components(self):
         """Assert trying to run a circuit with too large a connected component raises."""
         qc = QuantumCircuit(8)